@@ -215,6 +215,47 @@ public:
     /// @return The Stage after which this value is available.                  
     Stage getDependsOnStage(int derivOrder=0) const;
 
+    /// Declare that this Measure's value is calculated from the value of
+    /// the \a upstream Measure. Once a Measure has any declared 
+    /// prerequisites, its cached value is invalidated only when one of them
+    /// changes (or when its prerequisite stage is invalidated) rather than
+    /// whenever its depends-on stage is invalidated, so that changing one
+    /// input of a large graph of Measures recomputes only the Measures 
+    /// downstream of it. The upstream Measure's topology should be realized
+    /// before this one's, so it should be adopted earlier by the same
+    /// Subsystem or belong to one the System realizes first; otherwise this
+    /// one falls back to depending on the stage whose invalidation may
+    /// change the upstream Measure's value. The Plus, Minus, and Scale
+    /// Measures declare their operands automatically. This is a topological
+    /// change.
+    AbstractMeasure& addPrerequisite(const AbstractMeasure& upstream);
+    /// Declare that this Measure's value is calculated directly from the
+    /// generalized coordinates q. This is a topological change.
+    AbstractMeasure& addPrerequisiteQ();
+    /// Declare that this Measure's value is calculated directly from the
+    /// generalized speeds u. This is a topological change.
+    AbstractMeasure& addPrerequisiteU();
+    /// Declare that this Measure's value is calculated directly from the
+    /// auxiliary continuous state variables z. This is a topological change.
+    AbstractMeasure& addPrerequisiteZ();
+    /// For a Measure with declared prerequisites, set the lowest stage whose
+    /// invalidation must still invalidate this Measure's value; the default
+    /// is Stage::Instance. Set this to Stage::Time for a Measure that also
+    /// reads the time, for example.
+    AbstractMeasure& setPrerequisiteStage(Stage stage);
+    /// Return the stage set with setPrerequisiteStage().
+    Stage getPrerequisiteStage() const;
+    /// Return true if this Measure has any declared prerequisites.
+    bool hasPrerequisites() const;
+
+    /// Return the number of times this Measure has calculated its cached
+    /// value, in any State, since it was constructed or the count was last
+    /// reset. Measures that have no cached value (like Variable and Constant)
+    /// always report zero.
+    long long getNumRecomputations() const;
+    /// Reset the count returned by getNumRecomputations() to zero.
+    void resetNumRecomputations() const;
+
 
     /// There can be multiple handles on the same Measure.
     bool isSameMeasure(const AbstractMeasure& other) const
@@ -33,6 +33,8 @@
 #include "SimTKcommon/internal/SubsystemGuts.h"
 
 #include <cmath>
+#include <algorithm>
+#include <atomic>
 
 
 namespace SimTK {
@@ -49,13 +51,21 @@ class SimTK_SimTKCOMMON_EXPORT AbstractMeasure::Implementation {
 protected:
     /** This default constructor is for use by concrete measure implementation
     classes. **/
-    Implementation() : copyNumber(0), mySubsystem(0), refCount(0) {}
+    Implementation() 
+    :   copyNumber(0), mySubsystem(0), refCount(0),
+        prerequisiteQ(false), prerequisiteU(false), prerequisiteZ(false),
+        prerequisiteStage(Stage::Instance), numRecomputations(0) {}
 
     /** Base class copy constructor removes the Subsystem
     and sets the reference count to zero. This gets used by the clone()
-    methods in the concrete classes. **/
+    methods in the concrete classes. The declared prerequisites are kept
+    but the recomputation count starts over. **/
     Implementation(const Implementation& src)
-    :   copyNumber(src.copyNumber+1), mySubsystem(0), refCount(0) {}
+    :   copyNumber(src.copyNumber+1), mySubsystem(0), refCount(0),
+        prerequisiteQ(src.prerequisiteQ), prerequisiteU(src.prerequisiteU),
+        prerequisiteZ(src.prerequisiteZ), 
+        prerequisiteMeasures(src.prerequisiteMeasures),
+        prerequisiteStage(src.prerequisiteStage), numRecomputations(0) {}
     
     /** Base class copy assignment operator removes the
     Subsystem, and sets the reference count to zero. This is probably
@@ -63,7 +73,12 @@ protected:
     Implementation& operator=(const Implementation& src) {
         if (&src != this)
         {   copyNumber=src.copyNumber+1;
-            refCount=0; mySubsystem=0; }
+            refCount=0; mySubsystem=0; 
+            prerequisiteQ=src.prerequisiteQ; prerequisiteU=src.prerequisiteU;
+            prerequisiteZ=src.prerequisiteZ;
+            prerequisiteMeasures=src.prerequisiteMeasures;
+            prerequisiteStage=src.prerequisiteStage;
+            numRecomputations=0; }
         return *this; 
     }
 
@@ -127,6 +142,96 @@ protected:
 
     Stage getStage(const State& s) const {return getSubsystem().getStage(s);}
 
+    /** Declare that this %Measure's value is calculated from the value of
+    \a upstream. Once a %Measure has any declared prerequisites, its value
+    cache entry is invalidated only when one of those changes, or when the
+    prerequisite stage changes, rather than whenever its depends-on stage
+    changes. This is a topological change. **/
+    void addPrerequisite(const AbstractMeasure& upstream) {
+        SimTK_ERRCHK_ALWAYS(upstream.hasImpl(),
+            "Measure::addPrerequisite()",
+            "An empty Measure handle can't be a prerequisite.");
+        for (const AbstractMeasure& m : prerequisiteMeasures)
+            if (m.isSameMeasure(upstream))
+                return;
+        prerequisiteMeasures.push_back(upstream);
+        invalidateTopologyCache();
+    }
+
+    /** Declare that this %Measure's value is calculated directly from the
+    generalized coordinates q, speeds u, or auxiliary variables z. **/
+    void addPrerequisiteQ() {prerequisiteQ=true; invalidateTopologyCache();}
+    void addPrerequisiteU() {prerequisiteU=true; invalidateTopologyCache();}
+    void addPrerequisiteZ() {prerequisiteZ=true; invalidateTopologyCache();}
+
+    /** Set the lowest stage whose invalidation must still invalidate this
+    %Measure's value even though it has declared prerequisites; the default
+    is Stage::Instance. For example, a %Measure that also reads the time
+    should set this to Stage::Time. Stages above this one are relied upon
+    only if this %Measure's own depends-on stage is lower. **/
+    void setPrerequisiteStage(Stage stage) 
+    {   prerequisiteStage = stage; invalidateTopologyCache(); }
+
+    Stage getPrerequisiteStage() const {return prerequisiteStage;}
+
+    /** Return true if this %Measure has declared any prerequisites and so
+    uses dependency tracking rather than stage invalidation. **/
+    bool hasPrerequisites() const 
+    {   return prerequisiteQ || prerequisiteU || prerequisiteZ
+            || !prerequisiteMeasures.empty(); }
+
+    /** Return the number of times this %Measure has calculated its value
+    (in any State) since it was constructed or since the count was last
+    reset. Only cached values are counted. **/
+    long long getNumRecomputations() const {return numRecomputations;}
+    void resetNumRecomputations() const {numRecomputations = 0;}
+
+    /** The set of State resources on which a %Measure's value cache entry
+    depends, in the form required by 
+    State::allocateCacheEntryWithPrerequisites(). **/
+    struct Prerequisites {
+        Prerequisites() : stage(Stage::Topology), q(false), u(false), z(false)
+        {}
+        Stage                   stage;
+        bool                    q, u, z;
+        Array_<DiscreteVarKey>  discreteVars;
+        Array_<CacheEntryKey>   cacheEntries;
+    };
+
+    /** Collect the prerequisites declared for this %Measure. An upstream
+    %Measure that is realized later than this one (so that its State
+    resources don't exist yet when this one's are allocated), or that is not
+    in any Subsystem, is handled conservatively by depending on the stage
+    whose invalidation may change its value instead. This must be called
+    during realizeTopology(). **/
+    void getPrerequisites(const State& s, Prerequisites& p) const {
+        p = Prerequisites();
+        p.stage = Stage(std::max(Stage(Stage::Topology), 
+                     Stage(std::min(prerequisiteStage, getDependsOnStage(0)))));
+        p.q = prerequisiteQ; p.u = prerequisiteU; p.z = prerequisiteZ;
+        for (const AbstractMeasure& m : prerequisiteMeasures) {
+            const Implementation& up = m.getImpl();
+            if (isRealizedAfter(s, up))
+                up.addValuePrerequisitesVirtual(s, p);
+            else
+                p.stage = Stage(std::max(p.stage, up.getValueChangedStage()));
+        }
+    }
+
+    /** Return the lowest stage whose invalidation may change this %Measure's
+    value. That is at least its depends-on stage, but may be higher for a
+    %Measure that can be changed directly or that has prerequisites. **/
+    Stage getValueChangedStage() const {
+        Stage g = Stage(std::max(getDependsOnStage(0), 
+                                 getValueChangedStageVirtual()));
+        if (prerequisiteQ) g = Stage(std::max(g, Stage(Stage::Position)));
+        if (prerequisiteU) g = Stage(std::max(g, Stage(Stage::Velocity)));
+        if (prerequisiteZ) g = Stage(std::max(g, Stage(Stage::Dynamics)));
+        for (const AbstractMeasure& m : prerequisiteMeasures)
+            g = Stage(std::max(g, m.getImpl().getValueChangedStage()));
+        return g;
+    }
+
     // VIRTUALS //
 
     virtual ~Implementation() {}
@@ -147,7 +252,34 @@ protected:
     virtual int   getNumTimeDerivativesVirtual() const {return 0;}
     virtual Stage getDependsOnStageVirtual(int order) const = 0;
 
+    /** Add to \a p whatever State resources hold this %Measure's value, so
+    that a downstream %Measure is invalidated when that value changes. This
+    is only called for a %Measure that has already been realized. The
+    default can't be more specific than this %Measure's depends-on stage. **/
+    virtual void addValuePrerequisitesVirtual(const State&, 
+                                              Prerequisites& p) const
+    {   p.stage = Stage(std::max(p.stage, getValueChangedStage())); }
+
+    /** Override this for a %Measure whose value can change without its
+    depends-on stage being invalidated. **/
+    virtual Stage getValueChangedStageVirtual() const {return Stage::Empty;}
+
+    // Note that a Measure has been computed; for use by Measure_<T>.
+    void noteRecomputation() const {++numRecomputations;}
+
 private:
+    // Has the upstream Measure's realizeTopology() already been called? A
+    // System may realize its Subsystems in any order, so for one in another
+    // Subsystem we have to ask the State; within a Subsystem, Measures are
+    // realized in the order they were adopted.
+    bool isRealizedAfter(const State& s, const Implementation& up) const {
+        if (!up.isInSubsystem() || !isInSubsystem()) return false;
+        const SubsystemIndex upSub = up.getSubsystemIndex();
+        if (upSub != getSubsystemIndex())
+            return s.getSubsystemStage(upSub) >= Stage::Topology;
+        return up.getSubsystemMeasureIndex() < getSubsystemMeasureIndex();
+    }
+
     int             copyNumber; // bumped each time we do a deep copy
 
     // These are set when this Measure is adopted by a Subsystem.
@@ -158,6 +290,14 @@ private:
     // objects, which are only deleted when the refCount goes to zero.
     mutable int     refCount;
 
+    // Declared prerequisites (topology state).
+    bool                    prerequisiteQ, prerequisiteU, prerequisiteZ;
+    Array_<AbstractMeasure> prerequisiteMeasures;
+    Stage                   prerequisiteStage;
+
+    // Statistics; Measures may be realized in several States concurrently.
+    mutable std::atomic<long long> numRecomputations;
+
 friend class AbstractMeasure;
 friend class Subsystem::Guts;
 };
@@ -249,6 +389,42 @@ inline int AbstractMeasure::
 getRefCount() const
 {   return getImpl().getRefCount(); }
 
+inline AbstractMeasure& AbstractMeasure::
+addPrerequisite(const AbstractMeasure& upstream)
+{   updImpl().addPrerequisite(upstream); return *this; }
+
+inline AbstractMeasure& AbstractMeasure::
+addPrerequisiteQ()
+{   updImpl().addPrerequisiteQ(); return *this; }
+
+inline AbstractMeasure& AbstractMeasure::
+addPrerequisiteU()
+{   updImpl().addPrerequisiteU(); return *this; }
+
+inline AbstractMeasure& AbstractMeasure::
+addPrerequisiteZ()
+{   updImpl().addPrerequisiteZ(); return *this; }
+
+inline AbstractMeasure& AbstractMeasure::
+setPrerequisiteStage(Stage stage)
+{   updImpl().setPrerequisiteStage(stage); return *this; }
+
+inline Stage AbstractMeasure::
+getPrerequisiteStage() const
+{   return getImpl().getPrerequisiteStage(); }
+
+inline bool AbstractMeasure::
+hasPrerequisites() const
+{   return getImpl().hasPrerequisites(); }
+
+inline long long AbstractMeasure::
+getNumRecomputations() const
+{   return getImpl().getNumRecomputations(); }
+
+inline void AbstractMeasure::
+resetNumRecomputations() const
+{   getImpl().resetNumRecomputations(); }
+
 
 /** @cond **/ // Hide from Doxygen.
 // This is a helper class that makes it possible to treat Real, Vec, and 
@@ -392,6 +568,7 @@ public:
                 T& value = updCacheEntry(s,derivOrder);
                 calcCachedValueVirtual(s, derivOrder, value);
                 markCacheValueRealized(s,derivOrder);
+                this->noteRecomputation();
                 return value;
             }
             return getCacheEntry(s,derivOrder);
@@ -559,20 +736,55 @@ protected:
     %Measure's value. **/
     const T& getValueZero() const {return zeroValue;}
 
+    /** A downstream %Measure depends on our value cache entry, which 
+    already tracks everything our value depends on. A %Measure with no
+    value cache entry falls back to the stage whose invalidation may change
+    its value. **/
+    void addValuePrerequisitesVirtual
+       (const State& s, typename AbstractMeasure::Implementation::Prerequisites& p)
+        const override
+    {
+        if (!getNumCacheEntries()) {
+            AbstractMeasure::Implementation::addValuePrerequisitesVirtual(s,p);
+            return;
+        }
+        const CacheEntryKey key(this->getSubsystemIndex(), derivIx[0]);
+        if (std::find(p.cacheEntries.begin(), p.cacheEntries.end(), key)
+            == p.cacheEntries.end())
+            p.cacheEntries.push_back(key);
+        p.stage = Stage(std::max(p.stage, valueCacheDependsOnStage));
+    }
+
 private:
     // Satisfy the realizeTopology() pure virtual here now that we know the 
     // data type T. Allocate lazy- or auto-validated- cache entries depending 
-    // on the setting of presumeValidAtDependsOnStage.
+    // on the setting of presumeValidAtDependsOnStage. If this Measure has
+    // declared prerequisites, its value cache entry is allocated with those
+    // so that it is invalidated only when one of them changes.
     void realizeTopology(State& s) const override final {
         // Allocate cache entries. Initialize the value cache entry to
         // the given defaultValue; all the derivative cache entries should be
         // initialized to a NaN of the same size.
         if (getNumCacheEntries()) {
-            derivIx[0] = presumeValidAtDependsOnStage 
-                ? this->getSubsystem().allocateCacheEntry
+            valueCacheDependsOnStage = getDependsOnStage(0);
+            if (this->hasPrerequisites()) {
+                typename AbstractMeasure::Implementation::Prerequisites p;
+                this->getPrerequisites(s, p);
+                valueCacheDependsOnStage = p.stage;
+                const Stage latest = presumeValidAtDependsOnStage
+                    ? Stage(std::max(p.stage, getDependsOnStage(0)))
+                    : Stage(Stage::Infinity);
+                derivIx[0] = s.allocateCacheEntryWithPrerequisites
+                   (this->getSubsystemIndex(), p.stage, latest,
+                    p.q, p.u, p.z, p.discreteVars, p.cacheEntries,
+                    new Value<T>(defaultValue));
+            } else {
+                derivIx[0] = presumeValidAtDependsOnStage 
+                    ? this->getSubsystem().allocateCacheEntry
                         (s, getDependsOnStage(0), new Value<T>(defaultValue))
-                : this->getSubsystem().allocateLazyCacheEntry
+                    : this->getSubsystem().allocateLazyCacheEntry
                         (s, getDependsOnStage(0), new Value<T>(defaultValue));
+            }
 
             if (getNumCacheEntries() > 1) {
                 T nanValue; Measure_Num<T>::makeNaNLike(defaultValue, nanValue);
@@ -599,6 +811,7 @@ private:
 
     // TOPOLOGY CACHE
     mutable Array_<CacheEntryIndex> derivIx;
+    mutable Stage                   valueCacheDependsOnStage;
 };
 
 
@@ -756,7 +969,17 @@ public:
         override
     {   return derivOrder>0 ? this->getValueZero() : getVarValue(s); }
 
-    // No cached values.
+    // Setting the value invalidates a later stage than the one the value
+    // becomes available at.
+    Stage getValueChangedStageVirtual() const override
+    {   return invalidatedStage; }
+
+    // No cached values. Downstream measures depend directly on the variable.
+    void addValuePrerequisitesVirtual
+       (const State&, typename AbstractMeasure::Implementation::Prerequisites& p)
+        const override
+    {   p.discreteVars.push_back
+           (DiscreteVarKey(this->getSubsystemIndex(), discreteVarIndex)); }
 
     void realizeMeasureTopologyVirtual(State& s) const override {
         discreteVarIndex = this->getSubsystem().allocateDiscreteVariable
@@ -975,7 +1198,10 @@ public:
 
     Implementation(const Measure_<T>& left, 
                    const Measure_<T>& right)
-    :   left(left), right(right) {}
+    :   left(left), right(right) {
+        if (left.hasImpl())  this->addPrerequisite(left);
+        if (right.hasImpl()) this->addPrerequisite(right);
+    }
 
     // Default copy constructor gives us a new Implementation object,
     // but with references to the *same* operand measures.
@@ -1028,7 +1254,10 @@ public:
 
     Implementation(const Measure_<T>& left, 
                    const Measure_<T>& right)
-    :   left(left), right(right) {}
+    :   left(left), right(right) {
+        if (left.hasImpl())  this->addPrerequisite(left);
+        if (right.hasImpl()) this->addPrerequisite(right);
+    }
 
     // Default copy constructor gives us a new Implementation object,
     // but with references to the *same* operand measures.
@@ -1082,7 +1311,8 @@ public:
     Implementation() : factor(NaN) {}
 
     Implementation(Real factor, const Measure_<T>& operand)
-    :   factor(factor), operand(operand) {}
+    :   factor(factor), operand(operand) 
+    {   if (operand.hasImpl()) this->addPrerequisite(operand); }
 
     // Default copy constructor gives us a new Implementation object,
     // but with references to the *same* operand measure.
@@ -288,6 +288,10 @@ State();
 /// source %State, copying only state variables and not the cache. If the source
 /// state hasn't been realized to at least Stage::Model, then we don't copy its
 /// state variables either, except those associated with the Topology stage.
+/// Every variable and cache entry of the new %State is allocated separately
+/// on the heap, so this is expensive for a large System. Code that copies a
+/// %State repeatedly should instead copy it once and then assign to that
+/// copy, which reuses its storage; see operator=().
 State(const State&);
 
 /// The move constructor is very fast. The source object is left empty.
@@ -298,7 +302,12 @@ State(State&& source);
 /// current %State contain a copy of the state information in the source %State,
 /// copying only state variables and not the cache. If the source state hasn't
 /// been realized to at least Stage::Model, then we don't copy its state
-/// variables either, except those associated with the Topology stage.
+/// variables either, except those associated with the Topology stage. If both
+/// States have the same allocations and are realized through Stage::Instance
+/// (for example, this %State was earlier copied from another %State of the
+/// same System), the values are copied into this %State's existing storage
+/// with no heap allocation; otherwise this is as expensive as copy 
+/// construction.
 State& operator=(const State&);
 
 /// Move assignment is very fast. The source object is left in a valid but
@@ -380,6 +389,26 @@ inline void invalidateAll(Stage);
 /// to cache entries. "All" here refers to all Subsystems.
 inline void invalidateAllCacheAtOrAbove(Stage) const;
 
+/// (Advanced) Invalidate Topology stage for just the given %Subsystem,
+/// discarding its state variables and cache entries, and for any other
+/// %Subsystem with a cache entry that has one of those as a prerequisite.
+/// The other %Subsystems lose only their Model-stage allocations and remain
+/// realized through Topology stage. This is used by System::realizeTopology()
+/// to rebuild only the %Subsystems whose topology has changed.
+inline void invalidateSubsystemTopology(SubsystemIndex);
+
+/// (Advanced) Copy into the given %Subsystem the values of the state
+/// variables that the same %Subsystem of the \a source State allocated at
+/// \a stage, which must be Stage::Topology or Stage::Model. The Model-stage
+/// variables include the %Subsystem's q's, u's, and z's. Variables are
+/// matched by position, so nothing is copied and false is returned unless
+/// the %Subsystem allocated its state variables identically through
+/// \a stage in both States. Stages are invalidated as though each variable
+/// had been updated individually.
+/// @see System::updateStateToCurrentTopology()
+inline bool copySubsystemVariablesFrom(SubsystemIndex, const State& source,
+                                       Stage stage);
+
 /// Advance a particular Subsystem's current stage by one to
 /// the indicated stage. The stage is passed in just to give us a
 /// chance to verify that all is as expected. You can only advance one stage at
@@ -1142,6 +1171,20 @@ was created. This has no effect on the realization level.
 **/
 inline void setSystemTopologyStageVersion(StageVersion topoVersion);
 
+/** (Advanced) Return the Topology stage version number of a particular 
+%Subsystem. When a System realizes a %Subsystem's topology it sets this to
+the System's topology cache version at the time, so two States whose 
+%Subsystem has the same version here got it from the same realization.
+@see setSubsystemTopologyStageVersion() **/
+inline StageVersion getSubsystemTopologyStageVersion(SubsystemIndex) const;
+
+/** (Advanced) This explicitly modifies a %Subsystem's Topology stage version;
+don't use this method unless you know what you're doing! This has no effect 
+on the realization level.
+@see getSubsystemTopologyStageVersion() **/
+inline void setSubsystemTopologyStageVersion(SubsystemIndex, 
+                                             StageVersion topoVersion);
+
 /** (Advanced) Return a ValueVersion for q, meaning an integer that is
 incremented whenever any q is changed (or more precisely whenever q or y is
 returned with writable access). Will be 1 or greater if q has been
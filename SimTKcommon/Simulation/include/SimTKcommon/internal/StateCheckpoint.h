@@ -0,0 +1,132 @@
+#ifndef SimTK_SimTKCOMMON_STATE_CHECKPOINT_H_
+#define SimTK_SimTKCOMMON_STATE_CHECKPOINT_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon/basics.h"
+#include "SimTKcommon/Simmatrix.h"
+#include "SimTKcommon/internal/State.h"
+
+#include <cstdint>
+
+namespace SimTK {
+
+/** A binary snapshot of the variables in a State, written to a file so that a
+long simulation can be resumed later, in another process, from where it left
+off. This is what State's stream output is not: compact, exact (values are
+stored in binary, not printed), and quick to load.
+
+A checkpoint holds the time, q, u, and z, the event trigger values, and the
+values of those discrete variables whose types it knows how to store. Those
+are bool, int, Real, Vec2, Vec3, Vec4, SpatialVec, Vector, Vector_<Vec3>,
+Vector_<SpatialVec>, and Array_<bool> (which covers the common Force and
+Constraint parameters and enable flags). A State with a discrete variable of
+any other type can't be checkpointed completely, so write() throws unless you
+ask it to skip such variables. That is the case for a MultibodySystem, whose
+SimbodyMatterSubsystem keeps its model and instance settings (for example
+body mass properties, locked mobilizers and disabled constraints) in
+variables of its own types. Skipped variables are left as they are in the
+target State on restore, normally at their default values, so any settings
+they hold must be made again before restoring. Cache entries are never saved;
+they are recalculated by realize() after the restore.
+
+A checkpoint can only be restored into a State that has the same structure as
+the one that was saved: the same subsystems, with the same numbers of each
+kind of variable and the same discrete variable types. That is checked using a
+key computed from the State's structure, recorded in the file header, so you
+should realize the target State to Stage::Model (for a System, call
+realizeTopology() and realizeModel() with any model-stage options set as they
+were when the checkpoint was written) before restoring. The file is native
+binary, so checkpoints move between runs of the same program on the same
+kind of machine, not across platforms or compilers.
+
+Restoring maps the file into memory rather than reading it, and copies each
+variable straight from the mapped file into the State's existing storage; no
+memory is allocated unless a Vector-valued discrete variable changes size.
+Keep a %StateCheckpoint object around if you want to restore the same
+checkpoint many times (for example as the start of many ensemble runs).
+
+@code
+    // Every so often, in the simulation loop. The matter subsystem's own
+    // variables are skipped; its settings are made by the program at startup.
+    StateCheckpoint::write(integ.getState(), "run.chk", true);
+
+    // After a restart:
+    State state = system.realizeTopology();
+    system.realizeModel(state);
+    StateCheckpoint("run.chk").restore(state);
+    integ.initialize(state);
+@endcode
+
+Writing goes to a temporary file that is renamed to the requested name only
+when it is complete, so a job that is killed while writing a checkpoint
+leaves the previous one intact. **/
+class SimTK_SimTKCOMMON_EXPORT StateCheckpoint {
+public:
+    /** Write a checkpoint of \a state (which must be realized through at
+    least Stage::Model) to the file \a pathname, replacing any file already
+    there. If \a state has discrete variables whose types are not supported,
+    an exception is thrown unless \a skipUnsupported is true, in which case
+    they are left out. Returns the number of discrete variables left out. An
+    exception is thrown if the file can't be written. **/
+    static int write(const State& state, const String& pathname,
+                     bool skipUnsupported = false);
+
+    /** Map the checkpoint file \a pathname into memory and check its header.
+    An exception is thrown if the file can't be opened or is not a valid
+    checkpoint. The file stays mapped until this object is destroyed. **/
+    explicit StateCheckpoint(const String& pathname);
+    ~StateCheckpoint();
+
+    /** Return true if this checkpoint was written from a State with the same
+    structure as \a state, so that restore() will work. **/
+    bool isCompatible(const State& state) const;
+
+    /** Set the time, q, u, z, event triggers and saved discrete variables of
+    \a state from this checkpoint. \a state must be realized through at least
+    Stage::Model and be compatible with the checkpoint; an exception is
+    thrown otherwise. Changing the variables invalidates the appropriate
+    stages of \a state as usual. **/
+    void restore(State& state) const;
+
+    /** The time at which the checkpoint was written. **/
+    Real getTime() const;
+
+    /** Compute the key identifying the structure of \a state that is used to
+    check compatibility. Two States with the same key have the same
+    subsystems and the same numbers and types of variables. **/
+    static std::uint64_t calcStructureKey(const State& state);
+
+private:
+    // Not copyable; this owns the file mapping.
+    StateCheckpoint(const StateCheckpoint&) = delete;
+    StateCheckpoint& operator=(const StateCheckpoint&) = delete;
+
+    class Impl;
+    Impl* impl;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SimTKCOMMON_STATE_CHECKPOINT_H_
@@ -176,6 +176,24 @@ public:
         m_value.reset();
     }
 
+    // Return true if the source variable was allocated the same way as this
+    // one and has a value that can be assigned to this one's.
+    bool isLayoutCompatible(const DiscreteVarInfo& src) const {
+        return m_allocationStage  == src.m_allocationStage
+            && m_invalidatedStage == src.m_invalidatedStage
+            && m_autoUpdateEntry  == src.m_autoUpdateEntry
+            && m_value && src.m_value && m_value->isCompatible(*src.m_value);
+    }
+
+    // Like deepAssign() but assigns the source value to the existing value
+    // object rather than replacing it with a clone, and keeps dependents.
+    // Requires isLayoutCompatible(src).
+    void assignInPlace(const DiscreteVarInfo& src) {
+        m_value->compatibleAssign(*src.m_value);
+        m_valueVersion    = src.m_valueVersion;
+        m_timeLastUpdated = src.m_timeLastUpdated;
+    }
+
     const Stage& getAllocationStage()  const {return m_allocationStage;}
 
     // Exchange value pointers (should be from this dv's update cache entry).
@@ -343,6 +361,48 @@ public:
         unregisterWithPrerequisites(stateImpl);
     }
 
+    // Return true if the source entry was allocated the same way as this one,
+    // with the same prerequisites, and has a value that can be assigned to
+    // this one's.
+    bool isLayoutCompatible(const CacheEntryInfo& src) const {
+        return m_myKey           == src.m_myKey
+            && m_allocationStage == src.m_allocationStage
+            && m_dependsOnStage  == src.m_dependsOnStage
+            && m_computedByStage == src.m_computedByStage
+            && m_associatedVar   == src.m_associatedVar
+            && m_qIsPrerequisite == src.m_qIsPrerequisite
+            && m_uIsPrerequisite == src.m_uIsPrerequisite
+            && m_zIsPrerequisite == src.m_zIsPrerequisite
+            && m_discreteVarPrerequisites == src.m_discreteVarPrerequisites
+            && m_cacheEntryPrerequisites  == src.m_cacheEntryPrerequisites
+            && m_value && src.m_value && m_value->isCompatible(*src.m_value);
+    }
+
+    // Like deepAssign() but assigns the source value to the existing value
+    // object rather than replacing it with a clone. This entry stays on the
+    // same lists of dependents, which are the right ones since the 
+    // prerequisites match. As after a copy, an entry with prerequisites is
+    // left out of date with respect to them. Requires isLayoutCompatible(src).
+    void assignInPlace(const CacheEntryInfo& src) {
+        m_value->compatibleAssign(*src.m_value);
+        m_valueVersion = src.m_valueVersion;
+        m_dependsOnVersionWhenLastComputed = 
+            src.m_dependsOnVersionWhenLastComputed;
+        m_isUpToDateWithPrerequisites = !hasPrerequisites();
+        #ifndef NDEBUG
+        m_qVersion = src.m_qVersion; m_uVersion = src.m_uVersion;
+        m_zVersion = src.m_zVersion;
+        m_discreteVarVersions = src.m_discreteVarVersions;
+        m_cacheEntryVersions  = src.m_cacheEntryVersions;
+        #endif
+    }
+
+    bool hasPrerequisites() const {
+        return m_qIsPrerequisite || m_uIsPrerequisite || m_zIsPrerequisite
+            || !m_discreteVarPrerequisites.empty()
+            || !m_cacheEntryPrerequisites.empty();
+    }
+
     const Stage& getAllocationStage() const {return m_allocationStage;}
 
     // Exchange values with a discrete variable (presumably this
@@ -389,6 +449,16 @@ public:
                != m_cacheEntryPrerequisites.cend();
     }
 
+    // Return true if any discrete variable or cache entry prerequisite of
+    // this cache entry belongs to the given subsystem.
+    bool hasPrerequisiteInSubsystem(SubsystemIndex sx) const {
+        for (const auto& dk : m_discreteVarPrerequisites)
+            if (dk.first == sx) return true;
+        for (const auto& ck : m_cacheEntryPrerequisites)
+            if (ck.first == sx) return true;
+        return false;
+    }
+
     #ifndef NDEBUG
     void recordPrerequisiteVersions(const StateImpl&);
     void validatePrerequisiteVersions(const StateImpl&) const;
@@ -476,6 +546,10 @@ public:
     {   return operator=(src); }
     void         deepDestruct(StateImpl&) {}
     const Stage& getAllocationStage() const {return allocationStage;}
+    bool isLayoutCompatible(const TriggerInfo& src) const 
+    {   return allocationStage==src.allocationStage 
+            && firstIndex==src.firstIndex && nslots==src.nslots; }
+    void assignInPlace(const TriggerInfo&) {} // nothing else to copy
 private:
     // These are fixed at construction.
     Stage                   allocationStage;
@@ -531,6 +605,12 @@ public:
     {   return operator=(src); }
     void               deepDestruct(StateImpl&) {}
     const Stage&       getAllocationStage() const {return allocationStage;}
+    bool isLayoutCompatible(const ContinuousVarInfo& src) const 
+    {   return allocationStage==src.allocationStage 
+            && firstIndex==src.firstIndex && getNumVars()==src.getNumVars(); }
+    // Same-size Vector assignment reuses the existing storage.
+    void assignInPlace(const ContinuousVarInfo& src) 
+    {   initialValues = src.initialValues; weights = src.weights; }
 private:
     // These are fixed at construction.
     Stage     allocationStage;
@@ -582,6 +662,11 @@ public:
     {   return operator=(src); }
     void               deepDestruct(StateImpl&) {}
     const Stage&       getAllocationStage() const {return allocationStage;}
+    bool isLayoutCompatible(const ConstraintErrInfo& src) const 
+    {   return allocationStage==src.allocationStage 
+            && firstIndex==src.firstIndex && getNumErrs()==src.getNumErrs(); }
+    // Same-size Vector assignment reuses the existing storage.
+    void assignInPlace(const ConstraintErrInfo& src) {weights = src.weights;}
 private:
     // These are fixed at construction.
     Stage     allocationStage;
@@ -906,6 +991,26 @@ private:
     // forgotten as Instance, Model, and Topology stages are invalidated.
     void restoreToStage(Stage g);
 
+    // Return true if this subsystem and the source have identical allocation
+    // stacks, with assignment-compatible values. Then the source can be
+    // copied with assignInPlace() without any heap allocation.
+    bool isLayoutCompatible(const PerSubsystemInfo& src) const;
+
+    // Make this subsystem a copy of the source through Instance stage, as
+    // copyFrom() would, but by assigning into the existing allocations and
+    // leaving the views of the global resources alone. Requires 
+    // isLayoutCompatible(src) and both subsystems realized through Instance.
+    void assignInPlace(const PerSubsystemInfo& src);
+
+    // Return true if this subsystem and the source allocated their discrete
+    // and continuous state variables identically through stage g, so that
+    // variable values can be copied from one to the other.
+    bool isVariableLayoutCompatible(const PerSubsystemInfo& src, Stage g) const;
+
+    // Return true if any cache entry here has a discrete variable or cache
+    // entry prerequisite that belongs to subsystem sx.
+    bool hasCachePrerequisiteInSubsystem(SubsystemIndex sx) const;
+
     // Utility which makes "this" a copy of the source subsystem exactly as it
     // was after being realized to stage maxStage. If maxStage >= Model then
     // all the subsystem-private state variables will be copied, but only
@@ -924,6 +1029,16 @@ private:
     template <class T>
     void copyAllocationStackThroughStage(Array_<T>& stack, 
                                          const Array_<T>& src, const Stage&);
+    template <class T>
+    static bool isAllocationStackLayoutCompatible(const Array_<T>& stack,
+                                                  const Array_<T>& src);
+    template <class T>
+    static bool isAllocationStackLayoutCompatible(const Array_<T>& stack,
+                                                  const Array_<T>& src,
+                                                  const Stage&);
+    template <class T>
+    static void assignAllocationStackInPlace(Array_<T>& stack, 
+                                             const Array_<T>& src);
 };
 
 
@@ -1001,6 +1116,7 @@ public:
     void setNumSubsystems(int nSubs) {
         assert(nSubs >= 0);
         subsystems.clear();
+        subsystems.reserve(nSubs); // growing would lose the backpointers
         for (int i=0; i < nSubs; ++i)
             subsystems.emplace_back(*this); // set backpointer
     }
@@ -1014,6 +1130,9 @@ public:
     SubsystemIndex addSubsystem(const String& name, const String& version) {
         const SubsystemIndex sx(subsystems.size());
         subsystems.emplace_back(*this, name, version);
+        // If the array grew, the copied subsystems lost their backpointers.
+        for (auto& subsys : subsystems)
+            subsys.m_stateImpl = this;
         return sx;
     }
     
@@ -1048,6 +1167,22 @@ public:
         for (SubsystemIndex i(0); i<(int)subsystems.size(); ++i)
             mthis->subsystems[i].invalidateStageJustThisSubsystem(g);
     }
+
+    // Invalidate Topology stage for just subsystem sx, discarding all its
+    // allocations, along with any other subsystem that has a cache entry
+    // with a prerequisite there. The system stage is invalidated too, and
+    // the remaining subsystems lose their Model-stage allocations but stay
+    // realized through Topology stage so need not be realized again.
+    void invalidateSubsystemTopology(SubsystemIndex sx);
+
+    // Copy into subsystem sx the values of the state variables that the
+    // same subsystem of the source State allocated at stage g, which must
+    // be Topology or Model. For Model this includes the subsystem's q, u,
+    // and z. Nothing is copied, and false is returned, unless the subsystem
+    // allocated its variables identically through g in both States. Stages
+    // are invalidated just as they would be if the variables were updated.
+    bool copySubsystemVariablesFrom(SubsystemIndex sx, const StateImpl& src,
+                                    Stage g);
     
     // Move the stage for a particular subsystem from g-1 to g. No other
     // subsystems are affected, nor the global system stage.
@@ -2054,6 +2189,14 @@ public:
     {   assert(topoVersion>0); 
         systemStageVersions[Stage::Topology]=topoVersion; }
 
+    StageVersion getSubsystemTopologyStageVersion(SubsystemIndex subsys) const
+    {   return getSubsystem(subsys).stageVersions[Stage::Topology]; }
+
+    void setSubsystemTopologyStageVersion(SubsystemIndex subsys, 
+                                          StageVersion topoVersion)
+    {   assert(topoVersion>0); 
+        updSubsystem(subsys).stageVersions[Stage::Topology]=topoVersion; }
+
     // Capture the stage versions only for currently-realized stages.
     void getSystemStageVersions(Array_<StageVersion>& versions) const {
         versions.resize(currentSystemStage+1);
@@ -2106,6 +2249,13 @@ private:
     // cache entries are valid.
     void copyFrom(const StateImpl& source);
 
+    // Copy assignment into a State that has exactly the same allocations as
+    // the source, and both realized through Instance stage, can reuse all
+    // the destination's storage rather than discarding and reallocating it.
+    // The result is the same as that of copyFrom().
+    bool isLayoutCompatible(const StateImpl& source) const;
+    void assignInPlace(const StateImpl& source);
+
     // Make sure that no cache entry copied from src could accidentally think
     // it was up to date, by setting all the version counters higher than
     // the ones in the source. (Don't set these to zero because then a
@@ -2342,6 +2492,14 @@ inline void State::invalidateAll(Stage stage) {
 inline void State::invalidateAllCacheAtOrAbove(Stage stage) const {
     getImpl().invalidateAllCacheAtOrAbove(stage);
 }
+inline void State::invalidateSubsystemTopology(SubsystemIndex subsys) {
+    updImpl().invalidateSubsystemTopology(subsys);
+}
+inline bool State::copySubsystemVariablesFrom
+   (SubsystemIndex subsys, const State& source, Stage stage) {
+    return updImpl().copySubsystemVariablesFrom(subsys, source.getImpl(), 
+                                                stage);
+}
 inline void State::advanceSubsystemToStage(SubsystemIndex subsys, Stage stage) const {
     getImpl().advanceSubsystemToStage(subsys, stage);
 }
@@ -2860,6 +3018,14 @@ inline void State::
 setSystemTopologyStageVersion(StageVersion topoVersion)
 {   return updImpl().setSystemTopologyStageVersion(topoVersion); }
 
+inline StageVersion State::
+getSubsystemTopologyStageVersion(SubsystemIndex subsys) const
+{   return getImpl().getSubsystemTopologyStageVersion(subsys); }
+inline void State::
+setSubsystemTopologyStageVersion(SubsystemIndex subsys, 
+                                 StageVersion topoVersion)
+{   updImpl().setSubsystemTopologyStageVersion(subsys, topoVersion); }
+
 inline void State::
 getSystemStageVersions(Array_<StageVersion>& versions) const {
     return getImpl().getSystemStageVersions(versions); 
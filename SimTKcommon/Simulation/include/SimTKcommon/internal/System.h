@@ -253,6 +253,36 @@ const State& getDefaultState() const;
 your copy. **/
 State&       updDefaultState();
 
+/** (Advanced) Normally any topological change makes the next
+realizeTopology() rebuild the default State from scratch, realizing the
+topology of every %Subsystem again. If this is set, a change confined to some
+%Subsystems (for example, adding a Force to one force %Subsystem) makes
+realizeTopology() realize only those %Subsystems, the %System's default
+%Subsystem, and any %Subsystem with cache entries that depend on them; the
+others keep their allocations in the default State. A %System subclass may
+still choose to rebuild more; MultibodySystem rebuilds everything after a
+change to its matter %Subsystem, such as adding a Constraint or contact
+surface. The default is false. 
+@see updateStateToCurrentTopology() **/
+System& setUsePartialTopologyRealization(bool usePartial);
+/** Return the value set by setUsePartialTopologyRealization(). **/
+bool getUsePartialTopologyRealization() const;
+
+/** After a topological change to this %System, make an existing \a state
+usable again while keeping as much of its contents as possible. This calls
+realizeTopology() if necessary and replaces \a state with a copy of the 
+default State, but then restores the time and the values of the state 
+variables of every %Subsystem whose topology has not been realized again
+since \a state was made, which requires setUsePartialTopologyRealization().
+For example, after a Force is added to one force
+%Subsystem, the positions and velocities of the bodies and the settings of 
+the other %Subsystems are kept, while that force %Subsystem and the %System's
+default %Subsystem (which is always rebuilt) get their default values. On
+return \a state has been realized through Stage::Model. If \a state already
+has the current Topology version, this does nothing.
+@see realizeTopology(), State::copySubsystemVariablesFrom() **/
+void updateStateToCurrentTopology(State& state) const;
+
 /** Realize the model to be used for subsequent computations with the given
 \a state. This call is required if Model-stage variables are changed from their 
 default values. The %System topology must already have been realized (that is, 
@@ -696,6 +726,78 @@ void multiplyByNPInvTranspose(const State& state, const Vector& fu,
 /**@}**/
 
 
+//------------------------------------------------------------------------------
+/**@name                Mass matrix and velocity constraints
+
+Some integrators must correct the generalized speeds u with impulses normal to
+the constraints, which requires the System's mass matrix M and the Jacobian 
+G=d uerr/d u of the velocity constraint errors uerr (one row for each of 
+the State's uerrs). A System that knows these provides O(n) operators for 
+multiplication by M^-1, G and ~G. They require a State realized through
+Stage::Velocity. **/
+/**@{**/
+/** Return true if this System provides multiplyByMInv(), multiplyByG() and
+multiplyByGTranspose(). Otherwise calling them throws an exception. **/
+bool hasMassMatrixOperators() const;
+/** Calculate MInvf=M^-1*f for a generalized force-like vector f. **/
+void multiplyByMInv(const State& state, const Vector& f, 
+                    Vector& MInvf) const;
+/** Calculate Gu=G*u for a u-like vector u; Gu has one element per uerr. **/
+void multiplyByG(const State& state, const Vector& u, Vector& Gu) const;
+/** Calculate f=~G*lambda for multipliers lambda, one per uerr. **/
+void multiplyByGTranspose(const State& state, const Vector& lambda, 
+                          Vector& f) const;
+/**@}**/
+
+
+//------------------------------------------------------------------------------
+/**@name                  State derivative Jacobian
+
+Implicit integrators need the Jacobian J=d ydot/d y of the state derivatives
+with respect to the continuous state variables y={q,u,z} for their Newton
+iterations. A System can calculate it directly, usually far more cheaply than
+by perturbing each of the ny state variables in turn and realizing the 
+derivatives again. The result may be an approximation; it is used only to 
+converge the iteration, not to determine the solution. **/
+/**@{**/
+/** Return true if this System can calculate its own state derivative
+Jacobian with calcStateDerivativeJacobian(). This is cheap; use it rather
+than calculating a Jacobian just to find out. **/
+bool hasStateDerivativeJacobian() const;
+/** If this System knows how to, calculate the ny X ny Jacobian J=d ydot/d y
+of the state derivatives with respect to the continuous state variables at
+the given  state, which must have been realized through Stage::Dynamics,
+and return true. Otherwise return false without touching  J; the caller
+will have to find the Jacobian numerically. **/
+bool calcStateDerivativeJacobian(const State& state, Matrix& J) const;
+/**@}**/
+
+
+//------------------------------------------------------------------------------
+/**@name                         Slow forces
+
+Some forces are expensive to calculate but change slowly compared to the rest
+of the System's dynamics. A System may designate such forces as "slow" so that
+a multirate integrator can calculate them less often, holding them at fixed
+values while it takes several smaller steps with the remaining, fast, forces.
+For a MultibodySystem the slow forces are those of any force elements and
+force subsystems that have been marked slow. **/
+/**@{**/
+/** If this System has slow forces, hold them at the values they have in the
+given \a state, which must have been realized through Stage::Dynamics, and
+return true. Until releaseSlowForces() is called, realizing this \a state 
+(or a copy of it) uses the held values instead of calculating the slow forces 
+again. This is a Dynamics-stage change unless the slow forces were already 
+held, in which case nothing happens. Return false without changing anything
+if the System has no slow forces. **/
+bool holdSlowForces(State& state) const;
+/** Stop holding the slow forces in the given \a state so that they are 
+calculated again when it is realized. This is a Dynamics-stage change if 
+the slow forces were being held; otherwise nothing happens. **/
+void releaseSlowForces(State& state) const;
+/**@}**/
+
+
 //------------------------------------------------------------------------------
 /**@name                         Statistics
 
@@ -119,6 +119,7 @@ public:
     StageVersion getSystemTopologyCacheVersion() const;
     void setSystemTopologyCacheVersion(StageVersion topoVersion) const;
     void invalidateSystemTopologyCache() const;
+    void noteSubsystemTopologyChange() const;
 
     // Wrap the cloneImpl virtual method.
     System::Guts* clone() const;
@@ -147,6 +148,16 @@ public:
                          Vector& u) const;
     void multiplyByNPInvTranspose(const State& state, const Vector& fu, 
                                   Vector& fq) const;
+    bool hasMassMatrixOperators() const;
+    void multiplyByMInv(const State& state, const Vector& f, 
+                        Vector& MInvf) const;
+    void multiplyByG(const State& state, const Vector& u, Vector& Gu) const;
+    void multiplyByGTranspose(const State& state, const Vector& lambda, 
+                              Vector& f) const;
+    bool hasStateDerivativeJacobian() const;
+    bool calcStateDerivativeJacobian(const State& state, Matrix& J) const;
+    bool holdSlowForces(State& state) const;
+    void releaseSlowForces(State& state) const;
 
     bool prescribeQ(State&) const;
     bool prescribeU(State&) const;
@@ -206,6 +217,27 @@ protected:
     virtual void multiplyByNPInvTransposeImpl(const State& state, const Vector& fu, 
                                               Vector& fq) const;
 
+    // Default is that the System doesn't know its mass matrix or velocity 
+    // constraint Jacobian; the multiply methods must be implemented if used.
+    virtual bool hasMassMatrixOperatorsImpl() const {return false;}
+    virtual void multiplyByMInvImpl(const State& state, const Vector& f, 
+                                    Vector& MInvf) const;
+    virtual void multiplyByGImpl(const State& state, const Vector& u, 
+                                 Vector& Gu) const;
+    virtual void multiplyByGTransposeImpl(const State& state, 
+                                          const Vector& lambda, 
+                                          Vector& f) const;
+
+    // Default is that the System can't calculate its own Jacobian.
+    virtual bool hasStateDerivativeJacobianImpl() const {return false;}
+    virtual bool calcStateDerivativeJacobianImpl(const State& state, 
+                                                 Matrix& J) const 
+    {   return false; }
+
+    // Default is that the System has no slow forces to hold.
+    virtual bool holdSlowForcesImpl(State& state) const {return false;}
+    virtual void releaseSlowForcesImpl(State& state) const {}
+
     // Defaults assume no prescribed motion; hence, no change made.
     virtual bool prescribeQImpl(State&) const {return false;}
     virtual bool prescribeUImpl(State&) const {return false;}
@@ -222,6 +222,48 @@ void PerSubsystemInfo::copyAllocationStackThroughStage
         stack[i].deepAssign(src[i]);
 }
 
+// Check whether this allocation stack matches the source one entry for entry,
+// so that the source can be copied into it with assignAllocationStackInPlace().
+// The template value must also support isLayoutCompatible() and 
+// assignInPlace(). 
+template <class T>
+bool PerSubsystemInfo::isAllocationStackLayoutCompatible
+   (const Array_<T>& stack, const Array_<T>& src)
+{
+    if (stack.size() != src.size())
+        return false;
+    for (unsigned i=0; i < src.size(); ++i)
+        if (!stack[i].isLayoutCompatible(src[i]))
+            return false;
+    return true;
+}
+
+// Same, but considering only the entries allocated at or before stage g. 
+// Stacks are ordered by allocation stage so those are a prefix of each.
+template <class T>
+bool PerSubsystemInfo::isAllocationStackLayoutCompatible
+   (const Array_<T>& stack, const Array_<T>& src, const Stage& g)
+{
+    unsigned n = 0;
+    while (n < src.size() && src[n].getAllocationStage() <= g)
+        ++n;
+    if (stack.size() < n 
+        || (stack.size() > n && stack[n].getAllocationStage() <= g))
+        return false;
+    for (unsigned i=0; i < n; ++i)
+        if (!stack[i].isLayoutCompatible(src[i]))
+            return false;
+    return true;
+}
+
+template <class T>
+void PerSubsystemInfo::assignAllocationStackInPlace
+   (Array_<T>& stack, const Array_<T>& src)
+{
+    for (unsigned i=0; i < src.size(); ++i)
+        stack[i].assignInPlace(src[i]);
+}
+
 void PerSubsystemInfo::clearContinuousVars() {
     clearAllocationStack(q_info); 
     clearAllocationStack(uInfo);                                
@@ -320,6 +362,68 @@ void PerSubsystemInfo::copyAllStacksThroughStage
         copyEventsThroughStage(src.triggerInfo[i], g, triggerInfo[i]);
 }
 
+bool PerSubsystemInfo::isLayoutCompatible(const PerSubsystemInfo& src) const {
+    if (!(   isAllocationStackLayoutCompatible(q_info, src.q_info)
+          && isAllocationStackLayoutCompatible(uInfo, src.uInfo)
+          && isAllocationStackLayoutCompatible(zInfo, src.zInfo)
+          && isAllocationStackLayoutCompatible(discreteInfo, src.discreteInfo)
+          && isAllocationStackLayoutCompatible(qerrInfo, src.qerrInfo)
+          && isAllocationStackLayoutCompatible(uerrInfo, src.uerrInfo)
+          && isAllocationStackLayoutCompatible(udoterrInfo, src.udoterrInfo)
+          && isAllocationStackLayoutCompatible(cacheInfo, src.cacheInfo)))
+        return false;
+    for (int i=0; i < Stage::NValid; ++i)
+        if (!isAllocationStackLayoutCompatible(triggerInfo[i], 
+                                               src.triggerInfo[i]))
+            return false;
+    return true;
+}
+
+void PerSubsystemInfo::assignInPlace(const PerSubsystemInfo& src) {
+    assert(currentStage >= Stage::Instance && src.currentStage >= Stage::Instance);
+
+    name    = src.name;
+    version = src.version;
+
+    assignAllocationStackInPlace(q_info, src.q_info);
+    assignAllocationStackInPlace(uInfo, src.uInfo);
+    assignAllocationStackInPlace(zInfo, src.zInfo);
+    assignAllocationStackInPlace(discreteInfo, src.discreteInfo);
+    assignAllocationStackInPlace(qerrInfo, src.qerrInfo);
+    assignAllocationStackInPlace(uerrInfo, src.uerrInfo);
+    assignAllocationStackInPlace(udoterrInfo, src.udoterrInfo);
+    assignAllocationStackInPlace(cacheInfo, src.cacheInfo);
+    for (int i=0; i < Stage::NValid; ++i)
+        assignAllocationStackInPlace(triggerInfo[i], src.triggerInfo[i]);
+
+    // Copy the stage versions through Instance as copyFrom() does. Later
+    // stages are not copied, so their versions must not match any version
+    // recorded in the source's cache entries, or in our old ones.
+    for (int i=0; i <= Stage::Instance; ++i)
+        stageVersions[i] = src.stageVersions[i];
+    for (int i=Stage::Instance+1; i < Stage::NValid; ++i)
+        stageVersions[i] = 
+            std::max(stageVersions[i], src.stageVersions[i]) + 1;
+
+    currentStage = Stage::Instance;
+}
+
+bool PerSubsystemInfo::isVariableLayoutCompatible
+   (const PerSubsystemInfo& src, Stage g) const {
+    return isAllocationStackLayoutCompatible(q_info, src.q_info, g)
+        && isAllocationStackLayoutCompatible(uInfo, src.uInfo, g)
+        && isAllocationStackLayoutCompatible(zInfo, src.zInfo, g)
+        && isAllocationStackLayoutCompatible(discreteInfo, src.discreteInfo, g);
+}
+
+bool PerSubsystemInfo::hasCachePrerequisiteInSubsystem(SubsystemIndex sx) const
+{
+    for (const auto& ce : cacheInfo)
+        if (ce.hasPrerequisiteInSubsystem(sx))
+            return true;
+    return false;
+}
+
 void PerSubsystemInfo::restoreToStage(Stage g) {
     if (currentStage <= g)
         return;
@@ -428,6 +532,111 @@ void StateImpl::copyFrom(const StateImpl& src) {
     registerWithPrerequisitesAfterCopy();
 }
 
+//------------------------------------------------------------------------------
+//                           ASSIGN IN PLACE
+//------------------------------------------------------------------------------
+bool StateImpl::isLayoutCompatible(const StateImpl& src) const {
+    if (   currentSystemStage < Stage::Instance 
+        || src.currentSystemStage < Stage::Instance
+        || subsystems.size() != src.subsystems.size())
+        return false;
+    for (SubsystemIndex i(0); i < (int)subsystems.size(); ++i)
+        if (!subsystems[i].isLayoutCompatible(src.subsystems[i]))
+            return false;
+    return true;
+}
+
+// The allocations, global resource sizes, views into them, and the lists of
+// dependents all match already so we just copy values. The global cache 
+// entries (ydot, yerr, etc.) aren't copied; they are invalid after this since
+// only the stages through Instance are valid.
+void StateImpl::assignInPlace(const StateImpl& src) {
+    for (SubsystemIndex i(0); i < (int)subsystems.size(); ++i)
+        subsystems[i].assignInPlace(src.subsystems[i]);
+
+    for (int i=0; i <= Stage::Instance; ++i)
+        systemStageVersions[i] = src.systemStageVersions[i];
+    for (int i=Stage::Instance+1; i < Stage::NValid; ++i)
+        systemStageVersions[i] = 
+            std::max(systemStageVersions[i], src.systemStageVersions[i]) + 1;
+    currentSystemStage = Stage::Instance;
+
+    t = src.t;
+    y = src.y; // same size; no reallocation
+    qVersion = src.qVersion; 
+    uVersion = src.uVersion; 
+    zVersion = src.zVersion;
+    uWeights = src.uWeights;
+    zWeights = src.zWeights;
+    qerrWeights = src.qerrWeights;
+    uerrWeights = src.uerrWeights;
+}
+
+//------------------------------------------------------------------------------
+//                     INVALIDATE SUBSYSTEM TOPOLOGY
+//------------------------------------------------------------------------------
+void StateImpl::invalidateSubsystemTopology(SubsystemIndex sx) {
+    invalidateAll(Stage::Model);
+    invalidateJustSystemStage(Stage::Topology);
+
+    // A cache entry that names a prerequisite in a discarded subsystem would
+    // be left registered with nothing, or with whatever gets allocated there
+    // next, so its subsystem has to be discarded as well. Find them all 
+    // before discarding anything.
+    const int nSubs = (int)subsystems.size();
+    Array_<bool,SubsystemIndex> discard(nSubs, false);
+    discard[sx] = true;
+    bool sawNew = true;
+    while (sawNew) {
+        sawNew = false;
+        for (SubsystemIndex i(0); i < nSubs; ++i) {
+            if (discard[i] || subsystems[i].currentStage == Stage::Empty)
+                continue;
+            for (SubsystemIndex j(0); j < nSubs; ++j)
+                if (discard[j] && subsystems[i].hasCachePrerequisiteInSubsystem(j))
+                {   discard[i] = sawNew = true; break; }
+        }
+    }
+
+    for (SubsystemIndex i(0); i < nSubs; ++i)
+        if (discard[i])
+            subsystems[i].invalidateStageJustThisSubsystem(Stage::Topology);
+}
+
+//------------------------------------------------------------------------------
+//                     COPY SUBSYSTEM VARIABLES FROM
+//------------------------------------------------------------------------------
+bool StateImpl::copySubsystemVariablesFrom
+   (SubsystemIndex sx, const StateImpl& src, Stage g) {
+    SimTK_APIARGCHECK1_ALWAYS(g == Stage::Topology || g == Stage::Model,
+        "State", "copySubsystemVariablesFrom",
+        "Stage must be Topology or Model but was %s.", g.getName().c_str());
+
+    if (sx >= getNumSubsystems() || sx >= src.getNumSubsystems())
+        return false;
+    const PerSubsystemInfo& srcSub = src.getSubsystem(sx);
+    if (   getSubsystem(sx).currentStage < g || srcSub.currentStage < g
+        || !getSubsystem(sx).isVariableLayoutCompatible(srcSub, g))
+        return false;
+    if (g == Stage::Model 
+        && (getSystemStage() < Stage::Model || src.getSystemStage() < Stage::Model))
+        return false;
+
+    for (DiscreteVariableIndex dx(0); dx < srcSub.discreteInfo.size(); ++dx) {
+        const DiscreteVarInfo& info = srcSub.discreteInfo[dx];
+        if (info.getAllocationStage() == g)
+            updDiscreteVariable(DiscreteVarKey(sx,dx))
+                .compatibleAssign(info.getValue());
+    }
+
+    if (g == Stage::Model) {
+        if (srcSub.q.size()) updQ(sx) = srcSub.q;
+        if (srcSub.u.size()) updU(sx) = srcSub.u;
+        if (srcSub.z.size()) updZ(sx) = srcSub.z;
+    }
+    return true;
+}
+
 //------------------------------------------------------------------------------
 //                           COPY CONSTRUCTOR
 //------------------------------------------------------------------------------
@@ -441,6 +650,11 @@ StateImpl::StateImpl(const StateImpl& src) : StateImpl() {
 StateImpl& StateImpl::operator=(const StateImpl& src) {
     if (&src == this) return *this;
 
+    if (isLayoutCompatible(src)) {
+        assignInPlace(src);
+        return *this;
+    }
+
     // Make sure no stage is valid.
     invalidateJustSystemStage(Stage::Topology);
     for (SubsystemIndex i(0); i<(int)subsystems.size(); ++i)
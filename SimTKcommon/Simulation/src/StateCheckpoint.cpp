@@ -0,0 +1,548 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon/internal/StateCheckpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #if !defined(NOMINMAX)
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using std::uint32_t; using std::uint64_t;
+
+namespace SimTK {
+
+//==============================================================================
+//                               FILE LAYOUT
+//==============================================================================
+// A checkpoint file is a FileHeader, followed by the q, u, z and event trigger
+// values as arrays of Real, followed by one record per saved discrete variable.
+// Each record is a RecordHeader followed by its payload, padded so the next
+// record starts on an 8-byte boundary. Everything is in native byte order; the
+// header has a byte order marker so a file from a different kind of machine
+// is rejected rather than misread.
+namespace {
+
+const char     Magic[8]        = {'S','i','m','T','K','C','h','k'};
+const uint32_t FormatVersion   = 1;
+const uint32_t ByteOrderMarker = 0x01020304;
+
+struct FileHeader {
+    char        magic[8];
+    uint32_t    formatVersion;
+    uint32_t    byteOrder;
+    uint32_t    realSize;
+    uint32_t    numSubsystems;
+    uint64_t    structureKey;
+    uint64_t    nq, nu, nz, nTriggers;  // nTriggers is 0 if not saved
+    uint64_t    numRecords;
+    uint64_t    fileSize;
+    double      time;
+};
+
+struct RecordHeader {
+    uint32_t    subsystem;
+    uint32_t    index;      // DiscreteVariableIndex within the subsystem
+    uint32_t    typeCode;
+    uint32_t    reserved;
+    uint64_t    nBytes;     // payload, not including padding
+};
+
+size_t padded(size_t nBytes) {return (nBytes + 7) & ~size_t(7);}
+
+
+
+//==============================================================================
+//                          DISCRETE VARIABLE CODECS
+//==============================================================================
+// How to store each of the supported discrete variable types. A fixed-size
+// type's payload is its bytes; a Vector_ or Array_ payload is the element
+// count (uint64) followed by the contiguous elements. differs() and load()
+// may only be given a payload that isValid() accepted.
+
+struct Codec {
+    uint32_t    typeCode;
+    bool        (*isA)(const AbstractValue&);
+    size_t      (*size)(const AbstractValue&);
+    void        (*save)(const AbstractValue&, char* payload);
+    bool        (*isValid)(const char* payload, size_t nBytes);
+    bool        (*differs)(const char* payload, size_t, const AbstractValue&);
+    void        (*load)(const char* payload, size_t, AbstractValue&);
+};
+
+// Set x from its bytes at p. Vecs are filled element by element rather than
+// by copying over the object.
+template <class T> void readBytes(const char* p, T& x)
+{   std::memcpy(&x, p, sizeof(T)); }
+template <int M, class E, int S> void readBytes(const char* p, Vec<M,E,S>& v)
+{   for (int i=0; i < M; ++i) readBytes(p + i*sizeof(E), v[i]); }
+
+template <class T> struct FixedCodec {
+    static bool isA(const AbstractValue& v) {return Value<T>::isA(v);}
+    static size_t size(const AbstractValue&) {return sizeof(T);}
+    static void save(const AbstractValue& v, char* p)
+    {   std::memcpy(p, &Value<T>::downcast(v).get(), sizeof(T)); }
+    static bool isValid(const char*, size_t n) {return n == sizeof(T);}
+    static bool differs(const char* p, size_t, const AbstractValue& v)
+    {   return std::memcmp(p, &Value<T>::downcast(v).get(), sizeof(T)) != 0; }
+    static void load(const char* p, size_t, AbstractValue& v)
+    {   readBytes(p, Value<T>::updDowncast(v).upd()); }
+};
+
+// Vector_<E> and Array_<bool> have the same payload layout.
+template <class C> struct SequenceCodec {
+    typedef typename std::remove_reference
+        <decltype(std::declval<C&>()[0])>::type Elt;
+
+    static bool isA(const AbstractValue& v) {return Value<C>::isA(v);}
+    static size_t size(const AbstractValue& v)
+    {   return sizeof(uint64_t) + Value<C>::downcast(v).get().size()*sizeof(Elt); }
+    static void save(const AbstractValue& v, char* p) {
+        const C& c = Value<C>::downcast(v).get();
+        const uint64_t n = (uint64_t)c.size();
+        std::memcpy(p, &n, sizeof(n)); p += sizeof(n);
+        for (int i=0; i < (int)n; ++i, p += sizeof(Elt))
+            std::memcpy(p, &c[i], sizeof(Elt));
+    }
+    // The payload must hold exactly the number of elements it says it does.
+    static bool isValid(const char* p, size_t nBytes) {
+        if (nBytes < sizeof(uint64_t)) return false;
+        uint64_t n; std::memcpy(&n, p, sizeof(n));
+        const size_t nElts = (nBytes - sizeof(uint64_t))/sizeof(Elt);
+        return n == nElts && n <= (uint64_t)std::numeric_limits<int>::max()
+            && sizeof(uint64_t) + nElts*sizeof(Elt) == nBytes;
+    }
+    static bool differs(const char* p, size_t, const AbstractValue& v) {
+        const C& c = Value<C>::downcast(v).get();
+        uint64_t n; std::memcpy(&n, p, sizeof(n)); p += sizeof(n);
+        if (n != (uint64_t)c.size()) return true;
+        for (int i=0; i < (int)n; ++i, p += sizeof(Elt))
+            if (std::memcmp(p, &c[i], sizeof(Elt)) != 0) return true;
+        return false;
+    }
+    static void load(const char* p, size_t, AbstractValue& v) {
+        C& c = Value<C>::updDowncast(v).upd();
+        uint64_t n; std::memcpy(&n, p, sizeof(n)); p += sizeof(n);
+        if ((uint64_t)c.size() != n) c.resize((int)n);
+        for (int i=0; i < (int)n; ++i, p += sizeof(Elt))
+            readBytes(p, c[i]);
+    }
+};
+
+template <class T, template <class> class Kind>
+Codec makeCodec(uint32_t code) {
+    const Codec c = {code, &Kind<T>::isA, &Kind<T>::size, &Kind<T>::save,
+                     &Kind<T>::isValid, &Kind<T>::differs, &Kind<T>::load};
+    return c;
+}
+
+// The type codes are part of the file format; don't renumber them.
+const Codec* findCodec(const AbstractValue& v) {
+    static const Codec codecs[] = {
+        makeCodec<bool,                 FixedCodec>     (1),
+        makeCodec<int,                  FixedCodec>     (2),
+        makeCodec<Real,                 FixedCodec>     (3),
+        makeCodec<Vec2,                 FixedCodec>     (4),
+        makeCodec<Vec3,                 FixedCodec>     (5),
+        makeCodec<Vec4,                 FixedCodec>     (6),
+        makeCodec<SpatialVec,           FixedCodec>     (7),
+        makeCodec<Vector,               SequenceCodec>  (8),
+        makeCodec<Vector_<Vec3>,        SequenceCodec>  (9),
+        makeCodec<Vector_<SpatialVec>,  SequenceCodec>  (10),
+        makeCodec<Array_<bool>,         SequenceCodec>  (11)
+    };
+    for (const Codec& c : codecs)
+        if (c.isA(v)) return &c;
+    return nullptr;
+}
+
+int getNumDiscreteVariables(const State& s, SubsystemIndex sx) {
+    return s.getPerSubsystemInfo(sx).getNextDiscreteVariableIndex();
+}
+
+// Whether a record names a discrete variable that exists in this State.
+bool refersToVariableOf(const RecordHeader& rh, const State& s) {
+    return rh.subsystem < (uint32_t)s.getNumSubsystems()
+        && rh.index < (uint32_t)getNumDiscreteVariables
+                                        (s, SubsystemIndex(rh.subsystem));
+}
+
+// 64-bit FNV-1a.
+class KeyHasher {
+public:
+    KeyHasher() : h(14695981039346656037ULL) {}
+    void add(const void* data, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i=0; i < n; ++i) {h ^= p[i]; h *= 1099511628211ULL;}
+    }
+    void add(int i) {const int64_t v = i; add(&v, sizeof(v));}
+    void add(const String& s) {add((int)s.size()); add(s.c_str(), s.size());}
+    uint64_t get() const {return h;}
+private:
+    uint64_t h;
+};
+
+}
+
+
+
+//==============================================================================
+//                             STRUCTURE KEY
+//==============================================================================
+uint64_t StateCheckpoint::calcStructureKey(const State& s) {
+    SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage::Model,
+                               "StateCheckpoint::calcStructureKey()");
+    KeyHasher key;
+    key.add((int)sizeof(Real));
+    key.add(s.getNumSubsystems());
+    for (SubsystemIndex sx(0); sx < s.getNumSubsystems(); ++sx) {
+        key.add(s.getSubsystemName(sx)); key.add(s.getSubsystemVersion(sx));
+        key.add(s.getNQ(sx)); key.add(s.getNU(sx)); key.add(s.getNZ(sx));
+        const int ndv = getNumDiscreteVariables(s, sx);
+        key.add(ndv);
+        for (DiscreteVariableIndex dx(0); dx < ndv; ++dx) {
+            key.add(s.getDiscreteVariable(sx, dx).getTypeName());
+            key.add((int)s.getDiscreteVarInvalidatesStage(sx, dx));
+        }
+    }
+    return key.get();
+}
+
+
+
+//==============================================================================
+//                                  WRITE
+//==============================================================================
+int StateCheckpoint::write(const State& s, const String& pathname,
+                           bool skipUnsupported) {
+    const char* where = "StateCheckpoint::write()";
+    SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage::Model, where);
+
+    // Work out what we can save, and the size of the records.
+    struct Saved {SubsystemIndex sx; DiscreteVariableIndex dx;
+                  const Codec* codec; size_t nBytes;};
+    Array_<Saved> saved;
+    int numUnsaved = 0;
+    for (SubsystemIndex sx(0); sx < s.getNumSubsystems(); ++sx)
+        for (DiscreteVariableIndex dx(0);
+             dx < getNumDiscreteVariables(s, sx); ++dx) {
+            const AbstractValue& v = s.getDiscreteVariable(sx, dx);
+            const Codec* codec = findCodec(v);
+            SimTK_ERRCHK3_ALWAYS(codec || skipUnsupported, where,
+                "Discrete variable %d of subsystem '%s' has type %s, which "
+                "can't be written to a checkpoint. Pass skipUnsupported=true "
+                "to write the checkpoint without it.", (int)dx,
+                s.getSubsystemName(sx).c_str(), v.getTypeName().c_str());
+            if (!codec) {++numUnsaved; continue;}
+            const Saved rec = {sx, dx, codec, codec->size(v)};
+            saved.push_back(rec);
+        }
+
+    // Trigger values are only meaningful once they have been calculated.
+    const bool haveTriggers = s.getSystemStage() >= Stage::Acceleration;
+    const Vector* triggers = haveTriggers ? &s.getEventTriggers() : nullptr;
+
+    FileHeader hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, Magic, sizeof(Magic));
+    hdr.formatVersion   = FormatVersion;
+    hdr.byteOrder       = ByteOrderMarker;
+    hdr.realSize        = (uint32_t)sizeof(Real);
+    hdr.numSubsystems   = (uint32_t)s.getNumSubsystems();
+    hdr.structureKey    = calcStructureKey(s);
+    hdr.nq              = s.getNQ();
+    hdr.nu              = s.getNU();
+    hdr.nz              = s.getNZ();
+    hdr.nTriggers       = triggers ? triggers->size() : 0;
+    hdr.numRecords      = saved.size();
+    hdr.time            = s.getTime();
+    size_t fileSize = padded(sizeof(FileHeader))
+        + padded((size_t)(hdr.nq+hdr.nu+hdr.nz+hdr.nTriggers)*sizeof(Real));
+    for (const Saved& rec : saved)
+        fileSize += sizeof(RecordHeader) + padded(rec.nBytes);
+    hdr.fileSize = fileSize;
+
+    // Write to a temporary and rename it when done, so that an interrupted
+    // write doesn't destroy an existing checkpoint.
+    const String tmpname = pathname + ".tmp";
+    {
+    std::ofstream out(tmpname.c_str(), std::ios::binary | std::ios::trunc);
+    SimTK_ERRCHK1_ALWAYS(out.good(), where,
+        "Can't open checkpoint file '%s' for writing.", tmpname.c_str());
+
+    const char zeros[8] = {0,0,0,0,0,0,0,0};
+    auto writePadded = [&](const void* data, size_t n) {
+        if (n) out.write(static_cast<const char*>(data), n);
+        out.write(zeros, padded(n) - n);
+    };
+    auto writeVector = [&](const Vector& v) {
+        if (v.size() == 0) return;
+        if (v.hasContiguousData())
+            out.write(reinterpret_cast<const char*>(&v[0]),
+                      v.size()*sizeof(Real));
+        else for (int i=0; i < v.size(); ++i)
+            out.write(reinterpret_cast<const char*>(&v[i]), sizeof(Real));
+    };
+
+    writePadded(&hdr, sizeof(hdr));
+    writeVector(s.getQ()); writeVector(s.getU()); writeVector(s.getZ());
+    if (triggers) writeVector(*triggers);
+    const size_t nReals = (size_t)(hdr.nq+hdr.nu+hdr.nz+hdr.nTriggers);
+    out.write(zeros, padded(nReals*sizeof(Real)) - nReals*sizeof(Real));
+
+    Array_<char> payload;
+    for (const Saved& rec : saved) {
+        RecordHeader rh;
+        rh.subsystem = (uint32_t)rec.sx;
+        rh.index     = (uint32_t)rec.dx;
+        rh.typeCode  = rec.codec->typeCode;
+        rh.reserved  = 0;
+        rh.nBytes    = rec.nBytes;
+        out.write(reinterpret_cast<const char*>(&rh), sizeof(rh));
+        payload.resize((unsigned)rec.nBytes);
+        if (rec.nBytes)
+            rec.codec->save(s.getDiscreteVariable(rec.sx, rec.dx),
+                            payload.begin());
+        writePadded(payload.begin(), rec.nBytes);
+    }
+    out.close();
+    SimTK_ERRCHK1_ALWAYS(!out.fail(), where,
+        "Failed writing checkpoint file '%s'.", tmpname.c_str());
+    }
+
+#ifdef _WIN32
+    std::remove(pathname.c_str()); // rename() won't replace a file here
+#endif
+    SimTK_ERRCHK2_ALWAYS(std::rename(tmpname.c_str(), pathname.c_str()) == 0,
+        where, "Can't rename checkpoint file '%s' to '%s'.",
+        tmpname.c_str(), pathname.c_str());
+
+    return numUnsaved;
+}
+
+
+
+//==============================================================================
+//                          STATE CHECKPOINT :: IMPL
+//==============================================================================
+// Owns the read-only mapping of the checkpoint file.
+class StateCheckpoint::Impl {
+public:
+    explicit Impl(const String& pathname)
+    :   pathname(pathname), data(nullptr), size(0) {
+        const char* where = "StateCheckpoint::StateCheckpoint()";
+    #ifdef _WIN32
+        file = CreateFileA(pathname.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        mapping = NULL;
+        SimTK_ERRCHK1_ALWAYS(file != INVALID_HANDLE_VALUE, where,
+            "Can't open checkpoint file '%s'.", pathname.c_str());
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        size = (size_t)fileSize.QuadPart;
+        if (size) {
+            mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping)
+                data = static_cast<const char*>
+                    (MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+    #else
+        fd = open(pathname.c_str(), O_RDONLY);
+        SimTK_ERRCHK1_ALWAYS(fd >= 0, where,
+            "Can't open checkpoint file '%s'.", pathname.c_str());
+        struct stat st;
+        if (fstat(fd, &st) == 0) size = (size_t)st.st_size;
+        if (size) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) data = static_cast<const char*>(p);
+        }
+    #endif
+        const bool mapped = data != nullptr;
+        if (!mapped) {
+            release();
+            SimTK_ERRCHK1_ALWAYS(mapped, where,
+                "Can't map checkpoint file '%s' into memory.",
+                pathname.c_str());
+        }
+
+        bool ok = size >= sizeof(FileHeader);
+        if (ok) {
+            std::memcpy(&hdr, data, sizeof(hdr));
+            ok = std::memcmp(hdr.magic, Magic, sizeof(Magic)) == 0
+                 && hdr.formatVersion == FormatVersion
+                 && hdr.byteOrder == ByteOrderMarker
+                 && hdr.realSize == sizeof(Real)
+                 && hdr.fileSize <= size;
+        }
+        if (!ok) {
+            release();
+            SimTK_ERRCHK1_ALWAYS(ok, where, "File '%s' is not a checkpoint "
+                "written by this version of SimTK on this kind of machine, "
+                "or it is truncated.", pathname.c_str());
+        }
+    }
+
+    ~Impl() {release();}
+
+    void release() {
+    #ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL; file = INVALID_HANDLE_VALUE;
+    #else
+        if (data) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) close(fd);
+        fd = -1;
+    #endif
+        data = nullptr;
+    }
+
+    const Real* getReals() const
+    {   return reinterpret_cast<const Real*>(data + padded(sizeof(FileHeader))); }
+    const char* getFirstRecord() const {
+        return data + padded(sizeof(FileHeader))
+            + padded((size_t)(hdr.nq+hdr.nu+hdr.nz+hdr.nTriggers)*sizeof(Real));
+    }
+
+    String      pathname;
+    FileHeader  hdr;
+    const char* data;
+    size_t      size;
+#ifdef _WIN32
+    HANDLE      file, mapping;
+#else
+    int         fd;
+#endif
+};
+
+
+
+//==============================================================================
+//                             STATE CHECKPOINT
+//==============================================================================
+StateCheckpoint::StateCheckpoint(const String& pathname)
+:   impl(new Impl(pathname)) {}
+
+StateCheckpoint::~StateCheckpoint() {delete impl;}
+
+Real StateCheckpoint::getTime() const {return (Real)impl->hdr.time;}
+
+bool StateCheckpoint::isCompatible(const State& s) const {
+    return s.getSystemStage() >= Stage::Model
+        && calcStructureKey(s) == impl->hdr.structureKey;
+}
+
+void StateCheckpoint::restore(State& s) const {
+    const char* where = "StateCheckpoint::restore()";
+    const FileHeader& hdr = impl->hdr;
+    SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage::Model, where);
+    SimTK_ERRCHK1_ALWAYS(isCompatible(s), where,
+        "The checkpoint in '%s' was written from a State with a different "
+        "structure (subsystems, numbers of variables, or discrete variable "
+        "types) than this one.", impl->pathname.c_str());
+
+    // Find the records, checking that they are all within the file and that
+    // their types are still what they were (the structure key only checks
+    // the type names). We won't change anything if a Model-stage variable
+    // would change since that would require reallocating the State.
+    Array_<const char*> records((unsigned)hdr.numRecords);
+    const char* p = impl->getFirstRecord();
+    const char* end = impl->data + hdr.fileSize;
+    for (unsigned r=0; r < records.size(); ++r) {
+        RecordHeader rh;
+        SimTK_ERRCHK1_ALWAYS(p + sizeof(rh) <= end, where,
+            "Checkpoint file '%s' is corrupt.", impl->pathname.c_str());
+        std::memcpy(&rh, p, sizeof(rh));
+        const char* payload = p + sizeof(rh);
+        SimTK_ERRCHK1_ALWAYS(payload + padded(rh.nBytes) <= end
+                             && refersToVariableOf(rh, s), where,
+            "Checkpoint file '%s' is corrupt.", impl->pathname.c_str());
+        const SubsystemIndex sx(rh.subsystem);
+        const DiscreteVariableIndex dx(rh.index);
+        const AbstractValue& v = s.getDiscreteVariable(sx, dx);
+        const Codec* codec = findCodec(v);
+        SimTK_ERRCHK1_ALWAYS(codec && codec->typeCode == rh.typeCode
+                             && codec->isValid(payload, (size_t)rh.nBytes),
+            where, "Checkpoint file '%s' is corrupt.", impl->pathname.c_str());
+        SimTK_ERRCHK3_ALWAYS(
+            s.getDiscreteVarInvalidatesStage(sx, dx) > Stage::Model
+            || !codec->differs(payload, (size_t)rh.nBytes, v), where,
+            "Model-stage discrete variable %d of subsystem '%s' has a "
+            "different value in checkpoint '%s'. Set it as it was when the "
+            "checkpoint was written and realize Model stage before restoring.",
+            (int)dx, s.getSubsystemName(sx).c_str(), impl->pathname.c_str());
+        records[r] = p;
+        p = payload + padded(rh.nBytes);
+    }
+
+    // Continuous variables; these are all contiguous in a State.
+    const Real* reals = impl->getReals();
+    s.setTime((Real)hdr.time);
+    auto copyInto = [](const Real* from, Vector& to) {
+        if (to.size() == 0) return;
+        if (to.hasContiguousData())
+            std::memcpy(&to[0], from, to.size()*sizeof(Real));
+        else for (int i=0; i < to.size(); ++i) to[i] = from[i];
+    };
+    copyInto(reals, s.updQ());                     reals += hdr.nq;
+    copyInto(reals, s.updU());                     reals += hdr.nu;
+    copyInto(reals, s.updZ());                     reals += hdr.nz;
+    if (hdr.nTriggers && s.getSystemStage() >= Stage::Instance
+        && (uint64_t)s.getNEventTriggers() == hdr.nTriggers)
+        copyInto(reals, s.updEventTriggers());
+
+    // Discrete variables. We only touch the ones that differ, to avoid
+    // needlessly invalidating stages.
+    for (const char* rec : records) {
+        RecordHeader rh;
+        std::memcpy(&rh, rec, sizeof(rh));
+        const char* payload = rec + sizeof(rh);
+        SimTK_ERRCHK1_ALWAYS(refersToVariableOf(rh, s), where,
+            "Checkpoint file '%s' is corrupt.", impl->pathname.c_str());
+        const SubsystemIndex sx(rh.subsystem);
+        const DiscreteVariableIndex dx(rh.index);
+        const Codec* codec = findCodec(s.getDiscreteVariable(sx, dx));
+        if (codec->differs(payload, (size_t)rh.nBytes,
+                           s.getDiscreteVariable(sx, dx)))
+            codec->load(payload, (size_t)rh.nBytes,
+                        s.updDiscreteVariable(sx, dx));
+    }
+}
+
+} // namespace SimTK
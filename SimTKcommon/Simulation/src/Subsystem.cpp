@@ -134,13 +134,14 @@ bool Subsystem::Guts::isInSameSystem(const Subsystem& otherSubsystem) const {
 }
 
 // Invalidating a Subsystem's topology cache forces invalidation of the
-// whole System's topology cache, which will in turn invalidate all the other
-// Subsystem's topology caches.
+// whole System's topology cache. The other Subsystems' topology caches remain
+// valid; the next System realizeTopology() will realize only this Subsystem
+// and any others that depend on it.
 void Subsystem::Guts::invalidateSubsystemTopologyCache() const {
     if (m_subsystemTopologyRealized) {
         m_subsystemTopologyRealized = false;
         if (isInSystem()) 
-            getSystem().getSystemGuts().invalidateSystemTopologyCache();
+            getSystem().getSystemGuts().noteSubsystemTopologyChange();
     }
 }
 
@@ -206,6 +207,14 @@ Subsystem::Guts* Subsystem::Guts::clone() const {
 void Subsystem::Guts::realizeSubsystemTopology(State& s) const {
     SimTK_STAGECHECK_EQ_ALWAYS(getStage(s), Stage::Empty, 
         "Subsystem::Guts::realizeSubsystemTopology()");
+
+    // Record which System topology this realization belongs to; see
+    // System::updateStateToCurrentTopology(). This must precede any
+    // Topology-stage cache entry computations.
+    if (isInSystem())
+        s.setSubsystemTopologyStageVersion(getMySubsystemIndex(),
+            getSystem().getSystemTopologyCacheVersion());
+
     realizeSubsystemTopologyImpl(s);
 
     // Realize this Subsystem's Measures.
@@ -111,6 +111,11 @@ System& System::setUseUniformBackground(bool useUniformBackground)
     return *this; }
 bool System::getUseUniformBackground() const
 {   return getSystemGuts().getRep().getUseUniformBackground(); }
+System& System::setUsePartialTopologyRealization(bool usePartial)
+{   updSystemGuts().updRep().setUsePartialTopologyRealization(usePartial);
+    return *this; }
+bool System::getUsePartialTopologyRealization() const
+{   return getSystemGuts().getRep().getUsePartialTopologyRealization(); }
 
 void System::resetAllCountersToZero() {updSystemGuts().updRep().resetAllCounters();}
 int System::getNumRealizationsOfThisStage(Stage g) const {return getSystemGuts().getRep().nRealizationsOfStage[g];}
@@ -167,6 +172,43 @@ void System::invalidateSystemTopologyCache() const
 
 
 const State& System::realizeTopology() const {return getSystemGuts().realizeTopology();}
+
+// Topology-stage variables are copied first since they may affect the Model
+// stage allocations; then Model stage is realized and the Model-stage 
+// variables (including q, u, and z) are copied.
+void System::updateStateToCurrentTopology(State& state) const {
+    const State& defaultState = realizeTopology();
+    if (   state.getNumSubsystems() == getNumSubsystems()
+        && state.getSystemStage() >= Stage::Topology
+        && state.getSystemTopologyStageVersion() 
+           == getSystemTopologyCacheVersion())
+        return;
+
+    State newState(defaultState);
+    if (state.getNumSubsystems() != getNumSubsystems()) {
+        state = newState;
+        return;
+    }
+
+    // A Subsystem is unchanged if its topology was realized at the same time
+    // for both States, and then only if it is still realized in the old one.
+    Array_<bool,SubsystemIndex> isSame(getNumSubsystems(), false);
+    for (SubsystemIndex i(0); i < getNumSubsystems(); ++i)
+        isSame[i] = state.getSubsystemStage(i) >= Stage::Topology
+            &&    state.getSubsystemTopologyStageVersion(i) 
+               == newState.getSubsystemTopologyStageVersion(i)
+            && newState.copySubsystemVariablesFrom(i, state, Stage::Topology);
+
+    realizeModel(newState);
+    for (SubsystemIndex i(0); i < getNumSubsystems(); ++i)
+        if (isSame[i])
+            newState.copySubsystemVariablesFrom(i, state, Stage::Model);
+
+    if (state.getSystemStage() >= Stage::Topology)
+        newState.setTime(state.getTime());
+
+    state = newState;
+}
 void System::realizeModel(State& s) const {getSystemGuts().realizeModel(s);}
 void System::realize(const State& s, Stage g) const {getSystemGuts().realize(s,g);}
 void System::calcDecorativeGeometryAndAppend
@@ -182,6 +224,24 @@ void System::multiplyByNPInv(const State& s, const Vector& dq, Vector& u) const
 void System::multiplyByNPInvTranspose(const State& s, const Vector& fu, Vector& fq) const
 {   getSystemGuts().multiplyByNPInvTranspose(s,fu,fq); }
 
+bool System::hasMassMatrixOperators() const
+{   return getSystemGuts().hasMassMatrixOperators(); }
+void System::multiplyByMInv(const State& s, const Vector& f, Vector& MInvf) const
+{   getSystemGuts().multiplyByMInv(s,f,MInvf); }
+void System::multiplyByG(const State& s, const Vector& u, Vector& Gu) const
+{   getSystemGuts().multiplyByG(s,u,Gu); }
+void System::multiplyByGTranspose(const State& s, const Vector& lambda, Vector& f) const
+{   getSystemGuts().multiplyByGTranspose(s,lambda,f); }
+
+bool System::hasStateDerivativeJacobian() const
+{   return getSystemGuts().hasStateDerivativeJacobian(); }
+bool System::calcStateDerivativeJacobian(const State& s, Matrix& J) const
+{   return getSystemGuts().calcStateDerivativeJacobian(s,J); }
+bool System::holdSlowForces(State& s) const
+{   return getSystemGuts().holdSlowForces(s); }
+void System::releaseSlowForces(State& s) const
+{   getSystemGuts().releaseSlowForces(s); }
+
 bool System::prescribeQ(State& s) const
 {   return getSystemGuts().prescribeQ(s); }
 bool System::prescribeU(State& s) const
@@ -315,6 +375,8 @@ void System::Guts::setSystemTopologyCacheVersion(StageVersion topoVersion) const
 {   getRep().setSystemTopologyCacheVersion(topoVersion); }
 void System::Guts::invalidateSystemTopologyCache() const 
 {   return getRep().invalidateSystemTopologyCache(); } // mutable
+void System::Guts::noteSubsystemTopologyChange() const 
+{   return getRep().noteSubsystemTopologyChange(); } // mutable
 
 const State& System::Guts::getDefaultState() const {
     SimTK_STAGECHECK_TOPOLOGY_REALIZED_ALWAYS(systemTopologyHasBeenRealized(),
@@ -348,13 +410,29 @@ const State& System::Guts::realizeTopology() const {
     if (getRep().systemTopologyHasBeenRealized())
         return defaultState;
 
-    defaultState.clear();
-    defaultState.setNumSubsystems(getNumSubsystems());
-    for (SubsystemIndex i(0); i<getNumSubsystems(); ++i) 
-        defaultState.initializeSubsystem(i, getRep().subsystems[i].getName(), 
-                                            getRep().subsystems[i].getVersion());
+    // If only some Subsystems' topology has changed since the defaultState
+    // was built, we discard just their allocations (and those of anything
+    // depending on them) and leave the rest realized through Topology stage.
+    // The System subclass may allocate resources in the default Subsystem
+    // from its realizeTopologyImpl() so that one is always discarded.
+    if (   defaultState.getNumSubsystems() == getNumSubsystems()
+        && defaultState.getSystemStage() >= Stage::Topology) {
+        for (SubsystemIndex i(0); i<getNumSubsystems(); ++i) 
+            if (i == 0 || !getRep().subsystems[i].getSubsystemGuts()
+                                .subsystemTopologyHasBeenRealized())
+                defaultState.invalidateSubsystemTopology(i);
+    } else {
+        defaultState.clear();
+        defaultState.setNumSubsystems(getNumSubsystems());
+        for (SubsystemIndex i(0); i<getNumSubsystems(); ++i) 
+            defaultState.initializeSubsystem(i, 
+                getRep().subsystems[i].getName(), 
+                getRep().subsystems[i].getVersion());
+    }
         
-    // Allow the concrete System subclass to do its processing.
+    // Allow the concrete System subclass to do its processing. Subsystems
+    // that are still realized through Topology stage in the defaultState
+    // must not be realized again.
     realizeTopologyImpl(defaultState); // defaultState is mutable
 
     // Realize any subsystems that the subclass didn't already take care of.
@@ -589,6 +667,49 @@ void System::Guts::multiplyByNPInvTranspose(const State& s, const Vector& fu,
     return multiplyByNPInvTransposeImpl(s,fu,fq);
 }
 
+bool System::Guts::hasMassMatrixOperators() const {
+    return hasMassMatrixOperatorsImpl();
+}
+void System::Guts::multiplyByMInv(const State& s, const Vector& f, 
+                                  Vector& MInvf) const {
+    SimTK_STAGECHECK_GE(s.getSystemStage(), Stage::Velocity,
+        "System::Guts::multiplyByMInv()");
+    return multiplyByMInvImpl(s,f,MInvf);
+}
+void System::Guts::multiplyByG(const State& s, const Vector& u, 
+                               Vector& Gu) const {
+    SimTK_STAGECHECK_GE(s.getSystemStage(), Stage::Velocity,
+        "System::Guts::multiplyByG()");
+    return multiplyByGImpl(s,u,Gu);
+}
+void System::Guts::multiplyByGTranspose(const State& s, const Vector& lambda, 
+                                        Vector& f) const {
+    SimTK_STAGECHECK_GE(s.getSystemStage(), Stage::Velocity,
+        "System::Guts::multiplyByGTranspose()");
+    return multiplyByGTransposeImpl(s,lambda,f);
+}
+
+bool System::Guts::hasStateDerivativeJacobian() const {
+    return hasStateDerivativeJacobianImpl();
+}
+
+bool System::Guts::calcStateDerivativeJacobian(const State& s, 
+                                               Matrix& J) const {
+    SimTK_STAGECHECK_GE(s.getSystemStage(), Stage::Dynamics,
+        "System::Guts::calcStateDerivativeJacobian()");
+    return calcStateDerivativeJacobianImpl(s,J);
+}
+
+bool System::Guts::holdSlowForces(State& s) const {
+    SimTK_STAGECHECK_GE(s.getSystemStage(), Stage::Dynamics,
+        "System::Guts::holdSlowForces()");
+    return holdSlowForcesImpl(s);
+}
+
+void System::Guts::releaseSlowForces(State& s) const {
+    releaseSlowForcesImpl(s);
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -832,6 +953,20 @@ void System::Guts::multiplyByNPInvTransposeImpl
 {   SimTK_THROW2(Exception::UnimplementedVirtualMethod, "System::Guts", 
                  "multiplyByNPInvTransposeImpl"); }
 
+// So must these mass matrix and constraint Jacobian operators.
+void System::Guts::multiplyByMInvImpl
+   (const State& state, const Vector& f, Vector& MInvf) const
+{   SimTK_THROW2(Exception::UnimplementedVirtualMethod, "System::Guts", 
+                 "multiplyByMInvImpl"); }
+void System::Guts::multiplyByGImpl
+   (const State& state, const Vector& u, Vector& Gu) const
+{   SimTK_THROW2(Exception::UnimplementedVirtualMethod, "System::Guts", 
+                 "multiplyByGImpl"); }
+void System::Guts::multiplyByGTransposeImpl
+   (const State& state, const Vector& lambda, Vector& f) const
+{   SimTK_THROW2(Exception::UnimplementedVirtualMethod, "System::Guts", 
+                 "multiplyByGTransposeImpl"); }
+
 
 //------------------------------------------------------------------------------
 //                          HANDLE EVENTS IMPL
@@ -52,6 +52,7 @@ public:
         defaultUpDirection(YAxis), 
         useUniformBackground(false),
         hasTimeAdvancedEventsFlag(false),
+        usePartialTopologyRealization(false),
         systemTopologyRealized(false), 
         topologyCacheVersion(1) // not zero
 
@@ -73,6 +74,7 @@ public:
         defaultUpDirection(src.defaultUpDirection), 
         useUniformBackground(src.useUniformBackground),
         hasTimeAdvancedEventsFlag(src.hasTimeAdvancedEventsFlag),
+        usePartialTopologyRealization(src.usePartialTopologyRealization),
         systemTopologyRealized(false),
         topologyCacheVersion(src.topologyCacheVersion)
     {
@@ -101,6 +103,10 @@ public:
     void setUseUniformBackground(bool useUniform)
     {   useUniformBackground = useUniform; }
     bool getUseUniformBackground() const {return useUniformBackground;}
+    void setUsePartialTopologyRealization(bool usePartial)
+    {   usePartialTopologyRealization = usePartial; }
+    bool getUsePartialTopologyRealization() const 
+    {   return usePartialTopologyRealization; }
 
     const State& getDefaultState() const {return defaultState;}
     State&       updDefaultState()       {return defaultState;}
@@ -164,6 +170,22 @@ public:
         }
     }
 
+    // When the topology of just one Subsystem changes, the System topology
+    // cache is invalid but the other Subsystems' topology caches are not, and
+    // if the System allows it we keep the defaultState so that 
+    // realizeTopology() can reuse their allocations there rather than 
+    // rebuilding everything.
+    void noteSubsystemTopologyChange() const {
+        if (!usePartialTopologyRealization) {
+            invalidateSystemTopologyCache();
+            return;
+        }
+        if (systemTopologyRealized) {
+            systemTopologyRealized = false;
+            topologyCacheVersion++;
+        }
+    }
+
 protected:
     String systemName;
     String systemVersion;
@@ -183,6 +205,7 @@ private:
     bool                useUniformBackground;   // visualization hint
 
     bool hasTimeAdvancedEventsFlag; //TODO: should be in State as a Model variable
+    bool usePartialTopologyRealization; // see noteSubsystemTopologyChange()
        
     
     // TOPOLOGY STAGE CACHE //
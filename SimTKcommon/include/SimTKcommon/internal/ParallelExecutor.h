@@ -25,6 +25,8 @@
  * -------------------------------------------------------------------------- */
 
 #include "PrivateImplementation.h"
+#include "SimTKcommon/internal/ClonePtr.h"
+#include <functional>
 #include <thread>
 #include <iostream>
  
@@ -56,16 +58,26 @@ class ParallelExecutorImpl;
  * any assumptions about what order they will occur in or which ones will
  * happen at the same time.
  * 
- * The threads are created in the ParallelExecutor's constructor and remain
- * active until it is deleted. This means that creating a ParallelExecutor is a
- * somewhat expensive operation, but it may then be used repeatedly for
- * executing various calculations.  By default, the number of threads is chosen
- * to be equal to the number of available processor cores.  You can optionally
- * specify a different number of threads to create.  For example, using more
- * threads than processors can sometimes lead to better processor
- * utilitization.  Alternatively, if the Task will only be executed four times,
- * you might specify min(4, ParallelExecutor::getNumProcessors()) to avoid
- * creating extra threads that will never have any work to do.
+ * The work is done by a work-stealing thread pool that is shared by all
+ * ParallelExecutor and ParallelWorkQueue objects in the process, plus the
+ * thread that called execute(), which always takes part. The pool's threads
+ * are created the first time they are needed and remain active until the
+ * program exits, and idle threads wait briefly for more work before going to
+ * sleep, so executing many short tasks in a row is cheap. By default, a
+ * ParallelExecutor uses as many threads as there are processor cores.  You
+ * can optionally specify a different number.  For example, using more threads
+ * than processors can sometimes lead to better processor utilitization.
+ * Alternatively, if the Task will only be executed four times, you might
+ * specify min(4, ParallelExecutor::getNumProcessors()) to avoid creating extra
+ * threads that will never have any work to do.
+ *
+ * A Task may itself call execute() on the same or another ParallelExecutor;
+ * the nested calls share the same pool.
+ *
+ * If the Task throws an exception, no further indices are started, and the
+ * first exception thrown on any thread is rethrown by execute() once all the
+ * threads are done. Each thread that called the Task's initialize() calls its
+ * finish() whether or not anything was thrown.
  *
  * You may find it useful to use "thread local" variables with your parallel
  * tasks. A thread local variable may have a different value on each thread
@@ -123,6 +135,14 @@ public:
      * @param times   the number of times the Task should be executed
      */
     void execute(Task& task, int times);
+    /**
+     * Execute op(index) for each index from 0 to times-1, in parallel as for
+     * execute(Task&, int).
+     *
+     * @param op      the function to call for each index
+     * @param times   the number of times op should be called
+     */
+    void execute(const std::function<void(int)>& op, int times);
     /**
      * Get the total number of available processor cores (physical cores and
      * hyperthreads on Intel architecture). If the number of threads is not
@@ -130,8 +150,9 @@ public:
      */
     static int getNumProcessors();
     /**
-     * Determine whether the thread invoking this method is a worker thread
-     * created by ParallelExecutor.
+     * Determine whether the thread invoking this method is currently running
+     * a Task on behalf of a multithreaded ParallelExecutor. This includes the
+     * thread that called execute() while it takes part in the work.
      */
     static bool isWorkerThread();
     /**
@@ -169,6 +190,39 @@ public:
     }
 };
 
+/**
+ * This helper is for classes that offer a setNumberOfThreads() option. It
+ * holds the requested number of threads and, if that is more than one, a
+ * ParallelExecutor with that many threads. Copies get their own executor.
+ */
+class SimTK_SimTKCOMMON_EXPORT ParallelExecutorOption {
+public:
+    ParallelExecutorOption() : numThreads(1) {}
+    /**
+     * Set the number of threads; 1 means no ParallelExecutor is used. Throws
+     * an exception naming \a className if \a numThreads is less than 1.
+     */
+    void setNumberOfThreads(int numThreads, const char* className);
+    /** Get the number of threads set with setNumberOfThreads() (default 1). */
+    int getNumberOfThreads() const {return numThreads;}
+    /**
+     * Get the ParallelExecutor to use, or null if only one thread was
+     * requested.
+     */
+    ParallelExecutor* getExecutor() const {return executor.upd();}
+    /**
+     * Call body(begin, end) on consecutive ranges that together cover [0, n).
+     * The ranges are executed in parallel if there is an executor and n is
+     * at least 2*minPerChunk; otherwise body(0, n) is called on this thread.
+     * The first exception thrown by any range is rethrown here.
+     */
+    void forEachChunk(int n, int minPerChunk,
+                      const std::function<void(int,int)>& body) const;
+private:
+    int                                 numThreads;
+    mutable ClonePtr<ParallelExecutor>  executor;
+};
+
 } // namespace SimTK
 
 #endif // SimTK_SimTKCOMMON_PARALLEL_EXECUTOR_H_
@@ -53,9 +53,11 @@ class ParallelWorkQueueImpl;
  * done in parallel on multiple threads, so you cannot make any assumptions about what order they will occur in
  * or which ones will happen at the same time.
  *
- * The threads are created in the ParallelWorkQueue's constructor and remain active until it is deleted.
- * This means that creating a ParallelWorkQueue is a somewhat expensive operation, but it may then be
- * used repeatedly for executing various calculations.  By default, the number of threads is chosen
+ * The Tasks are run by the work-stealing thread pool that is shared with ParallelExecutor; the
+ * constructor makes sure the pool has at least the requested number of threads.  No more than that
+ * many of this queue's Tasks run at once, so with one thread they run one at a time in the order
+ * they were added.  Deleting a
+ * ParallelWorkQueue waits for the Tasks already added to it to finish.  By default, the number of threads is chosen
  * to be equal to the number of available processor cores.  You can optionally specify a different number
  * of threads to create.  For example, using more threads than processors can sometimes lead to better
  * processor utilitization.  Alternatively, if only four Tasks will be executed, you might specify
@@ -70,7 +72,7 @@ public:
      * Construct a ParallelWorkQueue.
      *
      * @param queueSize  the maximum number of Tasks that can be in the queue waiting to start executing at any time
-     * @param numThreads the number of threads to create.  By default, this is set equal to the number of processors.
+     * @param numThreads the most Tasks from this queue that may run at once, and the number of threads the shared pool must have.  By default, this is set equal to the number of processors.
      */
     explicit ParallelWorkQueue(int queueSize, int numThreads = ParallelExecutor::getNumProcessors());
     /**
@@ -22,20 +22,135 @@
  * -------------------------------------------------------------------------- */
 
 #include "ParallelExecutorImpl.h"
+#include "WorkStealingPool.h"
 #include "SimTKcommon/internal/ParallelExecutor.h"
 
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 using namespace std;
 
 namespace SimTK {
 
-static void threadBody(ThreadInfo& info);
+namespace {
 
-ParallelExecutorImpl::ParallelExecutorImpl() : finished(false) {
+/**
+ * One call to ParallelExecutor::execute(). Copies of this Job are pushed onto
+ * the pool, one for each extra thread we would like to use. Every thread that
+ * runs a copy (and the calling thread) "participates": it grabs chunks of
+ * indices from a shared atomic counter until they are all gone. A thread calls
+ * the Task's initialize() before its first index and finish() after its last,
+ * so threads that arrive too late to get any indices do not touch the Task.
+ * The first exception thrown by the Task is kept for the caller to rethrow;
+ * after that no more indices are handed out, but each thread that called 
+ * initialize() still calls finish().
+ */
+class ExecuteJob : public WorkStealingPool::Job {
+public:
+    ExecuteJob(ParallelExecutor::Task& task, int times, int chunk, int copies)
+    :   task(task), times(times), chunk(chunk), next(0), outstanding(copies) {}
+
+    void run() override {
+        participate();
+        // This must be the last access to the job; the caller may destroy it
+        // as soon as it sees the count reach zero.
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (--outstanding == 0)
+            doneCondition.notify_one();
+    }
+
+    void participate() {
+        int begin = next.fetch_add(chunk);
+        if (begin >= times)
+            return;
+        const bool wasWorker = ParallelExecutorImpl::isWorker;
+        ParallelExecutorImpl::isWorker = true;
+        bool initialized = false;
+        try {
+            task.initialize();
+            initialized = true;
+            do {
+                const int end = std::min(begin+chunk, times);
+                for (int i = begin; i < end; ++i)
+                    task.execute(i);
+                begin = next.fetch_add(chunk);
+            } while (begin < times);
+        } catch (...) {
+            noteException();
+        }
+        if (initialized) {
+            std::lock_guard<std::mutex> lock(finishMutex);
+            try {
+                task.finish();
+            } catch (...) {
+                noteException();
+            }
+        }
+        ParallelExecutorImpl::isWorker = wasWorker;
+    }
+
+    // Called by the thread that pushed the copies once they are all done.
+    void rethrowIfFailed() const {
+        if (firstException)
+            std::rethrow_exception(firstException);
+    }
+
+    // Called by the thread that pushed the copies, after its own
+    // participate(), with the number of copies it took back off the pool.
+    void waitForCopies(int removed) {
+        // The stragglers are normally only a few microseconds behind, so spin
+        // briefly before sleeping.
+        for (int spin = 0; spin < 1024; ++spin) {
+            if (outstanding.load() == removed)
+                break;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(doneMutex);
+        outstanding -= removed;
+        doneCondition.wait(lock, [this] { return outstanding == 0; });
+    }
+
+private:
+    // Record the exception being handled if it is the first one, and stop
+    // handing out indices.
+    void noteException() {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!firstException)
+            firstException = std::current_exception();
+        next.store(times);
+    }
+
+    ParallelExecutor::Task&  task;
+    const int                times;
+    const int                chunk;
+    std::atomic<int>         next;
+    std::atomic<int>         outstanding;
+    std::mutex               finishMutex;
+    std::mutex               doneMutex;
+    std::condition_variable  doneCondition;
+    std::mutex               exceptionMutex;
+    std::exception_ptr       firstException;
+};
+
+// Adapts a function of the index to a Task.
+class FunctionTask : public ParallelExecutor::Task {
+public:
+    explicit FunctionTask(const std::function<void(int)>& op) : op(op) {}
+    void execute(int index) override {op(index);}
+private:
+    const std::function<void(int)>& op;
+};
+
+} // anonymous namespace
+
+ParallelExecutorImpl::ParallelExecutorImpl() {
 
     //By default, we use the total number of processors available of the
     //computer (including hyperthreads)
@@ -43,7 +158,7 @@ ParallelExecutorImpl::ParallelExecutorImpl() : finished(false) {
     if(numMaxThreads <= 0)
       numMaxThreads = 1;
 }
-ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : finished(false) {
+ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) {
 
     // Set the maximum number of threads that we can use
     SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ParallelExecutorImpl",
@@ -51,20 +166,6 @@ ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : finished(false) {
     numMaxThreads = numThreads;
 }
 ParallelExecutorImpl::~ParallelExecutorImpl() {
-    
-    // Notify the threads that they should exit.
-    
-    std::unique_lock<std::mutex> lock(runMutex);
-    finished = true;
-    for (int i = 0; i < (int) threads.size(); ++i)
-        threadInfo[i].running = true;
-    runCondition.notify_all();
-    lock.unlock();
-    
-    // Wait until all the threads have finished.
-    
-    for (int i = 0; i < (int) threads.size(); ++i)
-        threads[i].join();
 }
 ParallelExecutorImpl* ParallelExecutorImpl::clone() const {
     return new ParallelExecutorImpl(numMaxThreads);
@@ -73,98 +174,40 @@ void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
   if (numMaxThreads < 2) {
       //(1) NON-PARALLEL CASE:
       // Nothing is actually going to get done in parallel, so we might as well
-      // just execute the task directly and save the threading overhead.
+      // just execute the task directly and save the threading overhead. As in
+      // the parallel case, finish() is called even if execute() throws.
       task.initialize();
-      for (int i = 0; i < times; ++i)
-          task.execute(i);
+      try {
+          for (int i = 0; i < times; ++i)
+              task.execute(i);
+      } catch (...) {
+          task.finish();
+          throw;
+      }
       task.finish();
       return;
     }
-    
+
     //(2) PARALLEL CASE:
-    // We launch the maximum number of threads and save them for later use
-    if(threads.size() < (size_t)numMaxThreads)
-    {
-      // We do not support numMaxThreads changing for a given instance of
-      // ParallelExecutor.
-      assert(threads.size() == 0);
-      threadInfo.reserve(numMaxThreads);
-      threads.resize(numMaxThreads);
-      for (int i = 0; i < numMaxThreads; ++i) {
-          threadInfo.emplace_back(i, this);
-          threads[i] = std::thread(threadBody, std::ref(threadInfo[i]));
-      }
-    }
-   
-    // Initialize fields to execute the new task.
-    std::unique_lock<std::mutex> lock(runMutex);
-    currentTask = &task;
-    currentTaskCount = times;
-    waitingThreadCount = 0;
-    for (int i = 0; i < (int)threadInfo.size(); ++i) {
-        threadInfo[i].running = true;
-    }
+    // The calling thread counts as one of our threads; the rest come from the
+    // shared pool, which is grown to our size the first time it is needed.
+    WorkStealingPool& pool = WorkStealingPool::getShared();
+    pool.reserveWorkers(numMaxThreads-1);
+    const int participants = std::max(1, std::min(
+        std::min(numMaxThreads, times), pool.getNumWorkers()+1));
+    // Hand out several chunks per participant so that a thread that gets
+    // slow indices does not hold everyone else up.
+    const int chunk = std::max(1, times/(4*participants));
 
-    // Wake up the worker threads and wait until they finish.
-    runCondition.notify_all();
-    waitCondition.wait(lock,
-        [&] { return waitingThreadCount == (int)threads.size(); });
-    lock.unlock();
-}
-void ParallelExecutorImpl::incrementWaitingThreads() {
-    std::lock_guard<std::mutex> lock(runMutex);
-    getCurrentTask().finish();
-    waitingThreadCount++;
-    if (waitingThreadCount == (int)threads.size()) {
-        waitCondition.notify_one();
-    }
+    ExecuteJob job(task, times, chunk, participants-1);
+    pool.push(&job, participants-1);
+    job.participate();
+    job.waitForCopies(pool.remove(&job));
+    job.rethrowIfFailed();
 }
 
 thread_local bool ParallelExecutorImpl::isWorker(false);
 
-/**
- * This function contains the code executed by the worker threads.
- */
-
-void threadBody(ThreadInfo& info) {
-    ParallelExecutorImpl::isWorker = true;
-    ParallelExecutorImpl& executor = *info.executor;
-    int threadCount = executor.getThreadCount();
-    while (!executor.isFinished()) {
-        
-        // Wait for a Task to come in.
-        
-        std::unique_lock<std::mutex> lock(executor.getMutex());
-        executor.getCondition().wait(lock, [&] { return info.running; });
-        lock.unlock();
-        if (!executor.isFinished()) {
-            
-            // Execute the task for all the indices belonging to this thread.
-            
-            int count = executor.getCurrentTaskCount();
-            ParallelExecutor::Task& task = executor.getCurrentTask();
-            task.initialize();
-            int index = info.index;
-                        
-            try {
-                while (index < count) {
-                    task.execute(index);
-                    index += threadCount;
-                }
-            }
-            catch (const std::exception& ex) {
-                std::cerr <<"The parallel task threw an unhandled exception:"<< std::endl;
-                std::cerr <<ex.what()<< std::endl;
-            }
-            catch (...) {
-                std::cerr <<"The parallel task threw an error."<< std::endl;
-            }
-            info.running = false;
-            executor.incrementWaitingThreads();
-        }
-    }
-}
-
 ParallelExecutor::ParallelExecutor() : HandleBase(new ParallelExecutorImpl()) {
 }
 
@@ -179,6 +222,34 @@ void ParallelExecutor::execute(Task& task, int times) {
     updImpl().execute(task, times);
 }
 
+void ParallelExecutor::execute(const std::function<void(int)>& op, int times) {
+    FunctionTask task(op);
+    updImpl().execute(task, times);
+}
+
+void ParallelExecutorOption::setNumberOfThreads(int numThreads, 
+                                                const char* className) {
+    SimTK_APIARGCHECK1_ALWAYS(numThreads >= 1, className, "setNumberOfThreads",
+        "Number of threads must be at least 1 but was %d.", numThreads);
+    this->numThreads = numThreads;
+    if (numThreads == 1) executor.reset();
+    else executor.reset(new ParallelExecutor(numThreads));
+}
+
+void ParallelExecutorOption::forEachChunk
+   (int n, int minPerChunk, const std::function<void(int,int)>& body) const {
+    const int nChunks = executor.empty() ? 1
+        : std::min(numThreads, n/std::max(1,minPerChunk));
+    if (nChunks < 2) {
+        if (n > 0) body(0, n);
+        return;
+    }
+    executor.upd()->execute([&](int chunk) {
+        body((int)((long long)n*chunk/nChunks), 
+             (int)((long long)n*(chunk+1)/nChunks));
+    }, nChunks);
+}
+
 #ifdef __APPLE__
    #include <sys/sysctl.h>
    #include <dlfcn.h>
@@ -25,32 +25,14 @@
  * -------------------------------------------------------------------------- */
 
 #include "SimTKcommon/internal/ParallelExecutor.h"
-#include "SimTKcommon/internal/Array.h"
-
-#include <iostream>
-#include <thread>
-#include <mutex>
-#include <condition_variable>
 
 namespace SimTK {
 
-class ParallelExecutorImpl;
-
 /**
- * This class stores per-thread information used while executing a task.
- */
-
-class ThreadInfo {
-public:
-    ThreadInfo(int index, ParallelExecutorImpl* executor) : index(index), executor(executor), running(false) {
-    }
-    const int index;
-    ParallelExecutorImpl* const executor;
-    bool running;
-};
-
-/**
- * This is the internal implementation class for ParallelExecutor.
+ * This is the internal implementation class for ParallelExecutor. The work is
+ * done by the process-wide WorkStealingPool; the calling thread always takes
+ * part, so an execute() call made from inside a running Task (nested
+ * parallelism) cannot deadlock even when every pool worker is busy.
  */
 
 class ParallelExecutorImpl : public PIMPLImplementation<ParallelExecutor, ParallelExecutorImpl> {
@@ -60,38 +42,11 @@ public:
     ~ParallelExecutorImpl();
     ParallelExecutorImpl* clone() const;
     void execute(ParallelExecutor::Task& task, int times);
-    int getThreadCount() {
-        return threads.size();
-    }
-    ParallelExecutor::Task& getCurrentTask() {
-        return *currentTask;
-    }
-    int getCurrentTaskCount() {
-        return currentTaskCount;
-    }
-    bool isFinished() {
-        return finished;
-    }
-    std::mutex& getMutex() {
-        return runMutex;
-    }
-    std::condition_variable& getCondition() {
-        return runCondition;
-    }
     int getMaxThreads() const{
       return numMaxThreads;
     }
-    void incrementWaitingThreads();
     static thread_local bool isWorker;
 private:
-    bool finished;
-    std::mutex runMutex;
-    std::condition_variable runCondition, waitCondition;
-    Array_<std::thread> threads;
-    Array_<ThreadInfo> threadInfo;
-    ParallelExecutor::Task* currentTask;
-    int currentTaskCount;
-    int waitingThreadCount;
     int numMaxThreads;
 };
 
@@ -22,108 +22,87 @@
  * -------------------------------------------------------------------------- */
 
 #include "ParallelWorkQueueImpl.h"
+#include "WorkStealingPool.h"
 #include "SimTKcommon/internal/ParallelExecutor.h"
 #include <utility>
 #include <mutex>
 #include <condition_variable>
 
-using std::queue;
-
 namespace SimTK {
 
-static void threadBody(ParallelWorkQueueImpl& owner) {
-    queue<ParallelWorkQueue::Task*>& taskQueue = owner.updTaskQueue();
-    std::mutex& queueMutex = owner.getQueueMutex();
-    std::condition_variable& waitForTaskCondition = owner.getWaitCondition();
-    std::condition_variable& queueFullCondition = owner.getQueueFullCondition();
-    bool decrementTaskCount = false;
-    while (!owner.isFinished() || !taskQueue.empty()) {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        if (decrementTaskCount) {
-            owner.markTaskCompleted();
-            decrementTaskCount = false;
-        }
-        waitForTaskCondition.wait(lock,
-                [&] { return !taskQueue.empty() || owner.isFinished(); });
-        ParallelWorkQueue::Task* task = NULL;
-        if (!taskQueue.empty()) {
-            task = taskQueue.front();
-            taskQueue.pop();
-        }
-        queueFullCondition.notify_one();
-        lock.unlock();
-        if (task != NULL) {
+/**
+ * The pool job that runs this queue's Tasks until none are left waiting. It
+ * deletes each Task after running it, and deletes itself when it retires.
+ */
+class ParallelWorkQueueImpl::RunnerJob : public WorkStealingPool::Job {
+public:
+    explicit RunnerJob(ParallelWorkQueueImpl& owner) : owner(owner) {}
+    void run() override {
+        ParallelWorkQueueImpl& queue = owner;
+        delete this;
+        while (ParallelWorkQueue::Task* task = queue.takeNextTask()) {
             task->execute();
             delete task;
-            decrementTaskCount = true;
         }
+        // The queue may be gone now.
     }
-    if (decrementTaskCount) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        owner.markTaskCompleted();
-    }
-}
-
-ParallelWorkQueueImpl::ParallelWorkQueueImpl(int queueSize, int numThreads) : queueSize(queueSize), pendingTasks(0), finished(false) {
-    threads.resize(numThreads);
-    for (int i = 0; i < numThreads; ++i)
-        threads[i] = std::thread(threadBody, std::ref(*this));
+private:
+    ParallelWorkQueueImpl& owner;
+};
+
+ParallelWorkQueueImpl::ParallelWorkQueueImpl(int queueSize, int numThreads)
+:   queueSize(queueSize), numThreads(numThreads), runners(0) {
+    SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ParallelWorkQueue",
+        "ParallelWorkQueue", "Number of threads must be positive.");
+    WorkStealingPool::getShared().reserveWorkers(numThreads);
 }
 
 ParallelWorkQueueImpl::~ParallelWorkQueueImpl() {
-    // Wait for the theads to finish.
-
-    std::unique_lock<std::mutex> lock(queueMutex);
-    finished = true;
-    waitForTaskCondition.notify_all();
-    lock.unlock();
-    for (int i = 0; i < (int) threads.size(); ++i)
-        threads[i].join();
+    // Tasks already added still run to completion.
+    flush();
 }
 
 ParallelWorkQueueImpl* ParallelWorkQueueImpl::clone() const {
-    return new ParallelWorkQueueImpl(queueSize, threads.size());
+    return new ParallelWorkQueueImpl(queueSize, numThreads);
 }
 
 void ParallelWorkQueueImpl::addTask(ParallelWorkQueue::Task* task) {
     std::unique_lock<std::mutex> lock(queueMutex);
     queueFullCondition.wait(lock,
-            [this] { return (int)taskQueue.size() < queueSize; });
-    taskQueue.push(task);
-    ++pendingTasks;
-    waitForTaskCondition.notify_one();
+            [this] { return (int)waitingTasks.size() < queueSize; });
+    waitingTasks.push_back(task);
+    const bool needRunner = runners < numThreads;
+    if (needRunner)
+        ++runners;
     lock.unlock();
+    if (needRunner)
+        WorkStealingPool::getShared().push(new RunnerJob(*this));
 }
 
 void ParallelWorkQueueImpl::flush() {
+    // Wait for the runners to retire too, since they still use the queue
+    // after their last Task completes.
     std::unique_lock<std::mutex> lock(queueMutex);
-    queueFullCondition.wait(lock, [this] { return pendingTasks == 0; });
-    lock.unlock();
+    queueFullCondition.wait(lock, [this] { return runners == 0; });
 }
 
-queue<ParallelWorkQueue::Task*>& ParallelWorkQueueImpl::updTaskQueue() {
-    return taskQueue;
-}
-
-bool ParallelWorkQueueImpl::isFinished() const {
-    return finished;
-}
-
-std::mutex& ParallelWorkQueueImpl::getQueueMutex() {
-    return queueMutex;
-}
-
-std::condition_variable& ParallelWorkQueueImpl::getWaitCondition() {
-    return waitForTaskCondition;
-}
-
-std::condition_variable& ParallelWorkQueueImpl::getQueueFullCondition() {
-    return queueFullCondition;
-}
-
-void ParallelWorkQueueImpl::markTaskCompleted() {
-    --pendingTasks;
-    queueFullCondition.notify_one();
+// The waiters check their conditions while holding queueMutex, and we notify
+// while holding it, so a wake-up cannot slip in between their check and their
+// wait. Once runners reaches zero flush() may return and the queue may be
+// destroyed, so the runner must not touch it after releasing the lock.
+ParallelWorkQueue::Task* ParallelWorkQueueImpl::takeNextTask() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (waitingTasks.empty()) {
+        --runners;
+        if (runners == 0)
+            queueFullCondition.notify_all();
+        return nullptr;
+    }
+    ParallelWorkQueue::Task* task = waitingTasks.front();
+    waitingTasks.pop_front();
+    if ((int)waitingTasks.size() == queueSize-1)
+        queueFullCondition.notify_all();
+    return task;
 }
 
 ParallelWorkQueue::ParallelWorkQueue(int queueSize, int numThreads) : HandleBase(new ParallelWorkQueueImpl(queueSize, numThreads)) {
@@ -25,41 +25,40 @@
  * -------------------------------------------------------------------------- */
 
 #include "SimTKcommon/internal/ParallelWorkQueue.h"
-#include "SimTKcommon/internal/Array.h"
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 
 namespace SimTK {
 
-class ParallelExecutor;
-
 /**
- * This is the internal implementation class for ParallelWorkQueue.
+ * This is the internal implementation class for ParallelWorkQueue. Tasks wait
+ * in this queue's own FIFO and are run by "runner" jobs on the process-wide
+ * WorkStealingPool. Each runner takes Tasks from the front of the queue until
+ * it is empty. There are never more runners than the number of threads the
+ * queue was created with, so a queue with one thread runs its Tasks one at a
+ * time in the order they were added, as a queue with its own single thread
+ * would.
  */
 
 class ParallelWorkQueueImpl : public PIMPLImplementation<ParallelWorkQueue, ParallelWorkQueueImpl> {
 public:
-    class ExecutorTask;
+    class RunnerJob;
     ParallelWorkQueueImpl(int queueSize, int numThreads);
     ~ParallelWorkQueueImpl();
     ParallelWorkQueueImpl* clone() const;
     void addTask(ParallelWorkQueue::Task* task);
     void flush();
-    std::queue<ParallelWorkQueue::Task*>& updTaskQueue();
-    bool isFinished() const;
-    std::mutex& getQueueMutex();
-    std::condition_variable& getWaitCondition();
-    std::condition_variable& getQueueFullCondition();
-    void markTaskCompleted();
+    // Called by a runner, after completing its previous Task if any: take
+    // the next Task, or return null and retire the runner if there are none.
+    ParallelWorkQueue::Task* takeNextTask();
 private:
     const int queueSize;
-    int pendingTasks;
-    bool finished;
-    std::queue<ParallelWorkQueue::Task*> taskQueue;
+    const int numThreads;
+    std::deque<ParallelWorkQueue::Task*> waitingTasks;
+    int runners;        // runner jobs pushed and not yet retired
     std::mutex queueMutex;
-    std::condition_variable waitForTaskCondition, queueFullCondition;
-    SimTK::Array_<std::thread> threads;
+    std::condition_variable queueFullCondition;
 };
 
 } // namespace SimTK
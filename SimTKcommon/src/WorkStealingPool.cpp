@@ -0,0 +1,188 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace SimTK {
+
+// Which pool, if any, the current thread works for, and the slot of its deque.
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local int currentSlot = -1;
+
+// How many times an idle worker looks for work before parking. The first
+// half of the attempts are tight; the rest yield the processor in between.
+static const int IdleSpins = 4096;
+
+WorkStealingPool& WorkStealingPool::getShared() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+WorkStealingPool::WorkStealingPool()
+:   numWorkers(0), queuedJobs(0), sleepers(0), shutdown(false), wakeEpoch(0) {
+    std::fill(deques, deques+MaxWorkers, (JobDeque*)nullptr);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    // Tell the workers to exit and wait for them.
+    std::unique_lock<std::mutex> lock(parkMutex);
+    shutdown = true;
+    ++wakeEpoch;
+    parkCondition.notify_all();
+    lock.unlock();
+    for (auto& thread : threads)
+        thread.join();
+    for (int i = 0; i < MaxWorkers; ++i)
+        delete deques[i];
+}
+
+void WorkStealingPool::reserveWorkers(int n) {
+    n = std::min(n, (int)MaxWorkers);
+    if (getNumWorkers() >= n)
+        return;
+    std::lock_guard<std::mutex> lock(growMutex);
+    for (int slot = getNumWorkers(); slot < n; ++slot) {
+        deques[slot] = new JobDeque();
+        // Publish the deque before its worker can be stolen from.
+        numWorkers.store(slot+1, std::memory_order_release);
+        threads.push_back(std::thread(workerBody, std::ref(*this), slot));
+    }
+}
+
+bool WorkStealingPool::isPoolThread() const {
+    return currentPool == this;
+}
+
+WorkStealingPool::JobDeque& WorkStealingPool::getCallerDeque() {
+    return isPoolThread() ? *deques[currentSlot] : injection;
+}
+
+void WorkStealingPool::push(Job* job, int copies) {
+    if (copies <= 0)
+        return;
+    JobDeque& deque = getCallerDeque();
+    deque.lock.lock();
+    for (int i = 0; i < copies; ++i)
+        deque.jobs.push_back(job);
+    deque.lock.unlock();
+    queuedJobs.fetch_add(copies);
+
+    // A worker about to park re-checks queuedJobs after announcing itself in
+    // sleepers, so one of us is guaranteed to see the other.
+    if (sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        ++wakeEpoch;
+        if (copies == 1)
+            parkCondition.notify_one();
+        else
+            parkCondition.notify_all();
+    }
+}
+
+int WorkStealingPool::remove(Job* job) {
+    JobDeque& deque = getCallerDeque();
+    deque.lock.lock();
+    const auto end = std::remove(deque.jobs.begin(), deque.jobs.end(), job);
+    const int removed = (int)(deque.jobs.end() - end);
+    deque.jobs.erase(end, deque.jobs.end());
+    deque.lock.unlock();
+    if (removed)
+        queuedJobs.fetch_sub(removed);
+    return removed;
+}
+
+WorkStealingPool::Job* WorkStealingPool::popBack(JobDeque& deque) {
+    deque.lock.lock();
+    Job* job = nullptr;
+    if (!deque.jobs.empty()) {
+        job = deque.jobs.back();
+        deque.jobs.pop_back();
+    }
+    deque.lock.unlock();
+    if (job)
+        queuedJobs.fetch_sub(1);
+    return job;
+}
+
+WorkStealingPool::Job* WorkStealingPool::popFront(JobDeque& deque) {
+    deque.lock.lock();
+    Job* job = nullptr;
+    if (!deque.jobs.empty()) {
+        job = deque.jobs.front();
+        deque.jobs.pop_front();
+    }
+    deque.lock.unlock();
+    if (job)
+        queuedJobs.fetch_sub(1);
+    return job;
+}
+
+WorkStealingPool::Job* WorkStealingPool::findJob(int slot) {
+    if (queuedJobs.load(std::memory_order_relaxed) == 0)
+        return nullptr;
+    if (Job* job = popBack(*deques[slot]))
+        return job;
+    // Injection deque first so that outside callers are served promptly,
+    // then the other workers starting with our neighbor.
+    if (Job* job = popFront(injection))
+        return job;
+    const int n = getNumWorkers();
+    for (int k = 1; k < n; ++k)
+        if (Job* job = popFront(*deques[(slot+k) % n]))
+            return job;
+    return nullptr;
+}
+
+void WorkStealingPool::park() {
+    std::unique_lock<std::mutex> lock(parkMutex);
+    const long long epoch = wakeEpoch;
+    sleepers.fetch_add(1);
+    if (queuedJobs.load() == 0 && !shutdown)
+        parkCondition.wait(lock,
+            [&] { return wakeEpoch != epoch || shutdown; });
+    sleepers.fetch_sub(1);
+}
+
+void WorkStealingPool::workerBody(WorkStealingPool& pool, int slot) {
+    currentPool = &pool;
+    currentSlot = slot;
+    int idle = 0;
+    while (!pool.shutdown.load(std::memory_order_relaxed)) {
+        if (Job* job = pool.findJob(slot)) {
+            job->run();
+            idle = 0;
+        }
+        else if (++idle < IdleSpins) {
+            if (idle > IdleSpins/2)
+                std::this_thread::yield();
+        }
+        else {
+            pool.park();
+            idle = 0;
+        }
+    }
+}
+
+} // namespace SimTK
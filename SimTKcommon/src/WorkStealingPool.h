@@ -0,0 +1,134 @@
+#ifndef SimTK_SimTKCOMMON_WORK_STEALING_POOL_H_
+#define SimTK_SimTKCOMMON_WORK_STEALING_POOL_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SimTK {
+
+/**
+ * This is the internal thread pool shared by ParallelExecutor and
+ * ParallelWorkQueue (and hence by Parallel2DExecutor, which runs on a
+ * ParallelExecutor).
+ *
+ * Each worker thread owns a deque of Jobs. A worker pushes and pops at the
+ * back of its own deque and, when that is empty, steals from the front of
+ * the other workers' deques. The deques are not lock-free: each is a
+ * std::deque guarded by its own spin lock, which is held only for the push
+ * or pop itself. Jobs pushed by threads that do not belong to the
+ * pool go into a separate injection deque that every worker steals from. An
+ * idle worker spins for a short while looking for work before parking on a
+ * condition variable, so back-to-back short parallel loops do not pay for a
+ * wake-up each time.
+ *
+ * Only one process-wide pool exists; it is obtained with getShared() and
+ * grows on demand to the largest number of workers any client has asked for.
+ * Jobs are not owned by the pool.
+ */
+
+class WorkStealingPool {
+public:
+    /** A unit of work. The same Job object may be pushed several times, in
+    which case run() is called once for each copy. **/
+    class Job {
+    public:
+        virtual ~Job() {}
+        virtual void run() = 0;
+    };
+
+    /** Get the process-wide pool, creating it on first use. **/
+    static WorkStealingPool& getShared();
+
+    WorkStealingPool();
+    ~WorkStealingPool();
+
+    /** Make sure the pool has at least \a numWorkers worker threads (up to an
+    internal limit). **/
+    void reserveWorkers(int numWorkers);
+    /** Get the number of worker threads currently in the pool. **/
+    int getNumWorkers() const {
+        return numWorkers.load(std::memory_order_acquire);
+    }
+    /** Push \a copies copies of \a job. If the calling thread is one of this
+    pool's workers the copies go on its own deque, otherwise on the injection
+    deque. **/
+    void push(Job* job, int copies = 1);
+    /** Remove any copies of \a job that were pushed by the calling thread and
+    have not been started yet. Returns the number of copies removed. **/
+    int remove(Job* job);
+    /** Determine whether the calling thread is one of this pool's workers. **/
+    bool isPoolThread() const;
+
+    /** The most worker threads the pool will create. **/
+    static const int MaxWorkers = 256;
+private:
+    class SpinLock {
+    public:
+        SpinLock() {flag.clear();}
+        void lock() {
+            while (flag.test_and_set(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+        void unlock() {flag.clear(std::memory_order_release);}
+    private:
+        std::atomic_flag flag;
+    };
+
+    // Padded so that workers polling their own deque do not share a cache
+    // line with their neighbors'.
+    struct JobDeque {
+        SpinLock         lock;
+        std::deque<Job*> jobs;
+        char             padding[64];
+    };
+
+    static void workerBody(WorkStealingPool& pool, int slot);
+    Job* findJob(int slot);
+    Job* popBack(JobDeque& deque);
+    Job* popFront(JobDeque& deque);
+    void park();
+    JobDeque& getCallerDeque();
+
+    JobDeque*               deques[MaxWorkers];
+    JobDeque                injection;
+    std::atomic<int>        numWorkers;
+    std::atomic<int>        queuedJobs;
+    std::atomic<int>        sleepers;
+    std::atomic<bool>       shutdown;
+    std::mutex              growMutex;
+    std::mutex              parkMutex;
+    std::condition_variable parkCondition;
+    long long               wakeEpoch;
+    std::vector<std::thread> threads;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SimTKCOMMON_WORK_STEALING_POOL_H_
@@ -518,6 +518,90 @@ void testConsistent() {
 
 }
 
+// Build a State with one of each kind of allocation, realized through
+// Instance stage.
+static void buildInstanceState(State& s) {
+    const SubsystemIndex Sub0(0), Sub1(1);
+    s.setNumSubsystems(2);
+    s.allocateQ(Sub0, Vector(3, Real(1)));
+    s.allocateU(Sub1, Vector(2, Real(2)));
+    s.allocateZ(Sub1, Vector(1, Real(3)));
+    s.allocateDiscreteVariable(Sub0, Stage::Position, new Value<Vec3>(Vec3(4)));
+    s.allocateCacheEntry(Sub0, Stage::Instance, Stage::Infinity,
+                         new Value<Vector>(Vector(5, Real(0))));
+    advanceStage(s, Stage::Topology);
+    s.allocateDiscreteVariable(Sub1, Stage::Velocity, new Value<int>(6));
+    s.allocateEventTrigger(Sub1, Stage::Position, 2);
+    advanceStage(s, Stage::Model);
+    s.allocateCacheEntryWithPrerequisites(Sub1, Stage::Instance, 
+        Stage::Infinity, true, false, false, {}, {}, new Value<Real>(7));
+    advanceStage(s, Stage::Instance);
+}
+
+// Copy assignment between States with the same allocations should reuse the
+// destination's storage, and give the same result as a fresh copy.
+void testAssignInPlace() {
+    const SubsystemIndex Sub0(0), Sub1(1);
+    const DiscreteVariableIndex dv0(0), dv1(0);
+    const CacheEntryIndex cx0(0), cx1(0);
+
+    State sA; buildInstanceState(sA);
+    State sB; buildInstanceState(sB);
+
+    const AbstractValue* dvAddr = &sB.getDiscreteVariable(Sub0, dv0);
+    const AbstractValue* cxAddr = &sB.updCacheEntry(Sub0, cx0);
+    const Real*          qAddr  = &sB.getQ()[0];
+
+    sA.updQ() = 10;
+    Value<Vec3>::updDowncast(sA.updDiscreteVariable(Sub0, dv0)) = Vec3(11);
+    Value<Vector>::updDowncast(sA.updCacheEntry(Sub0, cx0)).upd() = 12;
+    sA.markCacheValueRealized(Sub0, cx0);
+    sA.setTime(13);
+    advanceStage(sA, Stage::Time);
+    Value<Real>::updDowncast(sA.updCacheEntry(Sub1, cx1)) = 14;
+    sA.markCacheValueRealized(Sub1, cx1);
+
+    sB = sA;
+    SimTK_TEST(&sB.getDiscreteVariable(Sub0, dv0) == dvAddr);
+    SimTK_TEST(&sB.updCacheEntry(Sub0, cx0) == cxAddr);
+    SimTK_TEST(&sB.getQ()[0] == qAddr);
+
+    State sC(sA); // reference result from a fresh copy
+    SimTK_TEST(sB.getSystemStage() == sC.getSystemStage());
+    SimTK_TEST(sB.getTime() == 13);
+    SimTK_TEST_EQ(sB.getY(), sC.getY());
+    SimTK_TEST(Value<Vec3>::downcast(sB.getDiscreteVariable(Sub0, dv0)).get()
+               == Vec3(11));
+    SimTK_TEST(Value<int>::downcast(sB.getDiscreteVariable(Sub1, dv1)) == 6);
+
+    // The Instance-stage cache entry stays valid; the one with a q
+    // prerequisite has to be recomputed, as after a fresh copy.
+    SimTK_TEST(sC.isCacheValueRealized(Sub0, cx0));
+    SimTK_TEST(sB.isCacheValueRealized(Sub0, cx0));
+    SimTK_TEST(Value<Vector>::downcast(sB.getCacheEntry(Sub0, cx0)).get()[4]
+               == 12);
+    SimTK_TEST(!sC.isCacheValueRealized(Sub1, cx1));
+    SimTK_TEST(!sB.isCacheValueRealized(Sub1, cx1));
+
+    // The copy still tracks its own prerequisites.
+    advanceStage(sB, Stage::Time);
+    sB.markCacheValueRealized(Sub1, cx1);
+    SimTK_TEST(sB.isCacheValueRealized(Sub1, cx1));
+    sB.updQ();
+    SimTK_TEST(!sB.isCacheValueRealized(Sub1, cx1));
+    SimTK_TEST(sA.isCacheValueRealized(Sub1, cx1));
+
+    // A State with different allocations is still copied correctly.
+    State sD; buildInstanceState(sD);
+    sD.invalidateAll(Stage::Instance);
+    sD.allocateCacheEntry(Sub0, Stage::Position, new Value<int>(15));
+    advanceStage(sD, Stage::Instance);
+    sD = sA;
+    SimTK_TEST(!sD.hasCacheEntry(CacheEntryKey(Sub0, CacheEntryIndex(1))));
+    SimTK_TEST_EQ(sD.getY(), sA.getY());
+
+}
+
 int main() {
     int major,minor,build;
     char out[100];
@@ -537,5 +621,6 @@ int main() {
         SimTK_SUBTEST(testCacheValidity);
         SimTK_SUBTEST(testMisc);
         SimTK_SUBTEST(testConsistent);
+        SimTK_SUBTEST(testAssignInPlace);
     SimTK_END_TEST();
 }
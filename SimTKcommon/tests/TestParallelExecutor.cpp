@@ -23,7 +23,10 @@
 
 #include "SimTKcommon.h"
 
+#include <atomic>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 #define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
 
@@ -93,6 +96,78 @@ void testSingleThreadedExecution() {
         ASSERT(flags[j] == (j < numFlags-10 ? 1 : 0));
 }
 
+// Counts the threads that called initialize() and finish(), and throws from
+// one index.
+class ThrowingTask : public ParallelExecutor::Task {
+public:
+    ThrowingTask(int throwAt) : throwAt(throwAt), started(0), finished(0) {}
+    void execute(int index) override {
+        if (index == throwAt)
+            throw std::runtime_error("index " + String(index));
+    }
+    void initialize() override {++started;}
+    void finish() override {++finished;}
+
+    const int           throwAt;
+    std::atomic<int>    started, finished;
+};
+
+void testExceptionIsRethrown() {
+    for (int nThreads = 1; nThreads <= 4; nThreads += 3) {
+        ParallelExecutor executor(nThreads);
+        ThrowingTask task(37);
+        SimTK_TEST_MUST_THROW_EXC(executor.execute(task, 100), 
+                                  std::runtime_error);
+        SimTK_TEST(task.started >= 1);
+        SimTK_TEST(task.finished == task.started);
+
+        // The executor is still usable afterwards.
+        Array_<int> flags(10, 0);
+        executor.execute([&](int i) {++flags[i];}, 10);
+        for (int i=0; i < 10; ++i)
+            SimTK_TEST(flags[i] == 1);
+        SimTK_TEST_MUST_THROW_EXC(executor.execute([](int i) 
+            {if (i==3) throw std::runtime_error("three");}, 10), 
+            std::runtime_error);
+    }
+}
+
+void testExecutorOption() {
+    ParallelExecutorOption option;
+    SimTK_TEST(option.getNumberOfThreads() == 1);
+    SimTK_TEST(option.getExecutor() == nullptr);
+    option.setNumberOfThreads(3, "testExecutorOption");
+    SimTK_TEST(option.getExecutor()->getMaxThreads() == 3);
+    const ParallelExecutorOption copy(option);
+    SimTK_TEST(copy.getNumberOfThreads() == 3);
+    SimTK_TEST(copy.getExecutor() != option.getExecutor());
+    SimTK_TEST_MUST_THROW(option.setNumberOfThreads(0, "testExecutorOption"));
+    SimTK_TEST_MUST_THROW(option.setNumberOfThreads(-1,"testExecutorOption"));
+    option.setNumberOfThreads(1, "testExecutorOption");
+    SimTK_TEST(option.getExecutor() == nullptr);
+}
+
+// The chunks must cover each index exactly once whether or not they run in
+// parallel.
+void testForEachChunk() {
+    ParallelExecutorOption option;
+    for (int numThreads = 1; numThreads <= 4; numThreads += 3) {
+        option.setNumberOfThreads(numThreads, "testForEachChunk");
+        for (int n : {0, 1, 7, 1000}) {
+            std::vector<std::atomic<int> > hits(n);
+            for (auto& h : hits) h = 0;
+            std::atomic<int> numChunks(0);
+            option.forEachChunk(n, 10, [&](int begin, int end) {
+                SimTK_TEST(0 <= begin && begin < end && end <= n);
+                ++numChunks;
+                for (int i=begin; i < end; ++i) ++hits[i];
+            });
+            for (auto& h : hits) SimTK_TEST(h == 1);
+            SimTK_TEST(numChunks == (n >= 20 ? numThreads : std::min(n,1)));
+        }
+    }
+}
+
 void testResizeThreads() {
     for(int x = 1; x < 100; ++x)
     {
@@ -105,6 +180,9 @@ int main() {
         SimTK_SUBTEST(testParallelExecution);
         SimTK_SUBTEST(testSingleThreadedExecution);
         SimTK_SUBTEST(testResizeThreads);
+        SimTK_SUBTEST(testExceptionIsRethrown);
+        SimTK_SUBTEST(testExecutorOption);
+        SimTK_SUBTEST(testForEachChunk);
     SimTK_END_TEST();
     return 0;
 }
@@ -0,0 +1,145 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Microbenchmark for the per-call overhead of ParallelExecutor with tasks
+that are much shorter than a thread wake-up, like the per-force tasks in
+GeneralForceSubsystem. It also checks that the answers are right, including
+for nested execute() calls. The timings are printed for information only. */
+
+#include "SimTKcommon.h"
+
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Sums the indices, using thread-local partial sums as GeneralForceSubsystem
+// does for its per-thread force accumulators.
+class SumTask : public ParallelExecutor::Task {
+public:
+    explicit SumTask(int workPerIndex) 
+    :   workPerIndex(workPerIndex), total(0) {}
+    void initialize() override {
+        localSum = 0;
+    }
+    void execute(int index) override {
+        // A little floating point work to stand in for a cheap force.
+        Real x = index;
+        for (int k = 0; k < workPerIndex; ++k)
+            x = std::sqrt(x*x + 1) - 1 + index;
+        localSum += index + 0*x;
+    }
+    void finish() override {
+        total += localSum;
+    }
+    long long getTotal() const {return total;}
+    void reset() {total = 0;}
+private:
+    const int workPerIndex;
+    long long total;
+    static thread_local long long localSum;
+};
+/*static*/ thread_local long long SumTask::localSum = 0;
+
+// Each index runs a nested parallel loop on the same executor.
+class NestedTask : public ParallelExecutor::Task {
+public:
+    NestedTask(ParallelExecutor& executor, int innerTimes)
+    :   executor(executor), innerTimes(innerTimes), count(0) {}
+    void execute(int index) override {
+        CountTask inner(count);
+        executor.execute(inner, innerTimes);
+    }
+    int getCount() const {return count;}
+private:
+    class CountTask : public ParallelExecutor::Task {
+    public:
+        explicit CountTask(std::atomic<int>& count) : count(count) {}
+        void execute(int index) override {++count;}
+    private:
+        std::atomic<int>& count;
+    };
+    ParallelExecutor& executor;
+    const int innerTimes;
+    std::atomic<int> count;
+};
+
+static void timeExecute(int numThreads, int times, int workPerIndex) {
+    const int reps = 500;
+    ParallelExecutor executor(numThreads);
+    SumTask task(workPerIndex);
+    const long long expected = (long long)times*(times-1)/2;
+    executor.execute(task, times); // warm up the pool
+    task.reset();
+
+    const double start = realTime();
+    for (int r = 0; r < reps; ++r) {
+        task.reset();
+        executor.execute(task, times);
+        SimTK_TEST(task.getTotal() == expected);
+    }
+    const double elapsed = realTime() - start;
+    cout << "    " << numThreads << " threads, " << times << " tasks of "
+         << workPerIndex << " sqrts: " << fixed << setprecision(2) 
+         << 1e6*elapsed/reps << " us per execute()" << endl;
+}
+
+void benchmarkExecuteOverhead() {
+    const int maxThreads = std::max(2, ParallelExecutor::getNumProcessors());
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+        for (int work = 1; work <= 100; work *= 10)
+            timeExecute(numThreads, 50, work);
+}
+
+void testNestedExecute() {
+    ParallelExecutor executor(4);
+    for (int r = 0; r < 20; ++r) {
+        NestedTask task(executor, 30);
+        executor.execute(task, 10);
+        SimTK_TEST(task.getCount() == 300);
+    }
+}
+
+// Two executors with different sizes share the same pool.
+void testExecutorsShareWork() {
+    ParallelExecutor small(2), large(5);
+    SumTask task(1);
+    for (int r = 0; r < 50; ++r) {
+        task.reset();
+        small.execute(task, 100);
+        SimTK_TEST(task.getTotal() == 4950);
+        task.reset();
+        large.execute(task, 7);
+        SimTK_TEST(task.getTotal() == 21);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelExecutorOverhead");
+        SimTK_SUBTEST(benchmarkExecuteOverhead);
+        SimTK_SUBTEST(testNestedExecute);
+        SimTK_SUBTEST(testExecutorsShareWork);
+    SimTK_END_TEST();
+}
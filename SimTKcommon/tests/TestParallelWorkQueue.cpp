@@ -56,9 +56,34 @@ void testParallelExecution() {
         ASSERT(flags[i] == (i < numFlags-10));
 }
 
+class AppendTask : public ParallelWorkQueue::Task {
+public:
+    AppendTask(Array_<int>& order, int index) : order(order), index(index) {}
+    void execute() override {order.push_back(index);}
+private:
+    Array_<int>& order;
+    int index;
+};
+
+// With one thread the Tasks run one at a time, in the order they were added;
+// push_back would not survive concurrent calls.
+void testSingleThreadedExecution() {
+    const int numTasks = 500;
+    Array_<int> order;
+    order.reserve(numTasks);
+    ParallelWorkQueue queue(10, 1);
+    for (int i = 0; i < numTasks; i++)
+        queue.addTask(new AppendTask(order, i));
+    queue.flush();
+    ASSERT(order.size() == numTasks);
+    for (int i = 0; i < numTasks; i++)
+        ASSERT(order[i] == i);
+}
+
 int main() {
     try {
         testParallelExecution();
+        testSingleThreadedExecution();
     } catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
         return 1;
@@ -162,6 +162,9 @@ private:
 
 class TestSystemGuts : public System::Guts {
 public:
+    explicit TestSystemGuts(bool reverseTopology)
+    :   reverseTopology(reverseTopology) {}
+
     const SystemSubsystem& getSystemSubsystem() const {return syssub;}
     SystemSubsystem& updSystemSubsystem() {return syssub;}
 
@@ -169,6 +172,18 @@ public:
     TestSystemGuts* cloneImpl() const override
     {   return new TestSystemGuts(*this); }
 
+    // Optionally realize the Subsystems' topology last to first, as a
+    // System is free to do (MultibodySystem does its Subsystem 0 last).
+    int realizeTopologyImpl(State& state) const override {
+        if (reverseTopology)
+            for (int i = getNumSubsystems()-1; i >= 0; --i) {
+                const Subsystem& sub = getSubsystem(SubsystemIndex(i));
+                if (sub.getStage(state) < Stage::Topology)
+                    sub.getSubsystemGuts().realizeSubsystemTopology(state);
+            }
+        return 0;
+    }
+
     bool prescribeQImpl(State& state) const override
     {
         return false;
@@ -234,13 +249,14 @@ public:
     }
 
 private:
+    bool            reverseTopology;
     SystemSubsystem syssub;
 };
 
 class TestSystem : public System {
 public:
-    TestSystem() {
-        adoptSystemGuts(new TestSystemGuts());
+    explicit TestSystem(bool reverseTopology=false) {
+        adoptSystemGuts(new TestSystemGuts(reverseTopology));
         adoptSubsystem(updGuts().updSystemSubsystem());
     }
 
@@ -861,9 +877,109 @@ void testOne() {
     }
 }
 
+// Build a small graph of Measures on Variables and check that changing one
+// Variable recomputes only the Measures downstream of it.
+void testMeasureDependencies() {
+    TestSystem sys;
+    TestSubsystem subsys(sys);
+
+    Measure::Variable a(subsys, Stage::Dynamics, 1);
+    Measure::Variable b(subsys, Stage::Dynamics, 2);
+    Measure::Plus  ab(subsys, a, b);             // a+b
+    Measure::Scale twiceA(subsys, 2, a);         // 2a
+    Measure::Plus  chain(subsys, ab, twiceA);    // 3a+b
+    Measure::Time  t(subsys);
+    Measure::Plus  aPlusT(subsys, a, t);         // a+t
+
+    ASSERT(ab.hasPrerequisites() && chain.hasPrerequisites());
+    ASSERT(!a.hasPrerequisites());
+
+    State state = sys.realizeTopology();
+    sys.realize(state, Stage::Dynamics);
+
+    ASSERT(chain.getValue(state) == 5);
+    ASSERT(ab.getNumRecomputations() == 1);
+    ASSERT(twiceA.getNumRecomputations() == 1);
+    ASSERT(chain.getNumRecomputations() == 1);
+
+    // Cached values are reused.
+    ASSERT(chain.getValue(state) == 5);
+    ASSERT(chain.getNumRecomputations() == 1);
+
+    // Changing b invalidates Dynamics stage but should recompute only 
+    // a+b and the chain; 2a doesn't depend on b.
+    b.setValue(state, 5);
+    sys.realize(state, Stage::Dynamics);
+    ASSERT(chain.getValue(state) == 8);
+    ASSERT(ab.getNumRecomputations() == 2);
+    ASSERT(twiceA.getNumRecomputations() == 1);
+    ASSERT(chain.getNumRecomputations() == 2);
+
+    // Changing a recomputes everything.
+    a.setValue(state, 3);
+    ASSERT(chain.getValue(state) == 14);
+    ASSERT(ab.getNumRecomputations() == 3);
+    ASSERT(twiceA.getNumRecomputations() == 2);
+    ASSERT(chain.getNumRecomputations() == 3);
+
+    // Changing time recomputes only what depends on Time stage.
+    ASSERT(aPlusT.getValue(state) == 3);
+    state.setTime(1);
+    sys.realize(state, Stage::Dynamics);
+    ASSERT(aPlusT.getValue(state) == 4);
+    ASSERT(aPlusT.getNumRecomputations() == 2);
+    ASSERT(chain.getValue(state) == 14);
+    ASSERT(chain.getNumRecomputations() == 3);
+
+    // A copy of the State has its own cache entries and dependencies.
+    State copy = state;
+    b.setValue(copy, 0);
+    ASSERT(chain.getValue(copy) == 9);
+    ASSERT(chain.getValue(state) == 14);
+
+    chain.resetNumRecomputations();
+    ASSERT(chain.getNumRecomputations() == 0);
+}
+
+// A Measure whose prerequisite is in a Subsystem whose topology is realized
+// after its own must still be invalidated when the prerequisite changes.
+// Plus and Scale take operands only from their own Subsystem, so the
+// dependencies across Subsystems are declared explicitly.
+void testCrossSubsystemMeasureDependencies() {
+    TestSystem sys(true); // realize topology last Subsystem first
+    TestSubsystem upstream(sys), downstream(sys);
+
+    Measure::Variable a(upstream, Stage::Dynamics, 1);
+    Measure::Variable b(downstream, Stage::Dynamics, 2);
+    Measure::Scale twiceA(upstream, 2, a);
+    Measure::Scale twiceB(downstream, 2, b);
+    twiceA.addPrerequisite(b); // realized before upstream
+    twiceB.addPrerequisite(a); // realized after downstream
+
+    State state = sys.realizeTopology();
+    sys.realize(state, Stage::Dynamics);
+    ASSERT(twiceA.getValue(state) == 2 && twiceB.getValue(state) == 4);
+    ASSERT(twiceA.getNumRecomputations() == 1);
+    ASSERT(twiceB.getNumRecomputations() == 1);
+
+    a.setValue(state, 4);
+    sys.realize(state, Stage::Dynamics);
+    ASSERT(twiceA.getValue(state) == 8 && twiceB.getValue(state) == 4);
+    ASSERT(twiceA.getNumRecomputations() == 2);
+    ASSERT(twiceB.getNumRecomputations() == 2);
+
+    b.setValue(state, 5);
+    sys.realize(state, Stage::Dynamics);
+    ASSERT(twiceA.getValue(state) == 8 && twiceB.getValue(state) == 10);
+    ASSERT(twiceA.getNumRecomputations() == 3);
+    ASSERT(twiceB.getNumRecomputations() == 3);
+}
+
 int main() {
     try {
         testOne();
+        testMeasureDependencies();
+        testCrossSubsystemMeasureDependencies();
     } catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
         return 1;
@@ -0,0 +1,272 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+const SubsystemIndex Sub0(0), Sub1(1);
+const char* ChkFile = "TestStateCheckpoint.chk";
+
+// Advance State by one stage from stage-1 to stage.
+void advanceStage(State& state, Stage stage) {
+    for (SubsystemIndex sx(0); sx <state.getNumSubsystems(); ++sx)
+        state.advanceSubsystemToStage(sx, stage);
+    state.advanceSystemToStage(stage);
+}
+
+// Discrete variable indices; they are the same in every State made by
+// makeState().
+struct Vars {
+    DiscreteVariableIndex modelInt, mass, point, gains, flags, name;
+};
+
+// Build a State the way a System would, with two subsystems, some continuous
+// variables, event triggers, and discrete variables of several types
+// including one (String) that can't be checkpointed. It is left at
+// Stage::Model.
+State makeState(Vars& vars, int nz = 4) {
+    State s;
+    s.setNumSubsystems(2);
+    s.initializeSubsystem(Sub0, "first", "1.0");
+    s.initializeSubsystem(Sub1, "second", "2.0");
+    s.allocateQ(Sub0, Vector(3, Real(1)));
+    s.allocateU(Sub0, Vector(2, Real(2)));
+    s.allocateZ(Sub1, Vector(nz, Real(3)));
+    s.allocateQ(Sub1, Vector(1, Real(4)));
+    vars.modelInt = s.allocateDiscreteVariable(Sub0, Stage::Model,
+                                               new Value<int>(7));
+    vars.mass  = s.allocateDiscreteVariable(Sub0, Stage::Instance,
+                                            new Value<Real>(1));
+    vars.point = s.allocateDiscreteVariable(Sub1, Stage::Dynamics,
+                                            new Value<Vec3>(Vec3(0)));
+    vars.gains = s.allocateDiscreteVariable(Sub1, Stage::Dynamics,
+                                            new Value<Vector>(Vector(2, 0.)));
+    vars.flags = s.allocateDiscreteVariable(Sub1, Stage::Instance,
+                        new Value<Array_<bool> >(Array_<bool>(3, false)));
+    vars.name  = s.allocateDiscreteVariable(Sub0, Stage::Instance,
+                                            new Value<String>("default"));
+    s.allocateEventTrigger(Sub1, Stage::Position, 2);
+    advanceStage(s, Stage::Topology);
+    advanceStage(s, Stage::Model);
+    return s;
+}
+
+// Checkpoints are exact, so compare without tolerance.
+bool same(const Vector& a, const Vector& b) {
+    if (a.size() != b.size()) return false;
+    for (int i=0; i < a.size(); ++i)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+
+void realizeToAcceleration(State& s) {
+    for (Stage g = s.getSystemStage().next(); g <= Stage::Acceleration;
+         g = g.next())
+        advanceStage(s, g);
+}
+}
+
+void testRoundTrip() {
+    Vars vars;
+    State saved = makeState(vars);
+    saved.setTime(12.5);
+    for (int i=0; i < saved.getNQ(); ++i) saved.updQ()[i] = std::sin(i+1.);
+    for (int i=0; i < saved.getNU(); ++i) saved.updU()[i] = 1/(i+3.);
+    for (int i=0; i < saved.getNZ(); ++i) saved.updZ()[i] = -Pi*i;
+    Value<Real>::updDowncast(saved.updDiscreteVariable(Sub0, vars.mass)) = 2.5;
+    Value<Vec3>::updDowncast(saved.updDiscreteVariable(Sub1, vars.point))
+        = Vec3(1,2,3);
+    Vector gains(5); for (int i=0; i < 5; ++i) gains[i] = i*i;
+    Value<Vector>::updDowncast(saved.updDiscreteVariable(Sub1, vars.gains))
+        = gains;
+    Value<Array_<bool> >::updDowncast
+        (saved.updDiscreteVariable(Sub1, vars.flags)).upd()[1] = true;
+    Value<String>::updDowncast(saved.updDiscreteVariable(Sub0, vars.name))
+        = "changed";
+    realizeToAcceleration(saved);
+    saved.updEventTriggers()[0] = 0.25; saved.updEventTriggers()[1] = -1;
+
+    // The String variable can't be saved, so it must be skipped explicitly.
+    SimTK_TEST_MUST_THROW(StateCheckpoint::write(saved, ChkFile));
+    SimTK_TEST(StateCheckpoint::write(saved, ChkFile, true) == 1);
+
+    Vars vars2;
+    State restored = makeState(vars2);
+    StateCheckpoint chk(ChkFile);
+    SimTK_TEST(chk.getTime() == 12.5);
+    SimTK_TEST(chk.isCompatible(restored));
+    chk.restore(restored);
+
+    SimTK_TEST(restored.getTime() == 12.5);
+    SimTK_TEST(same(restored.getQ(), saved.getQ())); // exact
+    SimTK_TEST(same(restored.getU(), saved.getU()));
+    SimTK_TEST(same(restored.getZ(), saved.getZ()));
+    SimTK_TEST(Value<Real>::downcast
+        (restored.getDiscreteVariable(Sub0, vars.mass)).get() == 2.5);
+    SimTK_TEST(Value<Vec3>::downcast
+        (restored.getDiscreteVariable(Sub1, vars.point)).get() == Vec3(1,2,3));
+    SimTK_TEST(same(Value<Vector>::downcast
+        (restored.getDiscreteVariable(Sub1, vars.gains)).get(), gains));
+    const Array_<bool>& flags = Value<Array_<bool> >::downcast
+        (restored.getDiscreteVariable(Sub1, vars.flags)).get();
+    SimTK_TEST(flags.size() == 3 && !flags[0] && flags[1] && !flags[2]);
+    SimTK_TEST(Value<String>::downcast
+        (restored.getDiscreteVariable(Sub0, vars.name)).get() == "default");
+
+    // The State's variables were changed so it must be realized again.
+    SimTK_TEST(restored.getSystemStage() < Stage::Instance);
+
+    // A checkpoint can be restored more than once. Once the discrete
+    // variables match they are left alone so Instance stage stays valid,
+    // and then the event triggers are restored too.
+    advanceStage(restored, Stage::Instance);
+    chk.restore(restored);
+    SimTK_TEST(restored.getSystemStage() == Stage::Instance);
+    SimTK_TEST(same(restored.getQ(), saved.getQ()));
+    SimTK_TEST(restored.updEventTriggers()[0] == 0.25);
+    SimTK_TEST(restored.updEventTriggers()[1] == -1);
+}
+
+void testIncompatible() {
+    Vars vars;
+    State saved = makeState(vars);
+    StateCheckpoint::write(saved, ChkFile, true);
+    StateCheckpoint chk(ChkFile);
+
+    // Different number of z's.
+    State other = makeState(vars, 5);
+    SimTK_TEST(!chk.isCompatible(other));
+    SimTK_TEST_MUST_THROW(chk.restore(other));
+
+    // Different subsystem name.
+    State renamed = makeState(vars);
+    renamed.initializeSubsystem(Sub1, "renamed", "2.0");
+    SimTK_TEST(!chk.isCompatible(renamed));
+
+    // A Model-stage variable differs; nothing should be changed.
+    State model = makeState(vars);
+    Value<int>::updDowncast(model.updDiscreteVariable(Sub0, vars.modelInt))
+        = 8;
+    advanceStage(model, Stage::Model);
+    model.updQ()[0] = 99;
+    SimTK_TEST(chk.isCompatible(model));
+    SimTK_TEST_MUST_THROW(chk.restore(model));
+    SimTK_TEST(model.getQ()[0] == 99);
+
+    // Not realized far enough.
+    State empty;
+    SimTK_TEST_MUST_THROW(StateCheckpoint::write(empty, ChkFile));
+}
+
+void testBadFiles() {
+    SimTK_TEST_MUST_THROW(StateCheckpoint("no/such/checkpoint.chk"));
+
+    { ofstream out(ChkFile, ios::binary); out << "not a checkpoint file"; }
+    SimTK_TEST_MUST_THROW(StateCheckpoint chk(ChkFile));
+
+    // Truncated.
+    Vars vars;
+    State saved = makeState(vars);
+    StateCheckpoint::write(saved, ChkFile, true);
+    ifstream in(ChkFile, ios::binary);
+    const string contents((istreambuf_iterator<char>(in)),
+                          istreambuf_iterator<char>());
+    in.close();
+    { ofstream out(ChkFile, ios::binary);
+      out.write(contents.data(), contents.size()-8); }
+    SimTK_TEST_MUST_THROW(StateCheckpoint chk(ChkFile));
+
+    // A Vector record whose element count doesn't match its size. The
+    // header is fine so this is only caught by restore(), which must not
+    // change anything.
+    Vector gains(3); gains[0] = 0.5; gains[1] = 1.5; gains[2] = 2.5;
+    Value<Vector>::updDowncast(saved.updDiscreteVariable(Sub1, vars.gains))
+        = gains;
+    StateCheckpoint::write(saved, ChkFile, true);
+    { ifstream in2(ChkFile, ios::binary);
+      string bytes((istreambuf_iterator<char>(in2)),
+                   istreambuf_iterator<char>());
+      in2.close();
+      const std::uint64_t count = 3;
+      string pattern(reinterpret_cast<const char*>(&count), sizeof(count));
+      pattern.append(reinterpret_cast<const char*>(&gains[0]), sizeof(Real));
+      const size_t at = bytes.find(pattern);
+      SimTK_TEST(at != string::npos);
+      const std::uint64_t tooMany = 4;
+      bytes.replace(at, sizeof(tooMany),
+                    reinterpret_cast<const char*>(&tooMany), sizeof(tooMany));
+      ofstream out(ChkFile, ios::binary);
+      out.write(bytes.data(), bytes.size()); }
+    { StateCheckpoint corrupt(ChkFile);
+      State target = makeState(vars);
+      target.updQ()[0] = 99;
+      SimTK_TEST_MUST_THROW(corrupt.restore(target));
+      SimTK_TEST(target.getQ()[0] == 99);
+      SimTK_TEST(Value<Vector>::downcast
+          (target.getDiscreteVariable(Sub1, vars.gains)).get().size() == 2); }
+
+    // A record naming a subsystem, then a discrete variable, that the State
+    // doesn't have. The record header (subsystem, index, type code, reserved,
+    // all uint32, then the uint64 size) immediately precedes the payload.
+    const size_t recordHeaderSize = 4*sizeof(std::uint32_t)
+                                    + sizeof(std::uint64_t);
+    for (int field=0; field < 2; ++field) {
+        StateCheckpoint::write(saved, ChkFile, true);
+        ifstream in2(ChkFile, ios::binary);
+        string bytes((istreambuf_iterator<char>(in2)),
+                     istreambuf_iterator<char>());
+        in2.close();
+        const std::uint64_t count = 3;
+        string pattern(reinterpret_cast<const char*>(&count), sizeof(count));
+        pattern.append(reinterpret_cast<const char*>(&gains[0]), sizeof(Real));
+        const size_t at = bytes.find(pattern);
+        SimTK_TEST(at != string::npos && at >= recordHeaderSize);
+        const std::uint32_t bogus = 1000;
+        bytes.replace(at - recordHeaderSize + field*sizeof(bogus), 
+                      sizeof(bogus), 
+                      reinterpret_cast<const char*>(&bogus), sizeof(bogus));
+        { ofstream out(ChkFile, ios::binary);
+          out.write(bytes.data(), bytes.size()); }
+        StateCheckpoint corrupt(ChkFile);
+        State target = makeState(vars);
+        SimTK_TEST_MUST_THROW(corrupt.restore(target));
+    }
+
+    std::remove(ChkFile);
+}
+
+int main() {
+    SimTK_START_TEST("TestStateCheckpoint");
+        SimTK_SUBTEST(testRoundTrip);
+        SimTK_SUBTEST(testIncompatible);
+        SimTK_SUBTEST(testBadFiles);
+    SimTK_END_TEST();
+}
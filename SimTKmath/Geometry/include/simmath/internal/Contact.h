@@ -493,6 +493,14 @@ public:
                         const Transform&        X_S1S2,
                         const std::set<int>&    faces1, 
                         const std::set<int>&    faces2);
+    /** Same as above, but takes over the contents of the face sets instead 
+    of copying them. Contact trackers use this to avoid duplicating large
+    sets of buried faces. **/
+    TriangleMeshContact(ContactSurfaceIndex     surf1, 
+                        ContactSurfaceIndex     surf2,
+                        const Transform&        X_S1S2,
+                        std::set<int>&&         faces1, 
+                        std::set<int>&&         faces2);
 
     /** Get the indices of all faces of surface1 that are partly or completely 
     inside surface2. If surface1 is not a TriangleMesh, this will return an 
@@ -1267,6 +1267,25 @@ may return any of them.
 specified point. **/
 Vec3 findNearestPoint(const Vec3& position, bool& inside, int& face, Vec2& uv) const;
 
+/** This is the same as findNearestPoint(position,inside,face,uv) except that
+the search is warm-started from a face that is expected to be near the answer,
+typically the face found by a previous call for a nearby point. The distance
+to that face bounds the search, so a good hint lets most of the mesh be 
+skipped; the answer does not depend on the hint (other than the choice among
+equally near points). 
+@param position    The point in question.
+@param hintFace    The face to start from, or -1 for no hint.
+@param inside      On exit, this is set to true if the specified point is 
+                   inside this object, false otherwise.
+@param face        On exit, this contains the index of the face containing the 
+                   returned point.
+@param uv          On exit, this contains the barycentric coordinates (u and v)
+                   of the returned point within its face.
+@return The point on the surface of the object which is closest to the 
+specified point. **/
+Vec3 findNearestPoint(const Vec3& position, int hintFace, bool& inside, 
+                      int& face, Vec2& uv) const;
+
 /** Given a point and a face of this object, find the point of the face that is
 nearest the given point. If multiple points on the face are equally close to 
 the specified point, this may return any of them.
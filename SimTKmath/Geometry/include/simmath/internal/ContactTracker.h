@@ -291,12 +291,12 @@ bool trackContact
     Contact&               currentStatus) const override;
 
 private:
-void processBox(const ContactGeometry::TriangleMesh&              mesh, 
+void processBox(const ContactGeometry::TriangleMesh::Impl&        mesh, 
                 const ContactGeometry::TriangleMesh::OBBTreeNode& node, 
                 const Transform& X_HM, const UnitVec3& hsNormal_M, 
-                Real hsFaceHeight_M, std::set<int>& insideFaces) const;
+                Real hsFaceHeight_M, Array_<int>& insideFaces) const;
 void addAllTriangles(const ContactGeometry::TriangleMesh::OBBTreeNode& node, 
-                     std::set<int>& insideFaces) const; 
+                     Array_<int>& insideFaces) const; 
 };
 
 
@@ -370,11 +370,10 @@ void findBuriedFaces
     const Transform&                        X_OM, 
     std::set<int>&                          insideFaces) const;
 
-void tagFaces(const ContactGeometry::TriangleMesh&   mesh, 
-              Array_<int>&                           faceType,
-              std::set<int>&                         triangles, 
-              int                                    index,
-              int                                    depth) const;
+void tagFaces(const ContactGeometry::TriangleMesh::Impl& mesh, 
+              Array_<int>&                               faceType,
+              Array_<int>&                               stack, 
+              int                                        index) const;
 };
 
 
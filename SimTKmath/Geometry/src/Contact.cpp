@@ -233,6 +233,14 @@ TriangleMeshContact::TriangleMeshContact
 :   Contact(new TriangleMeshContactImpl(surf1, surf2, X_S1S2, 
                                         faces1, faces2)) {}
 
+TriangleMeshContact::TriangleMeshContact
+   (ContactSurfaceIndex surf1, ContactSurfaceIndex surf2,
+    const Transform& X_S1S2,
+    std::set<int>&& faces1, std::set<int>&& faces2) 
+:   Contact(new TriangleMeshContactImpl(surf1, surf2, X_S1S2, 
+                                        std::move(faces1), 
+                                        std::move(faces2))) {}
+
 const set<int>& TriangleMeshContact::getSurface1Faces() const 
 {   return getImpl().faces1; }
 const set<int>& TriangleMeshContact::getSurface2Faces() const 
@@ -251,6 +259,13 @@ TriangleMeshContactImpl::TriangleMeshContactImpl
     const set<int>& faces1, const set<int>& faces2) 
 :   ContactImpl(surf1, surf2, X_S1S2), faces1(faces1), faces2(faces2) {}
 
+TriangleMeshContactImpl::TriangleMeshContactImpl
+   (ContactSurfaceIndex surf1, ContactSurfaceIndex surf2,
+    const Transform& X_S1S2,
+    set<int>&& faces1, set<int>&& faces2) 
+:   ContactImpl(surf1, surf2, X_S1S2), 
+    faces1(std::move(faces1)), faces2(std::move(faces2)) {}
+
 
 
 
@@ -1024,6 +1024,8 @@ public:
     UnitVec3 findNormalAtPoint(int face, const Vec2& uv) const;
     Vec3 findNearestPoint(const Vec3& position, bool& inside, int& face, 
                           Vec2& uv) const;
+    Vec3 findNearestPoint(const Vec3& position, int hintFace, bool& inside, 
+                          int& face, Vec2& uv) const;
     Vec3 findNearestPointToFace(const Vec3& position, int face, Vec2& uv) const;
     void createPolygonalMesh(PolygonalMesh& mesh) const;
 
@@ -1040,6 +1042,13 @@ public:
     bool isConvex() const override {return false;}
     bool isFinite() const override {return true;}
 
+    // Inline accessors for the contact trackers' inner loops; these skip the
+    // out-of-line calls made through the ContactGeometry::TriangleMesh handle.
+    inline const Vec3& getVertexPosition(int vertex) const;
+    inline int getFaceVertex(int face, int vertex) const;
+    // Return the face on the other side of edge 0, 1, or 2 of a face.
+    int getAdjacentFace(int face, int edge) const
+    {   return adjacentFaces[3*face+edge]; }
 
     static ContactGeometryTypeId classTypeId() {
         static const ContactGeometryTypeId id = 
@@ -1060,6 +1069,7 @@ private:
     Array_<Edge>    edges;
     Array_<Face>    faces;
     Array_<Vertex>  vertices;
+    Array_<int>     adjacentFaces; // 3 per face, in face edge order
     Vec3            boundingSphereCenter;
     Real            boundingSphereRadius;
     OBBTreeNodeImpl obb;
@@ -1118,6 +1128,14 @@ public:
     int         firstEdge;
 };
 
+inline const Vec3& ContactGeometry::TriangleMesh::Impl::
+getVertexPosition(int vertex) const
+{   return vertices[vertex].pos; }
+
+inline int ContactGeometry::TriangleMesh::Impl::
+getFaceVertex(int face, int vertex) const
+{   return faces[face].vertices[vertex]; }
+
 
 
 //==============================================================================
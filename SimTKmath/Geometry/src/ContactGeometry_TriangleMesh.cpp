@@ -166,6 +166,10 @@ Vec3 ContactGeometry::TriangleMesh::findNearestPoint
     return getImpl().findNearestPoint(position, inside, face, uv);
 }
 
+Vec3 ContactGeometry::TriangleMesh::findNearestPoint
+   (const Vec3& position, int hintFace, bool& inside, int& face, Vec2& uv) const
+{   return getImpl().findNearestPoint(position, hintFace, inside, face, uv); }
+
 Vec3 ContactGeometry::TriangleMesh::findNearestPointToFace
    (const Vec3& position, int face, Vec2& uv) const {
     return getImpl().findNearestPointToFace(position, face, uv);
@@ -263,6 +267,33 @@ findNearestPoint(const Vec3& position, bool& inside, int& face, Vec2& uv) const
     return nearestPoint;
 }
 
+Vec3 ContactGeometry::TriangleMesh::Impl::
+findNearestPoint(const Vec3& position, int hintFace, bool& inside, int& face, 
+                 Vec2& uv) const 
+{
+    if (hintFace < 0 || hintFace >= (int) faces.size())
+        return findNearestPoint(position, inside, face, uv);
+
+    // Nothing farther than the hint face can be the answer, so only search
+    // the boxes that come closer than that. The cutoff is widened slightly
+    // so that points the tree would consider tied are still examined.
+    Vec2 hintUV;
+    const Vec3 hintPoint = findNearestPointToFace(position, hintFace, hintUV);
+    const Real hintDistance2 = (hintPoint-position).normSqr();
+    const Real cutoff2 = hintDistance2*(1+1000*Eps) + LeastPositiveReal;
+    Real distance2;
+    Vec3 nearestPoint = obb.findNearestPoint(*this, position, cutoff2, 
+                                             distance2, face, uv);
+    if (distance2 == MostPositiveReal) { // can only happen through roundoff
+        nearestPoint = hintPoint;
+        face = hintFace;
+        uv = hintUV;
+    }
+    Vec3 delta = position-nearestPoint;
+    inside = (~delta*faces[face].normal < 0);
+    return nearestPoint;
+}
+
 bool ContactGeometry::TriangleMesh::Impl::
 intersectsRay(const Vec3& origin, const UnitVec3& direction, Real& distance, 
               UnitVec3& normal) const {
@@ -500,6 +531,16 @@ void ContactGeometry::TriangleMesh::Impl::init
         }
     }
     
+    // Record the neighboring face across each edge of each face.
+
+    adjacentFaces.resize(3*faces.size());
+    for (int i = 0; i < (int) faces.size(); i++)
+        for (int j = 0; j < 3; j++) {
+            const Edge& edge = edges[faces[i].edges[j]];
+            adjacentFaces[3*i+j] = 
+                (edge.faces[0] == i ? edge.faces[1] : edge.faces[0]);
+        }
+    
     // Record a single edge for each vertex.
     
     for (int i = 0; i < (int) edges.size(); i++) {
@@ -802,7 +843,7 @@ Vec3 OBBTreeNodeImpl::findNearestPoint
         
         Real child1distance2 = MostPositiveReal, 
              child2distance2 = MostPositiveReal;
-        int child1face, child2face;
+        int child1face = -1, child2face = -1;
         Vec2 child1uv, child2uv;
         Vec3 child1point, child2point;
         Real child1BoundsDist2 = 
@@ -823,7 +864,9 @@ Vec3 OBBTreeNodeImpl::findNearestPoint
                     child1point = child1->findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
             }
         }
-        if (   child1distance2 <= child2distance2*(1+tol) 
+        // Both children may have been cut off if a cutoff was given.
+        if (   child1distance2 < MostPositiveReal
+            && child1distance2 <= child2distance2*(1+tol) 
             && child2distance2 <= child1distance2*(1+tol)) {
             // Decide based on angle which one to use.
             
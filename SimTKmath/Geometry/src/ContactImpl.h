@@ -240,6 +240,11 @@ public:
                             const Transform&        X_S1S2,
                             const std::set<int>&    faces1, 
                             const std::set<int>&    faces2);
+    TriangleMeshContactImpl(ContactSurfaceIndex     surf1, 
+                            ContactSurfaceIndex     surf2,
+                            const Transform&        X_S1S2,
+                            std::set<int>&&         faces1, 
+                            std::set<int>&&         faces2);
 
     ContactTypeId getTypeId() const override {return classTypeId();}
     static ContactTypeId classTypeId() {
@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "SimTKmath.h"
+#include "ContactGeometryImpl.h"
 
 #include <algorithm>
 using std::pair; using std::make_pair;
@@ -806,8 +807,11 @@ bool ContactTracker::HalfSpaceTriangleMesh::trackContact
     const Real hsFaceHeight_M = dot((~X_HM).p(), hsNormal_M);
     // Now collect all the faces that are all or partially below the 
     // halfspace surface.
-    std::set<int> insideFaces;
-    processBox(mesh, mesh.getOBBTreeNode(), X_HM, 
+    // Each face lives in exactly one leaf of the OBB tree, so the list has
+    // no duplicates. Sorting it lets the set be built in linear time rather
+    // than with one tree search per face.
+    Array_<int> insideFaces;
+    processBox(mesh.getImpl(), mesh.getOBBTreeNode(), X_HM, 
                hsNormal_M, hsFaceHeight_M, insideFaces);
     
     if (insideFaces.empty()) {
@@ -815,10 +819,12 @@ bool ContactTracker::HalfSpaceTriangleMesh::trackContact
         return true; // successful return
     }
     
+    std::sort(insideFaces.begin(), insideFaces.end());
     currentStatus = TriangleMeshContact(priorStatus.getSurface1(), 
                                         priorStatus.getSurface2(), 
-                                        X_HM, 
-                                        std::set<int>(), insideFaces);
+                                        X_HM, std::set<int>(), 
+                                        std::set<int>(insideFaces.begin(),
+                                                      insideFaces.end()));
     return true; // success
 }
 
@@ -826,10 +832,10 @@ bool ContactTracker::HalfSpaceTriangleMesh::trackContact
 // Check a single OBB and its contents (recursively) against the halfspace,
 // appending any penetrating faces to the insideFaces list.
 void ContactTracker::HalfSpaceTriangleMesh::processBox
-   (const ContactGeometry::TriangleMesh&              mesh, 
+   (const ContactGeometry::TriangleMesh::Impl&        mesh, 
     const ContactGeometry::TriangleMesh::OBBTreeNode& node, 
     const Transform& X_HM, const UnitVec3& hsNormal_M, Real hsFaceHeight_M, 
-    std::set<int>& insideFaces) const 
+    Array_<int>& insideFaces) const 
 {   // First check against the node's bounding box.
     
     const OrientedBoundingBox& bounds = node.getBounds();
@@ -876,7 +882,7 @@ void ContactTracker::HalfSpaceTriangleMesh::processBox
             const Vec3& vertexPos      = mesh.getVertexPosition(vertex);
             const Real  vertexHeight_M = dot(vertexPos, hsNormal_M);
             if (vertexHeight_M < hsFaceHeight_M) {
-                insideFaces.insert(triangles[i]);
+                insideFaces.push_back(triangles[i]);
                 break; // done with this face
             }
         }
@@ -885,12 +891,12 @@ void ContactTracker::HalfSpaceTriangleMesh::processBox
 
 void ContactTracker::HalfSpaceTriangleMesh::addAllTriangles
    (const ContactGeometry::TriangleMesh::OBBTreeNode& node, 
-    std::set<int>& insideFaces) const 
+    Array_<int>& insideFaces) const 
 {
     if (node.isLeafNode()) {
         const Array_<int>& triangles = node.getTriangles();
-        for (int i = 0; i < (int) triangles.size(); i++)
-            insideFaces.insert(triangles[i]);
+        insideFaces.insert(insideFaces.end(), 
+                           triangles.begin(), triangles.end());
     }
     else {
         addAllTriangles(node.getFirstChildNode(), insideFaces);
@@ -944,8 +950,8 @@ bool ContactTracker::SphereTriangleMesh::trackContact
     
     currentStatus = TriangleMeshContact(priorStatus.getSurface1(), 
                                         priorStatus.getSurface2(), 
-                                        X_SM, 
-                                        std::set<int>(), insideFaces);
+                                        X_SM, std::set<int>(), 
+                                        std::move(insideFaces));
     return true; // success
 }
 
@@ -1044,7 +1050,8 @@ bool ContactTracker::TriangleMeshTriangleMesh::trackContact
     currentStatus = TriangleMeshContact(priorStatus.getSurface1(), 
                                         priorStatus.getSurface2(), 
                                         X_M1M2, 
-                                        insideFaces1, insideFaces2);
+                                        std::move(insideFaces1), 
+                                        std::move(insideFaces2));
     return true; // success
 }
 
@@ -1094,19 +1101,21 @@ findIntersectingFaces
     
     // These are both leaf nodes, so check triangles for intersections.
     
+    const ContactGeometry::TriangleMesh::Impl& mesh1Impl = mesh1.getImpl();
+    const ContactGeometry::TriangleMesh::Impl& mesh2Impl = mesh2.getImpl();
     const Array_<int>& node1triangles = node1.getTriangles();
     const Array_<int>& node2triangles = node2.getTriangles();
     for (unsigned i = 0; i < node2triangles.size(); i++) {
         const int face2 = node2triangles[i];
-        Vec3 a1 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 0));
-        Vec3 a2 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 1));
-        Vec3 a3 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 2));
+        Vec3 a1 = X_M1M2*mesh2Impl.getVertexPosition(mesh2Impl.getFaceVertex(face2, 0));
+        Vec3 a2 = X_M1M2*mesh2Impl.getVertexPosition(mesh2Impl.getFaceVertex(face2, 1));
+        Vec3 a3 = X_M1M2*mesh2Impl.getVertexPosition(mesh2Impl.getFaceVertex(face2, 2));
         const Geo::Triangle A(a1,a2,a3);
         for (unsigned j = 0; j < node1triangles.size(); j++) {
             const int face1 = node1triangles[j];
-            const Vec3& b1 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 0));
-            const Vec3& b2 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 1));
-            const Vec3& b3 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 2));
+            const Vec3& b1 = mesh1Impl.getVertexPosition(mesh1Impl.getFaceVertex(face1, 0));
+            const Vec3& b2 = mesh1Impl.getVertexPosition(mesh1Impl.getFaceVertex(face1, 1));
+            const Vec3& b3 = mesh1Impl.getVertexPosition(mesh1Impl.getFaceVertex(face1, 2));
             const Geo::Triangle B(b1,b2,b3);
             if (A.overlapsTriangle(B)) 
             {   // The triangles intersect.
@@ -1131,11 +1140,13 @@ findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M
     // Find which faces are inside.
     // We're passed in the list of Boundary faces, that is, those faces of
     // "mesh" that intersect faces of "otherMesh".
+    const ContactGeometry::TriangleMesh::Impl& meshImpl = mesh.getImpl();
     Array_<int> faceType(mesh.getNumFaces(), Unknown);
     for (std::set<int>::iterator iter = insideFaces.begin(); 
                                  iter != insideFaces.end(); ++iter)
         faceType[*iter] = Boundary;
 
+    Array_<int> stack;
     for (int i = 0; i < (int) faceType.size(); i++) {
         if (faceType[i] == Unknown) {
             // Trace a ray from its center to determine whether it is inside.           
@@ -1147,43 +1158,45 @@ findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M
             if (   otherMesh.intersectsRay(origin_O, direction_O, distance, 
                                            face, uv) 
                 && ~direction_O*otherMesh.getFaceNormal(face) > 0) 
-            {
                 faceType[i] = Inside;
-                insideFaces.insert(i);
-            } else
+            else
                 faceType[i] = Outside;
             
-            // Recursively mark adjacent inside or outside Faces.           
-            tagFaces(mesh, faceType, insideFaces, i, 0);
+            // Mark the whole region bounded by Boundary faces the same way,
+            // so there is only one ray test per region.
+            tagFaces(meshImpl, faceType, stack, i);
         }
     }
-}
 
-//TODO: the following method uses depth-first recursion to iterate through
-//unmarked faces. For a large mesh this was observed to produce a stack
-//overflow in OpenSim. Here we limit the recursion depth; after we get that
-//deep we'll pop back out and do another expensive intersectsRay() test in
-//the method above.
-static const int MaxRecursionDepth = 500;
+    // Every Boundary and Inside face is now marked; rebuild the set in 
+    // increasing order so each insertion goes at the end.
+    insideFaces.clear();
+    for (int i = 0; i < (int) faceType.size(); i++)
+        if (faceType[i] > 0)
+            insideFaces.insert(insideFaces.end(), i);
+}
 
+// Flood fill from face "index" to every face reachable from it without
+// crossing a Boundary face, giving them the same type. This uses an explicit
+// stack since recursion could overflow the call stack for a large mesh.
 void ContactTracker::TriangleMeshTriangleMesh::
-tagFaces(const ContactGeometry::TriangleMesh&   mesh, 
-         Array_<int>&                           faceType,
-         std::set<int>&                         triangles, 
-         int                                    index,
-         int                                    depth) const 
+tagFaces(const ContactGeometry::TriangleMesh::Impl& mesh, 
+         Array_<int>&                               faceType,
+         Array_<int>&                               stack, 
+         int                                        index) const 
 {
-    for (int i = 0; i < 3; i++) {
-        const int edge = mesh.getFaceEdge(index, i);
-        const int face = (mesh.getEdgeFace(edge, 0) == index 
-                            ? mesh.getEdgeFace(edge, 1) 
-                            : mesh.getEdgeFace(edge, 0));
-        if (faceType[face] == Unknown) {
-            faceType[face] = faceType[index];
-            if (faceType[index] > 0)
-                triangles.insert(face);
-            if (depth < MaxRecursionDepth)
-                tagFaces(mesh, faceType, triangles, face, depth+1);
+    const int type = faceType[index];
+    stack.clear();
+    stack.push_back(index);
+    while (!stack.empty()) {
+        const int current = stack.back();
+        stack.pop_back();
+        for (int i = 0; i < 3; i++) {
+            const int face = mesh.getAdjacentFace(current, i);
+            if (faceType[face] == Unknown) {
+                faceType[face] = type;
+                stack.push_back(face);
+            }
         }
     }
 }
@@ -73,6 +73,21 @@ public:
      * again with a larger value will fail.
      */
     void setOrderLimit(int order);
+    /**
+     * Ask the System for its state derivative Jacobian (see 
+     * System::calcStateDerivativeJacobian()) to form the Newton iteration
+     * matrix, rather than approximating it by finite differences, which takes
+     * one evaluation of the state derivatives per state variable. This pays
+     * off for large stiff systems, such as those with stiff compliant contact,
+     * but the System's Jacobian may be only an approximation so the iteration
+     * may need more steps to converge. If the System can't supply a Jacobian
+     * finite differences are used anyway. The default is false.
+     * 
+     * This method must be invoked before the integrator is initialized.
+     */
+    void setUseAnalyticJacobian(bool useAnalytic);
+    /** Return the value set by setUseAnalyticJacobian(). **/
+    bool getUseAnalyticJacobian() const;
 };
 
 } // namespace SimTK
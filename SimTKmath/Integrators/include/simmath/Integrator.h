@@ -396,6 +396,15 @@ public:
     /// constraint manifold after interpolation is performed. The default is
     /// "true".
     void setProjectInterpolatedStates(bool shouldProject);
+    /// Set whether interpolated states returned at report times should be
+    /// realized through Velocity stage (and projected, see
+    /// setProjectInterpolatedStates()). If this is false, such a state has
+    /// only its time and continuous variables set, which is much cheaper when
+    /// reports are frequent; anyone who needs more can realize it with
+    /// System::realize(), but it won't be projected and any prescribed motion
+    /// will have been interpolated rather than evaluated. Interpolated states
+    /// used for event handling are always realized. The default is "true".
+    void setRealizeInterpolatedStates(bool shouldRealize);
     /// (Advanced) Constraint projection may use an out-of-date iteration
     /// matrix for efficiency. You can force strict use of a current iteration
     /// matrix recomputed at each iteration if you want.
@@ -0,0 +1,74 @@
+#ifndef SimTK_SIMMATH_MULTIRATE_INTEGRATOR_H_
+#define SimTK_SIMMATH_MULTIRATE_INTEGRATOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+
+class MultirateIntegratorRep;
+
+/**
+ * This is an error controlled, explicit multirate Integrator for Systems in
+ * which some forces are expensive but change slowly, while others are cheap
+ * but stiff, such as compliant contact. The System's slow forces (see
+ * System::holdSlowForces(); in a MultibodySystem these are the force elements
+ * and force subsystems that have been marked slow) are evaluated once at the
+ * start of each step and then held at those values while the step is taken
+ * as a number of equal substeps of the 3rd order Runge-Kutta method used by
+ * RungeKutta3Integrator. The error estimate is the sum of the substeps' error
+ * estimates, so the step size is chosen to resolve the fast forces with the
+ * substeps, and the slow forces are evaluated once for every setNumSubsteps()
+ * substeps rather than three times per substep.
+ *
+ * Holding the slow forces constant across a step makes the method only first
+ * order accurate in the step size, so the error this causes is estimated by
+ * recalculating the slow forces at the end of each step, and is included in
+ * the error estimate that controls the step size. Those end-of-step slow
+ * forces are then held during the next step. If the slow forces change
+ * quickly the steps will be short, so this integrator only pays off when the
+ * slow forces really do change little over a step. If the System has no slow forces this is simply
+ * RungeKutta3Integrator with a step divided into substeps, and is third
+ * order.
+ */
+class SimTK_SIMMATH_EXPORT MultirateIntegrator : public Integrator {
+public:
+    explicit MultirateIntegrator(const System& sys);
+    /**
+     * Set the number of substeps into which each step is divided for the
+     * fast forces. This is the number of times the fast forces are evaluated
+     * (three times per substep) for each evaluation of the slow forces. The
+     * default is 10.
+     */
+    void setNumSubsteps(int numSubsteps);
+    /** Return the value set by setNumSubsteps(). **/
+    int getNumSubsteps() const;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_MULTIRATE_INTEGRATOR_H_
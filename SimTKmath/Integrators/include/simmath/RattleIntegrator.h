@@ -0,0 +1,93 @@
+#ifndef SimTK_SIMMATH_RATTLE_INTEGRATOR_H_
+#define SimTK_SIMMATH_RATTLE_INTEGRATOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+
+class RattleIntegratorRep;
+
+/** This is a fixed-step, second order, time-reversible integrator for
+long-duration simulations of conservative systems with holonomic constraints,
+based on the RATTLE method. It is velocity Verlet ("kick-drift-kick") with the
+position constraints enforced at the end of the drift and the velocity
+constraints at the end of the second kick.
+
+Because it doesn't control error it can't adjust the step size; it uses the
+step size given on construction unless you change it. The step size may be
+reduced to isolate events, and interpolated states are provided for reports
+between steps. An error-controlled integrator shrinks and grows its steps, so
+its energy error accumulates over a long run; this method has no such drift
+for a conservative system so energy errors stay bounded, and it can usually
+take considerably larger steps than an error-controlled integrator would choose
+for the same long-term energy behavior.
+
+<h3>Theory</h3>
+
+With h the step size, this integrator takes the step from (t0,q0,u0) as
+follows, where udot(q,u) includes the constraint forces that keep the
+accelerations consistent with the constraints: <pre>
+    u+ = u0 + h/2 udot(q0,u0)         kick
+    q1 = q0 + h N(q0) (u+ + du)        drift
+    u+ = u+ + du
+    u1 = u+ + h/2 udot(q1,u+)         kick
+    u1 = u1 - M^-1 ~G(q1) mu            enforce velocity constraints
+</pre> Here du = M^-1 ~G(q0) lambda is the velocity change produced by an
+impulse normal to the constraints at q0, chosen so that q1 satisfies the 
+position constraints, and mu is chosen so that u1 satisfies the velocity 
+constraints G(q1) u1 = b. M is the mass matrix and G the velocity constraint
+Jacobian. lambda is found by iteration: the System's projection of the 
+drifted q1 gives an implied velocity change, the part of that normal to the
+constraints at q0 is added to du, and the drift is repeated until no 
+projection is needed. See Hairer, Lubich & Wanner, Geometric Numerical 
+Integration, 2nd ed. 2006, section VII.1.4. Auxiliary state variables z are
+advanced with the same two half steps as u.
+
+The normal parts are found with the System's operators for M^-1, G and ~G
+(see System::hasMassMatrixOperators(); a MultibodySystem has them). For a
+System without them the System's velocity projection, which need not be mass
+weighted, is used instead. If the generalized coordinates are canonical (N is
+the identity) and M and G are available, this is exactly the symplectic 
+RATTLE method. Otherwise, e.g. with a MultibodySystem that uses quaternions,
+it still keeps the constraints satisfied at every step but is not strictly
+symplectic, and the long-term energy behavior should be checked for your
+system. Use a constraint tolerance (setConstraintTolerance()) small
+compared to the motion in one step, since it determines how precisely the 
+impulse is found. The accelerations are evaluated twice per step, at (q1,u+)
+for the second kick and again at the final state, where they supply the 
+first kick of the next step. **/
+class SimTK_SIMMATH_EXPORT RattleIntegrator : public Integrator {
+public:
+    /** Create a RattleIntegrator for integrating a System with fixed size 
+    steps. **/
+    RattleIntegrator(const System& sys, Real stepSize);
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_RATTLE_INTEGRATOR_H_
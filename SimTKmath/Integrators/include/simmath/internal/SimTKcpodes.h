@@ -69,7 +69,14 @@ public:
     virtual void errorHandler(int error_code, const char* module,
                               const char* function, char* msg) const;
 
-    //TODO: Jacobian functions
+    // Jacobian J=df/dy of an explicit ODE at (t,y), where fy=f(t,y), for
+    // use in the Newton iteration. Return 0 on success, >0 for a 
+    // recoverable failure, <0 for an unrecoverable one. Enable it with
+    // CPodes::dlsSetExplicitJacFn().
+    virtual int  explicitJacobian(Real t, const Vector& y, const Vector& fy,
+                                  Matrix& J) const;
+
+    //TODO: implicit ODE and projection Jacobian functions
 };
 
 
@@ -111,6 +118,11 @@ static void errorHandler_static(const CPodesSystem& sys,
                                 const char* function, char* msg)
   { sys.errorHandler(error_code,module,function,msg); }
 
+static int explicitJacobian_static(const CPodesSystem& sys, 
+                                   Real t, const Vector& y, const Vector& fy,
+                                   Matrix& J)
+  { return sys.explicitJacobian(t,y,fy,J); }
+
 /**
  * This is a straightforward translation of the Sundials CPODES C 
  * interface into C++. The class CPodes represents a single instance
@@ -253,6 +265,11 @@ public:
     int dlsSetJacFn(void* jac, void* jac_data);
     int dlsProjSetJacFn(void* jacP, void* jacP_data);
 
+    // This tells CPodes to use the user's explicitJacobian() method from
+    // CPodesSystem instead of finite differences to form the Newton matrix.
+    // Call this after choosing the dense linear solver with lapackDense().
+    int dlsSetExplicitJacFn();
+
 
     int step(Real tout, Real* tret, 
              Vector& y_inout, Vector& yp_inout, StepMode=Normal);
@@ -366,6 +383,9 @@ private:
     typedef void (*ErrorHandlerFunc)(const CPodesSystem&, 
                                      int error_code, const char* module, 
                                      const char* function, char* msg);
+    typedef int (*ExplicitJacobianFunc)(const CPodesSystem&, 
+                                        Real t, const Vector& y, 
+                                        const Vector& fy, Matrix& J);
 
     // Note that these routines do not tell CPodes to use the supplied
     // functions. They merely provide the client-side addresses of functions
@@ -383,6 +403,7 @@ private:
     void registerRootFunc(RootFunc);
     void registerWeightFunc(WeightFunc);
     void registerErrorHandlerFunc(ErrorHandlerFunc);
+    void registerExplicitJacobianFunc(ExplicitJacobianFunc);
 
 
     // This is the library-side part of the CPodes constructor. This must
@@ -401,6 +422,7 @@ private:
         registerRootFunc(root_static);
         registerWeightFunc(weight_static);
         registerErrorHandlerFunc(errorHandler_static);
+        registerExplicitJacobianFunc(explicitJacobian_static);
     }
 
     // FOR INTERNAL USE ONLY
@@ -30,7 +30,8 @@ AbstractIntegratorRep::AbstractIntegratorRep
    (Integrator* handle, const System& sys, int minOrder, int maxOrder, 
     const std::string& methodName, bool hasErrorControl) 
 :   IntegratorRep(handle, sys), minOrder(minOrder), maxOrder(maxOrder), 
-    methodName(methodName), hasErrorControl(hasErrorControl) {}
+    methodName(methodName), hasErrorControl(hasErrorControl),
+    denseOutputT0(NaN), denseOutputT1(NaN) {}
 
 
 
@@ -49,6 +50,7 @@ void AbstractIntegratorRep::methodInitialize(const State& state) {
         currentStepSize = std::min(currentStepSize, userMaxStepSize);
     lastStepSize = currentStepSize;
     actualInitialStepSizeTaken = (hasErrorControl ? NaN : currentStepSize);
+    invalidateDenseOutput();
     resetMethodStatistics();
  }
 
@@ -60,33 +62,52 @@ void AbstractIntegratorRep::methodInitialize(const State& state) {
 // Create an interpolated state at time t, which is between tPrev and tCurrent.
 // If we haven't yet delivered an interpolated state in this interval, we have
 // to initialize its discrete part from the advanced state.
-void AbstractIntegratorRep::createInterpolatedState(Real t) {
-    const System& system   = getSystem();
+void AbstractIntegratorRep::createInterpolatedState(Real t, bool isForReport) {
     const State&  advanced = getAdvancedState();
     State&        interp   = updInterpolatedState();
     interp = advanced; // pick up discrete stuff.
 
-    // Hermite interpolation requires state derivatives so we must realize
-    // end-of-step derivatives if they haven't already been realized.
-    realizeStateDerivatives(advanced);
-
-    interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
-                      advanced.getTime(), advanced.getY(), advanced.getYDot(),
-                      t, interp.updY());
+    interpolateY(t, interp.updY());
     interp.updTime() = t;
 
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
+    realizeInterpolatedState(interp, isForReport);
+}
+
+
+
+//==============================================================================
+//                               INTERPOLATE Y
+//==============================================================================
+// The dense output polynomial runs from y0 to the y1 calculated by the step,
+// but that may since have been projected onto the constraint manifold. So we
+// add in the fraction d of the change made by projection, which is smaller 
+// than the local error so doesn't affect the order of the interpolant, and
+// makes it agree with the advanced state at t1.
+void AbstractIntegratorRep::interpolateY(Real t, Vector& y) {
+    const State& advanced = getAdvancedState();
+
+    if (!hasDenseOutput()) {
+        // Hermite interpolation requires state derivatives so we must realize
+        // end-of-step derivatives if they haven't already been realized.
+        realizeStateDerivatives(advanced);
+        interpolateOrder3
+           (getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
+            advanced.getTime(), advanced.getY(), advanced.getYDot(), t, y);
         return;
     }
 
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    const Real h = denseOutputT1-denseOutputT0, d = (t-denseOutputT0)/h;
+    const Vector& y0 = getPreviousY();
+    const Vector& y1 = advanced.getY();
+    const Vector& c1 = denseOutputCoef[0];
+    const Vector& c2 = denseOutputCoef[1];
+    const Vector& c3 = denseOutputCoef[2];
+    y.resize(y0.size());
+    for (int i=0; i < y0.size(); ++i) {
+        const Real dy1 = h*(c1[i] + c2[i] + c3[i]); // unprojected y1-y0
+        y[i] = y0[i] + h*d*(c1[i] + d*(c2[i] + d*c3[i]))
+                     + d*((y1[i]-y0[i]) - dy1);
+    }
 }
 
 
@@ -100,16 +121,11 @@ void AbstractIntegratorRep::createInterpolatedState(Real t) {
 void AbstractIntegratorRep::backUpAdvancedStateByInterpolation(Real t) {
     const System& system   = getSystem();
     State& advanced = updAdvancedState();
-    Vector yinterp, dummy;
+    Vector yinterp;
 
     assert(getPreviousTime() <= t && t <= advanced.getTime());
 
-    // Hermite interpolation requires state derivatives so we must realize
-    // end-of-step derivatives if they haven't already been realized.
-    realizeStateDerivatives(advanced);
-    interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
-                      advanced.getTime(), advanced.getY(), advanced.getYDot(),
-                      t, yinterp);
+    interpolateY(t, yinterp);
     advanced.updY() = yinterp;
     advanced.updTime() = t;
 
@@ -286,7 +302,7 @@ AbstractIntegratorRep::stepTo(Real reportTime, Real scheduledEventTime) {
                   // interpolated report. After that we'll come right back here
                   // with the user having advanced the reportTime (hopefully).
                   if (reportTime < getAdvancedTime()) {
-                      createInterpolatedState(reportTime);
+                      createInterpolatedState(reportTime, true);
                       setUseInterpolatedState(true);
                   }
                   else
@@ -300,7 +316,7 @@ AbstractIntegratorRep::stepTo(Real reportTime, Real scheduledEventTime) {
               // The advanced state is at tHigh, but needs event handling.
 
               // Report the last "pre-event" state.
-              createInterpolatedState(getEventWindowLow()); 
+              createInterpolatedState(getEventWindowLow(), false);
               setUseInterpolatedState(true);
               setStepCommunicationStatus(StepHasBeenReturnedWithEvent);
               return Integrator::ReachedEventTrigger;
@@ -319,7 +335,7 @@ AbstractIntegratorRep::stepTo(Real reportTime, Real scheduledEventTime) {
                   // interpolated report. After that we'll come right back here
                   // with the user having advanced the reportTime (hopefully).
                   if (reportTime < getAdvancedTime()) {
-                      createInterpolatedState(reportTime);
+                      createInterpolatedState(reportTime, true);
                       setUseInterpolatedState(true);
                       // No change to step communication status -- this doesn't 
                       // count as reporting the current step since it is earlier 
@@ -548,6 +564,7 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
 
         int errOrder;
         int numIterations=1; // non-iterative methods can ignore this
+        invalidateDenseOutput(); // the method will record it if it has any
         //--------------------------------------------------------------------
         bool converged = attemptDAEStep(t1, yErrEst, errOrder, numIterations);
         //--------------------------------------------------------------------
@@ -677,7 +694,7 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
         const Real tMid = (tLow < tReport && tReport < tHigh) 
                           ? tReport : earliestTimeEst;
 
-        createInterpolatedState(tMid);
+        createInterpolatedState(tMid, false);
 
         // Failure to evaluate at the interpolated state is a disaster of some
         // kind, not something we expect to be able to recover from, so this 
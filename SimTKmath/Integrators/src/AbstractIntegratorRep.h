@@ -141,10 +141,13 @@ protected:
                                 bool hWasArtificiallyLimited);
     /**
      * Create an interpolated state at time t, which is between the previous 
-     * and advanced times. The default implementation uses third order 
-     * Hermite spline interpolation.
+     * and advanced times. The default implementation uses the method's dense
+     * output if it has one for the current step, otherwise third order
+     * Hermite spline interpolation. If \a isForReport is true the state is
+     * only going to be returned to the caller, so it need not be realized if
+     * the user has asked us not to realize interpolated states.
      */
-    virtual void createInterpolatedState(Real t);
+    virtual void createInterpolatedState(Real t, bool isForReport);
     /**
      * Interpolate the advanced state back to an earlier part of the interval,
      * forgetting about the rest of the interval. This is necessary, for 
@@ -153,6 +156,39 @@ protected:
      * third order Hermite spline interpolation.
      */
     virtual void backUpAdvancedStateByInterpolation(Real t);
+
+    /**
+     * Methods that have a continuous extension ("dense output") should call
+     * this from attemptODEStep() to record it for the step from t0 to t1. The
+     * interpolant is y(t0+d*h) = y0 + h*(d*c1 + d^2*c2 + d^3*c3), h=t1-t0,
+     * where the coefficients are combinations of the stage derivatives and
+     * are filled in by the caller using the references returned by
+     * updDenseOutputCoefficient(). It is used for interpolation only while
+     * the previous and advanced times are still t0 and t1.
+     */
+    void setDenseOutputInterval(Real t0, Real t1) 
+    {   denseOutputT0 = t0; denseOutputT1 = t1; }
+    /** Return a writable reference to coefficient ck (k=1,2,3) of the dense
+     * output polynomial, resized to \a n. */
+    Vector& updDenseOutputCoefficient(int k, int n) {
+        assert(1 <= k && k <= NDenseOutputCoefficients);
+        denseOutputCoef[k-1].resize(n);
+        return denseOutputCoef[k-1];
+    }
+    /** Forget any dense output recorded for the current step. */
+    void invalidateDenseOutput() {denseOutputT0 = denseOutputT1 = NaN;}
+    /** Check whether there is valid dense output for the current step. */
+    bool hasDenseOutput() const {
+        return getPreviousTime() == denseOutputT0 
+            && getAdvancedState().getTime() == denseOutputT1;
+    }
+    /**
+     * Interpolate y at time t between the previous and advanced times, using
+     * the dense output if there is any, otherwise third order Hermite
+     * interpolation. That requires the derivatives at the advanced state so
+     * will realize those if necessary.
+     */
+    void interpolateY(Real t, Vector& y);
     int statsStepsTaken, statsStepsAttempted, statsErrorTestFailures, statsConvergenceTestFailures;
 
     // Iterative methods should count iterations and then classify them as 
@@ -164,6 +200,10 @@ private:
     Real currentStepSize, lastStepSize, actualInitialStepSizeTaken;
     int minOrder, maxOrder;
     std::string methodName;
+
+    static const int NDenseOutputCoefficients = 3;
+    Real denseOutputT0, denseOutputT1;
+    Vector denseOutputCoef[NDenseOutputCoefficients];
 };
 
 } // namespace SimTK
@@ -66,6 +66,7 @@ public:
     CPodes::RootFunc            rootFunc;
     CPodes::WeightFunc          weightFunc;
     CPodes::ErrorHandlerFunc    errorHandlerFunc;
+    CPodes::ExplicitJacobianFunc explicitJacobianFunc;
 
     void zeroFunctionPointers() {
         explicitODEFunc  = 0;
@@ -76,6 +77,7 @@ public:
         rootFunc         = 0;
         weightFunc       = 0;
         errorHandlerFunc = 0;
+        explicitJacobianFunc = 0;
     }
 
     void setMyHandle(CPodes& cp) {myHandle = &cp;}
@@ -175,6 +177,27 @@ static int weightWrapper(N_Vector nv_y, N_Vector nv_ewt, void *e_data) {
     return rep.weightFunc(rep.getCPodesSystem(), y, ewt);
 }
 
+// The Jacobian is computed into a Matrix and then copied into CPodes' 
+// column-major dense matrix.
+static int explicitJacobianWrapper(int N, realtype t, N_Vector nv_y, 
+                                   N_Vector nv_fy, DlsMat Jac, void* j_data,
+                                   N_Vector, N_Vector, N_Vector)
+{
+    const Vector& y    = N_Vector_SimTK::getVector(nv_y);
+    const Vector& fy   = N_Vector_SimTK::getVector(nv_fy);
+    const CPodesRep& rep = *reinterpret_cast<const CPodesRep*>(j_data);
+    Matrix J(N, N);
+    const int flag = rep.explicitJacobianFunc(rep.getCPodesSystem(), 
+                                              t, y, fy, J);
+    if (flag != 0) return flag;
+    for (int j=0; j < N; ++j) {
+        realtype* col = Jac->cols[j];
+        for (int i=0; i < N; ++i)
+            col[i] = J(i,j);
+    }
+    return 0;
+}
+
 static void errorHandlerWrapper(int error_code, 
                                 const char *module, const char *function, 
                                 char *msg, void *eh_data)
@@ -630,6 +653,10 @@ char* CPodes::getReturnFlagName(int flag) {
 int CPodes::dlsSetJacFn(void* jac, void* jac_data) {
     return CPDlsSetJacFn(updRep().cpode_mem,jac,jac_data);
 }
+int CPodes::dlsSetExplicitJacFn() {
+    return CPDlsSetJacFn(updRep().cpode_mem, (void*)explicitJacobianWrapper,
+                         (void*)rep);
+}
 int CPodes::dlsGetWorkSpace(int* lenrwLS, int* leniwLS) {
     long llenrwLS, lleniwLS;
     int stat = CPDlsGetWorkSpace(updRep().cpode_mem,&llenrwLS,&lleniwLS);
@@ -708,6 +735,9 @@ void CPodes::registerWeightFunc(CPodes::WeightFunc f) {
 void CPodes::registerErrorHandlerFunc(CPodes::ErrorHandlerFunc f) {
     updRep().errorHandlerFunc = f;
 }
+void CPodes::registerExplicitJacobianFunc(CPodes::ExplicitJacobianFunc f) {
+    updRep().explicitJacobianFunc = f;
+}
 
 /////////////////////////////////
 // CPodesSystem IMPLEMENTATION //
@@ -757,6 +787,12 @@ void CPodesSystem::errorHandler(int, const char*, const char*, char*) const {
     SimTK_THROW2(Exception::UnimplementedVirtualMethod, "CPodesSystem", "errorHandler"); 
 }
 
+int CPodesSystem::explicitJacobian(Real, const Vector&, const Vector&, 
+                                   Matrix&) const {
+    SimTK_THROW2(Exception::UnimplementedVirtualMethod, "CPodesSystem", "explicitJacobian"); 
+    return std::numeric_limits<int>::min();
+}
+
 } // namespace SimTK
 
 
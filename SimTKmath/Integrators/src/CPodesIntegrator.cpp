@@ -51,6 +51,17 @@ void CPodesIntegrator::setOrderLimit(int order) {
     cprep.setOrderLimit(order);
 }
 
+void CPodesIntegrator::setUseAnalyticJacobian(bool useAnalytic) {
+    CPodesIntegratorRep& cprep = dynamic_cast<CPodesIntegratorRep&>(*rep);
+    cprep.setUseAnalyticJacobian(useAnalytic);
+}
+
+bool CPodesIntegrator::getUseAnalyticJacobian() const {
+    const CPodesIntegratorRep& cprep = 
+        dynamic_cast<const CPodesIntegratorRep&>(*rep);
+    return cprep.getUseAnalyticJacobian();
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -74,6 +85,20 @@ public:
         return CPodes::Success;
     }
 
+    // Calculate J = df/dy at (t,y) using the System's own Jacobian. This is
+    // only used if the System said it could supply one.
+    int explicitJacobian(Real t, const Vector& y, const Vector& fy, 
+                         Matrix& J) const override {
+        try { 
+            integ.setAdvancedStateAndRealizeDerivatives(t,y);
+            if (!system.calcStateDerivativeJacobian(integ.getAdvancedState(),
+                                                    J))
+                return CPodes::UnrecoverableError;
+        }
+        catch(...) { return CPodes::RecoverableError; } // assume recoverable
+        return CPodes::Success;
+    }
+
     // Calculate yerr = c(t,y).
     int constraint(Real t, const Vector& y, Vector& yerr) const override {
         try { 
@@ -137,6 +162,7 @@ void CPodesIntegratorRep::init
     cps = new CPodesSystemImpl(*this, getSystem());
     initialized = false;
     useCpodesProjection = false;
+    useAnalyticJacobian = false;
 }
 
 CPodesIntegratorRep::CPodesIntegratorRep
@@ -190,6 +216,9 @@ void CPodesIntegratorRep::methodInitialize(const State& state) {
         SimTK_THROW1(Integrator::InitializationFailed, "init() failed");
     }
     cpodes->lapackDense(ny);
+    // Use the System's Jacobian if it has one.
+    if (useAnalyticJacobian && getSystem().hasStateDerivativeJacobian())
+        cpodes->dlsSetExplicitJacFn();
     cpodes->setNonlinConvCoef(Real(0.01)); // TODO (default is 0.1)
     if (useCpodesProjection) {
         const int nqerr = state.getNQErr(), nuerr = state.getNUErr();
@@ -263,8 +292,8 @@ void CPodesIntegratorRep::reconstructForNewModel() {
 // Create an interpolated state at time t, which is between tPrev and tCurrent.
 // If we haven't yet delivered an interpolated state in this interval, we have
 // to initialize its discrete part from the advanced state.
-void CPodesIntegratorRep::createInterpolatedState(Real t) {
-    const System& system  = getSystem();
+void CPodesIntegratorRep::createInterpolatedState(Real t,
+                                                  bool isForReport) {
     const State& advanced = getAdvancedState();
     State&       interp   = updInterpolatedState();
     interp = advanced; // pick up discrete stuff.
@@ -273,18 +302,7 @@ void CPodesIntegratorRep::createInterpolatedState(Real t) {
     interp.updY() = yout;
     interp.updTime() = t;
 
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
-        return;
-    }
-
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    realizeInterpolatedState(interp, isForReport);
 }
 
 // Take a step. See AbstractIntegratorRep::stepTo() for how this is supposed
@@ -466,8 +484,9 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             // If necessary, generate an interpolated state.      
             if (tret > tMax) {
                 setUseInterpolatedState(true);
-                createInterpolatedState(tMax);
-                realizeStateDerivatives(getInterpolatedState());
+                createInterpolatedState(tMax, true);
+                if (userRealizeInterpolatedStates != 0)
+                    realizeStateDerivatives(getInterpolatedState());
             }
             savedY.resize(0);
             pendingReturnCode = res;
@@ -481,7 +500,7 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             if (tret > scheduledEventTime) {              
                 // Back up the advanced state to the event time.               
                 savedY = getAdvancedState().getY();
-                createInterpolatedState(scheduledEventTime);
+                createInterpolatedState(scheduledEventTime, false);
                 setAdvancedStateAndRealizeDerivatives(scheduledEventTime,
                                               getInterpolatedState().getY());
             }
@@ -515,7 +534,7 @@ stepTo(Real reportTime, Real scheduledEventTime) {
 
             // Generate an interpolated state at tLo.      
             setUseInterpolatedState(true);
-            createInterpolatedState(tret);
+            createInterpolatedState(tret, false);
             realizeStateDerivatives(getInterpolatedState());
 
             setTriggeredEvents(tret, previousTimeReturned, 
@@ -643,4 +662,11 @@ void CPodesIntegratorRep::setOrderLimit(int order) {
     cpodes->setMaxOrd(order);
 }
 
+void CPodesIntegratorRep::setUseAnalyticJacobian(bool useAnalytic) {
+    SimTK_APIARGCHECK_ALWAYS(!initialized, "CPodesIntegrator", 
+        "setUseAnalyticJacobian",
+        "This method may not be invoked after the integrator has been initialized.");
+    useAnalyticJacobian = useAnalytic;
+}
+
 
@@ -55,7 +55,7 @@ public:
        {SimTK_ASSERT_ALWAYS(false, "CPodesIntegratorRep::getNumDivergentIterations(): not implemented");}
     int getNumIterations() const override;
     void resetMethodStatistics() override;
-    void createInterpolatedState(Real t);
+    void createInterpolatedState(Real t, bool isForReport);
     void initializeIntegrationParameters();
     void reconstructForNewModel();
     const char* getMethodName() const override;
@@ -64,12 +64,14 @@ public:
     bool methodHasErrorControl() const override;
     void setUseCPodesProjection();
     void setOrderLimit(int order);
+    void setUseAnalyticJacobian(bool useAnalytic);
+    bool getUseAnalyticJacobian() const {return useAnalyticJacobian;}
     class CPodesSystemImpl;
     friend class CPodesSystemImpl;
 private:
     CPodes* cpodes;
     CPodesSystemImpl* cps;
-    bool initialized, useCpodesProjection;
+    bool initialized, useCpodesProjection, useAnalyticJacobian;
     int statsStepsTaken, statsErrorTestFailures, statsConvergenceTestFailures;
     int statsIterations;
     int pendingReturnCode;
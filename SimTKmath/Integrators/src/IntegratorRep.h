@@ -710,6 +710,7 @@ protected:
     int  userProjectEveryStep;          //      "
     int  userAllowInterpolation;        //      "
     int  userProjectInterpolatedStates; //      "
+    int  userRealizeInterpolatedStates; //      "
     int  userForceFullNewton;           //      "
 
     // Mark all user-supplied options "not supplied by user".
@@ -722,7 +723,8 @@ protected:
         // booleans
         userUseInfinityNorm = userReturnEveryInternalStep = 
             userProjectEveryStep = userAllowInterpolation = 
-            userProjectInterpolatedStates = userForceFullNewton = -1;
+            userProjectInterpolatedStates = userRealizeInterpolatedStates =
+            userForceFullNewton = -1;
 
         accuracyInUse = NaN;
         consTol  = NaN;
@@ -896,6 +898,32 @@ protected:
             ++statsUProjections;
     }
 
+    // Given an interpolated state whose time and continuous variables have 
+    // been set, realize it through Velocity stage, projecting it onto the
+    // constraint manifold unless the user has asked us not to. If the state
+    // is only going to be reported and the user doesn't want interpolated 
+    // states realized, we leave it as it is; whoever looks at it can realize
+    // it as far as they need.
+    void realizeInterpolatedState(State& interp, bool isForReport) {
+        if (isForReport && userRealizeInterpolatedStates == 0)
+            return;
+
+        if (userProjectInterpolatedStates == 0) {
+            const System& system = getSystem();
+            system.realize(interp, Stage::Time);
+            system.prescribeQ(interp);
+            system.realize(interp, Stage::Position);
+            system.prescribeU(interp);
+            system.realize(interp, Stage::Velocity);
+            return;
+        }
+
+        // We may need to project onto constraint manifold. Allow project()
+        // to throw an exception if it fails since there is no way to recover
+        // here.
+        realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    }
+
     // Set the advanced state and then evaluate state derivatives. Throws an
     // exception if it fails. Updates stats.
     void setAdvancedStateAndRealizeDerivatives(const Real& t, const Vector& y) 
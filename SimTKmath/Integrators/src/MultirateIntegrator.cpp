@@ -0,0 +1,164 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the private (library side) implementation of the
+ * MultirateIntegrator and MultirateIntegratorRep classes.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/Integrator.h"
+#include "simmath/MultirateIntegrator.h"
+
+#include "IntegratorRep.h"
+#include "MultirateIntegratorRep.h"
+
+using namespace SimTK;
+
+//------------------------------------------------------------------------------
+//                           MULTIRATE INTEGRATOR
+//------------------------------------------------------------------------------
+
+MultirateIntegrator::MultirateIntegrator(const System& sys)
+{
+    rep = new MultirateIntegratorRep(this, sys);
+}
+
+void MultirateIntegrator::setNumSubsteps(int numSubsteps) {
+    MultirateIntegratorRep& mrep = dynamic_cast<MultirateIntegratorRep&>(*rep);
+    mrep.setNumSubsteps(numSubsteps);
+}
+
+int MultirateIntegrator::getNumSubsteps() const {
+    const MultirateIntegratorRep& mrep =
+        dynamic_cast<const MultirateIntegratorRep&>(*rep);
+    return mrep.getNumSubsteps();
+}
+
+//------------------------------------------------------------------------------
+//                         MULTIRATE INTEGRATOR REP
+//------------------------------------------------------------------------------
+
+MultirateIntegratorRep::MultirateIntegratorRep
+   (Integrator* handle, const System& sys)
+:   AbstractIntegratorRep(handle, sys, 1, 3, "Multirate", true),
+    numSubsteps(10) {
+}
+
+void MultirateIntegratorRep::setNumSubsteps(int n) {
+    SimTK_APIARGCHECK1_ALWAYS(n > 0, "MultirateIntegrator", "setNumSubsteps",
+        "The number of substeps must be positive but was %d.", n);
+    numSubsteps = n;
+}
+
+// Each substep uses the same 3rd order Runge-Kutta method with embedded 2nd
+// order error estimate as RungeKutta3IntegratorRep; see there for details. The
+// slow forces are held at their values at (t0,y0), which is where the given
+// initial derivative f0 was evaluated, so f0 serves for the first substep.
+//
+// Holding the slow forces is only first order, so when there are any the
+// error they cause is added to the estimate: the difference between the
+// derivatives at (t1,y1) with the slow forces held and with them recalculated
+// grows about linearly over the step, and integrating that over the step
+// gives h/2 times the difference. That error is O(h^2) and so is the order
+// reported for step size control. Releasing the hold for that leaves the end
+// of the step, and anything the caller does with it, seeing the true slow
+// forces. Those also supply the slow forces to be held during the next step,
+// provided that step starts from the same state.
+bool MultirateIntegratorRep::attemptODEStep
+   (Real t1, Vector& y1err, int& errOrder, int& numIterations)
+{
+    const System& system = getSystem();
+    const Real t0 = getPreviousTime();
+    assert(t1 > t0);
+
+    statsStepsAttempted++;
+    errOrder = 3;
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    if (ytmp[0].size() != y0.size())
+        for (int i=0; i<NTemps; ++i)
+            ytmp[i].resize(y0.size());
+    Vector& y  = ytmp[0]; // rename temps
+    Vector& f  = ytmp[1];
+    Vector& f1 = ytmp[2];
+    Vector& f2 = ytmp[3];
+    Vector& fHeld = ytmp[4];
+
+    // The slow forces to be held must have been calculated at (t0,y0). That
+    // is still the case in the advanced state at the start of a step, since
+    // the previous state was saved from it, but not after a failed attempt at
+    // one. Releasing a hold left by an aborted attempt invalidates Dynamics
+    // stage so also forces the recalculation.
+    State& advanced = updAdvancedState();
+    system.releaseSlowForces(advanced);
+    if (!(advanced.getTime() == t0
+          && advanced.getSystemStage() >= Stage::Dynamics))
+        setAdvancedStateAndRealizeDerivatives(t0, y0);
+    const bool slowForcesHeld = system.holdSlowForces(advanced);
+
+    const Real h = (t1-t0)/numSubsteps;
+    y = y0;
+    y1err = 0;
+    for (int k=0; k < numSubsteps; ++k) {
+        const Real tk = t0 + k*h;
+        const Real tk1 = (k == numSubsteps-1 ? t1 : tk + h);
+        if (k == 0)
+            f = f0;
+        else {
+            setAdvancedStateAndRealizeDerivatives(tk, y);
+            f = getAdvancedState().getYDot();
+        }
+
+        setAdvancedStateAndRealizeDerivatives(tk+h/2, y + (h/2)*f);
+        f1 = getAdvancedState().getYDot();
+
+        setAdvancedStateAndRealizeDerivatives(tk1,    y + h*(2*f1-f));
+        f2 = getAdvancedState().getYDot();
+
+        // The substep errors add up (conservatively) to the error estimate
+        // for the whole step.
+        for (int i=0; i<y.size(); ++i) {
+            const Real yi = y[i] + (h/6)*(f[i] + 4*f1[i] + f2[i]);
+            y1err[i] += std::abs(yi - (y[i] + h*f1[i]));
+            y[i] = yi;
+        }
+    }
+
+    if (!slowForcesHeld) {
+        // Evaluate through kinematics only, as for the other explicit
+        // methods; the caller will project before evaluating derivatives.
+        setAdvancedStateAndRealizeKinematics(t1, y);
+        return true;
+    }
+
+    setAdvancedStateAndRealizeDerivatives(t1, y);
+    fHeld = getAdvancedState().getYDot();
+    system.releaseSlowForces(advanced);
+    setAdvancedStateAndRealizeDerivatives(t1, y);
+    const Vector& fEnd = getAdvancedState().getYDot();
+    for (int i=0; i<y.size(); ++i)
+        y1err[i] += ((t1-t0)/2)*std::abs(fEnd[i] - fHeld[i]);
+    errOrder = 2;
+    return true;
+}
@@ -0,0 +1,269 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the private (library side) implementation of the
+ * RattleIntegrator and RattleIntegratorRep classes.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/Integrator.h"
+#include "simmath/RattleIntegrator.h"
+
+#include "IntegratorRep.h"
+#include "RattleIntegratorRep.h"
+
+using namespace SimTK;
+
+//==============================================================================
+//                            RATTLE INTEGRATOR
+//==============================================================================
+
+RattleIntegrator::RattleIntegrator(const System& sys, Real stepSize) {
+    rep = new RattleIntegratorRep(this, sys);
+    setFixedStepSize(stepSize);
+}
+
+
+//==============================================================================
+//                          RATTLE INTEGRATOR REP
+//==============================================================================
+RattleIntegratorRep::RattleIntegratorRep(Integrator* handle, const System& sys)
+:   AbstractIntegratorRep(handle, sys, 2, 2, "Rattle",  false), 
+    m_haveW0(false) {}
+
+
+
+//==============================================================================
+//                            ATTEMPT DAE STEP
+//==============================================================================
+// Like the other symplectic methods, RATTLE overrides the entire DAE step 
+// because the constraint projections are part of the method rather than being
+// applied once the step is done. See RattleIntegrator.h for the formulas.
+bool RattleIntegratorRep::attemptDAEStep
+   (Real t1, Vector& yErrEst, int& errOrder, int& numIterations)
+{
+    const System& system   = getSystem();
+    State& advanced = updAdvancedState();
+    Vector dummyErrEst; // for when we don't want the error estimate projected
+
+    statsStepsAttempted++;
+    errOrder = 2;
+
+    const Real    t0        = getPreviousTime();       // nicer names
+    const Vector& q0        = getPreviousQ();
+    const Vector& u0        = getPreviousU();
+    const Vector& z0        = getPreviousZ();
+    const Vector& udot0     = getPreviousUDot();
+    const Vector& zdot0     = getPreviousZDot();
+
+    const Real h = t1-t0, hHalf = h/2, tHalf = t0 + hHalf;
+    m_haveW0 = false;
+
+    // First kick, using the accelerations at (t0,q0,u0).
+    advanced.updQ() = q0;
+    advanced.updU() = u0 + hHalf * udot0;
+    advanced.updZ() = z0 + hHalf * zdot0;
+    advanced.updTime() = tHalf;
+    system.realize(advanced, Stage::Position); // old q, new t=tHalf
+    system.prescribeU(advanced);
+    m_uHalf = advanced.getU();
+
+    // Drift, with qdot = N(q0)*u+, then enforce the position constraints. 
+    // The System's projection of q1 moves it to the nearest point on the
+    // constraint manifold, but RATTLE requires a correction that comes from
+    // an impulse normal to the constraints at q0, i.e. a change to u+ in the
+    // range of M^-1 ~G(q0). We keep only that part of the velocity change 
+    // implied by each projection and drift again, until the drift lands on
+    // the manifold (to within the constraint tolerance). 
+    // Projection failures are reported rather than thrown since reducing the 
+    // step size may fix them.
+    for (numIterations=1; ; ++numIterations) {
+        system.multiplyByN(advanced, m_uHalf, m_qdotTmp); // at q0
+        advanced.updQ() = q0 + h * m_qdotTmp;
+        advanced.updTime() = t1;
+        system.realize(advanced, Stage::Time);
+        system.prescribeQ(advanced);
+        system.realize(advanced, Stage::Position); // new q, new t=t1
+        m_qUnprojected = advanced.getQ();
+
+        // Measure the position errors the same way projection does.
+        const Vector& perr = advanced.getQErr();
+        if (!perr.size())
+            break; // no position constraints
+        const Real perrNorm = userUseInfinityNorm==1 
+            ? perr.rowScale(advanced.getQErrWeights()).normInf()
+            : perr.rowScale(advanced.getQErrWeights()).normRMS();
+        if (perrNorm <= getConstraintToleranceInUse())
+            break;
+        if (numIterations == MaxImpulseIterations)
+            return false; // the impulse calculation didn't converge
+
+        bool anyChanges;
+        if (!localProjectQAndQErrEstNoThrow(advanced, dummyErrEst, anyChanges))
+            return false; // convergence failure for this step
+
+        m_dq = advanced.getQ() - m_qUnprojected;
+
+        // Back to (tHalf,q0,u+) to find the normal part of the implied change
+        // to u+.
+        advanced.updQ() = q0;
+        advanced.updU() = m_uHalf;
+        advanced.updTime() = tHalf;
+        system.realize(advanced, Stage::Position);
+        system.multiplyByNPInv(advanced, m_dq, m_du);
+        m_du /= h;
+        m_duTangent = m_du;
+        system.realize(advanced, Stage::Velocity);
+        if (!removeNormalPartAtPreviousQ(advanced, m_duTangent))
+            return false;
+        m_uHalf += m_du - m_duTangent;
+        advanced.updU() = m_uHalf; // in case projection changed it
+    }
+
+    advanced.updU() = m_uHalf;
+    system.prescribeU(advanced); // update prescribed u in case q-dependent
+    system.realize(advanced, Stage::Velocity);
+
+    // Second kick, using the accelerations at (t1,q1,u+). Get these 
+    // references now -- as soon as we change u or z they will be invalid.
+    realizeStateDerivatives(advanced);
+    const Vector& udotHalf = advanced.getUDot();
+    const Vector& zdotHalf = advanced.getZDot();
+    advanced.updZ() += hHalf * zdotHalf;
+    advanced.updU() += hHalf * udotHalf;
+    system.realize(advanced, Stage::Position); // q1 still realized
+    system.prescribeU(advanced);
+    system.realize(advanced, Stage::Velocity);
+
+    // Now enforce the velocity constraints, with an impulse normal to the
+    // constraints at q1 if the System lets us calculate that.
+    if (system.hasMassMatrixOperators()) {
+        if (!projectUInMassMetric(advanced))
+            return false;
+    } else {
+        bool anyChanges;
+        if (!localProjectUAndUErrEstNoThrow(advanced, dummyErrEst, anyChanges))
+            return false; // convergence failure for this step
+    }
+
+    yErrEst = 0; // no error estimate
+    return true;
+}
+
+// The given state has been realized through Velocity stage at q0. Remove from
+// du its component normal to the constraints there. That is the impulse 
+// response M^-1 ~G lambda with (G M^-1 ~G) lambda = G du if the System 
+// provides those operators. Otherwise the best we can do is to project du as
+// a u error estimate, which removes the normal component in the metric of the
+// System's velocity projection; we overwrite u afterwards, and it satisfies
+// the velocity constraints well enough that projecting it changes little.
+bool RattleIntegratorRep::removeNormalPartAtPreviousQ(State& s, Vector& du) {
+    const System& system = getSystem();
+    if (system.hasMassMatrixOperators()) {
+        if (s.getNUErr() == 0)
+            return true;
+        if (!m_haveW0) {
+            factorConstraintCompliance(s, m_W0);
+            m_haveW0 = true;
+        }
+        system.multiplyByG(s, du, m_Gdu);
+        removeNormalPart(s, m_W0, m_Gdu, du);
+        return true;
+    }
+
+    ProjectOptions options;
+    options.setRequiredAccuracy(getConstraintToleranceInUse());
+    options.setOption(ProjectOptions::LocalOnly);
+    options.setOption(ProjectOptions::DontThrow);
+    options.setOption(ProjectOptions::ForceProjection);
+
+    ProjectResults results;
+    system.projectU(s, du, options, results);
+    return results.getExitStatus() == ProjectResults::Succeeded;
+}
+
+// The given state has been realized through Velocity stage at q1. Remove the
+// velocity constraint errors uerr with impulses M^-1 ~G mu, (G M^-1 ~G) mu = 
+// uerr. The constraints are linear in u so one iteration normally suffices, 
+// but nonholonomic ones need not be.
+bool RattleIntegratorRep::projectUInMassMetric(State& s) {
+    const System& system = getSystem();
+    if (s.getNUErr() == 0)
+        return true;
+
+    // Aim past the required tolerance as the System's projection does.
+    const Real tol = getConstraintToleranceInUse();
+    Real uerrNorm = calcUErrNorm(s);
+    if (uerrNorm <= tol)
+        return true;
+
+    factorConstraintCompliance(s, m_W1);
+    for (int i=0; i < MaxVelocityIterations && uerrNorm > tol/10; ++i) {
+        m_du = s.getU();
+        removeNormalPart(s, m_W1, s.getUErr(), m_du);
+        s.updU() = m_du;
+        system.realize(s, Stage::Velocity);
+        uerrNorm = calcUErrNorm(s);
+    }
+    return uerrNorm <= tol;
+}
+
+// Form W=G M^-1 ~G column by column and factor it. Redundant constraints make
+// W singular, hence the rank-revealing factorization.
+void RattleIntegratorRep::
+factorConstraintCompliance(const State& s, FactorQTZ& W) {
+    const System& system = getSystem();
+    const int m = s.getNUErr();
+    Matrix Wmat(m, m);
+    m_lambda.resize(m);
+    m_lambda = 0;
+    for (int j=0; j < m; ++j) {
+        m_lambda[j] = 1;
+        system.multiplyByGTranspose(s, m_lambda, m_GtLambda);
+        system.multiplyByMInv(s, m_GtLambda, m_MInvGtLambda);
+        system.multiplyByG(s, m_MInvGtLambda, m_Gdu);
+        Wmat(j) = m_Gdu;
+        m_lambda[j] = 0;
+    }
+    W.factor<Real>(Wmat, m*SqrtEps);
+}
+
+// Given Gdu, which is G*du for the du being corrected, subtract M^-1 ~G lambda
+// from du where W lambda = Gdu, so that G*du becomes zero.
+void RattleIntegratorRep::removeNormalPart
+   (const State& s, const FactorQTZ& W, const Vector& Gdu, Vector& du) {
+    const System& system = getSystem();
+    W.solve(Gdu, m_lambda);
+    system.multiplyByGTranspose(s, m_lambda, m_GtLambda);
+    system.multiplyByMInv(s, m_GtLambda, m_MInvGtLambda);
+    du -= m_MInvGtLambda;
+}
+
+// Measure the velocity errors the same way projection does.
+Real RattleIntegratorRep::calcUErrNorm(const State& s) const {
+    const Vector& uerr = s.getUErr();
+    return userUseInfinityNorm==1 
+        ? uerr.rowScale(s.getUErrWeights()).normInf()
+        : uerr.rowScale(s.getUErrWeights()).normRMS();
+}
@@ -0,0 +1,66 @@
+#ifndef SimTK_SIMMATH_RATTLE_INTEGRATOR_REP_H_
+#define SimTK_SIMMATH_RATTLE_INTEGRATOR_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "simmath/LinearAlgebra.h"
+
+#include "AbstractIntegratorRep.h"
+
+namespace SimTK {
+
+/**
+ * This is the private (library side) implementation of the RattleIntegrator
+ * class which is a concrete class implementing the abstract IntegratorRep.
+ */
+class RattleIntegratorRep : public AbstractIntegratorRep {
+public:
+    RattleIntegratorRep(Integrator* handle, const System& sys);
+protected:
+    bool attemptDAEStep
+       (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
+private:
+    bool removeNormalPartAtPreviousQ(State& s, Vector& du);
+    bool projectUInMassMetric(State& s);
+    void factorConstraintCompliance(const State& s, FactorQTZ& W);
+    void removeNormalPart(const State& s, const FactorQTZ& W, 
+                          const Vector& Gdu, Vector& du);
+    Real calcUErrNorm(const State& s) const;
+
+    // Limit on the drift-and-project iterations that find the constraint
+    // impulse in each step.
+    static const int MaxImpulseIterations = 20;
+    // Limit on the Newton iterations of the final velocity projection.
+    static const int MaxVelocityIterations = 7;
+    Vector m_uHalf, m_qdotTmp, m_qUnprojected, m_dq, m_du, m_duTangent;
+    // For mass-weighted corrections: the constraint compliance W=G M^-1 ~G
+    // at q0 (factored at most once per step) and at q1, and temporaries.
+    FactorQTZ m_W0, m_W1;
+    bool      m_haveW0;
+    Vector    m_lambda, m_GtLambda, m_MInvGtLambda, m_Gdu;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_RATTLE_INTEGRATOR_REP_H_
@@ -136,6 +136,23 @@ bool RungeKuttaMersonIntegratorRep::attemptODEStep
     for (int i=0; i<y1.size(); ++i)
         y1err[i] = Real(.2)*std::abs(y1[i]-ysave[i]);
 
+    // Dense output. Since f3 is at the midpoint, f0, f3 and f4 give the same
+    // third order continuous extension as for the classical 4th order method
+    // (Hairer, Norsett & Wanner, pg. 191), which reproduces y1 at d=1:
+    //     y(t0+dh) = y0 + h*(b0(d) f0 + b3(d) f3 + b4(d) f4)
+    //     b0 = d - 3/2 d^2 + 2/3 d^3
+    //     b3 =       2 d^2 - 4/3 d^3
+    //     b4 =    -1/2 d^2 + 2/3 d^3
+    const int ny = y0.size();
+    updDenseOutputCoefficient(1, ny) = f0;
+    Vector& c2 = updDenseOutputCoefficient(2, ny);
+    Vector& c3 = updDenseOutputCoefficient(3, ny);
+    for (int i=0; i<ny; ++i) {
+        c2[i] = Real(-1.5)*f0[i] + 2*fb[i] - Real(.5)*fa[i];
+        c3[i] = (2*f0[i] - 4*fb[i] + 2*fa[i])/3;
+    }
+    setDenseOutputInterval(t0, t1);
+
     return true;
 }
 
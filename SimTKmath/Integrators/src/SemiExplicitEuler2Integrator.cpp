@@ -61,8 +61,8 @@ SemiExplicitEuler2IntegratorRep::SemiExplicitEuler2IntegratorRep
 // the underlying steps. Alternately, the midpoint value could be used to
 // perform a second-order interpolation here; I'm not sure whether that would
 // be better.
-void SemiExplicitEuler2IntegratorRep::createInterpolatedState(Real t) {
-    const System& system   = getSystem();
+void SemiExplicitEuler2IntegratorRep::createInterpolatedState(Real t,
+                                                              bool isForReport) {
     const State&  advanced = getAdvancedState();
     State&        interp   = updInterpolatedState();
     interp = advanced; // pick up discrete stuff.
@@ -72,18 +72,7 @@ void SemiExplicitEuler2IntegratorRep::createInterpolatedState(Real t) {
     interp.updY() = weight1*getPreviousY()+weight2*getAdvancedState().getY();
     interp.updTime() = t;
 
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
-        return;
-    }
-
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    realizeInterpolatedState(interp, isForReport);
 }
 
 
@@ -54,8 +54,8 @@ SemiExplicitEulerIntegratorRep::SemiExplicitEulerIntegratorRep
 // Create an interpolated state at time t, which is between tPrev and tCurrent.
 // If we haven't yet delivered an interpolated state in this interval, we have
 // to initialize its discrete part from the advanced state.
-void SemiExplicitEulerIntegratorRep::createInterpolatedState(Real t) {
-    const System& system   = getSystem();
+void SemiExplicitEulerIntegratorRep::createInterpolatedState(Real t,
+                                                             bool isForReport) {
     const State&  advanced = getAdvancedState();
     State&        interp   = updInterpolatedState();
     interp = advanced; // pick up discrete stuff.
@@ -65,18 +65,7 @@ void SemiExplicitEulerIntegratorRep::createInterpolatedState(Real t) {
     interp.updY() = weight1*getPreviousY()+weight2*getAdvancedState().getY();
     interp.updTime() = t;
 
-    if (userProjectInterpolatedStates == 0) {
-        system.realize(interp, Stage::Time);
-        system.prescribeQ(interp);
-        system.realize(interp, Stage::Position);
-        system.prescribeU(interp);
-        system.realize(interp, Stage::Velocity);
-        return;
-    }
-
-    // We may need to project onto constraint manifold. Allow project()
-    // to throw an exception if it fails since there is no way to recover here.
-    realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
+    realizeInterpolatedState(interp, isForReport);
 }
 
 
@@ -34,7 +34,7 @@ public:
 protected:
     bool attemptDAEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
-    void createInterpolatedState(Real t) override;
+    void createInterpolatedState(Real t, bool isForReport) override;
     void backUpAdvancedStateByInterpolation(Real t) override;
 };
 
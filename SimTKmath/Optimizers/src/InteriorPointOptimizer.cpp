@@ -100,8 +100,16 @@ InteriorPointOptimizer::InteriorPointOptimizer( const OptimizerSystem& sys )
         int m = getOptimizerSystem().getNumConstraints();
 
         Index index_style = 0; /* C-style; start counting of rows and column indices at 0 */
-        Index nele_hess = 0;
-        Index nele_jac = n*m; /* always assume dense */
+        // Use the sparsity structures declared by the OptimizerSystem, if
+        // any; otherwise the Jacobian is dense and the Hessian approximated.
+        const OptimizerSystem& sys = getOptimizerSystem();
+        const bool exactHessian = sys.hasLagrangianHessianStructure();
+        Index nele_hess = exactHessian 
+            ? (Index)sys.getLagrangianHessianStructureRows().size() : 0;
+        Index nele_jac = sys.hasConstraintJacobianStructure()
+            ? (Index)sys.getConstraintJacobianStructureRows().size() : n*m;
+        if (isUsingNumericalJacobian())
+            initNumericalJacobianSparsity();
 
         // Parameter limits
         Number *x_L = NULL, *x_U = NULL;
@@ -140,7 +148,7 @@ InteriorPointOptimizer::InteriorPointOptimizer( const OptimizerSystem& sys )
 
         AddIpoptIntOption(nlp, "max_iter", maxIterations);
         AddIpoptStrOption(nlp, "mu_strategy", "adaptive");
-        AddIpoptStrOption(nlp, "hessian_approximation", "limited-memory"); // needs to be limited-memory unless you have explicit hessians
+        AddIpoptStrOption(nlp, "hessian_approximation", exactHessian ? "exact" : "limited-memory"); // needs to be limited-memory unless you have explicit hessians
         AddIpoptIntOption(nlp, "limited_memory_max_history", limitedMemoryHistory);
         AddIpoptIntOption(nlp, "print_level", diagnosticsLevel); // default is 4
 
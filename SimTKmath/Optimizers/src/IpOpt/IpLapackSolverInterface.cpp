@@ -2,16 +2,16 @@
 #include "IpLapackSolverInterface.hpp"
 #include "SimTKlapack.h"
 
+#include <algorithm>
+
 #if SimTK_DEFAULT_PRECISION==1 // float
 #define DGELSD   sgelsd_
-#define DSYEV    ssyev_
-#define DGETRF   sgetrf_
-#define DGETRS   sgetrs_
+#define DSYTRF   ssytrf_
+#define DSYTRS   ssytrs_
 #else // double
 #define DGELSD   dgelsd_
-#define DSYEV    dsyev_
-#define DGETRF   dgetrf_
-#define DGETRS   dgetrs_
+#define DSYTRF   dsytrf_
+#define DSYTRS   dsytrs_
 #endif
 
 namespace SimTKIpopt
@@ -25,6 +25,9 @@ namespace SimTKIpopt
       n(0),
       nz(0),
       a(NULL),
+      nzvals_(NULL),
+      nzpos_(NULL),
+      nnz_(0),
       irn_(NULL),
       jcn_(NULL),
       negevals_(-1),
@@ -39,6 +42,8 @@ namespace SimTKIpopt
     DBG_START_METH("LapackSolverInterface::~LapackSolverInterface()", dbg_verbosity);
 
     delete [] a;
+    delete [] nzvals_;
+    delete [] nzpos_;
     delete [] irn_;
     delete [] jcn_;
     delete [] ipiv_;
@@ -57,8 +62,6 @@ namespace SimTKIpopt
       Index nrhs, Number* rhs_vals, bool check_NegEVals,
       Index numberOfNegEVals)
   {
-    int i;
-    Number *atmp;
     DBG_START_METH("LapackSolverInterface::MultiSolve", dbg_verbosity);
     DBG_ASSERT(!check_NegEVals || ProvidesInertia());
     //DBG_ASSERT(initialized_);
@@ -69,8 +72,6 @@ namespace SimTKIpopt
     // check if a factorization has to be done
     // perform the factorization
 
-    atmp = new Number[n*n];
-    for(i=0;i<n*n;i++) atmp[i] = a[i];
     if (new_matrix) {
       retval = Factorization(ia, ja, check_NegEVals, numberOfNegEVals);
       if (retval == SYMSOLVER_SUCCESS)  {
@@ -85,12 +86,17 @@ namespace SimTKIpopt
         retval =  Solve(ia, ja, nrhs, rhs_vals);
       } else {
          Number rcond = -1.0;
-         Number *s,*work,workSize[2];
-         int ispec = 1;
+         Number *atmp,*s,*work,workSize[2];
          int info;
          int *iwork,rank,nlvl,smlsiz,lwork,liwork,nosmlsiz;
-         const char *name = "DGELSD";
-         const char opts = ' ';
+         // The factorization overwrote a, so rebuild the matrix from the
+         // nonzeros saved beforehand; DGELSD overwrites its input.
+         atmp = new Number[n*n];
+         for(int i=0;i<n*n;i++) atmp[i] = 0.0;
+         for(Index k=0;k<nnz_;k++) {
+             const Index row = nzpos_[k] % n, col = nzpos_[k] / n;
+             atmp[col*n+row] = atmp[row*n+col] = nzvals_[k];
+         }
          s = new Number[n];
 
          smlsiz = 25;
@@ -115,6 +121,7 @@ namespace SimTKIpopt
          delete [] work;
          delete [] s;
          delete [] iwork;
+         delete [] atmp;
          if( info > 0 ) {
 //            printf( "dgelsd %d elements failed to converge to zero \n",info );
          } else if( info < 0 ) {
@@ -123,7 +130,6 @@ namespace SimTKIpopt
             retval = SYMSOLVER_SUCCESS;
          }
       }
-      delete [] atmp;
       return retval;
 
   }
@@ -144,10 +150,13 @@ namespace SimTKIpopt
     n = dim;
     nz = nonzeros;
     delete [] a;
+    delete [] nzvals_;
+    delete [] nzpos_;
     delete [] irn_;
     delete [] jcn_;
-    ipiv_ = nullptr; 
+    delete [] ipiv_;
     a = new Number[dim*dim];
+    ipiv_ = new int[dim];
     irn_ = new int[nz];
     jcn_ = new int[nz];
     for (Index i=0; i<nz; i++) {
@@ -155,53 +164,66 @@ namespace SimTKIpopt
       jcn_[i] = ja[i];
     }
 
+    // Positions in a of the distinct structural nonzeros of the lower
+    // triangle; a triplet may appear more than once.
+    nzpos_ = new Index[nz];
+    for (Index i=0; i<nz; i++)
+      nzpos_[i] = std::min(ia[i],ja[i])*dim + std::max(ia[i],ja[i]);
+    std::sort(nzpos_, nzpos_+nz);
+    nnz_ = Index(std::unique(nzpos_, nzpos_+nz) - nzpos_);
+    nzvals_ = new Number[nnz_];
+
     return retval;
   }
 
 
+  // The matrix is factored as L*D*L^T with Bunch-Kaufman pivoting, where D
+  // is block diagonal with 1x1 and 2x2 blocks. D has the same inertia as the
+  // matrix, so unlike a full eigenvalue decomposition this gives the number 
+  // of negative eigenvalues as a by-product of the factorization used for
+  // the solves. The factorization is done in place in a; only the nonzeros
+  // are saved for the least squares fallback in MultiSolve().
   ESymSolverStatus LapackSolverInterface::Factorization(const Index* ia, const Index* ja,
       bool check_NegEVals, Index numberOfNegEVals)
   {
       DBG_START_METH("LapackSolverInterface::Factorization", dbg_verbosity);
       ESymSolverStatus retval = SYMSOLVER_SUCCESS;
       int info,lwork;
-      Number *w, *work,*atmp;
-      char jobz = 'N';
+      Number *work,workSize;
       char uplo = 'L';
       int i;
 
-      delete [] ipiv_;
-      ipiv_ = new int[n];
+      for(Index k=0;k<nnz_;k++) nzvals_[k] = a[nzpos_[k]];
 
-      /* compute negative eigenvalues */
-
-      negevals_ = 0;
-      w = new Number[n];
-      lwork = 3*n;   // TODO get optimial value
+      lwork = -1; // workspace query
+      DSYTRF(uplo, n, a, n, ipiv_, &workSize, lwork, info, 1);
+      lwork = std::max((int)workSize, 1);
       work = new Number[lwork];
-      atmp = new Number[n*n];
-      for(i=0;i<n*n;i++) atmp[i] = a[i];
-      DSYEV(jobz, uplo, n, atmp, n, w, work, lwork, info,  1, 1);
-      if( info != 0 ) {
-          delete [] w;
-          delete [] work;
-          delete [] atmp;
+      DSYTRF(uplo, n, a, n, ipiv_, work, lwork, info, 1);
+      delete [] work;
+      if( info < 0 ) {
           return(SYMSOLVER_FATAL_ERROR);
       }
+
+      /* count negative eigenvalues of the 1x1 and 2x2 blocks of D */
+
+      negevals_ = 0;
       for(i=0;i<n;i++){
-          if( w[i] < 0.0 ) negevals_++;
+          const Number d = a[i*n+i];
+          if( ipiv_[i] > 0 ) {
+              if( d < 0.0 ) negevals_++;
+          } else {
+              const Number e = a[i*n+i+1], f = a[(i+1)*n+i+1];
+              const Number det = d*f - e*e;
+              if( det < 0.0 ) negevals_++;
+              else if( det > 0.0 && d+f < 0.0 ) negevals_ += 2;
+              ++i; // skip the second row of the 2x2 block
+          }
       }
-      delete [] w;
-      delete [] work;
       if (check_NegEVals && (numberOfNegEVals!=negevals_)) {
-          delete [] atmp;
           return SYMSOLVER_WRONG_INERTIA;
       }
 
-
-      DGETRF( n, n, a, n, ipiv_, info);
-      delete [] atmp;
-
       if( info > 0  ) {
           retval = SYMSOLVER_SINGULAR;
       }
@@ -214,9 +236,9 @@ namespace SimTKIpopt
     DBG_START_METH("LapackSolverInterface::Solve", dbg_verbosity);
     ESymSolverStatus retval = SYMSOLVER_SUCCESS;
     int info;
-    char transpose = 'N';
+    char uplo = 'L';
 
-    DGETRS( transpose, n, nrhs, a, n, ipiv_, b, n, info, 1);
+    DSYTRS( uplo, n, nrhs, a, n, ipiv_, b, n, info, 1);
     if( info != 0 ) {
         if( info > 0 && info <= n  ) {
             retval = SYMSOLVER_SINGULAR;
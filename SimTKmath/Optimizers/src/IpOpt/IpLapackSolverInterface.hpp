@@ -108,8 +108,13 @@ namespace SimTKIpopt
     /** Array for storing the values of the matrix. */
     Number* a;
 
-    /** Array for storing the values of the factored matrix. */
-    Number* afact;
+    /** Values of the distinct nonzeros of the lower triangle, saved before
+     *  the matrix is factored in place. */
+    Number* nzvals_;
+    /** Positions of those nonzeros in the column-major array a. */
+    Index* nzpos_;
+    /** Number of distinct nonzeros. */
+    Index nnz_;
 
     /** Array for storing the row indices of the matrix */
     int* irn_;
@@ -28,10 +28,55 @@
 #include "InteriorPointOptimizer.h"
 #include "CFSQPOptimizer.h"
 #include "CMAESOptimizer.h"
+#include <algorithm>
 #include <string>
+#include <utility>
 
 namespace SimTK {
 
+int OptimizerSystem::constraintJacobianNonzeros
+   (const Vector& parameters, bool new_parameters, Vector& values) const {
+    Matrix jac(getNumConstraints(), getNumParameters());
+    const int status = constraintJacobian(parameters, new_parameters, jac);
+    for (int k=0; k < (int)jacobianRows.size(); ++k)
+        values[k] = jac(jacobianRows[k], jacobianCols[k]);
+    return status;
+}
+
+void OptimizerSystem::checkStructure
+   (const Array_<int>& rows, const Array_<int>& cols, int numRows,
+    bool lowerTriangle, const char* methodName) const {
+    SimTK_APIARGCHECK2_ALWAYS(rows.size() == cols.size(),
+        "OptimizerSystem", methodName,
+        "Got %d row indices but %d column indices.", 
+        (int)rows.size(), (int)cols.size());
+
+    Array_< std::pair<int,int> > elements;
+    elements.reserve(rows.size());
+    for (int k=0; k < (int)rows.size(); ++k) {
+        SimTK_APIARGCHECK3_ALWAYS(0 <= rows[k] && rows[k] < numRows,
+            "OptimizerSystem", methodName,
+            "Element %d has row %d but there are only %d rows.",
+            k, rows[k], numRows);
+        SimTK_APIARGCHECK3_ALWAYS(0 <= cols[k] && cols[k] < numParameters,
+            "OptimizerSystem", methodName,
+            "Element %d has column %d but there are only %d parameters.",
+            k, cols[k], numParameters);
+        SimTK_APIARGCHECK3_ALWAYS(!lowerTriangle || rows[k] >= cols[k],
+            "OptimizerSystem", methodName,
+            "Element %d (%d,%d) is not in the lower triangle.",
+            k, rows[k], cols[k]);
+        elements.push_back(std::make_pair(rows[k], cols[k]));
+    }
+
+    std::sort(elements.begin(), elements.end());
+    for (int k=1; k < (int)elements.size(); ++k)
+        SimTK_APIARGCHECK2_ALWAYS(elements[k] != elements[k-1],
+            "OptimizerSystem", methodName,
+            "Element (%d,%d) is listed more than once.",
+            elements[k].first, elements[k].second);
+}
+
 Optimizer::~Optimizer() {
    delete (OptimizerRep *)rep;
 }
@@ -153,6 +198,10 @@ void Optimizer::setDifferentiatorMethod( Differentiator::Method method) {
      updRep().setDifferentiatorMethod(method);
 }
 
+void Optimizer::setDifferentiatorNumberOfThreads(int numThreads) {
+     updRep().setDifferentiatorNumberOfThreads(numThreads);
+}
+
 void Optimizer::setConvergenceTolerance( Real accuracy ) {
      updRep().setConvergenceTolerance(accuracy);
 }
@@ -209,6 +258,10 @@ Differentiator::Method Optimizer::getDifferentiatorMethod() const {
     return getRep().getDifferentiatorMethod();
 }
 
+int Optimizer::getDifferentiatorNumberOfThreads() const {
+    return getRep().getDifferentiatorNumberOfThreads();
+}
+
 OptimizerAlgorithm Optimizer::getAlgorithm() const {
     return getRep().getAlgorithm();
 }
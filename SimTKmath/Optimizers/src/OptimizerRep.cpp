@@ -49,8 +49,11 @@ OptimizerAlgorithm DefaultOptimizer::getAlgorithm() const {
 Optimizer::OptimizerRep::~OptimizerRep() {
     delete jacDiff;
     delete gradDiff;
+    for (SysConstraintFunc* f : cfClones) delete f;
+    for (SysObjectiveFunc* f : ofClones) delete f;
     delete cf;
     delete of;
+    for (OptimizerSystem* sys : sysClones) delete sys;
 }
 
 void Optimizer::OptimizerRep::setConvergenceTolerance(Real accuracy ) {
@@ -125,15 +128,51 @@ setDifferentiatorMethod(Differentiator::Method method) {
      diffMethod = method;
 }
 
+void Optimizer::OptimizerRep::
+setDifferentiatorNumberOfThreads(int numThreads) {
+    SimTK_APIARGCHECK1_ALWAYS(numThreads >= 0, "Optimizer", 
+        "setDifferentiatorNumberOfThreads",
+        "The number of threads was %d but must be >= 0", numThreads);
+    diffNumThreads = numThreads;
+    // The number of clones the Differentiators need may have changed.
+    if (gradDiff) useNumericalGradient(true, objectiveEstimatedAccuracy);
+    if (jacDiff)  useNumericalJacobian(true, constraintsEstimatedAccuracy);
+}
+
+// Make sure there is a copy of the OptimizerSystem for each thread after the
+// first, if it can make copies, and return the number of copies to use.
+int Optimizer::OptimizerRep::updateSystemClones() {
+    const int numThreads = diffNumThreads > 0 
+        ? diffNumThreads : ParallelExecutor::getNumProcessors();
+    while ((int)sysClones.size() < numThreads-1) {
+        OptimizerSystem* clone = sysp->clone();
+        if (!clone)
+            break;
+        sysClones.push_back(clone);
+    }
+    return std::min((int)sysClones.size(), std::max(numThreads-1, 0));
+}
+
 void Optimizer::OptimizerRep::
 useNumericalGradient(bool flag, Real objEstAccuracy) {
     objectiveEstimatedAccuracy = 
         objEstAccuracy > 0 ? objEstAccuracy : SignificantReal;
-    delete gradDiff; gradDiff=0; delete of; of=0;
+    delete gradDiff; gradDiff=0; 
+    for (SysObjectiveFunc* f : ofClones) delete f;
+    ofClones.clear();
+    delete of; of=0;
     if (flag) {     // turn on numerical jacbobian
         of = new SysObjectiveFunc(sysp->getNumParameters(), sysp);
         of->setEstimatedAccuracy(objectiveEstimatedAccuracy);
         gradDiff = new Differentiator(*of, diffMethod);
+        gradDiff->setNumberOfThreads(diffNumThreads);
+        const int numClones = updateSystemClones();
+        for (int i=0; i < numClones; ++i) {
+            ofClones.push_back(new SysObjectiveFunc(sysp->getNumParameters(), 
+                                                    sysClones[i]));
+            ofClones.back()->setEstimatedAccuracy(objectiveEstimatedAccuracy);
+            gradDiff->addFunctionClone(*ofClones.back());
+        }
     }
     numericalGradient = flag;
 }
@@ -141,16 +180,61 @@ void Optimizer::OptimizerRep::
 useNumericalJacobian(bool flag, Real consEstAccuracy) {
     constraintsEstimatedAccuracy = 
         consEstAccuracy > 0 ? consEstAccuracy : SignificantReal;
-    delete jacDiff; jacDiff=0; delete cf; cf=0;
+    delete jacDiff; jacDiff=0; 
+    for (SysConstraintFunc* f : cfClones) delete f;
+    cfClones.clear();
+    delete cf; cf=0;
     if (flag) {     // turn on numerical gradients
         cf = new SysConstraintFunc(sysp->getNumConstraints(), 
                                    sysp->getNumParameters(), sysp);
         cf->setEstimatedAccuracy(constraintsEstimatedAccuracy);
         jacDiff = new Differentiator(*cf, diffMethod); 
+        jacDiff->setNumberOfThreads(diffNumThreads);
+        const int numClones = updateSystemClones();
+        for (int i=0; i < numClones; ++i) {
+            cfClones.push_back(new SysConstraintFunc(sysp->getNumConstraints(),
+                                   sysp->getNumParameters(), sysClones[i]));
+            cfClones.back()->setEstimatedAccuracy(constraintsEstimatedAccuracy);
+            jacDiff->addFunctionClone(*cfClones.back());
+        }
     }
     numericalJacobian = flag;
 }
 
+void Optimizer::OptimizerRep::initNumericalJacobianSparsity() {
+    jacNonzeroOrder.clear();
+    if (!jacDiff)
+        return;
+
+    const OptimizerSystem& sys = getOptimizerSystem();
+    if (!sys.hasConstraintJacobianStructure()) {
+        jacDiff->setJacobianSparsityPattern(Array_< Array_<int> >());
+        return;
+    }
+
+    // The Differentiator wants the nonzero rows of each column, and packs
+    // the calculated elements column by column in that order.
+    const Array_<int>& rows = sys.getConstraintJacobianStructureRows();
+    const Array_<int>& cols = sys.getConstraintJacobianStructureCols();
+    const int n = sys.getNumParameters();
+    const int nnz = (int)rows.size();
+    Array_< Array_<int> > pattern(n);
+    Array_<int> positionInColumn(nnz);
+    for (int k=0; k < nnz; ++k) {
+        positionInColumn[k] = (int)pattern[cols[k]].size();
+        pattern[cols[k]].push_back(rows[k]);
+    }
+    jacDiff->setJacobianSparsityPattern(pattern);
+
+    Array_<int> columnStart(n+1);
+    columnStart[0] = 0;
+    for (int j=0; j < n; ++j)
+        columnStart[j+1] = columnStart[j] + (int)pattern[j].size();
+    jacNonzeroOrder.resize(nnz);
+    for (int k=0; k < nnz; ++k)
+        jacNonzeroOrder[k] = columnStart[cols[k]] + positionInColumn[k];
+}
+
 
 int Optimizer::OptimizerRep::objectiveFuncWrapper
    (int n, const Real* x, int newX, Real* f, void* vrep)
@@ -216,6 +300,39 @@ int Optimizer::OptimizerRep::constraintJacobianWrapper
     if(m==0) return 1; // m==0 case occurs if you run IPOPT with no constraints
 
     const bool isNewParam = (newX==1);
+    const OptimizerSystem& sys = rep->getOptimizerSystem();
+
+    if (sys.hasConstraintJacobianStructure()) {
+        // Use the declared structure; Ipopt takes the same triplets.
+        const Array_<int>& rows = sys.getConstraintJacobianStructureRows();
+        const Array_<int>& cols = sys.getConstraintJacobianStructureCols();
+        assert(nele_jac == (int)rows.size());
+        if (values == NULL) {
+            for (int k=0; k < nele_jac; ++k) {
+                iRow[k] = rows[k];
+                jCol[k] = cols[k];
+            }
+            return 1;   // success
+        }
+
+        const Vector params(n,x,true);       // These Vectors refer to 
+        Vector       nonzeros(nele_jac,values,true); // existing space.
+
+        int status = -1;
+        if( rep->isUsingNumericalJacobian() ) {
+            assert((int)rep->jacNonzeroOrder.size() == nele_jac);
+            Vector sfy0(m);
+            status = sys.constraintFunc(params, true, sfy0);
+            rep->getJacobianDifferentiator().calcJacobianNonzeros
+               (params, sfy0, rep->jacNonzeroTmp);
+            for (int k=0; k < nele_jac; ++k)
+                nonzeros[k] = rep->jacNonzeroTmp[rep->jacNonzeroOrder[k]];
+        } else {
+            status = sys.constraintJacobianNonzeros(params, isNewParam, 
+                                                    nonzeros);
+        }
+        return (status==0) ? 1 : 0;
+    }
 
     if (values == NULL) {
         // always assume  the jacobian is dense
@@ -260,6 +377,27 @@ int Optimizer::OptimizerRep::hessianWrapper
 {
     assert(vrep);
     const OptimizerRep* rep = reinterpret_cast<const OptimizerRep*>(vrep);
+    const OptimizerSystem& sys = rep->getOptimizerSystem();
+
+    if (sys.hasLagrangianHessianStructure()) {
+        const Array_<int>& rows = sys.getLagrangianHessianStructureRows();
+        const Array_<int>& cols = sys.getLagrangianHessianStructureCols();
+        assert(nele_hess == (int)rows.size());
+        if (values == NULL) {
+            for (int k=0; k < nele_hess; ++k) {
+                iRow[k] = rows[k];
+                jCol[k] = cols[k];
+            }
+            return 1;   // success
+        }
+
+        // These Vectors refer to existing space.
+        const Vector params(n,x,true);
+        const Vector multipliers = m > 0 ? Vector(m,lambda,true) : Vector();
+        Vector       nonzeros(nele_hess,values,true);
+        return sys.lagrangianHessianNonzeros(params, newX==1, obj_factor,
+                    multipliers, new_lambda==1, nonzeros)==0 ? 1 : 0;
+    }
 
     // These Vectors refer to existing space.
     const Vector coeff(n,x,true); 
@@ -57,9 +57,11 @@
 #include "simmath/RungeKuttaMersonIntegrator.h"
 #include "simmath/RungeKuttaFeldbergIntegrator.h"
 #include "simmath/RungeKutta3Integrator.h"
+#include "simmath/MultirateIntegrator.h"
 #include "simmath/RungeKutta2Integrator.h"
 #include "simmath/ExplicitEulerIntegrator.h"
 #include "simmath/VerletIntegrator.h"
+#include "simmath/RattleIntegrator.h"
 #include "simmath/SemiExplicitEulerIntegrator.h"
 #include "simmath/SemiExplicitEuler2Integrator.h"
 
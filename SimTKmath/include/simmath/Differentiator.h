@@ -107,6 +107,39 @@ public:
     Differentiator& setDefaultMethod(Method);
     Method          getDefaultMethod() const;
 
+    // By default the perturbed evaluations of the function for a gradient
+    // or Jacobian are done one after another on the calling thread. Set 
+    // more than one thread, and supply clones of the function below, to have
+    // them done in parallel; 0 means use all the processors. Scalar 
+    // functions are always differentiated serially.
+    Differentiator& setNumberOfThreads(int numThreads);
+    int             getNumberOfThreads() const;
+
+    // Supply another Function object of the same kind and shape, equivalent
+    // to the one being differentiated, for parallel evaluations to use. Each
+    // thread works with a different one of the function objects, so f() 
+    // need not be thread safe, and at most one more thread than the number 
+    // of clones is used; with no clones the evaluations are done serially 
+    // whatever the number of threads. Calls made through a clone are counted
+    // in that clone's statistics. The clones must outlive this 
+    // Differentiator.
+    Differentiator& addFunctionClone(const Function& clone);
+    int             getNumFunctionClones() const;
+
+    // Declare which elements of the Jacobian df/dy can be nonzero, by giving
+    // for each parameter (column) the functions (rows) that depend on it. 
+    // Columns that have no nonzero rows in common are then perturbed 
+    // together in a single function evaluation, and the Jacobian is 
+    // recovered from those compressed differences; the undeclared elements
+    // are returned as zero. Give an empty pattern to go back to the dense 
+    // Jacobian. This affects only calcJacobian() and calcJacobianNonzeros().
+    Differentiator& setJacobianSparsityPattern
+       (const Array_< Array_<int> >& nonzeroRowsByColumn);
+    // The number of groups into which the columns were divided; this is the
+    // number of perturbed function evaluations per forward difference 
+    // Jacobian (twice that for central differences).
+    int getNumJacobianColumnGroups() const;
+
     // These are the real routines, which are efficient and flexible
     // but somewhat messy to use.
     void calcDerivative(Real y0, Real fy0, Real& dfdy, 
@@ -116,6 +149,16 @@ public:
     void calcJacobian  (const Vector& y0, const Vector& fy0, Matrix& dfdy,
                         Method=UnspecifiedMethod) const;
 
+    // Like calcJacobian() but returns only the elements declared in the
+    // Jacobian sparsity pattern, which must have been set. These are packed
+    // column by column, in the order the rows were listed for each column,
+    // so no storage for the full Jacobian is needed.
+    void calcJacobianNonzeros(const Vector& y0, const Vector& fy0, 
+                              Vector& nonzeros, 
+                              Method=UnspecifiedMethod) const;
+    // The number of elements in the Jacobian sparsity pattern.
+    int getNumJacobianNonzeros() const;
+
     // These provide a simpler though less efficient interface. They will
     // do some heap allocation, and will make an initial unperturbed call
     // to the user function.
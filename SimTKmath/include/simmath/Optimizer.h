@@ -41,7 +41,9 @@ enum OptimizerAlgorithm {
      /// Simmath will select best Optimizer based on problem type.
      BestAvailable = 0,
      /// IpOpt algorithm (https://projects.coin-or.org/ipopt);
-     /// gradient descent.
+     /// gradient descent. The bundled linear solver factors the KKT matrix
+     /// densely, so memory grows with the square of the number of
+     /// parameters plus constraints even when their Jacobian is sparse.
      InteriorPoint = 1,
      /// Limited-memory Broyden-Fletcher-Goldfarb-Shanno algorithm; 
      /// gradient descent.
@@ -85,6 +87,37 @@ public:
         setNumParameters(nParameters);
     }
 
+    /// Copies get their own copies of the limits, so a derived class can
+    /// implement clone() with its copy constructor.
+    OptimizerSystem(const OptimizerSystem& src) 
+    :   numParameters(src.numParameters),
+        numEqualityConstraints(src.numEqualityConstraints),
+        numInequalityConstraints(src.numInequalityConstraints),
+        numLinearEqualityConstraints(src.numLinearEqualityConstraints),
+        numLinearInequalityConstraints(src.numLinearInequalityConstraints),
+        useLimits(src.useLimits),
+        lowerLimits(src.useLimits ? new Vector(*src.lowerLimits) : 0),
+        upperLimits(src.useLimits ? new Vector(*src.upperLimits) : 0),
+        jacobianRows(src.jacobianRows), jacobianCols(src.jacobianCols),
+        hessianRows(src.hessianRows), hessianCols(src.hessianCols) {
+    }
+    OptimizerSystem& operator=(const OptimizerSystem& src) {
+        if (&src == this) 
+            return *this;
+        numParameters = src.numParameters;
+        numEqualityConstraints = src.numEqualityConstraints;
+        numInequalityConstraints = src.numInequalityConstraints;
+        numLinearEqualityConstraints = src.numLinearEqualityConstraints;
+        numLinearInequalityConstraints = src.numLinearInequalityConstraints;
+        if (src.useLimits)
+            setParameterLimits(*src.lowerLimits, *src.upperLimits);
+        else
+            setParameterLimits(Vector(), Vector());
+        jacobianRows = src.jacobianRows; jacobianCols = src.jacobianCols;
+        hessianRows = src.hessianRows; hessianCols = src.hessianCols;
+        return *this;
+    }
+
     virtual ~OptimizerSystem() {
         if( useLimits ) {
             delete lowerLimits;
@@ -124,6 +157,42 @@ public:
                                  bool new_parameters, Vector &gradient) const {
                                  SimTK_THROW2(SimTK::Exception::UnimplementedVirtualMethod , "OptimizerSystem", "hessian" );
                                  return -1; }
+    /// Returns a new copy of this OptimizerSystem, owned by the caller, or
+    /// null if it can't be copied (the default). Copies let numerical 
+    /// gradients and Jacobians evaluate objectiveFunc() and constraintFunc()
+    /// in several threads at once, each thread using its own copy, when
+    /// Optimizer::setDifferentiatorNumberOfThreads() allows that. 
+    /// Implement it with the copy constructor if the copy need share no 
+    /// state with the original: 
+    /// @code
+    ///     OptimizerSystem* clone() const override 
+    ///     {   return new MySystem(*this); }
+    /// @endcode
+    virtual OptimizerSystem* clone() const {return nullptr;}
+    /// Computes the elements of the constraint Jacobian that were declared
+    /// with setConstraintJacobianStructure(), in the same order, into
+    /// \p values (which already has the right length); return 0 when
+    /// successful. This is used instead of constraintJacobian() by optimizers
+    /// that exploit sparsity (currently InteriorPoint) when a structure has
+    /// been declared and a numerical Jacobian is not being used. The default
+    /// implementation calls constraintJacobian() and picks out the declared
+    /// elements, so it still forms the dense m by n Jacobian; override this
+    /// method for problems too large for that.
+    virtual int constraintJacobianNonzeros(const Vector& parameters,
+                                 bool new_parameters, Vector& values) const;
+    /// Computes the elements of the Hessian of the Lagrangian
+    /// <tt>objectiveFactor*f + sum_i multipliers[i]*c_i</tt> that were
+    /// declared with setLagrangianHessianStructure(), in the same order, into
+    /// \p values (which already has the right length); return 0 when
+    /// successful. Declaring a Hessian structure tells the InteriorPoint
+    /// optimizer to use this exact Hessian rather than its limited memory
+    /// approximation, so this method must then be supplied.
+    virtual int lagrangianHessianNonzeros(const Vector& parameters,
+                                 bool new_parameters, Real objectiveFactor,
+                                 const Vector& multipliers, 
+                                 bool new_multipliers, Vector& values) const {
+                                 SimTK_THROW2(SimTK::Exception::UnimplementedVirtualMethod , "OptimizerSystem", "lagrangianHessianNonzeros" );
+                                 return -1; }
 
    /// Sets the number of parameters in the objective function.
    void setNumParameters( const int nParameters ) {
@@ -203,6 +272,50 @@ public:
        }
    }
 
+   /// Declares which elements of the constraint Jacobian may be nonzero, as
+   /// (row,column) pairs with rows numbered like the constraints and columns
+   /// like the parameters. No element may be listed twice. The number of
+   /// parameters and constraints must be set first. Optimizers that exploit
+   /// sparsity then store only these elements, and a numerical Jacobian
+   /// perturbs structurally independent parameters together. Pass empty
+   /// arrays to go back to a dense Jacobian.
+   void setConstraintJacobianStructure(const Array_<int>& rows,
+                                       const Array_<int>& cols) {
+       checkStructure(rows, cols, getNumConstraints(), false,
+                      "setConstraintJacobianStructure");
+       jacobianRows = rows;
+       jacobianCols = cols;
+   }
+   /// Declares which elements of the Hessian of the Lagrangian may be
+   /// nonzero, as (row,column) pairs of parameter indices. The Hessian is
+   /// symmetric, so list only elements in its lower triangle (row >= column),
+   /// each at most once. See lagrangianHessianNonzeros().
+   void setLagrangianHessianStructure(const Array_<int>& rows,
+                                      const Array_<int>& cols) {
+       checkStructure(rows, cols, getNumParameters(), true,
+                      "setLagrangianHessianStructure");
+       hessianRows = rows;
+       hessianCols = cols;
+   }
+   /// Returns true if a constraint Jacobian structure has been declared.
+   bool hasConstraintJacobianStructure() const 
+   {   return !jacobianRows.empty(); }
+   /// Returns true if a Hessian of the Lagrangian structure has been declared.
+   bool hasLagrangianHessianStructure() const 
+   {   return !hessianRows.empty(); }
+   /// Returns the rows of the declared constraint Jacobian elements.
+   const Array_<int>& getConstraintJacobianStructureRows() const 
+   {   return jacobianRows; }
+   /// Returns the columns of the declared constraint Jacobian elements.
+   const Array_<int>& getConstraintJacobianStructureCols() const 
+   {   return jacobianCols; }
+   /// Returns the rows of the declared Hessian of the Lagrangian elements.
+   const Array_<int>& getLagrangianHessianStructureRows() const 
+   {   return hessianRows; }
+   /// Returns the columns of the declared Hessian of the Lagrangian elements.
+   const Array_<int>& getLagrangianHessianStructureCols() const 
+   {   return hessianCols; }
+
    /// Returns the number of parameters, that is, the number of variables that
    /// the Optimizer may adjust while searching for a solution.
    int getNumParameters() const {return numParameters;}
@@ -240,6 +353,12 @@ private:
    bool useLimits;
    Vector* lowerLimits;
    Vector* upperLimits;
+   Array_<int> jacobianRows, jacobianCols;
+   Array_<int> hessianRows, hessianCols;
+
+   void checkStructure(const Array_<int>& rows, const Array_<int>& cols,
+                       int numRows, bool lowerTriangle,
+                       const char* methodName) const;
 
 }; // class OptimizerSystem
 
@@ -479,6 +598,20 @@ public:
     /// @see SimTK::Differentiator
     Differentiator::Method getDifferentiatorMethod() const;
 
+    /// Set the number of threads the numerical gradient and Jacobian 
+    /// calculations may use to evaluate the perturbed objective or constraint
+    /// functions in parallel; 0 means use all the processors. The default is
+    /// 1, meaning serial evaluation. Each thread after the first uses its own
+    /// copy of your OptimizerSystem, so the evaluations are done serially 
+    /// anyway unless it implements OptimizerSystem::clone(). Unlike 
+    /// setDifferentiatorMethod(), this may be called before or after 
+    /// useNumericalGradient() or useNumericalJacobian().
+    /// @see SimTK::Differentiator::setNumberOfThreads()
+    void setDifferentiatorNumberOfThreads(int numThreads);
+    /// Return the value last supplied in a call to 
+    /// setDifferentiatorNumberOfThreads().
+    int getDifferentiatorNumberOfThreads() const;
+
     /// Return the algorithm used for the optimization. You may be interested
     /// in this value if you didn't specify an algorithm, or specified for
     /// Simbody to choose the BestAvailable algorithm. This method won't return
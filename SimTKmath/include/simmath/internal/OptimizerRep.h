@@ -76,6 +76,7 @@ public:
          limitedMemoryHistory(50),
          diagnosticsLevel(0),
          diffMethod(Differentiator::CentralDifference),
+         diffNumThreads(1),
          objectiveEstimatedAccuracy(SignificantReal),
          constraintsEstimatedAccuracy(SignificantReal),
          numericalGradient(false), 
@@ -96,6 +97,7 @@ public:
          limitedMemoryHistory(50),
          diagnosticsLevel(0),
          diffMethod(Differentiator::CentralDifference),
+         diffNumThreads(1),
          objectiveEstimatedAccuracy(SignificantReal),
          constraintsEstimatedAccuracy(SignificantReal),
          numericalGradient(false), 
@@ -136,10 +138,12 @@ public:
     void useNumericalGradient(bool flag, Real objEstAccuracy); 
     void useNumericalJacobian(bool flag, Real consEstAccuracy);  
     void setDifferentiatorMethod( Differentiator::Method method);
+    void setDifferentiatorNumberOfThreads(int numThreads);
 
     bool isUsingNumericalGradient() const { return numericalGradient; }
     bool isUsingNumericalJacobian() const { return numericalJacobian; }
     Differentiator::Method getDifferentiatorMethod() const {return diffMethod;}
+    int getDifferentiatorNumberOfThreads() const {return diffNumThreads;}
     Real getEstimatedAccuracyOfObjective() const 
     {   return objectiveEstimatedAccuracy; }
     Real getEstimatedAccuracyOfConstraints() const 
@@ -159,6 +163,13 @@ public:
         return UnknownOptimizerAlgorithm;
     }
 
+    // If a numerical Jacobian is in use, pass the OptimizerSystem's declared
+    // constraint Jacobian structure (if any) on to the Jacobian 
+    // Differentiator so that constraintJacobianWrapper() can calculate just
+    // the declared elements. Optimizers that use that structure call this
+    // before they start.
+    void initNumericalJacobianSparsity();
+
     static int numericalGradient_static( const OptimizerSystem&, const Vector & parameters,  const bool new_parameters,  Vector &gradient );
     static int numericalJacobian_static(const OptimizerSystem&,
                                    const Vector& parameters, const bool new_parameters, Matrix& jacobian );
@@ -185,6 +196,13 @@ protected:
     int maxIterations;
     int limitedMemoryHistory;
     Differentiator::Method   diffMethod;
+    int                      diffNumThreads;
+    // Copies of the OptimizerSystem, if it can make them, and the functions
+    // using them that are the Differentiators' clones of of and cf.
+    Array_<OptimizerSystem*>   sysClones;
+    Array_<SysObjectiveFunc*>  ofClones;
+    Array_<SysConstraintFunc*> cfClones;
+    int updateSystemClones();
     Real objectiveEstimatedAccuracy;
     Real constraintsEstimatedAccuracy;
 
@@ -195,6 +213,11 @@ private:
     Differentiator *gradDiff;   
     Differentiator *jacDiff; 
 
+    // For a sparse numerical Jacobian: where each element of the declared
+    // structure is found in the Differentiator's packed nonzeros.
+    Array_<int>    jacNonzeroOrder;
+    mutable Vector jacNonzeroTmp;
+
     SysObjectiveFunc  *of;   
     SysConstraintFunc *cf; 
 
@@ -29,7 +29,11 @@
 #include "SimTKcommon.h"
 #include "simmath/Differentiator.h"
 
+#include <atomic>
 #include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace SimTK {
 
@@ -77,6 +81,10 @@ public:
 
 
 
+// This is used as a value for y in calculating the step size when
+// the actual y is smaller.
+static const Real YMin = Real(0.1);
+
 // We want to perturb y0 by h such that the perturbation is
 // exactly representable in binary. hEst is our first guess
 // at h, which we calculate h=(y0+hEst)-y0 taking care not
@@ -86,6 +94,12 @@ static Real cleanUpH(Real hEst, Real y0) {
     return temp-y0;
 }
 
+// Calculate the perturbation to use for a parameter whose unperturbed value is
+// y0, given the accuracy factor for the method's order. 
+static Real calcPerturbation(Real accFac, Real y0) {
+    return cleanUpH(accFac*std::max(std::abs(y0), YMin), y0);
+}
+
 static void throwIfMethodInvalid(Differentiator::Method m, const char* op) {
     if (!Differentiator::isValidMethod(m))
         SimTK_THROW3(Differentiator::UnknownMethodSpecified, (int)m,
@@ -112,9 +126,6 @@ class ScalarFunctionRep;
 class GradientFunctionRep;
 class JacobianFunctionRep;
 
-// This is used as a value for y in calculating the step size when
-// the actual y is smaller.
-static const Real YMin = Real(0.1);
 class Differentiator::DifferentiatorRep {
 public:
     DifferentiatorRep(Differentiator* handle,
@@ -132,6 +143,9 @@ public:
                       const Vector& y0, Real fy0, Vector& gf)   const;
     void calcJacobian(const JacobianFunctionRep&, Differentiator::Method, 
                       const Vector& y0, const Vector& fy0, Matrix& dfdy) const;
+    void calcJacobianNonzeros(const JacobianFunctionRep&, Differentiator::Method,
+                              const Vector& y0, const Vector& fy0, 
+                              Vector& nonzeros) const;
 
     const Real& getAccFac(int order) const {
         if (order==1) return AccFac1;
@@ -144,6 +158,10 @@ public:
         nDifferentiations = nDifferentiationFailures = nCallsToUserFunction = 0;
     }
 
+    void setNumberOfThreads(int numThreads);
+    void addFunctionClone(const Differentiator::Function::FunctionRep&);
+    void setJacobianSparsityPattern(const Array_< Array_<int> >&);
+
     // Statistics
     mutable int nDifferentiations; 
     mutable int nDifferentiationFailures; 
@@ -167,11 +185,49 @@ private:
     // upon construction.
     const Real AccFac1, AccFac2;
 
+    // Parallel evaluation. The perturbed evaluations for a gradient or 
+    // Jacobian are divided among workers; worker w uses the function object
+    // getWorkerFunction(w) and its own temporaries below.
+    int numThreads;
+    std::unique_ptr<ParallelExecutor> executor; // only if numThreads > 1
+    Array_<const Differentiator::Function::FunctionRep*> clones;
+
+    // Jacobian sparsity, if declared: the rows that can be nonzero in each
+    // column, and the groups of columns that are perturbed together.
+    Array_< Array_<int> > nonzeroRows;  // [NParameters] or empty
+    Array_< Array_<int> > columnGroups; // empty if no sparsity declared
+    Array_<int>           nonzeroStart; // [NParameters+1] packed col offsets
+
+    // Each worker after the first needs its own clone of the function, so
+    // without clones everything is done serially.
+    int getNumWorkers(int numTasks) const {
+        const int n = std::min(std::min(numThreads, numTasks), 
+                               (int)clones.size()+1);
+        return std::max(n, 1);
+    }
+
+    // F is the concrete FunctionRep type; clones were checked on the way in
+    // to be of the same kind as the function being differentiated.
+    template <class F>
+    const F& getWorkerFunction(const F& f, int w) const {
+        return w==0 ? f : static_cast<const F&>(*clones[w-1]);
+    }
+
+    // Call work(w) for w=0..numWorkers-1, in parallel if numWorkers > 1. An
+    // exception thrown by any worker is rethrown here.
+    void runWorkers(int numWorkers, const std::function<void(int)>& work) const;
+
+    // Common implementation of calcJacobian() and calcJacobianNonzeros();
+    // exactly one of dfdy and nonzeros is non-null.
+    void calcJacobianImpl(const JacobianFunctionRep&, Differentiator::Method,
+                          const Vector& y0, const Vector& fy0, 
+                          Matrix* dfdy, Vector* nonzeros) const;
+
     // These temporaries are kept here so we can reuse their storage space
-    // from call to call once they have been allocated at construction. 
+    // from call to call once they have been allocated, one set per worker. 
     // The *values* do not persist across calls.
-    mutable Vector ytmp;           // [NParameters]
-    mutable Vector fyptmp, fymtmp; // [NFunctions]
+    mutable Array_<Vector> ytmp;           // [worker][NParameters]
+    mutable Array_<Vector> fyptmp, fymtmp; // [worker][NFunctions]
 
     // suppress
     DifferentiatorRep(const DifferentiatorRep&);
@@ -218,13 +274,15 @@ public:
     }
 
     void resetAllStatistics() {
-        nCalls = nFailures = 0;
+        nCalls = 0;
+        nFailures = 0;
     }
 
 protected:
-    // Stats
-    mutable int nCalls;
-    mutable int nFailures;
+    // Stats; atomic since a function may be called from several threads at
+    // once during parallel differentiation.
+    mutable std::atomic<int> nCalls;
+    mutable std::atomic<int> nFailures;
 
 private:
     int  nFunc, nParam;
@@ -451,6 +509,40 @@ Differentiator::Method Differentiator::getDefaultMethod() const {
     return rep->defaultMethod;
 }
 
+Differentiator& Differentiator::setNumberOfThreads(int numThreads) {
+    rep->setNumberOfThreads(numThreads);
+    return *this;
+}
+
+int Differentiator::getNumberOfThreads() const {
+    return rep->numThreads;
+}
+
+Differentiator& Differentiator::addFunctionClone(const Function& clone) {
+    rep->addFunctionClone(*clone.rep);
+    return *this;
+}
+
+int Differentiator::getNumFunctionClones() const {
+    return (int)rep->clones.size();
+}
+
+Differentiator& Differentiator::setJacobianSparsityPattern
+   (const Array_< Array_<int> >& nonzeroRowsByColumn) 
+{
+    rep->setJacobianSparsityPattern(nonzeroRowsByColumn);
+    return *this;
+}
+
+int Differentiator::getNumJacobianNonzeros() const {
+    return rep->nonzeroStart.empty() ? 0 : rep->nonzeroStart.back();
+}
+
+int Differentiator::getNumJacobianColumnGroups() const {
+    return rep->columnGroups.empty() ? rep->NParameters 
+                                     : (int)rep->columnGroups.size();
+}
+
 void Differentiator::calcDerivative
    (Real y0, Real fy0, Real& dfdy, Differentiator::Method m) const 
 {
@@ -527,6 +619,37 @@ void Differentiator::calcJacobian
     rep->nDifferentiationFailures--;
 }
 
+void Differentiator::calcJacobianNonzeros
+   (const Vector& y0, const Vector& fy0, Vector& nonzeros,
+   Differentiator::Method m) const 
+{
+    rep->nDifferentiations++;
+    rep->nDifferentiationFailures++; // assume the worst
+
+    const JacobianFunctionRep* jf = 
+        dynamic_cast<const JacobianFunctionRep*>(&rep->frep);
+    if (!jf)
+        SimTK_THROW5(Differentiator::OpNotAllowedForFunctionOfThisShape,
+            "calcJacobianNonzeros", "JacobianFunction", 
+            rep->frep.functionKind(), rep->NFunctions, rep->NParameters);
+
+    SimTK_APIARGCHECK_ALWAYS(!rep->nonzeroStart.empty(), 
+        "Differentiator", "calcJacobianNonzeros",
+        "A Jacobian sparsity pattern must be set first.");
+
+    SimTK_APIARGCHECK2_ALWAYS(y0.size()==rep->NParameters, "Differentiator", "calcJacobianNonzeros",
+        "Expecting %d elements in the parameter (state) vector but got %d", 
+        rep->NParameters, (int)y0.size());
+
+    SimTK_APIARGCHECK2_ALWAYS(fy0.size()==rep->NFunctions, "Differentiator", "calcJacobianNonzeros",
+        "Expecting %d elements in the unperturbed function value but got %d", 
+        rep->NFunctions, (int)fy0.size());
+
+    rep->calcJacobianNonzeros(*jf,m,y0,fy0,nonzeros);
+
+    rep->nDifferentiationFailures--;
+}
+
 // The slow version
 Matrix Differentiator::calcJacobian
    (const Vector& y0, Differentiator::Method m) const 
@@ -687,15 +810,112 @@ Differentiator::DifferentiatorRep::DifferentiatorRep
     EstimatedAccuracy(fr.getEstimatedAccuracy()),
     defaultMethod(getMethodOrThrow(defMthd, DefaultDefaultMethod, "Differentiator")),
     AccFac1(std::sqrt(EstimatedAccuracy)),
-    AccFac2(std::pow(EstimatedAccuracy, OneThird))
+    AccFac2(std::pow(EstimatedAccuracy, OneThird)),
+    numThreads(1)
 {
     //TODO
     assert(NParameters >= 0 && NFunctions >= 0 && EstimatedAccuracy > 0);
 
     resetAllStatistics();
-    ytmp.resize(NParameters);
-    fyptmp.resize(NFunctions);
-    fymtmp.resize(NFunctions);
+    ytmp.resize(1, Vector(NParameters));
+    fyptmp.resize(1, Vector(NFunctions));
+    fymtmp.resize(1, Vector(NFunctions));
+}
+
+void Differentiator::DifferentiatorRep::setNumberOfThreads(int n) {
+    SimTK_APIARGCHECK1_ALWAYS(n >= 0, "Differentiator", "setNumberOfThreads",
+        "The number of threads was %d but must be >= 0", n);
+    if (n == 0)
+        n = std::max(ParallelExecutor::getNumProcessors(), 1);
+    numThreads = n;
+    if (numThreads > 1)
+        executor.reset(new ParallelExecutor(numThreads));
+    else
+        executor.reset();
+}
+
+void Differentiator::DifferentiatorRep::addFunctionClone
+   (const Differentiator::Function::FunctionRep& clone)
+{
+    SimTK_APIARGCHECK_ALWAYS(&clone != &frep, "Differentiator", 
+        "addFunctionClone", 
+        "The clone must be a different object than the function itself.");
+    SimTK_APIARGCHECK4_ALWAYS(clone.functionKind() == frep.functionKind()
+        && clone.getNumFunctions() == NFunctions 
+        && clone.getNumParameters() == NParameters,
+        "Differentiator", "addFunctionClone",
+        "The clone must be a %s with %d functions of %d parameters "
+        "like the function being differentiated, but it is a %s.",
+        frep.functionKind().c_str(), NFunctions, NParameters,
+        clone.functionKind().c_str());
+    clones.push_back(&clone);
+}
+
+// Columns of the Jacobian that have no nonzero rows in common can be perturbed
+// together. We choose the groups by greedy coloring: each column goes in the 
+// first group none of whose columns uses any of its rows. That isn't optimal
+// but does well on the banded and block structures that usually occur.
+void Differentiator::DifferentiatorRep::setJacobianSparsityPattern
+   (const Array_< Array_<int> >& pattern)
+{
+    SimTK_APIARGCHECK2_ALWAYS(pattern.empty() || (int)pattern.size()==NParameters,
+        "Differentiator", "setJacobianSparsityPattern",
+        "Expected a list of nonzero rows for each of the %d parameters but "
+        "got %d lists.", NParameters, (int)pattern.size());
+    for (int j=0; j < (int)pattern.size(); ++j)
+        for (int r : pattern[j])
+            SimTK_APIARGCHECK3_ALWAYS(0 <= r && r < NFunctions,
+                "Differentiator", "setJacobianSparsityPattern",
+                "Column %d has a nonzero in row %d but there are only %d "
+                "functions.", j, r, NFunctions);
+
+    nonzeroRows = pattern;
+    columnGroups.clear();
+    nonzeroStart.clear();
+    if (pattern.empty())
+        return;
+
+    nonzeroStart.resize(NParameters+1);
+    nonzeroStart[0] = 0;
+    for (int j=0; j < NParameters; ++j)
+        nonzeroStart[j+1] = nonzeroStart[j] + (int)pattern[j].size();
+
+    std::vector< std::vector<bool> > rowUsedByGroup;
+    for (int j=0; j < NParameters; ++j) {
+        int g = 0;
+        for (; g < (int)columnGroups.size(); ++g) {
+            bool conflict = false;
+            for (int r : pattern[j])
+                if (rowUsedByGroup[g][r]) {conflict = true; break;}
+            if (!conflict)
+                break;
+        }
+        if (g == (int)columnGroups.size()) {
+            columnGroups.push_back(Array_<int>());
+            rowUsedByGroup.push_back(std::vector<bool>(NFunctions, false));
+        }
+        columnGroups[g].push_back(j);
+        for (int r : pattern[j])
+            rowUsedByGroup[g][r] = true;
+    }
+}
+
+void Differentiator::DifferentiatorRep::runWorkers
+   (int numWorkers, const std::function<void(int)>& work) const
+{
+    for (int w = (int)ytmp.size(); w < numWorkers; ++w) {
+        ytmp.push_back(Vector(NParameters));
+        fyptmp.push_back(Vector(NFunctions));
+        fymtmp.push_back(Vector(NFunctions));
+    }
+
+    if (numWorkers == 1) {
+        work(0);
+        return;
+    }
+
+    assert(executor);
+    executor->execute(work, numWorkers);
 }
 
 void Differentiator::DifferentiatorRep::calcDerivative
@@ -731,62 +951,126 @@ void Differentiator::DifferentiatorRep::calcGradient
 
     //TODO
     assert(NFunctions==1);
-    assert(ytmp.size()==NParameters);
     assert(y0.size() == NParameters);
 
     gradf.resize(NParameters);
 
-    ytmp = y0;
     const int order = Differentiator::getMethodOrder(method);
-
-    for (int i=0; i < f.getNumParameters(); ++i) {
-        const Real hEst = getAccFac(order)*std::max(std::abs(y0[i]), YMin);
-        const Real h = cleanUpH(hEst, y0[i]);
-        Real fyplus, fyminus;
-        ytmp[i] = y0[i]+h; 
-        nCallsToUserFunction++; f.call(ytmp, fyplus);
-        if (order==1) {
-            gradf[i] = (fyplus-fy0)/h;
-        } else {
-            ytmp[i] = y0[i]-h; 
-            nCallsToUserFunction++; f.call(ytmp, fyminus);
-            gradf[i] = (fyplus-fyminus)/(2*h);
+    const Real accFac = getAccFac(order);
+
+    // Worker w does parameters w, w+numWorkers, w+2*numWorkers, ...
+    const int numWorkers = getNumWorkers(NParameters);
+    Array_<int> numCalls(numWorkers, 0);
+    runWorkers(numWorkers, [&](int w) {
+        const GradientFunctionRep& fw = getWorkerFunction(f, w);
+        Vector& y = ytmp[w];
+        y = y0;
+        for (int i=w; i < NParameters; i += numWorkers) {
+            const Real h = calcPerturbation(accFac, y0[i]);
+            Real fyplus, fyminus;
+            y[i] = y0[i]+h; 
+            ++numCalls[w]; fw.call(y, fyplus);
+            if (order==1) {
+                gradf[i] = (fyplus-fy0)/h;
+            } else {
+                y[i] = y0[i]-h; 
+                ++numCalls[w]; fw.call(y, fyminus);
+                gradf[i] = (fyplus-fyminus)/(2*h);
+            }
+            y[i] = y0[i]; // restore
         }
-        ytmp[i] = y0[i]; // restore
-    }
+    });
+    for (int n : numCalls)
+        nCallsToUserFunction += n;
 }
 
 void Differentiator::DifferentiatorRep::calcJacobian
    (const JacobianFunctionRep& f, Differentiator::Method m, 
     const Vector& y0, const Vector& fy0, Matrix& dfdy) const 
+{
+    dfdy.resize(NFunctions,NParameters);
+    calcJacobianImpl(f, m, y0, fy0, &dfdy, nullptr);
+}
+
+void Differentiator::DifferentiatorRep::calcJacobianNonzeros
+   (const JacobianFunctionRep& f, Differentiator::Method m, 
+    const Vector& y0, const Vector& fy0, Vector& nonzeros) const 
+{
+    assert(!nonzeroStart.empty());
+    nonzeros.resize(nonzeroStart.back());
+    calcJacobianImpl(f, m, y0, fy0, nullptr, &nonzeros);
+}
+
+void Differentiator::DifferentiatorRep::calcJacobianImpl
+   (const JacobianFunctionRep& f, Differentiator::Method m, 
+    const Vector& y0, const Vector& fy0, Matrix* dfdy, Vector* nonzeros) const 
 {
     // This won't return if the method is bad.
     const Differentiator::Method method = getMethodOrThrow(m, defaultMethod, "calcJacobian");
 
     //TODO
-    assert(ytmp.size()==NParameters && fyptmp.size()==NFunctions && fymtmp.size()==NFunctions);
     assert(y0.size()  == NParameters);
     assert(fy0.size() == NFunctions);
-
-    dfdy.resize(NFunctions,NParameters);
+    assert((dfdy==nullptr) != (nonzeros==nullptr));
 
     const int order = Differentiator::getMethodOrder(method);
-
-    ytmp = y0;
-    for (int i=0; i < NParameters; ++i) {
-        const Real hEst = getAccFac(order)*std::max(std::abs(y0[i]), YMin);
-        const Real h = cleanUpH(hEst, y0[i]);
-        ytmp[i] = y0[i]+h; 
-        nCallsToUserFunction++; f.call(ytmp, fyptmp);
-        if (order==1) {
-            dfdy(i) = (fyptmp-fy0)/h;
-        } else {
-            ytmp[i] = y0[i]-h; 
-            nCallsToUserFunction++; f.call(ytmp, fymtmp);
-            dfdy(i) = (fyptmp-fymtmp)/(2*h);
+    const Real accFac = getAccFac(order);
+
+    // Without a sparsity pattern each column is a group by itself. Worker w
+    // does groups w, w+numWorkers, w+2*numWorkers, ...; since the groups 
+    // don't share columns the workers write to different output elements.
+    const bool isSparse = !columnGroups.empty();
+    const int numGroups = isSparse ? (int)columnGroups.size() : NParameters;
+    const int numWorkers = getNumWorkers(numGroups);
+    Array_<int> numCalls(numWorkers, 0);
+    runWorkers(numWorkers, [&](int w) {
+        const JacobianFunctionRep& fw = getWorkerFunction(f, w);
+        Vector& y = ytmp[w]; Vector& fyp = fyptmp[w]; Vector& fym = fymtmp[w];
+        y = y0;
+        for (int g=w; g < numGroups; g += numWorkers) {
+            const int  numCols = isSparse ? (int)columnGroups[g].size() : 1;
+            const int* cols    = isSparse ? columnGroups[g].cbegin() : &g;
+
+            for (int k=0; k < numCols; ++k) {
+                const int j = cols[k];
+                y[j] = y0[j] + calcPerturbation(accFac, y0[j]);
+            }
+            ++numCalls[w]; fw.call(y, fyp);
+            if (order==2) {
+                for (int k=0; k < numCols; ++k) {
+                    const int j = cols[k];
+                    y[j] = y0[j] - calcPerturbation(accFac, y0[j]);
+                }
+                ++numCalls[w]; fw.call(y, fym);
+            }
+
+            for (int k=0; k < numCols; ++k) {
+                const int j = cols[k];
+                const Real h = calcPerturbation(accFac, y0[j]);
+                if (nonzeros) {
+                    // Every row in the group's difference belongs to at
+                    // most one of its columns.
+                    Real* nz = &(*nonzeros)[nonzeroStart[j]];
+                    for (int r : nonzeroRows[j])
+                        *nz++ = order==1 ? (fyp[r]-fy0[r])/h 
+                                         : (fyp[r]-fym[r])/(2*h);
+                } else if (isSparse) {
+                    VectorView col = (*dfdy)(j);
+                    col = 0;
+                    for (int r : nonzeroRows[j])
+                        col[r] = order==1 ? (fyp[r]-fy0[r])/h 
+                                          : (fyp[r]-fym[r])/(2*h);
+                } else if (order==1) {
+                    (*dfdy)(j) = (fyp-fy0)/h;
+                } else {
+                    (*dfdy)(j) = (fyp-fym)/(2*h);
+                }
+                y[j] = y0[j]; // restore
+            }
         }
-        ytmp[i] = y0[i]; // restore
-    }
+    });
+    for (int n : numCalls)
+        nCallsToUserFunction += n;
 }
 
 } // namespace SimTK
@@ -38,6 +38,7 @@ using SimTK::Real;
 using SimTK::Vector;
 using SimTK::Matrix;
 using SimTK::Differentiator;
+using SimTK::Array_;
 using std::printf;
 using std::cout;
 using std::endl;
@@ -191,6 +192,157 @@ static void doSinOmegaExample() {
 };
 
 
+// A tridiagonal system: f_i depends only on y_(i-1), y_i, and y_(i+1). This
+// also serves as the objective for gradients, via its sum.
+class TridiagonalFunc : public Differentiator::JacobianFunction {
+public:
+    explicit TridiagonalFunc(int n) 
+        : Differentiator::JacobianFunction(n,n), failAt(-1) { }
+
+    // Make f() fail when y[i] is perturbed from yi, for testing errors.
+    void setFailAt(int i, Real yi) {failAt=i; failValue=yi;}
+
+    int f(const Vector& y, Vector& fy) const override {
+        const int n = y.size();
+        if (failAt >= 0 && y[failAt] != failValue) return 1;
+        for (int i=0; i < n; ++i) {
+            fy[i] = y[i]*y[i];
+            if (i > 0)   fy[i] += std::sin(y[i-1]);
+            if (i < n-1) fy[i] += y[i]*y[i+1];
+        }
+        return 0;
+    }
+private:
+    int  failAt;
+    Real failValue;
+};
+
+class TridiagonalSumFunc : public Differentiator::GradientFunction {
+public:
+    explicit TridiagonalSumFunc(int n) 
+        : Differentiator::GradientFunction(n), tri(n) { }
+    int f(const Vector& y, Real& fy) const override {
+        Vector fyv(y.size());
+        const int status = tri.f(y, fyv);
+        fy = fyv.sum();
+        return status;
+    }
+private:
+    TridiagonalFunc tri;
+};
+
+// Parallel and sparse (compressed) differentiation must give the same 
+// results as the serial, dense calculation to within roundoff, since the 
+// same perturbations are used for each element.
+static void testParallelAndSparse() {
+    const int n = 30;
+    TridiagonalFunc vf(n), clone1(n), clone2(n);
+    Vector y0(n), fy0(n);
+    for (int i=0; i < n; ++i) y0[i] = 1 + Real(i)/n;
+    vf.f(y0, fy0);
+
+    Array_< Array_<int> > pattern(n);
+    for (int j=0; j < n; ++j)
+        for (int r=std::max(j-1,0); r <= std::min(j+1,n-1); ++r)
+            pattern[j].push_back(r);
+
+    for (int order=1; order <= 2; ++order) {
+        const Differentiator::Method method = order==1 
+            ? Differentiator::ForwardDifference 
+            : Differentiator::CentralDifference;
+        Matrix J0, J;
+
+        Differentiator serial(vf, method);
+        serial.calcJacobian(y0, fy0, J0);
+        SimTK_ASSERT_ALWAYS(serial.getNumCallsToUserFunction() == order*n,
+            "Dense Jacobian should perturb each column.");
+
+        Differentiator sparse(vf, method);
+        sparse.setJacobianSparsityPattern(pattern);
+        SimTK_ASSERT_ALWAYS(sparse.getNumJacobianColumnGroups() == 3,
+            "A tridiagonal pattern should need three column groups.");
+        sparse.calcJacobian(y0, fy0, J);
+        SimTK_ASSERT_ALWAYS(sparse.getNumCallsToUserFunction() == order*3,
+            "Sparse Jacobian should perturb each column group once.");
+        SimTK_ASSERT_ALWAYS((J-J0).norm() <= 1e-12*J0.norm(),
+            "Sparse Jacobian differs from dense one.");
+
+        // The packed nonzeros follow the pattern column by column.
+        Vector nonzeros;
+        sparse.calcJacobianNonzeros(y0, fy0, nonzeros);
+        SimTK_ASSERT_ALWAYS(nonzeros.size() == sparse.getNumJacobianNonzeros()
+                            && nonzeros.size() == 3*n-2,
+            "Wrong number of Jacobian nonzeros.");
+        int k = 0;
+        for (int j=0; j < n; ++j)
+            for (int r : pattern[j])
+                SimTK_ASSERT_ALWAYS(nonzeros[k++] == J(r,j),
+                    "Packed Jacobian nonzero differs from calcJacobian().");
+
+        // Without clones, threads are not used since f() needn't be thread
+        // safe; the original function makes all the calls.
+        vf.resetAllStatistics();
+        Differentiator parallel(vf, method);
+        parallel.setNumberOfThreads(4);
+        parallel.calcJacobian(y0, fy0, J);
+        SimTK_ASSERT_ALWAYS(parallel.getNumCallsToUserFunction() == order*n
+                            && vf.getNumCalls() == order*n,
+            "Jacobian without clones made the wrong number of calls.");
+        SimTK_ASSERT_ALWAYS((J-J0).norm() <= 1e-12*J0.norm(),
+            "Jacobian without clones differs from serial one.");
+
+        // Each worker uses its own function object, so with two clones the 
+        // work is split three ways.
+        vf.resetAllStatistics(); 
+        clone1.resetAllStatistics(); clone2.resetAllStatistics();
+        Differentiator cloned(vf, method);
+        cloned.setNumberOfThreads(4).addFunctionClone(clone1)
+              .addFunctionClone(clone2);
+        cloned.calcJacobian(y0, fy0, J);
+        SimTK_ASSERT_ALWAYS(vf.getNumCalls() == order*n/3
+                            && clone1.getNumCalls() == order*n/3
+                            && clone2.getNumCalls() == order*n/3,
+            "Cloned functions should have shared the work.");
+        SimTK_ASSERT_ALWAYS((J-J0).norm() <= 1e-12*J0.norm(),
+            "Jacobian using clones differs from serial one.");
+
+        cloned.setJacobianSparsityPattern(pattern);
+        cloned.calcJacobian(y0, fy0, J);
+        SimTK_ASSERT_ALWAYS((J-J0).norm() <= 1e-12*J0.norm(),
+            "Parallel sparse Jacobian differs from serial one.");
+
+        TridiagonalSumFunc sf(n), sfClone1(n), sfClone2(n);
+        Real sfy0; sf.f(y0, sfy0);
+        Vector g0, g;
+        Differentiator(sf, method).calcGradient(y0, sfy0, g0);
+        Differentiator parallelGrad(sf, method);
+        parallelGrad.setNumberOfThreads(3).addFunctionClone(sfClone1)
+                    .addFunctionClone(sfClone2).calcGradient(y0, sfy0, g);
+        SimTK_ASSERT_ALWAYS((g-g0).norm() <= 1e-12*g0.norm(),
+            "Parallel gradient differs from serial one.");
+    }
+
+    // A failure in any of the threads must be reported to the caller.
+    vf.setFailAt(1, y0[1]);
+    clone1.setFailAt(1, y0[1]);
+    clone2.setFailAt(1, y0[1]);
+    Differentiator parallel(vf);
+    parallel.setNumberOfThreads(4).addFunctionClone(clone1)
+            .addFunctionClone(clone2);
+    bool threw = false;
+    Matrix J;
+    try {parallel.calcJacobian(y0, fy0, J);}
+    catch (const std::exception&) {threw = true;}
+    SimTK_ASSERT_ALWAYS(threw, "Failure in a parallel evaluation was lost.");
+
+    // A clone must have the same shape.
+    TridiagonalFunc wrongSize(n+1);
+    threw = false;
+    try {parallel.addFunctionClone(wrongSize);}
+    catch (const std::exception&) {threw = true;}
+    SimTK_ASSERT_ALWAYS(threw, "Clone of the wrong shape was accepted.");
+}
+
 static Real mysin(Real x) {
     return std::sin(x);
 }
@@ -225,6 +377,8 @@ int main() {
 
     int returnValue = 0; // assume success
   try {
+    testParallelAndSparse();
+
     gradf.setDefaultMethod(Differentiator::ForwardDifference);
     df.setDefaultMethod(Differentiator::UnspecifiedMethod);
 
@@ -0,0 +1,183 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check the interpolated states returned at report times, which come from the
+integrator's dense output if it has one (RungeKuttaMerson), otherwise from
+Hermite interpolation. They should agree with the states obtained by stopping
+the integrator at the report times, the dense output should be at least as
+good as Hermite interpolation over the same steps, and interpolated states
+should be left unrealized if the user asks for that. */
+
+#include "SimTKmath.h"
+
+#include "PendulumSystem.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace SimTK;
+using std::cout;
+using std::endl;
+
+namespace {
+const Real Accuracy = 1e-6;
+const Real ReportInterval = 0.01;
+const int NReports = 200;
+
+enum Method {Merson, Feldberg, RK3};
+
+Real maxAbsDifference(const Matrix& a, const Matrix& b) {
+    Real diff = 0;
+    for (int i=0; i < a.nrow(); ++i)
+        for (int j=0; j < a.ncol(); ++j)
+            diff = std::max(diff, std::abs(a(i,j) - b(i,j)));
+    return diff;
+}
+
+Integrator* makeIntegrator(Method method, const System& system) {
+    switch (method) {
+    case Merson:   return new RungeKuttaMersonIntegrator(system);
+    case Feldberg: return new RungeKuttaFeldbergIntegrator(system);
+    default:       return new RungeKutta3Integrator(system);
+    }
+}
+
+// Cubic Hermite interpolation of q between two realized states.
+Vector interpolateQ(const State& s0, const State& s1, Real t) {
+    const Real h = s1.getTime() - s0.getTime();
+    const Real d = (t - s0.getTime())/h;
+    const Real h00 = (2*d-3)*d*d+1, h10 = ((d-2)*d+1)*d,
+               h01 = (3-2*d)*d*d,   h11 = (d-1)*d*d;
+    return h00*s0.getQ() + (h10*h)*s0.getQDot()
+         + h01*s1.getQ() + (h11*h)*s1.getQDot();
+}
+
+// Record q at each report time, and in qHermite what Hermite interpolation
+// between the ends of the same step would have given instead. If
+// allowInterpolation is false the integrator has to stop at each report time
+// so these are real trajectory states.
+Matrix simulate(Method method, PendulumSystem& system, bool allowInterpolation,
+                bool realizeInterpolated, int& nVelocityRealizations,
+                Matrix& qHermite) {
+    std::unique_ptr<Integrator> integ(makeIntegrator(method, system));
+    integ->setAccuracy(Accuracy);
+    integ->setConstraintTolerance(Accuracy);
+    integ->setAllowInterpolation(allowInterpolation);
+    integ->setRealizeInterpolatedStates(realizeInterpolated);
+    integ->setReturnEveryInternalStep(true);
+    integ->initialize(system.getDefaultState());
+    system.resetAllCountersToZero();
+
+    // The ends of the most recent step, realized only for Hermite
+    // interpolation, after the counters have been read.
+    std::vector<State> stepEnds(1, integ->getAdvancedState());
+    Array_<int> stepOfReport;
+
+    Matrix q(NReports, 2);
+    int nInterpolated = 0;
+    for (int i=0; i < NReports; ++i) {
+        const Real tReport = (i+1)*ReportInterval;
+        do {
+            integ->stepTo(tReport);
+            if (integ->getAdvancedTime() > stepEnds.back().getTime())
+                stepEnds.push_back(integ->getAdvancedState());
+        } while (integ->getTime() < tReport);
+        const State& state = integ->getState();
+        SimTK_TEST(state.getTime() == tReport);
+        if (integ->isStateInterpolated()) {
+            ++nInterpolated;
+            SimTK_TEST((state.getSystemStage() >= Stage::Velocity)
+                       == realizeInterpolated);
+        }
+        q[i] = ~state.getQ();
+        stepOfReport.push_back(integ->isStateInterpolated() 
+                               ? (int)stepEnds.size()-1 : -1);
+    }
+    SimTK_TEST((nInterpolated > NReports/2) == allowInterpolation);
+
+    nVelocityRealizations = 
+        system.getNumRealizationsOfThisStage(Stage::Velocity);
+
+    for (State& end : stepEnds)
+        system.realize(end, Stage::Acceleration);
+    qHermite = q;
+    for (int i=0; i < NReports; ++i) {
+        const int k = stepOfReport[i];
+        if (k > 0)
+            qHermite[i] = ~interpolateQ(stepEnds[k-1], stepEnds[k], 
+                                        (i+1)*ReportInterval);
+    }
+    return q;
+}
+
+void testMethod(Method method) {
+    PendulumSystem system;
+    system.realizeTopology();
+    system.setDefaultMass(1);
+    const Real qi[] = {1,0}, ui[] = {0,0};
+    system.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+
+    int nStopping, nRealized, nUnrealized;
+    Matrix qHermite, qHermiteUnrealized, unused;
+    const Matrix qStopping = simulate(method, system, false, true, nStopping,
+                                      unused);
+    const Matrix qRealized = simulate(method, system, true, true, nRealized,
+                                      qHermite);
+    const Matrix qUnrealized = simulate(method, system, true, false, 
+                                        nUnrealized, qHermiteUnrealized);
+
+    const Real errRealized = maxAbsDifference(qRealized, qStopping);
+    const Real errUnrealized = maxAbsDifference(qUnrealized, qStopping);
+    const Real errHermite = maxAbsDifference(qHermite, qStopping);
+    cout << "method " << method << ": interpolation error " << errRealized 
+         << " (" << errUnrealized << " unrealized, " << errHermite 
+         << " Hermite); velocity realizations "
+         << nStopping << "/" << nRealized << "/" << nUnrealized << endl;
+
+    // Without dense output the integrator uses Hermite interpolation itself.
+    if (method == RK3)
+        SimTK_TEST_EQ_TOL(errRealized, errHermite, 1e-12);
+    SimTK_TEST(errRealized <= 1.1*errHermite);
+    // Hermite interpolation over Feldberg's long steps is much less accurate
+    // than the steps themselves; only the dense output keeps up.
+    if (method == Merson)
+        SimTK_TEST(errRealized < 10*Accuracy);
+    // Skipping projection of an unrealized state doesn't matter here since
+    // the pendulum's end-of-step projection is tiny.
+    SimTK_TEST_EQ_TOL(errUnrealized, errRealized, Accuracy);
+    SimTK_TEST(nUnrealized < nRealized);
+}
+}
+
+void testMerson()   {testMethod(Merson);}
+void testFeldberg() {testMethod(Feldberg);}
+void testRK3()      {testMethod(RK3);}
+
+int main() {
+    SimTK_START_TEST("InterpolatedStateTest");
+        SimTK_SUBTEST(testMerson);
+        SimTK_SUBTEST(testFeldberg);
+        SimTK_SUBTEST(testRK3);
+    SimTK_END_TEST();
+}
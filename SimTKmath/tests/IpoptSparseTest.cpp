@@ -0,0 +1,195 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKmath.h"
+
+#include <iostream>
+using std::cout;
+using std::endl;
+using namespace SimTK;
+
+/*
+ * A chain of n parameters, each coupled only to its neighbors:
+ *
+ *     min   sum_i x_i^2 / 2
+ *     s.t.  x_i * x_(i+1) = 1,   i = 0..n-2
+ *
+ * Starting from x = 2 the solution is x = 1, with f = n/2. Each constraint
+ * row of the Jacobian has two nonzeros, and the Hessian of the Lagrangian
+ * has the diagonal plus one subdiagonal.
+ */
+class ChainSystem : public OptimizerSystem {
+public:
+    ChainSystem(int n, bool declareJacobian, bool declareHessian)
+    :   OptimizerSystem(n) {
+        setNumEqualityConstraints(n-1);
+        if (declareJacobian) {
+            Array_<int> rows, cols;
+            for (int i=0; i < n-1; ++i) {
+                rows.push_back(i); cols.push_back(i);
+                rows.push_back(i); cols.push_back(i+1);
+            }
+            setConstraintJacobianStructure(rows, cols);
+        }
+        if (declareHessian) {
+            Array_<int> rows, cols;
+            for (int i=0; i < n; ++i) {
+                rows.push_back(i); cols.push_back(i);
+            }
+            for (int i=0; i < n-1; ++i) {
+                rows.push_back(i+1); cols.push_back(i);
+            }
+            setLagrangianHessianStructure(rows, cols);
+        }
+    }
+
+    int objectiveFunc(const Vector& x, bool, Real& f) const override {
+        f = (~x*x)/2;
+        return 0;
+    }
+
+    int gradientFunc(const Vector& x, bool, Vector& gradient) const override {
+        gradient = x;
+        return 0;
+    }
+
+    int constraintFunc(const Vector& x, bool, Vector& c) const override {
+        for (int i=0; i < getNumConstraints(); ++i)
+            c[i] = x[i]*x[i+1] - 1;
+        return 0;
+    }
+
+    // Only the dense form is needed for the default 
+    // constraintJacobianNonzeros(), which is compared against below.
+    int constraintJacobian(const Vector& x, bool, Matrix& jac) const override {
+        jac = 0;
+        for (int i=0; i < getNumConstraints(); ++i) {
+            jac(i,i) = x[i+1]; jac(i,i+1) = x[i];
+        }
+        return 0;
+    }
+
+    int lagrangianHessianNonzeros(const Vector& x, bool, Real objectiveFactor,
+                                  const Vector& multipliers, bool, 
+                                  Vector& values) const override {
+        const int n = getNumParameters();
+        for (int i=0; i < n; ++i)
+            values[i] = objectiveFactor;
+        for (int i=0; i < n-1; ++i)
+            values[n+i] = multipliers[i];
+        return 0;
+    }
+};
+
+// Same problem, but with the Jacobian supplied only as its nonzeros.
+class SparseChainSystem : public ChainSystem {
+public:
+    explicit SparseChainSystem(int n) : ChainSystem(n, true, true) {}
+
+    int constraintJacobian(const Vector&, bool, Matrix&) const override {
+        SimTK_TEST_FAILED("The dense Jacobian should not be requested.");
+        return -1;
+    }
+
+    int constraintJacobianNonzeros(const Vector& x, bool, 
+                                   Vector& values) const override {
+        for (int i=0; i < getNumConstraints(); ++i) {
+            values[2*i] = x[i+1]; values[2*i+1] = x[i];
+        }
+        return 0;
+    }
+};
+
+static void testSolution(const ChainSystem& sys, Optimizer& opt) {
+    const int n = sys.getNumParameters();
+    opt.setConvergenceTolerance(1e-8);
+    opt.setConstraintTolerance(1e-10);
+    Vector x(n, Real(2));
+    const Real f = opt.optimize(x);
+    SimTK_TEST_EQ_TOL(x, Vector(n, Real(1)), 1e-6);
+    SimTK_TEST_EQ_TOL(f, Real(n)/2, 1e-6);
+}
+
+void testStructureValidation() {
+    ChainSystem sys(4, false, false);
+    Array_<int> rows, cols;
+    rows.push_back(0); cols.push_back(1);
+    rows.push_back(0); cols.push_back(1);
+    SimTK_TEST_MUST_THROW(sys.setConstraintJacobianStructure(rows, cols));
+    rows.pop_back(); 
+    SimTK_TEST_MUST_THROW(sys.setConstraintJacobianStructure(rows, cols));
+    cols.pop_back();
+    SimTK_TEST_MUST_THROW(sys.setLagrangianHessianStructure(rows, cols));
+    sys.setConstraintJacobianStructure(rows, cols);
+    SimTK_TEST(sys.hasConstraintJacobianStructure());
+    rows[0] = 3;
+    SimTK_TEST_MUST_THROW(sys.setConstraintJacobianStructure(rows, cols));
+    sys.setLagrangianHessianStructure(rows, cols);
+    SimTK_TEST(sys.hasLagrangianHessianStructure());
+    sys.setConstraintJacobianStructure(Array_<int>(), Array_<int>());
+    SimTK_TEST(!sys.hasConstraintJacobianStructure());
+}
+
+void testDefaultNonzeros() {
+    const int n = 6;
+    ChainSystem sys(n, true, false);
+    Vector x(n);
+    for (int i=0; i < n; ++i) x[i] = i+1;
+    Vector values(2*(n-1));
+    SimTK_TEST(sys.constraintJacobianNonzeros(x, true, values) == 0);
+    for (int i=0; i < n-1; ++i) {
+        SimTK_TEST(values[2*i]   == x[i+1]);
+        SimTK_TEST(values[2*i+1] == x[i]);
+    }
+}
+
+// The Jacobian and Hessian must reach IpOpt without ever being formed densely;
+// SparseChainSystem fails if the dense Jacobian is requested.
+void testSparseAnalytic() {
+    SparseChainSystem sys(1000);
+    Optimizer opt(sys, InteriorPoint);
+    testSolution(sys, opt);
+}
+
+void testSparseNumericalJacobian() {
+    ChainSystem sys(500, true, false);
+    Optimizer opt(sys, InteriorPoint);
+    opt.useNumericalJacobian(true);
+    testSolution(sys, opt);
+}
+
+void testDense() {
+    ChainSystem sys(20, false, false);
+    Optimizer opt(sys, InteriorPoint);
+    testSolution(sys, opt);
+}
+
+int main() {
+    SimTK_START_TEST("IpoptSparseTest");
+        SimTK_SUBTEST(testStructureValidation);
+        SimTK_SUBTEST(testDefaultNonzeros);
+        SimTK_SUBTEST(testDense);
+        SimTK_SUBTEST(testSparseNumericalJacobian);
+        SimTK_SUBTEST(testSparseAnalytic);
+    SimTK_END_TEST();
+}
@@ -62,8 +62,18 @@ class ProblemSystem : public OptimizerSystem {
       return(0);
 
    }
+
+   // Lets the numerical gradient be evaluated in several threads.
+   OptimizerSystem* clone() const override {
+      ++numClones;
+      return new ProblemSystem(*this);
+   }
+
+   static int numClones;
 };
 
+int ProblemSystem::numClones = 0;
+
 static bool equalToTol(Real v1, Real v2, Real tol) {
     const Real scale = std::max(std::max(std::abs(v1), std::abs(v2)), Real(1));
     return std::abs(v1-v2) < scale*tol;
@@ -90,6 +100,28 @@ int main() {
     results[1] = -100;
     
     opt.optimize( results );
+
+    // The same problem with the perturbed objectives evaluated in parallel,
+    // using copies of the system, must give the same answer.
+    Vector parallelResults(NUMBER_OF_PARAMETERS);
+    Optimizer parallelOpt( sys ); 
+    parallelOpt.setConvergenceTolerance( .0001 );
+    parallelOpt.setDifferentiatorNumberOfThreads( 3 );
+    parallelOpt.useNumericalGradient( true );
+    parallelResults[0] =  100;
+    parallelResults[1] = -100;
+    parallelOpt.optimize( parallelResults );
+
+    if (ProblemSystem::numClones != 2) {
+       printf(" LBFGSDiffTest.cpp: made %d clones; expected 2\n",
+              ProblemSystem::numClones);
+       returnValue = 1;
+    }
+    if ((parallelResults-results).normInf() > 1e-10) {
+       printf(" LBFGSDiffTest.cpp: parallel results differ by %g\n",
+              (parallelResults-results).normInf());
+       returnValue = 1;
+    }
   }
   catch (const std::exception& e) {
     std::cout << e.what() << std::endl;
@@ -0,0 +1,111 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "IntegratorTestFramework.h"
+#include "simmath/RattleIntegrator.h"
+
+static Real calcEnergy(const PendulumSystem& sys, const State& s) {
+    const Vector& q = s.getQ();
+    const Vector& u = s.getU();
+    const Real m = sys.getMass(s), g = sys.getGravity(s);
+    return m*(u[0]*u[0] + u[1]*u[1])/2 + m*g*q[1];
+}
+
+// Integrate the pendulum for many periods with a step size large enough that
+// an explicit method would show steady energy drift. The energy error should
+// stay bounded: no larger in the second half of the run than in the first.
+void testEnergyConservation() {
+    PendulumSystem sys;
+    sys.realizeTopology();
+    const Real qi[] = {1,0};
+    const Real ui[] = {0,0};
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+
+    RattleIntegrator integ(sys, 0.02);
+    integ.setConstraintTolerance(1e-8);
+    integ.setReturnEveryInternalStep(true);
+    integ.initialize(sys.getDefaultState());
+    const Real e0 = calcEnergy(sys, integ.getState());
+    const Real scale = sys.getDefaultMass()*sys.getDefaultGravity()
+                       *sys.getDefaultLength(); // energy range of the swing
+
+    const Real tFinal = 200;
+    Real maxErrFirstHalf = 0, maxErrSecondHalf = 0;
+    while (integ.getTime() < tFinal) {
+        integ.stepTo(tFinal);
+        const State& s = integ.getState();
+        const Real err = std::abs(calcEnergy(sys, s) - e0);
+        if (s.getTime() <= tFinal/2)
+            maxErrFirstHalf = std::max(maxErrFirstHalf, err);
+        else
+            maxErrSecondHalf = std::max(maxErrSecondHalf, err);
+
+        // The constraints are enforced at every step.
+        ASSERT(std::abs(s.getQErr()[0]) < 1e-6);
+        ASSERT(std::abs(s.getUErr()[0]) < 1e-6);
+    }
+    ASSERT(integ.getTime() == tFinal);
+    ASSERT(integ.getNumStepsTaken() >= (int)(tFinal/0.02));
+    ASSERT(maxErrFirstHalf < 0.01*scale);
+    ASSERT(maxErrSecondHalf < 1.5*maxErrFirstHalf + 1e-10*scale);
+}
+
+int main () {
+  try {
+    PendulumSystem sys;
+    sys.addEventHandler(new ZeroVelocityHandler(sys));
+    sys.addEventHandler(PeriodicHandler::handler = new PeriodicHandler());
+    sys.addEventHandler(new ZeroPositionHandler(sys));
+    sys.addEventReporter(PeriodicReporter::reporter = new PeriodicReporter(sys));
+    sys.addEventReporter(new OnceOnlyEventReporter());
+    sys.addEventReporter(new DiscontinuousReporter());
+    sys.realizeTopology();
+
+    // Test with various intervals for the event handler and event reporter, 
+    // ones that are either large or small compared to the step size of the
+    // integrator.
+
+    for (int i = 0; i < 4; ++i) {
+        PeriodicHandler::handler->setEventInterval
+           (i == 0 || i == 1 ? 0.01 : 2.0);
+        PeriodicReporter::reporter->setEventInterval
+           (i == 0 || i == 2 ? 0.015 : 1.5);
+        
+        // Test the integrator in both normal and single step modes.
+        
+        RattleIntegrator integ(sys, 0.005);
+        testIntegrator(integ, sys);
+        integ.setReturnEveryInternalStep(true);
+        testIntegrator(integ, sys);
+    }
+
+    testEnergyConservation();
+    cout << "Done" << endl;
+    return 0;
+  }
+  catch (std::exception& e) {
+    std::printf("FAILED: %s\n", e.what());
+    return 1;
+  }
+}
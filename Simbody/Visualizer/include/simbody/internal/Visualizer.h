@@ -185,6 +185,12 @@ to the desired executable name. For example, if you want to use the
 debug visualizer with release libraries, set SIMBODY_VISUALIZER_NAME
 to simbody-visualizer_d.
 
+Where the platform supports it (not Windows), each frame is handed to the
+visualizer through shared memory, and a mesh drawn just as in the previous
+frame is sent as only its new transform. Otherwise, or if the environment
+variable SIMBODY_VISUALIZER_NO_SHARED_MEMORY is set, frames go through the
+pipe to the visualizer, still written all at once.
+
 The SimTK::Pathname class is used to process the supplied search path, which
 can consist of absolute, working directory-relative, or executable 
 directory-relative path names.
@@ -200,6 +206,23 @@ constructor's documentation for more information. **/
 Visualizer(const MultibodySystem& system,
            const Array_<String>&  searchPath);
 
+/** Create a %Visualizer that doesn't launch simbody-visualizer, for runs on
+machines without a display. Every frame that would have been sent to the
+display is instead appended to the file  recordingFileName, in the same
+compact form: meshes are defined once and a mesh drawn just as in the 
+previous frame costs only its transform. Every reported frame is recorded
+without waiting, whatever the Mode, since pacing happens at replay. Display
+options such as the camera and background are recorded too. Replay the file later, at the recorded pace
+or any frame rate, with
+@code
+    simbody-visualizer --replay <recordingFileName> [framesPerSecond]
+@endcode
+which can also save the frames as a movie. Recordings can only be replayed
+by a simbody-visualizer of the same protocol version. There is no user input 
+in this mode, so menus, sliders, and InputListeners have no effect. **/
+static Visualizer createRecordOnly(const MultibodySystem& system,
+                                   const String&          recordingFileName);
+
 /** Copy constructor has reference counted, shallow copy semantics;
 that is, the Visualizer copy is just another reference to the same
 Visualizer object. **/
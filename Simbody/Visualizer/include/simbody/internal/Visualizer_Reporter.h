@@ -47,6 +47,12 @@ any simulation. Use it like this:
     // is taken by the System; don't delete it yourself.
     system.addEventReporter(new Visualizer::Reporter(viz, interval));
 @endcode 
+To record the frames to a file for later replay instead of displaying them,
+pass a file name: 
+@code
+    system.addEventReporter(
+        new Visualizer::Reporter(system, "run.simviz", interval));
+@endcode
 **/
 class SimTK_SIMBODY_EXPORT Visualizer::Reporter : public PeriodicEventReporter {
 public:
@@ -62,6 +68,16 @@ public:
     settings for the supplied system \a sys. This is an abbreviation for
     @code Reporter(Visualizer(system), reportInterval); @endcode. **/
     explicit Reporter(const MultibodySystem& sys, Real reportInterval=Infinity);
+
+    /** This constructor will create a record-only Visualizer for the 
+    supplied system \a sys that writes its frames to \a recordingFileName
+    rather than displaying them, for runs without a display. This is an 
+    abbreviation for 
+    @code Reporter(Visualizer::createRecordOnly(sys, recordingFileName),
+                   reportInterval); @endcode
+    @see Visualizer::createRecordOnly() **/
+    Reporter(const MultibodySystem& sys, const String& recordingFileName,
+             Real reportInterval=Infinity);
  
     /** Destructor will also destroy the contained Visualizer object if there
     are no other references to it. **/
@@ -98,11 +98,14 @@ static void shutdown();
 
 // Next, get the functions necessary for reading from and writing to pipes.
 #ifdef _WIN32
+    #include <fcntl.h>
     #include <io.h>
     #define READ _read
     #define WRITEFUNC _write
     #define CLOSE _close
 #else
+    #include <fcntl.h>
+    #include <sys/mman.h>
     #include <unistd.h>
     #define READ read
     #define WRITEFUNC write
@@ -137,6 +140,16 @@ static int inPipe, outPipe;
 // If the simulator told us to stop communication, then we close the outPipe
 // and can no longer write to the simulator.
 static std::atomic<bool> writeToSimulator{true};
+// Shared memory through which the simulator sends scenes, if we could map it,
+// and the commands most recently taken out of it that are still to be read.
+static SharedSceneBuffer*       sharedScenes = 0;
+static vector<unsigned char>    sharedSceneBytes;
+static size_t                   sharedSceneBytesRead = 0;
+// When replaying a recording instead, inPipe is the recording file. Scenes
+// are shown at replayFrameRate frames per second, or as far apart as their 
+// simulated times if that is zero.
+static bool  replaying = false;
+static float replayFrameRate = 0;
 
 // On Mac, if the simbody-visualizer.app/Contents/MacOS/Info.plist's field
 // NSHighResolutionCapable is set to true, then this function is expected
@@ -264,6 +277,15 @@ public:
     const fTransform& getTransform() const {
         return transform;
     }
+    void setTransform(const fTransform& newTransform) {
+        transform = newTransform;
+    }
+    short getRepresentation() const {
+        return representation;
+    }
+    float getOpacity() const {
+        return color[3];
+    }
     void computeBoundingSphere(float& radius, fVec3& center) const {
         meshes[meshIndex][resolution]->getBoundingSphere(radius, center);
         center += transform.p();
@@ -2058,9 +2080,98 @@ static void readDataFromPipe(int srcPipe, unsigned char* buffer, int bytes) {
         totalRead += retval;
     }
 }
+// Commands that came through shared memory are read first, then those
+// from the pipe.
 // Throws ReadingInterrupted if inPipe is closed.
 static void readData(unsigned char* buffer, int bytes) {
-    readDataFromPipe(inPipe, buffer, bytes);
+    const size_t available = sharedSceneBytes.size() - sharedSceneBytesRead;
+    if (available > 0) {
+        const int fromShared = (int)std::min(available, (size_t)bytes);
+        memcpy(buffer, &sharedSceneBytes[sharedSceneBytesRead], fromShared);
+        sharedSceneBytesRead += fromShared;
+        buffer += fromShared; bytes -= fromShared;
+    }
+    if (bytes > 0)
+        readDataFromPipe(inPipe, buffer, bytes);
+}
+
+// We have just processed a SceneInSharedMemory command. Take the given
+// number of bytes out of the shared ring so readData() will return them 
+// next, and free their space for the simulator.
+static void takeCommandsFromSharedMemory() {
+    unsigned length;
+    readData((unsigned char*)&length, sizeof(unsigned));
+    SimTK_ERRCHK_ALWAYS(sharedScenes && length <= sharedScenes->capacity,
+        "simbody-visualizer",
+        "Received a scene in shared memory that can't be there.");
+    const unsigned capacity = sharedScenes->capacity;
+    const unsigned long long consumed = sharedScenes->consumed.load();
+    const unsigned start = (unsigned)(consumed % capacity);
+    const unsigned first = std::min(length, capacity - start);
+    sharedSceneBytes.resize(length);
+    sharedSceneBytesRead = 0;
+    if (length == 0)
+        return;
+    memcpy(&sharedSceneBytes[0], sharedScenes->updRing() + start, first);
+    memcpy(&sharedSceneBytes[first], sharedScenes->updRing(), length - first);
+    sharedScenes->consumed.store(consumed + length);
+}
+
+// Hold back each replayed scene until it is due.
+static void waitForReplayFrame(float simTime) {
+    static double    firstRealTime = -1;
+    static float     firstSimTime = 0;
+    static long long numFrames = 0;
+    const double now = realTime();
+    if (firstRealTime < 0) {
+        firstRealTime = now;
+        firstSimTime = simTime;
+    }
+    const double due = firstRealTime + (replayFrameRate > 0 
+                                        ? numFrames/replayFrameRate
+                                        : simTime - firstSimTime);
+    ++numFrames;
+    if (due > now)
+        sleepInSec(due - now);
+}
+
+// Open a recording made by a record-only Visualizer and check that we can
+// read it. Returns the file descriptor to read the commands from.
+static int openRecording(const char* fileName) {
+#ifdef _WIN32
+    const int fd = _open(fileName, _O_RDONLY|_O_BINARY);
+#else
+    const int fd = open(fileName, O_RDONLY);
+#endif
+    SimTK_ERRCHK3_ALWAYS(fd != -1, "simbody-visualizer",
+        "Unable to open recording '%s'; errno=%d (%s).",
+        fileName, errno, strerror(errno));
+    char magic[sizeof(RecordingMagic)];
+    unsigned version;
+    readDataFromPipe(fd, (unsigned char*)magic, sizeof(magic));
+    SimTK_ERRCHK1_ALWAYS(std::equal(magic, magic+sizeof(magic), RecordingMagic),
+        "simbody-visualizer", "'%s' is not a Visualizer recording.", fileName);
+    readDataFromPipe(fd, (unsigned char*)&version, sizeof(unsigned));
+    SimTK_ERRCHK3_ALWAYS(version == ProtocolVersion, "simbody-visualizer",
+        "Recording '%s' was made with protocol version %u but this "
+        "simbody-visualizer uses protocol %u. Can't replay it.",
+        fileName, version, ProtocolVersion);
+    return fd;
+}
+
+// The meshes of the previous scene and the one being read, in the order the
+// simulator sent them. A RepeatMesh command refers to the mesh in the same
+// position in the previous scene. These are used only by the listener thread.
+static vector<RenderedMesh> prevSceneMeshes, newSceneMeshes;
+
+static void addMeshToScene(Scene* newScene, const RenderedMesh& mesh) {
+    newSceneMeshes.push_back(mesh);
+    if (mesh.getRepresentation() != DecorativeGeometry::DrawSurface)
+        newScene->drawnMeshes.push_back(mesh);
+    else if (mesh.getOpacity() == 1)
+        newScene->solidMeshes.push_back(mesh);
+    else
+        newScene->transparentMeshes.push_back(mesh);
 }
 
 // We have just processed a StartOfScene command. Read in all the scene
@@ -2074,6 +2185,7 @@ static Scene* readNewScene() {
     unsigned short* shortBuffer = (unsigned short*) buffer;
 
     Scene* newScene = new Scene;
+    newSceneMeshes.clear();
 
     // Simulated time for this frame comes first.
     readData(buffer, sizeof(float));
@@ -2091,6 +2203,7 @@ static Scene* readNewScene() {
             break;
 
         case EndOfScene:
+            prevSceneMeshes.swap(newSceneMeshes);
             finished = true;
             break;
 
@@ -2107,13 +2220,7 @@ static Scene* readNewScene() {
             short representation = (command == AddPointMesh ? DecorativeGeometry::DrawPoints : (command == AddWireframeMesh ? DecorativeGeometry::DrawWireframe : DecorativeGeometry::DrawSurface));
             unsigned short meshIndex = shortBuffer[13*sizeof(float)/sizeof(short)];
             unsigned short resolution = shortBuffer[13*sizeof(float)/sizeof(short)+1];
-            RenderedMesh mesh(position, scale, color, representation, meshIndex, resolution);
-            if (command != AddSolidMesh)
-                newScene->drawnMeshes.push_back(mesh);
-            else if (color[3] == 1)
-                newScene->solidMeshes.push_back(mesh);
-            else
-                newScene->transparentMeshes.push_back(mesh);
+            addMeshToScene(newScene, RenderedMesh(position, scale, color, representation, meshIndex, resolution));
             if (meshIndex < NumPredefinedMeshes && (meshes[meshIndex].size() <= resolution || meshes[meshIndex][resolution] == NULL)) {
                 // A real mesh will be generated from this the next
                 // time the scene is redrawn.
@@ -2124,6 +2231,23 @@ static Scene* readNewScene() {
             break;
         }
 
+        // Draw the same mesh as the corresponding one in the previous scene,
+        // with a new transform.
+        case RepeatMesh: {
+            readData(buffer, 6*sizeof(float));
+            const size_t index = newSceneMeshes.size();
+            SimTK_ERRCHK_ALWAYS(index < prevSceneMeshes.size(),
+                "simbody-visualizer",
+                "Received RepeatMesh with no corresponding previous mesh.");
+            fTransform position;
+            position.updR().setRotationToBodyFixedXYZ(fVec3(floatBuffer[0], floatBuffer[1], floatBuffer[2]));
+            position.updP() = fVec3(floatBuffer[3], floatBuffer[4], floatBuffer[5]);
+            RenderedMesh mesh = prevSceneMeshes[index];
+            mesh.setTransform(position);
+            addMeshToScene(newScene, mesh);
+            break;
+        }
+
         case AddLine: {
             readData(buffer, 10*sizeof(float));
             fVec3 color = fVec3(floatBuffer[0], floatBuffer[1], floatBuffer[2]);
@@ -2456,6 +2580,8 @@ void listenForInput() {
         }
         case StartOfScene: {
             Scene* newScene = readNewScene();
+            if (replaying)
+                waitForReplayFrame(newScene->simTime);
             std::unique_lock<std::mutex> lock(sceneMutex); //--- LOCK SCENE ----
             if (scene != NULL) {
                 // -------- WAIT FOR CONDITION --------
@@ -2476,6 +2602,10 @@ void listenForInput() {
             break;
         }
 
+        case SceneInSharedMemory:
+            takeCommandsFromSharedMemory();
+            break;
+
         case Shutdown:
             shutdown(); // doesn't return
             break;
@@ -2516,7 +2646,10 @@ void listenForInput() {
             requestPassiveRedisplay();         //------- PASSIVE REDISPLAY --
     }
   } catch (const ReadingInterrupted&) {
-        // Stop listening, because the simulator was closed.
+        // Stop listening, because the simulator was closed or we reached the
+        // end of the recording.
+        if (replaying)
+            printf("simbody-visualizer: end of recording.\n");
   } catch (const std::exception& e) {
         std::cout << "simbody-visualizer listenerThread: unrecoverable error:\n";
         std::cout << e.what() << std::endl;
@@ -2727,6 +2860,32 @@ static void setVsync(bool enable) {
 }
 
 
+// Map the shared memory the simulator created for sending us scenes. If that
+// fails, sharedScenes stays null and the simulator will use only the pipe.
+static void mapSharedSceneBuffer(const char* name) {
+#ifndef _WIN32
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd == -1)
+        return;
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 
+        && (size_t)info.st_size >= sizeof(SharedSceneBuffer))
+        memory = mmap(0, (size_t)info.st_size, PROT_READ|PROT_WRITE, 
+                      MAP_SHARED, fd, 0);
+    CLOSE(fd);
+    if (memory == MAP_FAILED)
+        return;
+    SharedSceneBuffer* buffer = static_cast<SharedSceneBuffer*>(memory);
+    if (sizeof(SharedSceneBuffer) + (size_t)buffer->capacity 
+                                                    > (size_t)info.st_size) {
+        munmap(memory, (size_t)info.st_size);
+        return;
+    }
+    sharedScenes = buffer;
+#endif
+}
+
 // This is executed from the main thread at startup.
 static void shakeHandsWithSimulator(int fromSimPipe, int toSimPipe) {
     unsigned char handshakeCommand;
@@ -2760,8 +2919,21 @@ static void shakeHandsWithSimulator(int fromSimPipe, int toSimPipe) {
 
     simulatorExecutableName = std::string(exeNameBuf, exeNameLength);
 
+    // Name of the shared memory for scenes, or empty if not offered.
+    unsigned sharedNameLength;
+    char sharedNameBuf[256];
+    readDataFromPipe(fromSimPipe, (unsigned char*)&sharedNameLength, sizeof(unsigned));
+    SimTK_ASSERT_ALWAYS(sharedNameLength <= 255,
+        "simbody-visualizer: shared memory name length violates protocol.");
+    readDataFromPipe(fromSimPipe, (unsigned char*)sharedNameBuf, sharedNameLength);
+    sharedNameBuf[sharedNameLength] = (char)0;
+    if (sharedNameLength)
+        mapSharedSceneBuffer(sharedNameBuf);
+
     WRITE(outPipe, &ReturnHandshake, 1);
     WRITE(outPipe, &ProtocolVersion, sizeof(unsigned));
+    const unsigned char usingSharedMemory = (sharedScenes != 0);
+    WRITE(outPipe, &usingSharedMemory, 1);
 }
 
 // Received Shutdown message from simulator. Die immediately.
@@ -2774,7 +2946,20 @@ int main(int argc, char** argv) {
   try
   { bool talkingToSimulator = false;
       
-    if (argc >= 3) {
+    if (argc >= 2 && string(argv[1]) == "--replay") {
+        // Show a recording instead of talking to a simulator:
+        //    simbody-visualizer --replay <file> [framesPerSecond]
+        if (argc < 3) {
+            printf("Usage: %s --replay <recording> [framesPerSecond]\n",
+                   argv[0]);
+            return 1;
+        }
+        inPipe = openRecording(argv[2]);
+        if (argc >= 4)
+            stringstream(argv[3]) >> replayFrameRate;
+        replaying = true;
+        writeToSimulator = false; // there is no one to tell about input
+    } else if (argc >= 3) {
         stringstream(argv[1]) >> inPipe;
         stringstream(argv[2]) >> outPipe;
         talkingToSimulator = true; // presumably those were the pipes
@@ -2793,7 +2978,10 @@ int main(int argc, char** argv) {
 
     if (talkingToSimulator)
         shakeHandsWithSimulator(inPipe, outPipe);
-    else {
+    else if (replaying) {
+        simbodyVersionStr = "?.?.?";
+        simulatorExecutableName = "Replay of " + string(argv[2]);
+    } else {
         simbodyVersionStr = "?.?.?";
         simulatorExecutableName = "No simulator";
     }
@@ -2891,7 +3079,7 @@ int main(int argc, char** argv) {
 
     // Spawn the listener thread. After this it runs independently.
     std::thread listenerThread;
-    if (talkingToSimulator) {
+    if (talkingToSimulator || replaying) {
         listenerThread = std::thread(listenForInput);
     } else {
         scene = new Scene;
@@ -96,10 +96,13 @@ public:
 // Implementation of the Visualizer.
 class Visualizer::Impl {
 public:
-    // Create a Visualizer and put it in PassThrough mode.
+    // Create a Visualizer and put it in PassThrough mode. If a recording
+    // file is given, frames are recorded there rather than displayed.
     Impl(Visualizer* owner, const MultibodySystem& system,
-         const Array_<String>& searchPath) 
-    :   m_system(system), m_protocol(*owner, searchPath),
+         const Array_<String>& searchPath,
+         const String& recordingFileName = String()) 
+    :   m_system(system), m_protocol(*owner, searchPath, recordingFileName),
+        m_recordOnly(!recordingFileName.empty()),
         m_shutdownWhenDestructed(false), m_upDirection(YAxis), m_groundHeight(0),
         m_mode(PassThrough), m_frameRateFPS(DefaultFrameRateFPS), 
         m_simTimeUnitsPerSec(1), 
@@ -448,6 +451,7 @@ public:
 
     const MultibodySystem&                  m_system;
     VisualizerProtocol                      m_protocol;
+    bool                                    m_recordOnly; // no display
     bool                                    m_shutdownWhenDestructed;
 
     Array_<DecorativeGeometry>              m_addedGeometry;
@@ -772,6 +776,16 @@ Visualizer::Visualizer(const MultibodySystem& system,
     impl->incrRefCount();
 }
 
+Visualizer Visualizer::createRecordOnly(const MultibodySystem& system,
+                                        const String& recordingFileName) {
+    SimTK_APIARGCHECK_ALWAYS(!recordingFileName.empty(), "Visualizer",
+        "createRecordOnly", "A recording file name is required.");
+    Visualizer viz((Impl*)0);
+    viz.impl = new Impl(&viz, system, Array_<String>(), recordingFileName);
+    viz.impl->incrRefCount();
+    return viz;
+}
+
 Visualizer::Visualizer(const Visualizer& source) : impl(0) {
     if (source.impl) {
         impl = source.impl;
@@ -819,6 +833,13 @@ void Visualizer::report(const State& state) const {
     Visualizer::Impl& rep = const_cast<Visualizer*>(this)->updImpl();
 
     ++rep.numFramesReportedBySimulation;
+
+    // A recording is paced when it is replayed, so record every frame now.
+    if (rep.m_recordOnly) {
+        drawFrameNow(state);
+        return;
+    }
+
     if (rep.m_mode == RealTime) {
         rep.reportRealtime(state);
         return;
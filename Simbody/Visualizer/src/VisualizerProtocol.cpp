@@ -26,6 +26,7 @@
 #include "simbody/internal/Visualizer_InputListener.h"
 #include "VisualizerProtocol.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cctype>
@@ -44,6 +45,9 @@ using namespace std;
     #define WRITEFUNC _write
     #define CLOSE _close
 #else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
     #include <unistd.h>
     #define READ read
     #define WRITEFUNC write
@@ -63,6 +67,18 @@ using namespace std;
     "An attempt to write() %d bytes to pipe %d failed with errno=%d (%s).", \
     (len),(pipeno),errno,strerror(errno));}
 
+// Write all of a buffer that may be too big for one write() call.
+static void writeAllToPipe(int pipeno, const unsigned char* buf, size_t len) {
+    while (len > 0) {
+        const unsigned chunk = (unsigned)std::min(len, (size_t)(1<<20));
+        const int status = WRITEFUNC(pipeno, buf, chunk);
+        SimTK_ERRCHK4_ALWAYS(status!=-1, "VisualizerProtocol",
+            "An attempt to write() %u bytes to pipe %d failed with errno=%d (%s).",
+            chunk, pipeno, errno, strerror(errno));
+        buf += status; len -= status;
+    }
+}
+
 static int inPipe;
 
 // Create the pipe going *from* simulator *to* visualizer, so only the
@@ -249,8 +265,25 @@ static void listenForVisualizerEvents(Visualizer& visualizer) {
 }
 
 VisualizerProtocol::VisualizerProtocol
-   (Visualizer& visualizer, const Array_<String>& userSearchPath) 
+   (Visualizer& visualizer, const Array_<String>& userSearchPath,
+    const String& recordingFileName) 
+:   outPipe(-1), recording(nullptr), 
+    sharedScenes(nullptr), sharedScenesSize(0), sharedScenesWritten(0)
 {
+    if (!recordingFileName.empty()) {
+        // Record-only: there is no GUI to launch or to hear from.
+        recording = fopen(recordingFileName.c_str(), "wb");
+        SimTK_ERRCHK3_ALWAYS(recording != nullptr, 
+            "VisualizerProtocol::ctor()",
+            "Unable to open recording file '%s' for writing; errno=%d (%s).",
+            recordingFileName.c_str(), errno, strerror(errno));
+        // Scenes are written whole, so a large buffer saves system calls.
+        setvbuf(recording, nullptr, _IOFBF, 1<<20);
+        fwrite(RecordingMagic, 1, sizeof(RecordingMagic), recording);
+        fwrite(&ProtocolVersion, sizeof(unsigned), 1, recording);
+        return;
+    }
+
     // Launch the GUI application. We'll first look for one in the same
     // directory as the running executable; then if that doesn't work we'll
     // look in the bin subdirectory of the SimTK installation.
@@ -347,6 +380,24 @@ VisualizerProtocol::VisualizerProtocol
     // Spawn the visualizer gui, trying local first then installed version.
     spawnViz(actualSearchPath, vizExecutableName, sim2vizPipe, viz2simPipe);
 
+    // The visualizer is offered this during the handshake. If the handshake
+    // fails the destructor won't run, so the guard must give the segment back
+    // to the system; otherwise it would outlive this process.
+    createSharedSceneBuffer();
+    struct SharedSceneBufferGuard {
+        explicit SharedSceneBufferGuard(VisualizerProtocol& p) : protocol(&p) {}
+        ~SharedSceneBufferGuard() {
+            if (!protocol) return;
+            #ifndef _WIN32
+            if (protocol->sharedScenes)
+                shm_unlink(protocol->sharedScenesName.c_str());
+            #endif
+            protocol->releaseSharedSceneBuffer();
+        }
+        void dismiss() { protocol = nullptr; }
+        VisualizerProtocol* protocol;
+    } sharedSceneBufferGuard(*this);
+
     // Before we do anything else, attempt to exchange handshake messages with
     // the visualizer. This will throw an exception if anything goes wrong.
     // Note that this is done on the main thread.
@@ -355,6 +406,7 @@ VisualizerProtocol::VisualizerProtocol
     // Spawn the thread to listen for events.
     eventListenerThread = std::thread(listenForVisualizerEvents,
             std::ref(visualizer));
+    sharedSceneBufferGuard.dismiss();
 }
 
 // This is executed on the main thread at GUI startup and thus does not
@@ -387,6 +439,11 @@ void VisualizerProtocol::shakeHandsWithGUI(int toGUIPipe, int fromGUIPipe) {
     WRITE(outPipe, &nameLength, sizeof(unsigned));
     WRITE(outPipe, fileName.c_str(), nameLength);
 
+    // Offer the shared memory for scenes; an empty name means there isn't any.
+    unsigned sharedNameLength = (unsigned)sharedScenesName.size();
+    WRITE(outPipe, &sharedNameLength, sizeof(unsigned));
+    WRITE(outPipe, sharedScenesName.c_str(), sharedNameLength);
+
         // Now wait for handshake response from GUI.
 
     unsigned char handshakeCommand;
@@ -405,10 +462,63 @@ void VisualizerProtocol::shakeHandsWithGUI(int toGUIPipe, int fromGUIPipe) {
         " Can't continue.",
         GUIversion, ProtocolVersion);
 
+    // Find out whether the GUI was able to map the shared memory. Either way
+    // it has no further need for the name.
+    unsigned char GUIUsesSharedMemory;
+    readDataFromPipe(fromGUIPipe, &GUIUsesSharedMemory, 1);
+    #ifndef _WIN32
+    if (sharedScenes)
+        shm_unlink(sharedScenesName.c_str());
+    #endif
+    if (!GUIUsesSharedMemory)
+        releaseSharedSceneBuffer();
+
     // Handshake was successful.
 }
 
+// Create the shared memory through which we'd like to send scenes. If that
+// isn't possible here we'll just use the pipe. Setting the environment
+// variable SIMBODY_VISUALIZER_NO_SHARED_MEMORY also forces the pipe.
+void VisualizerProtocol::createSharedSceneBuffer() {
+    #ifndef _WIN32
+    if (Pathname::environmentVariableExists
+                                    ("SIMBODY_VISUALIZER_NO_SHARED_MEMORY"))
+        return;
+    static std::atomic<int> numCreated(0);
+    const std::string name = "/simbody-viz-" + String((int)getpid()) 
+                             + "-" + String(numCreated++);
+    const int fd = shm_open(name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0600);
+    if (fd == -1)
+        return;
+    const size_t size = sizeof(SharedSceneBuffer) + SharedSceneBufferSize;
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        memory = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    CLOSE(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return;
+    }
+    sharedScenes = static_cast<SharedSceneBuffer*>(memory);
+    sharedScenes->consumed.store(0);
+    sharedScenes->capacity = SharedSceneBufferSize;
+    sharedScenesName = name;
+    sharedScenesSize = size;
+    #endif
+}
+
+void VisualizerProtocol::releaseSharedSceneBuffer() {
+    #ifndef _WIN32
+    if (sharedScenes)
+        munmap(sharedScenes, sharedScenesSize);
+    #endif
+    sharedScenes = nullptr;
+    sharedScenesName.clear();
+}
+
 void VisualizerProtocol::shutdownGUI() {
+    if (recording)
+        return; // there is no GUI
     // Don't wait for scene completion; kill GUI now.
     
     // We no longer need to listen for events from the GUI. Stop the listener
@@ -426,6 +536,14 @@ VisualizerProtocol::~VisualizerProtocol() {
     // If shutdownGUI() was not called, then the listener thread is still
     // running and we should kill it.
     stopListeningIfNecessary();
+    releaseSharedSceneBuffer();
+    if (recording) {
+        if (fclose(recording) != 0)
+            std::cout << "Warning in Simbody VisualizerProtocol: "
+                << "Failed to finish writing the recording; errno=" << errno
+                << " (" << strerror(errno) << ")." << std::endl;
+        return;
+    }
     int retval = CLOSE(outPipe); // TODO(chrisdembia) is this necessary?
     if (retval == -1) {
         std::cout << "Warning in Simbody VisualizerProtocol: "
@@ -450,19 +568,76 @@ void VisualizerProtocol::stopListeningIfNecessary() {
     }
 }
 
+// Add to the commands waiting to be sent.
+void VisualizerProtocol::send(const void* data, unsigned length) const {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    outBuffer.insert(outBuffer.end(), bytes, bytes+length);
+}
+
+// Send the waiting commands to the GUI. If they fit in the free part of the
+// shared ring we copy them there and send only their length through the 
+// pipe; otherwise they all go through the pipe, in one write. When recording
+// they are appended to the file.
+void VisualizerProtocol::flush() const {
+    if (outBuffer.empty())
+        return;
+    const unsigned length = (unsigned)outBuffer.size();
+    if (recording) {
+        const size_t written = fwrite(&outBuffer[0], 1, length, recording);
+        outBuffer.clear();
+        SimTK_ERRCHK2_ALWAYS(written == length, "VisualizerProtocol",
+            "An attempt to record %u bytes failed with errno=%d.",
+            length, errno);
+        return;
+    }
+    if (sharedScenes) {
+        const unsigned capacity = sharedScenes->capacity;
+        const unsigned long long inUse = 
+            sharedScenesWritten - sharedScenes->consumed.load();
+        if (length <= capacity - inUse) {
+            unsigned char* ring = sharedScenes->updRing();
+            const unsigned start = (unsigned)(sharedScenesWritten % capacity);
+            const unsigned first = std::min(length, capacity - start);
+            memcpy(ring + start, &outBuffer[0], first);
+            memcpy(ring, &outBuffer[first], length - first);
+            sharedScenesWritten += length;
+
+            unsigned char doorbell[1+sizeof(unsigned)];
+            doorbell[0] = SceneInSharedMemory;
+            memcpy(doorbell+1, &length, sizeof(unsigned));
+            writeAllToPipe(outPipe, doorbell, sizeof(doorbell));
+            outBuffer.clear();
+            return;
+        }
+    }
+    writeAllToPipe(outPipe, &outBuffer[0], outBuffer.size());
+    outBuffer.clear();
+}
+
+bool VisualizerProtocol::MeshRecord::operator==(const MeshRecord& other) const
+{
+    return meshIndex == other.meshIndex && resolution == other.resolution
+        && representation == other.representation
+        && std::equal(scale, scale+3, other.scale)
+        && std::equal(color, color+4, other.color);
+}
+
 void VisualizerProtocol::beginScene(Real time) {
     sceneLockBeginFinishScene.lock();
+    sceneMeshes.clear();
     char command = StartOfScene;
-    WRITE(outPipe, &command, 1);
+    send(&command, 1);
     float fTime = (float)time;
-    WRITE(outPipe, &fTime, sizeof(float));
+    send(&fTime, sizeof(float));
     // The sceneMutex is NOT unlocked at the end of this scope
     // (sceneLockBeginFinishScene is a member variable); see finishScene().
 }
 
 void VisualizerProtocol::finishScene() {
     char command = EndOfScene;
-    WRITE(outPipe, &command, 1);
+    send(&command, 1);
+    flush();
+    prevSceneMeshes.swap(sceneMeshes);
     sceneLockBeginFinishScene.unlock();
 }
 
@@ -561,13 +736,13 @@ void VisualizerProtocol::drawPolygonalMesh(const PolygonalMesh& mesh, const Tran
         "Too many unique DecorativeMesh objects; max is 65535.");
     
     meshes[impl] = (unsigned short)index;    // insert new mesh
-    WRITE(outPipe, &DefineMesh, 1);
+    send(&DefineMesh, 1);
     unsigned short numVertices = (unsigned short)(vertices.size()/3);
     unsigned short numFaces = (unsigned short)(faces.size()/3);
-    WRITE(outPipe, &numVertices, sizeof(short));
-    WRITE(outPipe, &numFaces, sizeof(short));
-    WRITE(outPipe, &vertices[0], (unsigned)(vertices.size()*sizeof(float)));
-    WRITE(outPipe, &faces[0], (unsigned)(faces.size()*sizeof(short)));
+    send(&numVertices, sizeof(short));
+    send(&numFaces, sizeof(short));
+    send(&vertices[0], (unsigned)(vertices.size()*sizeof(float)));
+    send(&faces[0], (unsigned)(faces.size()*sizeof(short)));
 
     drawMesh(X_GM, scale, color, (short) representation, (unsigned short)index, 0);
 }
@@ -576,13 +751,36 @@ void VisualizerProtocol::
 drawMesh(const Transform& X_GM, const Vec3& scale, const Vec4& color, 
          short representation, unsigned short meshIndex, unsigned short resolution)
 {
+    MeshRecord record;
+    for (int i=0; i < 3; ++i) record.scale[i] = (float)scale[i];
+    for (int i=0; i < 4; ++i) record.color[i] = (float)color[i];
+    record.representation = representation;
+    record.meshIndex = meshIndex;
+    record.resolution = resolution;
+    const bool isRepeat = sceneMeshes.size() < prevSceneMeshes.size()
+                          && prevSceneMeshes[sceneMeshes.size()] == record;
+    sceneMeshes.push_back(record);
+
+    float buffer[13];
+    Vec3 rot = X_GM.R().convertRotationToBodyFixedXYZ();
+    if (isRepeat) {
+        // The GUI reuses everything else from the same call last scene.
+        buffer[0] = (float) rot[0];
+        buffer[1] = (float) rot[1];
+        buffer[2] = (float) rot[2];
+        buffer[3] = (float) X_GM.p()[0];
+        buffer[4] = (float) X_GM.p()[1];
+        buffer[5] = (float) X_GM.p()[2];
+        send(&RepeatMesh, 1);
+        send(buffer, 6*sizeof(float));
+        return;
+    }
+
     char command = (representation == DecorativeGeometry::DrawPoints 
                     ? AddPointMesh 
                     : (representation == DecorativeGeometry::DrawWireframe 
                         ? AddWireframeMesh : AddSolidMesh));
-    WRITE(outPipe, &command, 1);
-    float buffer[13];
-    Vec3 rot = X_GM.R().convertRotationToBodyFixedXYZ();
+    send(&command, 1);
     buffer[0] = (float) rot[0];
     buffer[1] = (float) rot[1];
     buffer[2] = (float) rot[2];
@@ -596,17 +794,17 @@ drawMesh(const Transform& X_GM, const Vec3& scale, const Vec4& color,
     buffer[10] = (float) color[1];
     buffer[11] = (float) color[2];
     buffer[12] = (float) color[3];
-    WRITE(outPipe, buffer, 13*sizeof(float));
+    send(buffer, 13*sizeof(float));
     unsigned short buffer2[2];
     buffer2[0] = meshIndex;
     buffer2[1] = resolution;
-    WRITE(outPipe, buffer2, 2*sizeof(unsigned short));
+    send(buffer2, 2*sizeof(unsigned short));
 }
 
 void VisualizerProtocol::
 drawLine(const Vec3& end1, const Vec3& end2, const Vec4& color, Real thickness)
 {
-    WRITE(outPipe, &AddLine, 1);
+    send(&AddLine, 1);
     float buffer[10];
     buffer[0] = (float) color[0];
     buffer[1] = (float) color[1];
@@ -618,7 +816,7 @@ drawLine(const Vec3& end1, const Vec3& end2, const Vec4& color, Real thickness)
     buffer[7] = (float) end2[0];
     buffer[8] = (float) end2[1];
     buffer[9] = (float) end2[2];
-    WRITE(outPipe, buffer, 10*sizeof(float));
+    send(buffer, 10*sizeof(float));
 }
 
 void VisualizerProtocol::
@@ -628,7 +826,7 @@ drawText(const Transform& X_GT, const Vec3& scale, const Vec4& color,
         "VisualizerProtocol::drawText()",
         "Can't display DecorativeText longer than 256 characters;"
         " received text of length %u.", (unsigned)string.size());
-    WRITE(outPipe, &AddText, 1);
+    send(&AddText, 1);
     float buffer[12];
     const Vec3 rot = X_GT.R().convertRotationToBodyFixedXYZ();
     buffer[0] = (float) rot[0];
@@ -643,19 +841,19 @@ drawText(const Transform& X_GT, const Vec3& scale, const Vec4& color,
     buffer[9] = (float) color[0];
     buffer[10]= (float) color[1];
     buffer[11]= (float) color[2];
-    WRITE(outPipe, buffer, 12*sizeof(float));
+    send(buffer, 12*sizeof(float));
     short face = (short)faceCamera;
-    WRITE(outPipe, &face, sizeof(short));
+    send(&face, sizeof(short));
     short screen = (short)isScreenText;
-    WRITE(outPipe, &screen, sizeof(short));
+    send(&screen, sizeof(short));
     short length = (short)string.size();
-    WRITE(outPipe, &length, sizeof(short));
-    WRITE(outPipe, &string[0], length);
+    send(&length, sizeof(short));
+    send(&string[0], length);
 }
 
 void VisualizerProtocol::
 drawCoords(const Transform& X_GF, const Vec3& axisLengths, const Vec4& color) {
-    WRITE(outPipe, &AddCoords, 1);
+    send(&AddCoords, 1);
     float buffer[12];
     const Vec3 rot = X_GF.R().convertRotationToBodyFixedXYZ();
     buffer[0] = (float) rot[0];
@@ -670,72 +868,78 @@ drawCoords(const Transform& X_GF, const Vec3& axisLengths, const Vec4& color) {
     buffer[9] = (float) color[0];
     buffer[10]= (float) color[1];
     buffer[11]= (float) color[2];
-    WRITE(outPipe, buffer, 12*sizeof(float));
+    send(buffer, 12*sizeof(float));
 }
 
 void VisualizerProtocol::
 addMenu(const String& title, int id, const Array_<pair<String, int> >& items) {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &DefineMenu, 1);
+    send(&DefineMenu, 1);
     short titleLength = (short)title.size();
-    WRITE(outPipe, &titleLength, sizeof(short));
-    WRITE(outPipe, title.c_str(), titleLength);
-    WRITE(outPipe, &id, sizeof(int));
+    send(&titleLength, sizeof(short));
+    send(title.c_str(), titleLength);
+    send(&id, sizeof(int));
     short numItems = (short)items.size();
-    WRITE(outPipe, &numItems, sizeof(short));
+    send(&numItems, sizeof(short));
     for (int i = 0; i < numItems; i++) {
         int buffer[] = {items[i].second, items[i].first.size()};
-        WRITE(outPipe, buffer, 2*sizeof(int));
-        WRITE(outPipe, items[i].first.c_str(), items[i].first.size());
+        send(buffer, 2*sizeof(int));
+        send(items[i].first.c_str(), items[i].first.size());
     }
+    flush();
 }
 
 void VisualizerProtocol::
 addSlider(const String& title, int id, Real minVal, Real maxVal, Real value) {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &DefineSlider, 1);
+    send(&DefineSlider, 1);
     short titleLength = (short)title.size();
-    WRITE(outPipe, &titleLength, sizeof(short));
-    WRITE(outPipe, title.c_str(), titleLength);
-    WRITE(outPipe, &id, sizeof(int));
+    send(&titleLength, sizeof(short));
+    send(title.c_str(), titleLength);
+    send(&id, sizeof(int));
     float buffer[3];
     buffer[0] = (float) minVal;
     buffer[1] = (float) maxVal;
     buffer[2] = (float) value;
-    WRITE(outPipe, buffer, 3*sizeof(float));
+    send(buffer, 3*sizeof(float));
+    flush();
 }
 
 
 void VisualizerProtocol::setSliderValue(int id, Real newValue) const {
     const float value = (float)newValue;
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetSliderValue, 1);
-    WRITE(outPipe, &id, sizeof(int));
-    WRITE(outPipe, &value, sizeof(float));
+    send(&SetSliderValue, 1);
+    send(&id, sizeof(int));
+    send(&value, sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::setSliderRange(int id, Real newMin, Real newMax) const {
     float buffer[2];
     buffer[0] = (float)newMin; buffer[1] = (float)newMax;
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetSliderRange, 1);
-    WRITE(outPipe, &id, sizeof(int));
-    WRITE(outPipe, buffer, 2*sizeof(float));
+    send(&SetSliderRange, 1);
+    send(&id, sizeof(int));
+    send(buffer, 2*sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::setWindowTitle(const String& title) const {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetWindowTitle, 1);
+    send(&SetWindowTitle, 1);
     short titleLength = (short)title.size();
-    WRITE(outPipe, &titleLength, sizeof(short));
-    WRITE(outPipe, title.c_str(), titleLength);
+    send(&titleLength, sizeof(short));
+    send(title.c_str(), titleLength);
+    flush();
 }
 
 void VisualizerProtocol::setMaxFrameRate(Real rate) const {
     const float frameRate = (float)rate;
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetMaxFrameRate, 1);
-    WRITE(outPipe, &frameRate, sizeof(float));
+    send(&SetMaxFrameRate, 1);
+    send(&frameRate, sizeof(float));
+    flush();
 }
 
 
@@ -745,48 +949,54 @@ void VisualizerProtocol::setBackgroundColor(const Vec3& color) const {
     buffer[1] = (float)color[1]; 
     buffer[2] = (float)color[2];
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetBackgroundColor, 1);
-    WRITE(outPipe, buffer, 3*sizeof(float));
+    send(&SetBackgroundColor, 1);
+    send(buffer, 3*sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::setShowShadows(bool shouldShow) const {
     const short show = (short)shouldShow; // 0 or 1
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetShowShadows, 1);
-    WRITE(outPipe, &show, sizeof(short));
+    send(&SetShowShadows, 1);
+    send(&show, sizeof(short));
+    flush();
 }
 
 void VisualizerProtocol::setShowFrameRate(bool shouldShow) const {
     const short show = (short)shouldShow; // 0 or 1
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetShowFrameRate, 1);
-    WRITE(outPipe, &show, sizeof(short));
+    send(&SetShowFrameRate, 1);
+    send(&show, sizeof(short));
+    flush();
 }
 
 void VisualizerProtocol::setShowSimTime(bool shouldShow) const {
     const short show = (short)shouldShow; // 0 or 1
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetShowSimTime, 1);
-    WRITE(outPipe, &show, sizeof(short));
+    send(&SetShowSimTime, 1);
+    send(&show, sizeof(short));
+    flush();
 }
 
 void VisualizerProtocol::setShowFrameNumber(bool shouldShow) const {
     const short show = (short)shouldShow; // 0 or 1
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetShowFrameNumber, 1);
-    WRITE(outPipe, &show, sizeof(short));
+    send(&SetShowFrameNumber, 1);
+    send(&show, sizeof(short));
+    flush();
 }
 
 void VisualizerProtocol::setBackgroundType(Visualizer::BackgroundType type) const {
     const short backgroundType = (short)type;
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetBackgroundType, 1);
-    WRITE(outPipe, &backgroundType, sizeof(short));
+    send(&SetBackgroundType, 1);
+    send(&backgroundType, sizeof(short));
+    flush();
 }
 
 void VisualizerProtocol::setCameraTransform(const Transform& X_GC) const {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetCamera, 1);
+    send(&SetCamera, 1);
     float buffer[6];
     Vec3 rot = X_GC.R().convertRotationToBodyFixedXYZ();
     buffer[0] = (float) rot[0];
@@ -795,17 +1005,19 @@ void VisualizerProtocol::setCameraTransform(const Transform& X_GC) const {
     buffer[3] = (float) X_GC.p()[0];
     buffer[4] = (float) X_GC.p()[1];
     buffer[5] = (float) X_GC.p()[2];
-    WRITE(outPipe, buffer, 6*sizeof(float));
+    send(buffer, 6*sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::zoomCamera() const {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &ZoomCamera, 1);
+    send(&ZoomCamera, 1);
+    flush();
 }
 
 void VisualizerProtocol::lookAt(const Vec3& point, const Vec3& upDirection) const {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &LookAt, 1);
+    send(&LookAt, 1);
     float buffer[6];
     buffer[0] = (float) point[0];
     buffer[1] = (float) point[1];
@@ -813,41 +1025,46 @@ void VisualizerProtocol::lookAt(const Vec3& point, const Vec3& upDirection) cons
     buffer[3] = (float) upDirection[0];
     buffer[4] = (float) upDirection[1];
     buffer[5] = (float) upDirection[2];
-    WRITE(outPipe, buffer, 6*sizeof(float));
+    send(buffer, 6*sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::setFieldOfView(Real fov) const {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetFieldOfView, 1);
+    send(&SetFieldOfView, 1);
     float buffer[1];
     buffer[0] = (float)fov;
-    WRITE(outPipe, buffer, sizeof(float));
+    send(buffer, sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::setClippingPlanes(Real near, Real far) const {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetClipPlanes, 1);
+    send(&SetClipPlanes, 1);
     float buffer[2];
     buffer[0] = (float)near;
     buffer[1] = (float)far;
-    WRITE(outPipe, buffer, 2*sizeof(float));
+    send(buffer, 2*sizeof(float));
+    flush();
 }
 
 void VisualizerProtocol::
 setSystemUpDirection(const CoordinateDirection& upDir) {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetSystemUpDirection, 1);
+    send(&SetSystemUpDirection, 1);
     const unsigned char axis = (unsigned char)upDir.getAxis();
     const signed char   sign = (signed char)upDir.getDirection();
-    WRITE(outPipe, &axis, 1);
-    WRITE(outPipe, &sign, 1);
+    send(&axis, 1);
+    send(&sign, 1);
+    flush();
 }
 
 void VisualizerProtocol::setGroundHeight(Real height) {
     std::lock_guard<std::mutex> lock(sceneMutex);
-    WRITE(outPipe, &SetGroundHeight, 1);
+    send(&SetGroundHeight, 1);
     float heightBuffer = (float) height;
-    WRITE(outPipe, &heightBuffer, sizeof(float));
+    send(&heightBuffer, sizeof(float));
+    flush();
 }
 
 
@@ -29,6 +29,7 @@
 #include <utility>
 #include <map>
 #include <atomic>
+#include <vector>
 
 /** @file
  * This file defines commands that are used for communication between the 
@@ -37,7 +38,7 @@
 
 // Increment this every time you make *any* change to the protocol;
 // we insist on an exact match.
-static const unsigned ProtocolVersion   = 34;
+static const unsigned ProtocolVersion   = 35;
 
 // The visualizer has several predefined cached meshes for common
 // shapes so that we don't have to send them. These are the mesh 
@@ -87,6 +88,8 @@ static const unsigned char SetShowSimTime        = 28;
 static const unsigned char SetShowFrameNumber    = 29;
 static const unsigned char Shutdown              = 30;
 static const unsigned char StopCommunication     = 31;
+static const unsigned char RepeatMesh            = 32;
+static const unsigned char SceneInSharedMemory   = 33;
 
 
 // Events sent from the GUI back to the simulation application.
@@ -99,11 +102,35 @@ static const unsigned char KeyPressed            = 2;
 static const unsigned char MenuSelected          = 3;
 static const unsigned char SliderMoved           = 4;
 
+// Size of the ring through which scenes are sent when shared memory is
+// available. A scene that doesn't fit in the free part goes through the pipe.
+static const unsigned SharedSceneBufferSize = 16*1024*1024;
+
+// A recording starts with these 8 bytes and then ProtocolVersion, followed
+// by the commands that would have been sent to the GUI after the handshake.
+static const char RecordingMagic[8] = {'S','i','m','T','K','V','i','z'};
+
 namespace SimTK {
+
+// This header is at the start of the shared memory; the ring's bytes follow 
+// it. The simulator copies a scene's commands into the ring and then sends 
+// SceneInSharedMemory and their length through the pipe, so commands are 
+// still received in order. The visualizer copies them out and advances 
+// "consumed", the total number of bytes taken out so far, to free the space.
+struct SharedSceneBuffer {
+    std::atomic<unsigned long long> consumed;
+    unsigned                        capacity;
+
+    unsigned char* updRing() {return reinterpret_cast<unsigned char*>(this+1);}
+};
+
 class VisualizerProtocol {
 public:
+    // If recordingFileName is not empty, no GUI is launched and the commands
+    // are written to that file instead.
     VisualizerProtocol(Visualizer& visualizer,
-                       const Array_<String>& searchPath);
+                       const Array_<String>& searchPath,
+                       const String& recordingFileName = String());
     ~VisualizerProtocol();
     void shakeHandsWithGUI(int toGUIPipe, int fromGUIPipe);
     void shutdownGUI();
@@ -157,7 +184,32 @@ private:
     void drawMesh(const Transform& transform, const Vec3& scale, 
                   const Vec4& color, short representation, 
                   unsigned short meshIndex, unsigned short resolution);
-    int outPipe;
+    // Commands are collected by send() and written out together by flush(),
+    // through shared memory if possible.
+    void send(const void* data, unsigned length) const;
+    void flush() const;
+    void createSharedSceneBuffer();
+    void releaseSharedSceneBuffer();
+
+    int outPipe;        // -1 if recording
+    FILE* recording;    // null unless recording
+    mutable std::vector<unsigned char> outBuffer;
+
+    SharedSceneBuffer*  sharedScenes;   // null if we're using only the pipe
+    std::string         sharedScenesName;
+    size_t              sharedScenesSize;
+    mutable unsigned long long sharedScenesWritten;
+
+    // What was drawn by each drawMesh() call of a scene other than the
+    // transform. When the same call in the next scene draws the same thing
+    // we send only the new transform.
+    struct MeshRecord {
+        float           scale[3], color[4];
+        short           representation;
+        unsigned short  meshIndex, resolution;
+        bool operator==(const MeshRecord& other) const;
+    };
+    std::vector<MeshRecord> prevSceneMeshes, sceneMeshes;
 
     // For user-defined meshes, map their unique memory addresses to the 
     // assigned visualizer cache index.
@@ -60,6 +60,14 @@ Visualizer::Reporter::Reporter(const MultibodySystem& sys, Real reportInterval)
     updImpl().handle = this;
 }
 
+Visualizer::Reporter::Reporter(const MultibodySystem& sys, 
+                               const String& recordingFileName,
+                               Real reportInterval) 
+:   PeriodicEventReporter(reportInterval) {
+    impl = new Impl(Visualizer::createRecordOnly(sys, recordingFileName));
+    updImpl().handle = this;
+}
+
 Visualizer::Reporter::~Reporter() {
     if (impl->handle == this)
         delete impl;
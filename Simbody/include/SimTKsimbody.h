@@ -66,6 +66,7 @@ will include this one). **/
 #include "simbody/internal/SmoothSphereHalfSpaceForce.h"
 #include "simbody/internal/DecorationSubsystem.h"
 #include "simbody/internal/TextDataEventReporter.h"
+#include "simbody/internal/BinaryDataEventReporter.h"
 #include "simbody/internal/ObservedPointFitter.h"
 #include "simbody/internal/Assembler.h"
 #include "simbody/internal/AssemblyCondition.h"
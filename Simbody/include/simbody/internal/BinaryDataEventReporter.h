@@ -0,0 +1,155 @@
+#ifndef SimTK_SIMBODY_BINARY_DATA_EVENT_REPORTER_H_
+#define SimTK_SIMBODY_BINARY_DATA_EVENT_REPORTER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simbody/internal/common.h"
+
+namespace SimTK {
+
+/** This is an EventReporter which records numeric data at regular intervals
+into a binary file, for simulations that report too often or too much for
+TextDataEventReporter. At every reporting interval it invokes a UserFunction
+(or, if you don't supply one, takes the State's q's and u's) and hands the
+time and values to a background thread that writes the file; the simulation
+thread copies the values into a preallocated ring buffer and returns without
+waiting for any I/O or allocating memory. Use BinaryDataReader to read the
+file back.
+
+Every report must have the same number of values. Frames are collected into
+chunks of a fixed number of frames, and each chunk is stored column by
+column: all the times, then all the values of the first column, and so on.
+An index of the chunks is written at the end of the file when the reporter is
+closed, so that a reader can find the frame at a given time without reading
+the whole file. Values are stored in native binary, so the file is read back
+exactly, but only on the same kind of machine.
+
+If the simulation produces frames faster than they can be written, for long
+enough to fill the ring buffer, the simulation waits for the writer to catch
+up rather than losing data; getNumStalls() tells you how often that
+happened so that you can choose a bigger buffer.
+
+After creating a BinaryDataEventReporter, add it to the System by calling
+the addEventReporter() method. The file is completed when the reporter is
+destroyed along with the System, or earlier if you call close(). **/
+class SimTK_SIMBODY_EXPORT BinaryDataEventReporter
+:   public PeriodicEventReporter {
+public:
+
+    /** This template class defines a standard interface for objects that
+    calculate a function based on a System and State for use in a
+    BinaryDataEventReporter. **/
+    template <class T> class UserFunction {
+    public:
+        virtual ~UserFunction() {}
+        virtual T evaluate(const System& system, const State& state) = 0;
+    };
+
+    /** Create a BinaryDataEventReporter which calculates a vector of numbers
+    at each reporting interval and records them along with the time in the
+    file \a pathname, which is created (or replaced) immediately. Takes
+    ownership of the UserFunction object.
+
+    @param framesPerChunk   number of frames stored together in each chunk
+                            of the file
+    @param bufferFrames     number of frames the ring buffer between the
+                            simulation and the writer thread can hold **/
+    BinaryDataEventReporter(const System&           system,
+                            UserFunction<Vector>*   function,
+                            Real                    reportInterval,
+                            const String&           pathname,
+                            int                     framesPerChunk = 256,
+                            int                     bufferFrames = 4096);
+
+    /** Create a BinaryDataEventReporter which records the State's q's
+    followed by its u's at each reporting interval. **/
+    BinaryDataEventReporter(const System&           system,
+                            Real                    reportInterval,
+                            const String&           pathname,
+                            int                     framesPerChunk = 256,
+                            int                     bufferFrames = 4096);
+
+    /** The destructor closes the file if that hasn't been done already and
+    deletes the UserFunction object; don't delete it yourself. **/
+    ~BinaryDataEventReporter();
+
+    /** Wait for the writer thread to write all the frames reported so far,
+    then write the chunk index and close the file. No frames can be reported
+    after this. An exception is thrown if anything could not be written. **/
+    void close();
+
+    /** Return the number of frames reported so far. **/
+    int getNumFrames() const;
+
+    /** Return the number of times the simulation had to wait because the
+    ring buffer was full. **/
+    int getNumStalls() const;
+
+    /** This is the implementation of the EventReporter virtual. **/
+    void handleEvent(const State& state) const override;
+
+    class BinaryDataEventReporterRep;
+protected:
+    BinaryDataEventReporterRep* rep;
+    const BinaryDataEventReporterRep& getRep() const {assert(rep); return *rep;}
+    BinaryDataEventReporterRep&       updRep() const {assert(rep); return *rep;}
+};
+
+/** This class reads files written by BinaryDataEventReporter. Frames can be
+read in any order; reading a frame reads in the whole chunk containing it, so
+reading neighboring frames is cheap. **/
+class SimTK_SIMBODY_EXPORT BinaryDataReader {
+public:
+    /** Open the file \a pathname and read its chunk index. An exception is
+    thrown if it isn't a complete file written by BinaryDataEventReporter. **/
+    explicit BinaryDataReader(const String& pathname);
+    ~BinaryDataReader();
+
+    /** Return the number of frames in the file. **/
+    int getNumFrames() const;
+    /** Return the number of values in each frame (not counting the time). **/
+    int getNumColumns() const;
+
+    /** Return the time of frame \a frame. **/
+    Real getTime(int frame) const;
+
+    /** Read the values of frame \a frame into \a values, resizing it if
+    necessary, and return that frame's time. **/
+    Real getFrame(int frame, Vector& values) const;
+
+    /** Return the index of the last frame whose time is no later than
+    \a time, or -1 if all frames are later than that. **/
+    int findFrame(Real time) const;
+
+    class BinaryDataReaderRep;
+private:
+    BinaryDataReader(const BinaryDataReader&) = delete;
+    BinaryDataReader& operator=(const BinaryDataReader&) = delete;
+    BinaryDataReaderRep* rep;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_BINARY_DATA_EVENT_REPORTER_H_
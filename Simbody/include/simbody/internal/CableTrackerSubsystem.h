@@ -80,6 +80,17 @@ const CablePath& getCablePath(CablePathIndex cableIx) const;
 /** Get writable access to a particular cable path. **/
 CablePath& updCablePath(CablePathIndex cableIx);
 
+/** Set the number of threads used to solve for the cable paths. Each path is
+solved independently, starting from its solution at the previous step, so 
+with more than one thread different paths are solved concurrently at Position
+and Velocity stages. The default of 1 does everything serially. The results
+do not depend on the number of threads.
+@note This method should NOT be called while a State is being realized. **/
+void setNumberOfThreads(int numThreads);
+/** Return the number of threads used to solve for the cable paths.
+@see setNumberOfThreads() **/
+int getNumberOfThreads() const;
+
 /** @cond **/ // Hide from Doxygen.
 SimTK_PIMPL_DOWNCAST(CableTrackerSubsystem, Subsystem);
 class Impl;
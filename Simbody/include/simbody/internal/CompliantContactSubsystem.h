@@ -671,6 +671,22 @@ virtual void calcContactPatch
     const SpatialVec&       V_S1S2,  // relative surface velocity (S2 in S1)
     ContactPatch&           patch) const = 0;
 
+/** The CompliantContactSubsystem will invoke this method when an implicit
+integrator needs the state derivative Jacobian. Given the force \a contactForce
+just calculated by calcContactForce() (in the S1 frame), return the contact 
+normal (pointing away from surface 1, expressed in S1) and the derivative of
+the force on surface 2, including any friction, with respect to the 
+penetration depth. The default returns false, meaning that this generator 
+can't provide the derivative and its force will be treated as nonstiff in 
+position. **/
+virtual bool calcForceDepthDerivative
+   (const State&            state,
+    const Contact&          overlapping,
+    const ContactForce&     contactForce,
+    UnitVec3&               normal_S1,
+    Vec3&                   dFdDepth_S1) const
+{   return false; }
+
 
 //--------------------------------------------------------------------------
 private:
@@ -711,6 +727,13 @@ void calcContactPatch
     const Contact&          overlapping,
     const SpatialVec&       V_S1S2,
     ContactPatch&           patch) const override;
+
+bool calcForceDepthDerivative
+   (const State&            state,
+    const Contact&          overlapping,
+    const ContactForce&     contactForce,
+    UnitVec3&               normal_S1,
+    Vec3&                   dFdDepth_S1) const override;
 };
 
 
@@ -741,6 +764,13 @@ void calcContactPatch
     const Contact&          overlapping,
     const SpatialVec&       V_S1S2,
     ContactPatch&           patch) const override;
+
+bool calcForceDepthDerivative
+   (const State&            state,
+    const Contact&          overlapping,
+    const ContactForce&     contactForce,
+    UnitVec3&               normal_S1,
+    Vec3&                   dFdDepth_S1) const override;
 };
 
 
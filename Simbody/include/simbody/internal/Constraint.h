@@ -75,7 +75,16 @@ explicit Constraint(ConstraintImpl* r) : HandleBase(r) { }
 
 /** Disable this %Constraint, effectively removing it from the system. This
 is an Instance-stage change and affects the allocation of %Constraint-
-related resources in the supplied State. **/
+related resources in the supplied State. 
+
+Adding or removing a %Constraint after realizeTopology() is a topology change,
+so the next realizeTopology() rebuilds the whole System and the default State.
+When constraints come and go during a simulation, as when a gripper picks up
+and puts down objects, create every %Constraint that may be needed up front,
+use setDisabledByDefault() on the ones not in effect at the start, and then
+enable() and disable() them as needed. That changes only the Instance stage of
+the given State: the System's topology and the State's variables are kept.
+@see enable(), setDisabledByDefault() **/
 void disable(State&) const;
 
 /** Enable this %Constraint, without necessarily satisfying it. This is an 
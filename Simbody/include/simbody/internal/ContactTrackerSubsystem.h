@@ -245,6 +245,49 @@ const ContactTracker& getContactTracker(ContactGeometryTypeId surface1,
                                         bool& reverseOrder) const;
 /**@}**/
 
+/**@name                     Broad phase
+These methods control how the subsystem finds the pairs of surfaces whose
+bounding spheres touch and which therefore have to be examined by a
+ContactTracker. The choice affects only performance, never which contacts are
+found. **/
+/**@{**/
+
+/** The available broad phase algorithms. **/
+enum BroadPhase {
+    /** Sort the bounding spheres along the axis on which they are most spread
+    out and sweep along it. Nothing is remembered from one evaluation to the
+    next. This is the default and is fine for up to a few hundred surfaces
+    that aren't bunched up along one axis. **/
+    SingleAxisSweep = 0,
+    /** Like SingleAxisSweep, but keep the sort order from one evaluation to
+    the next and repair it incrementally, and reject pairs that are separated
+    along any axis before testing the spheres. **/
+    MultiAxisSweep  = 1,
+    /** Keep a dynamic tree of slightly enlarged bounding boxes; a surface's
+    box is only moved when the surface leaves it. This is the best choice for
+    thousands of surfaces, especially when they are piled together as in
+    granular media. **/
+    DynamicAABBTree = 2
+};
+
+/** Select the broad phase algorithm. This is a Topology-stage change. **/
+void setBroadPhase(BroadPhase broadPhase);
+/** Return the broad phase algorithm currently in use. **/
+BroadPhase getBroadPhase() const;
+
+/** Set the number of threads that may be used to find the overlapping pairs
+and to run the ContactTracker on them. With the default of 1 everything is
+done serially. If you use more, the ContactTracker objects and contact
+geometry in use must be safe to call concurrently from several threads (the
+built-in ones are). The contacts found, and their order, do not depend on
+the number of threads.
+@note This method should NOT be called while a State is being realized. **/
+void setNumberOfThreads(int numThreads);
+/** Return the number of threads the broad and narrow phase may use.
+@see setNumberOfThreads() **/
+int getNumberOfThreads() const;
+/**@}**/
+
 /**@name                     Advanced/Obscure
 You probably don't want to call any of these methods. Some may be 
 unimplemented. **/
@@ -125,6 +125,17 @@ public:
      * Set the transition velocity (vt) of the friction model.
      */
     void setTransitionVelocity(Real v);
+    /**
+     * Set the number of threads that may be used to evaluate the springs of a contact. The
+     * default of 1 does everything serially. Contacts with only a few hundred springs inside
+     * the other object are always evaluated serially, and the forces do not depend on the
+     * number of threads. This should not be called while a State is being realized.
+     */
+    void setNumberOfThreads(int numThreads);
+    /**
+     * Get the number of threads that may be used to evaluate the springs.
+     */
+    int getNumberOfThreads() const;
     SimTK_INSERT_DERIVED_HANDLE_DECLARATIONS(ElasticFoundationForce, ElasticFoundationForceImpl, Force);
 };
 
@@ -80,6 +80,22 @@ public:
     bool isDisabledByDefault() const;
     /*@}*/
 
+    /**@name                   Multirate integration
+    A force element that is expensive to calculate but changes slowly can be
+    marked "slow" so that a multirate integrator such as MultirateIntegrator
+    calculates it less often than the other forces, holding it at a fixed
+    value in between. See System::holdSlowForces(). You can mark a whole force
+    subsystem slow with ForceSubsystem::setSlow(). **/
+    /*@{*/
+    /** Mark this force element as slow (or not). This is a Topology-stage 
+    change; you will have to call realizeTopology() before using the 
+    containing System after a change to this setting has been made. **/
+    void setSlow(bool isSlow);
+    /** Test whether this force element has been marked slow. The default is
+    false. **/
+    bool isSlow() const;
+    /*@}*/
+
     /**@name                   Advanced methods
     Don't use these unless you're sure you know what you're doing. They aren't
     normally necessary but can be handy sometimes, especially when debugging
@@ -40,6 +40,15 @@ public:
 
     ForceSubsystem() : Subsystem() { }
 
+    /// Mark all the forces produced by this subsystem as slow, meaning that
+    /// they are expensive to calculate but change slowly, so that a multirate
+    /// integrator such as MultirateIntegrator may calculate them less often
+    /// than the other forces. This is a topology-stage change.
+    /// @see System::holdSlowForces(), Force::setSlow()
+    void setSlow(bool isSlow);
+    /// Return the value set by setSlow(); the default is false.
+    bool isSlow() const;
+
     SimTK_PIMPL_DOWNCAST(ForceSubsystem, Subsystem);
     Guts& updRep();
     const Guts& getRep() const;
@@ -39,7 +39,7 @@ namespace SimTK {
 class ForceSubsystem::Guts : public Subsystem::Guts {
 public:
     Guts(const String& name, const String& version) 
-      : Subsystem::Guts(name,version)
+      : Subsystem::Guts(name,version), slow(false)
     {
     }
 
@@ -58,7 +58,36 @@ public:
     /// be at Dynamics stage or later.
     virtual Real calcPotentialEnergy(const State& state) const = 0;
 
+    /// Add this subsystem's contribution to the nu X nu mobility-space 
+    /// stiffness matrix K=-d f/d theta and damping matrix D=-d f/d u, where
+    /// f are the generalized forces it produces and theta is a displacement 
+    /// in u-space (dq=N*dtheta). These are used to form the state derivative
+    /// Jacobian for implicit integrators and need only be good enough to
+    /// converge their iterations. The default adds nothing, which is right for
+    /// subsystems whose forces don't change quickly with q or u. The state 
+    /// must be at Dynamics stage or later.
+    virtual void addInStiffnessAndDamping(const State& state, 
+                                          Matrix& K, Matrix& D) const {}
+
+    /// Mark all the forces of this subsystem as slow, for use with multirate
+    /// integrators; see System::holdSlowForces(). This is a topology-stage
+    /// change. While slow forces are being held, the MultibodySystem skips
+    /// this subsystem's Dynamics-stage realization and applies its held forces
+    /// instead, so nothing else it calculates at that stage will be available.
+    void setSlow(bool isSlow) {
+        invalidateSubsystemTopologyCache();
+        slow = isSlow;
+    }
+    bool isSlow() const {return slow;}
+
+    /// Return true if any of this subsystem's forces are slow. The default 
+    /// says so only if the whole subsystem is slow; subsystems that can mark
+    /// some of their forces as slow should override this.
+    virtual bool hasSlowForces() const {return slow;}
+
     SimTK_DOWNCAST(ForceSubsystem::Guts, Subsystem::Guts);
+private:
+    bool slow;
 };
 
 // typedef ForceSubsystem::Guts ForceSubsystemRep;
@@ -122,6 +122,42 @@ public:
      * may still invoke it to calculate forces based on contacts.
      */
     const Array_<Contact>& getContacts(const State& state, ContactSetIndex set) const;
+    /**
+     * The broad phase algorithms that can be used to find the pairs of bodies whose bounding
+     * spheres overlap. The choice affects only performance, not which contacts are found.
+     */
+    enum BroadPhase {
+        /** Sort along the axis of greatest spread and sweep; nothing is remembered between
+         *  evaluations. This is the default and works well for up to a few hundred bodies. */
+        SingleAxisSweep = 0,
+        /** Like SingleAxisSweep, but keep the sort order between evaluations and repair it
+         *  incrementally, and reject pairs separated along any axis before testing their spheres. */
+        MultiAxisSweep  = 1,
+        /** Keep a dynamic tree of slightly enlarged bounding boxes that are only moved when
+         *  a body leaves its box. Best for thousands of bodies, e.g. granular media. */
+        DynamicAABBTree = 2
+    };
+    /**
+     * Select the broad phase algorithm used for all contact sets. This is a Topology-stage change.
+     * With SingleAxisSweep the contacts in each set are reported in the same order as in previous
+     * releases; with the others they are ordered by the indices of the two bodies.
+     */
+    void setBroadPhase(BroadPhase broadPhase);
+    /**
+     * Get the broad phase algorithm currently in use.
+     */
+    BroadPhase getBroadPhase() const;
+    /**
+     * Set the number of threads that may be used for the broad phase and for running the
+     * collision detection algorithms on the overlapping pairs. The default of 1 does everything
+     * serially. The contacts found, and their order, do not depend on the number of threads.
+     * This should not be called while a State is being realized.
+     */
+    void setNumberOfThreads(int numThreads);
+    /**
+     * Get the number of threads that may be used for collision detection.
+     */
+    int getNumberOfThreads() const;
     SimTK_PIMPL_DOWNCAST(GeneralContactSubsystem, Subsystem);
 private:
     class GeneralContactSubsystemImpl& updImpl();
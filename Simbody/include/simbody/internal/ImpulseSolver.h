@@ -29,6 +29,8 @@
 
 namespace SimTK {
 
+class SimbodyMatterSubsystem;
+
 /** This is the abstract base class for impulse solvers, which solve an
 important subproblem of the contact and impact equations.
 
@@ -114,6 +116,7 @@ public:
     struct BoundedRT;
     struct ConstraintLtdFrictionRT;
     struct StateLtdFrictionRT;
+    class  SparseCompliance;
 
     // How to treat a unilateral contact (input to solver).
     enum ContactType {TypeNA=-1, Observing=0, Known=1, Participating=2};
@@ -138,6 +141,13 @@ public:
 
     virtual ~ImpulseSolver() {}
 
+    /** Return a new solver of the same concrete type and with the same 
+    settings, but with no statistics and no initial guess, so that 
+    independent problems can be solved concurrently. The caller takes over 
+    ownership. The default returns null, meaning this solver can't be 
+    copied; callers must then solve their problems one at a time. **/
+    virtual ImpulseSolver* clone() const {return nullptr;}
+
     void setMaxRollingSpeed(Real roll2slipTransitionSpeed) {
         assert(roll2slipTransitionSpeed >= 0);
         m_maxRollingTangVel = roll2slipTransitionSpeed; 
@@ -166,6 +176,19 @@ public:
         m_nBilateralSolves = m_nBilateralIters = m_nBilateralFail = 0;
     }
 
+    /** Add the statistics gathered by another solver, typically a clone()
+    of this one, to the statistics of this solver. **/
+    void accumulateStats(const ImpulseSolver& other) const {
+        for (int i=0; i < MaxNumPhases; ++i) {
+            m_nSolves[i] += other.m_nSolves[i];
+            m_nIters[i]  += other.m_nIters[i];
+            m_nFail[i]   += other.m_nFail[i];
+        }
+        m_nBilateralSolves += other.m_nBilateralSolves;
+        m_nBilateralIters  += other.m_nBilateralIters;
+        m_nBilateralFail   += other.m_nBilateralFail;
+    }
+
     void clearStats(int phase) const {
         SimTK_ERRCHK2(0<=phase&&phase<MaxNumPhases,
             "ImpulseSolver::clearStats(phase)",
@@ -222,6 +245,53 @@ public:
         Vector&                             pi     // m, unknown result
         ) const = 0;
 
+    /** Solve, with the compliance matrix A supplied in matrix-free form
+    rather than as a dense matrix. Otherwise this is identical to the dense
+    solve() above. The default implementation forms the dense A from the
+    SparseCompliance and calls the dense method; concrete solvers that can
+    work directly with the sparse form should override this. **/
+    virtual bool solve
+       (int                                 phase,
+        const Array_<MultiplierIndex>&      participating, // p<=m of these 
+        const SparseCompliance&             A,     // m X m, matrix-free
+        const Vector&                       D,     // m, diag>=0 added to A
+        const Array_<MultiplierIndex>&      expanding, // nx<=m of these 
+        Vector&                             piExpand, // m
+        Vector&                             verrStart,   // m, RHS (in/out)
+        Vector&                             verrApplied, // m
+        Vector&                             pi,       // m, known+unknown
+        Array_<UncondRT>&                   unconditional,
+        Array_<UniContactRT>&               uniContact, // with friction
+        Array_<UniSpeedRT>&                 uniSpeed,
+        Array_<BoundedRT>&                  bounded,
+        Array_<ConstraintLtdFrictionRT>&    consLtdFriction,
+        Array_<StateLtdFrictionRT>&         stateLtdFriction
+        ) const;
+
+    /** Solve a set of bilateral constraints, with the compliance matrix A
+    supplied in matrix-free form. The default implementation forms the dense
+    A and calls the dense solveBilateral(). **/
+    virtual bool solveBilateral
+       (const Array_<MultiplierIndex>&      participating, // p<=m of these 
+        const SparseCompliance&             A,     // m X m, matrix-free
+        const Vector&                       D,     // m, diag>=0 added to A
+        const Vector&                       rhs,   // m, RHS
+        Vector&                             pi     // m, unknown result
+        ) const;
+
+    /** Supply an initial guess for the unknown impulse pi to be used by
+    subsequent solve() calls, typically the impulse found for the same
+    constraints at the previous time step. The guess has length m; only its
+    participating entries are used and NaN entries are treated as zero. It
+    remains in effect until replaced or cleared. Iterative solvers use it as
+    their starting point; solvers that can't use a guess ignore it. **/
+    void setInitialGuess(const Vector& piGuess) {m_piGuess = piGuess;}
+    /** Remove the initial guess so that solves start from pi=0. **/
+    void clearInitialGuess() {m_piGuess.resize(0);}
+    /** Return the current initial guess; this has length zero if there is
+    none. **/
+    const Vector& getInitialGuess() const {return m_piGuess;}
+
     // Printable names for the enum values for debugging.
     static const char* getContactTypeName(ContactType ct);
     static const char* getUniCondName(UniCond uc);
@@ -236,6 +306,7 @@ protected:
     Real m_maxRollingTangVel; // Sliding above this speed if solver cares.
     Real m_convergenceTol;    // Meaning depends on concrete solver.
     int  m_maxIters;          // Meaning depends on concrete solver.
+    Vector m_piGuess;         // Initial guess for pi, or length zero.
 
     mutable long long m_nSolves[MaxNumPhases];
     mutable long long m_nIters[MaxNumPhases];
@@ -363,6 +434,74 @@ struct ImpulseSolver::StateLtdFrictionRT {
     Array_<Real>            m_Fimpulse; // same size as m_Fk
 };
 
+/** A matrix-free representation of the constraint compliance matrix
+A = G M\ ~G, for use by the impulse solvers when m is too large for the dense
+mXm matrix to be worth forming. For each constraint equation j we keep the
+nonzeros of the j'th row of G and of the corresponding column W[j]=M\ ~G[j]
+of the response matrix W=M\ ~G. These are nonzero only for the mobilities of
+the tree branches (subtrees of base bodies) that the equation's Constraint
+acts on, so each is short when there are many small bodies. Then
+A(i,j) = G[i]*W[j] and A*pi = G*(W*pi) take time proportional to the number of
+stored entries. The diagonal of each Constraint's Delassus block, A(j,j), is
+kept explicitly for use in Gauss-Seidel updates.
+
+calc() obtains the entries using O(n) operators, handling one equation from
+each of many Constraints at once: Constraints that act on disjoint sets of
+branches don't interact through M\, so a single application of ~G and M\
+serves all of them. The number of such "probes" is about the number of
+equations in the largest group of Constraints sharing a branch, rather than
+the m operator applications needed to form the dense A. We assume the ~G
+applied by multiplyByGTranspose() is the transpose of the G applied by
+multiplyByG(), as it is for non-working constraints. **/
+class SimTK_SIMBODY_EXPORT ImpulseSolver::SparseCompliance {
+public:
+    SparseCompliance() : m_nu(0), m_numProbes(0) {}
+
+    /** Calculate the rows of G and columns of W for all the constraint 
+    equations currently in use in \a state, which must be realized through
+    Velocity stage (Position if all constraints are holonomic). **/
+    void calc(const SimbodyMatterSubsystem& matter, const State& state);
+
+    /** Return m, the number of constraint equations. **/
+    int size() const {return m_diag.size();}
+    /** Return n, the number of mobilities. **/
+    int getNumMobilities() const {return m_nu;}
+    /** Return the number of ~G, M\ operator pairs used by the last calc(). **/
+    int getNumProbes() const {return m_numProbes;}
+
+    /** Return the diagonal element A(j,j). **/
+    Real getDiag(MultiplierIndex j) const {return m_diag[j];}
+
+    /** Return G[j]*du, the j'th constraint-space velocity produced by a
+    mobility-space velocity change du (length n). **/
+    Real multiplyRowByVelocity(MultiplierIndex j, const Vector& du) const;
+
+    /** Add s*W[j] to du, the velocity change produced by an impulse s in
+    the j'th constraint equation. **/
+    void addColumnToVelocity(MultiplierIndex j, Real s, Vector& du) const;
+
+    /** Calculate Api = A*pi without forming A. **/
+    void multiply(const Vector& pi, Vector& Api) const;
+
+    /** Form the dense mXm matrix A, for solvers that need it. **/
+    void calcMatrix(Matrix& A) const;
+
+    /** Set \a sub to the principal submatrix of A for the given equations,
+    renumbered 0..rows.size()-1 in the given order, keeping only the
+    mobilities that those equations involve. **/
+    void calcSubset(const Array_<MultiplierIndex>& rows, 
+                    SparseCompliance& sub) const;
+
+private:
+    int             m_nu;
+    int             m_numProbes;
+    Array_<int>     m_start;  // m+1; entries of row j are [start[j],start[j+1])
+    Array_<int>     m_uIndex; // the mobility for each entry
+    Array_<Real>    m_G;      // G(j,u) for each entry
+    Array_<Real>    m_W;      // W(u,j) for each entry
+    Vector          m_diag;   // A(j,j)
+};
+
 } // namespace SimTK
 
 #endif // SimTK_SIMBODY_IMPULSE_SOLVER_H_
@@ -60,6 +60,13 @@ public:
                       100), // default PGS max number iterations
         m_SOR(1.2) {}
 
+    PGSImpulseSolver* clone() const override {
+        PGSImpulseSolver* copy = new PGSImpulseSolver(*this);
+        copy->clearStats();
+        copy->clearInitialGuess();
+        return copy;
+    }
+
     /** Solve with conditional constraints. In the common underdetermined
     case (redundant contact) we will return the first solution encountered but
     it is unlikely to be the best possible solution. **/
@@ -94,7 +101,56 @@ public:
         Vector&                             pi     // m, unknown result
         ) const override;
 
+    /** Solve with conditional constraints, using the matrix-free compliance.
+    The iterates are the same as for the dense solve(); the Gauss-Seidel row
+    sums are formed from a running mobility-space velocity change du=W*pi
+    rather than from columns of A. **/
+    bool solve
+       (int                                 phase,
+        const Array_<MultiplierIndex>&      participating,
+        const SparseCompliance&             A,
+        const Vector&                       D, 
+        const Array_<MultiplierIndex>&      expanding, // nx<=m of these 
+        Vector&                             piExpand,
+        Vector&                             verrStart, // in/out
+        Vector&                             verrApplied, // in/out
+        Vector&                             pi, 
+        Array_<UncondRT>&                   unconditional,
+        Array_<UniContactRT>&               uniContact,
+        Array_<UniSpeedRT>&                 uniSpeed,
+        Array_<BoundedRT>&                  bounded,
+        Array_<ConstraintLtdFrictionRT>&    consLtdFriction,
+        Array_<StateLtdFrictionRT>&         stateLtdFriction
+        ) const override;
+
+    /** Solve with only unconditional constraints, using the matrix-free
+    compliance. **/
+    bool solveBilateral
+       (const Array_<MultiplierIndex>&      participating, // p<=m of these 
+        const SparseCompliance&             A,     // m X m, matrix-free
+        const Vector&                       D,     // m, diag>=0 added to A
+        const Vector&                       rhs,   // m, RHS
+        Vector&                             pi     // m, unknown result
+        ) const override;
+
 private:
+    // The iterations, written once for both representations of A. Ops 
+    // supplies the row sums, diagonals, and products with A.
+    template <class Ops>
+    bool solveImpl
+       (int phase, const Array_<MultiplierIndex>& participating, Ops& A,
+        const Vector& D, const Array_<MultiplierIndex>& expanding,
+        Vector& piExpand, Vector& verrStart, Vector& verrApplied, Vector& pi,
+        Array_<UncondRT>& unconditional, Array_<UniContactRT>& uniContact,
+        Array_<UniSpeedRT>& uniSpeed, Array_<BoundedRT>& bounded,
+        Array_<ConstraintLtdFrictionRT>& consLtdFriction,
+        Array_<StateLtdFrictionRT>& stateLtdFriction) const;
+
+    template <class Ops>
+    bool solveBilateralImpl
+       (const Array_<MultiplierIndex>& participating, Ops& A, const Vector& D,
+        const Vector& rhs, Vector& pi) const;
+
     Real m_SOR; 
 };
 
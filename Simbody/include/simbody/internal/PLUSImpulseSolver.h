@@ -41,6 +41,17 @@ public:
         m_cosMaxSlidingDirChange(std::cos(Pi/6)) // 30 degrees
     {}
 
+    // PLUS works with the dense A; the matrix-free overloads form it.
+    using ImpulseSolver::solve;
+    using ImpulseSolver::solveBilateral;
+
+    PLUSImpulseSolver* clone() const override {
+        PLUSImpulseSolver* copy = new PLUSImpulseSolver(*this);
+        copy->clearStats();
+        copy->clearInitialGuess();
+        return copy;
+    }
+
     /** Solve with conditional constraints. **/
     bool solve
        (int                                 phase,
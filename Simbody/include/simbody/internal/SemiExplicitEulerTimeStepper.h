@@ -31,6 +31,10 @@
 #include "simbody/internal/PGSImpulseSolver.h"
 #include "simbody/internal/PLUSImpulseSolver.h"
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace SimTK {
 
 /** A low-accuracy, high performance, velocity-level time stepper for
@@ -151,6 +155,58 @@ public:
     ImpulseSolverType getImpulseSolverType() const 
     {   return m_solverType; }
 
+    /** Choose whether the constraint compliance matrix A=G M\ ~G is formed
+    explicitly at each step (the default) or kept in matrix-free form, as the
+    rows of G and columns of M\ ~G restricted to the tree branches each
+    Constraint acts on (see ImpulseSolver::SparseCompliance). The matrix-free
+    form avoids the O(m^2) memory and most of the O(m*n) cost of forming A
+    and is much faster when there are many contacts spread over many bodies;
+    the PGS solver then works with it directly while the PLUS solver forms
+    the dense matrix from it. **/
+    void setUseMatrixFreeCompliance(bool useMatrixFree)
+    {   m_useMatrixFree = useMatrixFree; }
+    bool getUseMatrixFreeCompliance() const 
+    {   return m_useMatrixFree; }
+
+    /** Choose whether the impulse solver starts each step's contact solve
+    from the impulses found at the previous step for the same unilateral
+    contacts, matched by UnilateralContactIndex, rather than from zero. This
+    is on by default; it usually reduces the iterations needed by the PGS
+    solver considerably when contacts persist, and is ignored by solvers that
+    can't make use of a starting guess. **/
+    void setWarmStartImpulses(bool warmStart)
+    {   m_warmStart = warmStart; }
+    bool getWarmStartImpulses() const 
+    {   return m_warmStart; }
+
+    /** Choose whether to split each impulse problem into independent
+    "islands", one for each group of bodies linked to one another by the
+    constraints and contacts in use at a step, and solve those separately.
+    The islands are found each step with a union-find over the tree branches
+    (subtrees of base bodies) that each Constraint acts on. Islands are off
+    by default, and are used only when there is more than one and the
+    ImpulseSolver supports ImpulseSolver::clone(), as the built-in ones do.
+    A problem with a single island is solved exactly as before. Iterative
+    solvers test convergence for each island separately, so with islands
+    their results can differ from a single solve by up to the solver's
+    convergence tolerance, which may accumulate over many steps. **/
+    void setUseIslands(bool useIslands)
+    {   m_useIslands = useIslands; }
+    bool getUseIslands() const 
+    {   return m_useIslands; }
+
+    /** Return the number of islands found at the last step; this is zero if
+    there were no constraints and 1 if islands aren't in use. **/
+    int getNumIslands() const {return m_numIslands;}
+
+    /** Set the number of threads that may be used to solve the islands'
+    impulse problems concurrently. With the default of 1 they are solved one
+    after another. Each thread gets its own clone() of the ImpulseSolver; the
+    results do not depend on the number of threads. **/
+    void setNumberOfThreads(int numThreads);
+    /** Return the number of threads set by setNumberOfThreads(). **/
+    int getNumberOfThreads() const {return m_threads.getNumberOfThreads();}
+
     /** Set the impact capture velocity to be used by default when a contact
     does not provide its own. This is the impact velocity below which the
     coefficient of restitution is to be treated as zero. This avoids a Zeno's
@@ -273,6 +329,7 @@ public:
     /** (Advanced) Delete the existing ImpulseSolver if any. **/
     void clearImpulseSolver() {
         delete m_solver; m_solver=0;
+        m_islandSolvers.clear();
     }
 
     /** Get human-readable string representing the given enum value. **/
@@ -381,6 +438,62 @@ private:
                               Vector&       impulse);
     bool anyPositionErrorsViolated(const State&, const Vector& perr) const;
 
+    // Invoke the impulse solver with either the dense or the matrix-free
+    // compliance matrix, whichever is in use.
+    bool solveForImpulses
+       (int                                             phase,
+        const Array_<MultiplierIndex>&                  participating,
+        const Array_<MultiplierIndex>&                  expanding,
+        Vector&                                         piExpand,
+        Vector&                                         verrStart,
+        Vector&                                         verrApplied,
+        Vector&                                         pi,
+        Array_<ImpulseSolver::UncondRT>&                unconditional,
+        Array_<ImpulseSolver::UniContactRT>&            uniContact,
+        Array_<ImpulseSolver::UniSpeedRT>&              uniSpeed,
+        Array_<ImpulseSolver::BoundedRT>&               bounded,
+        Array_<ImpulseSolver::ConstraintLtdFrictionRT>& consLtdFriction,
+        Array_<ImpulseSolver::StateLtdFrictionRT>&      stateLtdFriction);
+    bool solveBilateralForImpulses(const Array_<MultiplierIndex>& participating,
+                                   const Vector& rhs, Vector& pi);
+
+    // Find the contact islands for the constraints now in use, filling in
+    // m_multIsland and m_numIslands.
+    void findIslands(const State& s);
+    // Split an impulse problem into its islands and solve those separately,
+    // possibly concurrently. Returns false in *split if the problem couldn't
+    // be split, in which case nothing has been done.
+    bool solveByIslands
+       (int                                             phase,
+        const Array_<MultiplierIndex>&                  participating,
+        const Array_<MultiplierIndex>&                  expanding,
+        Vector&                                         piExpand,
+        Vector&                                         verrStart,
+        Vector&                                         verrApplied,
+        Vector&                                         pi,
+        Array_<ImpulseSolver::UncondRT>&                unconditional,
+        Array_<ImpulseSolver::UniContactRT>&            uniContact,
+        Array_<ImpulseSolver::UniSpeedRT>&              uniSpeed,
+        Array_<ImpulseSolver::BoundedRT>&               bounded,
+        Array_<ImpulseSolver::ConstraintLtdFrictionRT>& consLtdFriction,
+        Array_<ImpulseSolver::StateLtdFrictionRT>&      stateLtdFriction,
+        bool*                                           split);
+    bool solveBilateralByIslands(const Array_<MultiplierIndex>& participating,
+                                 const Vector& rhs, Vector& pi, bool* split);
+    // Make a fresh clone of the impulse solver for each of nSolvers
+    // concurrent island solves. Returns false if the solver can't be cloned.
+    bool prepareIslandSolvers(int nSolvers);
+    // Run solveIsland(solver, island) for islands 0..nIslands-1, spread over 
+    // the threads if there are any.
+    void forEachIsland(int nIslands, 
+        const std::function<void(ImpulseSolver&,int)>& solveIsland);
+
+    // Give the impulse solver a starting guess for the compression phase 
+    // impulses, from the contact forces saved at the end of the last step.
+    void setWarmStartGuess(Real h);
+    // Save the unilateral contact forces found in this step.
+    void saveWarmStartForces(const Vector& lambda);
+
     // This phase uses only holonomic constraints, and zero is a good initial
     // guess for the (hopefully small) position correction.
     bool doPositionCorrectionPhase(const State& state, 
@@ -397,6 +510,9 @@ private:
     int                         m_maxInducedImpactsPerStep;
     PositionProjectionMethod    m_projectionMethod;
     ImpulseSolverType           m_solverType;
+    bool                        m_useMatrixFree;
+    bool                        m_warmStart;
+    bool                        m_useIslands;
 
 
     Real                        m_defaultCaptureVelocity;
@@ -406,12 +522,20 @@ private:
 
     ImpulseSolver*              m_solver;
 
+    // For solving islands concurrently; there is one solver per chunk.
+    ParallelExecutorOption                      m_threads;
+    std::vector<std::unique_ptr<ImpulseSolver>> m_islandSolvers;
+
     // Persistent runtime data.
     State                       m_state;
     Vector                      m_emptyVector; // don't change this!
 
     // Step temporaries.
     Matrix                      m_GMInvGt; // G M\ ~G
+    ImpulseSolver::SparseCompliance m_compliance; // same, if matrix-free
+    Vector                      m_impulseGuess;
+    Array_<int>                 m_multIsland; // island of each multiplier
+    int                         m_numIslands;
     Vector                      m_D; // soft diagonal
     Vector                      m_deltaU;
     Vector                      m_verr;
@@ -424,6 +548,10 @@ private:
     Array_<StateLimitedFrictionIndex>   m_proximalStateLtdFriction,
                                         m_distalStateLtdFriction;
 
+    // Normal and friction multipliers (forces) of each unilateral contact at
+    // the end of the last step, for warm starting; NaN if not available.
+    Array_<Vec3,UnilateralContactIndex> m_prevUniContactForce;
+
     // This is for use in the no-impact phase where all proximals participate.
     Array_<MultiplierIndex>                         m_allParticipating;
 
@@ -205,6 +205,61 @@ void setShowDefaultGeometry(bool show);
 geometry that can be used to visualize this multibody system. **/
 bool getShowDefaultGeometry() const;
 
+/** Set the number of threads the matter subsystem may use for the recursive
+tip-to-base and base-to-tip sweeps of the articulated body algorithm
+(realizeArticulatedBodyInertias(), calcTreeAccelerations() and the forward
+dynamics operators built on them). Bodies at the same level of the multibody
+tree are independent during these sweeps so they can be processed
+concurrently. Only levels containing enough work to pay for the thread 
+synchronization are split; narrow levels are always processed serially, so 
+this is mainly useful for wide trees (many branches or many free bodies).
+
+By default only one thread is used and all sweeps are serial. If you enable
+this and have Custom mobilizers, their implementations must be safe to call
+concurrently from several threads.
+
+@param[in] numThreads   At least 1; 1 makes the sweeps serial.
+@note This method should NOT be called while a State is being realized. **/
+void setNumberOfThreads(int numThreads);
+/** Return the number of threads the matter subsystem may use for its
+recursive sweeps; 1 (the default) means they are serial. 
+@see setNumberOfThreads() **/
+int getNumberOfThreads() const;
+
+/** The methods that can be used to solve for the constraint multipliers
+during forward dynamics (and for constraint impulses); see 
+setConstraintSolver(). **/
+enum ConstraintSolver {
+    /** Form the full matrix G M^-1 ~G with one O(n) operator sequence per
+    constraint equation and factor it with a dense rank-revealing 
+    factorization. Cost is O(m*n + m^3) for m constraint equations. This is
+    the default. **/
+    DenseConstraintSolver  = 0,
+    /** Take advantage of the fact that constraints acting on different 
+    branches of the multibody tree (subtrees of different base bodies) are 
+    not coupled through the mass matrix. Only the nonzeros of G M^-1 ~G are 
+    formed, several columns at a time, and it is factored with a sparse 
+    LDL^T factorization using a minimum degree ordering. For systems made of
+    many separately mobilized bodies joined by constraints (chains, nets and
+    cloth of free bodies welded or ball-jointed together) the cost grows
+    roughly linearly with the number of constraints. Constraints within a 
+    single branch are all coupled and get no benefit. Redundant constraint
+    equations are dropped, so their multipliers are zero rather than sharing
+    the load as with the dense solver. If G M^-1 ~G is not symmetric (some
+    constraints don't transmit forces through ~G) the dense solver is used 
+    instead. **/
+    SparseConstraintSolver = 1
+};
+
+/** Select the method used to solve for the constraint multipliers. Both 
+give the same accelerations when the constraints are independent. This 
+invalidates the Topology stage.
+@see ConstraintSolver **/
+void setConstraintSolver(ConstraintSolver solver);
+/** Return the method currently used to solve for the constraint 
+multipliers. @see setConstraintSolver() **/
+ConstraintSolver getConstraintSolver() const;
+
 /** The number of bodies includes all mobilized bodies \e including Ground,
 which is the first mobilized body, at MobilizedBodyIndex 0. (Note: if 
 special particle handling were implemented, the count here would \e not 
@@ -2035,6 +2090,27 @@ void calcAccelerationIgnoringConstraints
     Vector&                     udot,    
     Vector_<SpatialVec>&        A_GB) const;
 
+/** Batch version of calcAccelerationIgnoringConstraints() that works on many
+States of this same System at once. Entry k of each of the force and result
+arrays goes with <tt>*states[k]</tt>; the output arrays are resized to match
+the number of States. Articulated body inertias are realized for the whole
+batch with realizeArticulatedBodyInertias(const Array_<const State*>&). If 
+setNumberOfThreads() has enabled threads the batch is divided among them;
+otherwise this is equivalent to calling the single-State method on each State
+in turn, and results are identical in either case. Each State is computed 
+with the same scalar code as the single-State method; there is no 
+vectorization across the batch.
+
+@par Required stage
+  \c Stage::Dynamics for every State. Each State may appear only once in the
+  batch. **/
+void calcAccelerationIgnoringConstraints
+   (const Array_<const State*>&         states,
+    const Array_<Vector>&               appliedMobilityForces,
+    const Array_<Vector_<SpatialVec> >& appliedBodyForces,
+    Array_<Vector>&                     udot,
+    Array_<Vector_<SpatialVec> >&       A_GB) const;
+
 
 
 /** This is the inverse dynamics operator for the tree system; if there are
@@ -2589,6 +2665,19 @@ are guaranteed to be available by Stage::Acceleration.
 @see invalidateArticulatedBodyInertias() **/
 void realizeArticulatedBodyInertias(const State&) const;
 
+/** (Advanced) Batch version of realizeArticulatedBodyInertias() for many
+States of this same System, such as the perturbed copies used in Monte Carlo
+or optimizer rollouts. The result is the same as calling 
+realizeArticulatedBodyInertias() on each State in turn. If 
+setNumberOfThreads() has been used to enable multiple threads, the batch is 
+divided among them. States whose ABIs are already valid are skipped.
+
+@par Required stage
+  For every State: \c Stage::Position, or \c Stage::Instance and 
+  \c PositionKinematics. Each State may appear only once in the batch.
+@see calcAccelerationIgnoringConstraints(const Array_<const State*>&, ...) **/
+void realizeArticulatedBodyInertias(const Array_<const State*>& states) const;
+
 /** (Advanced) This method ensures that velocity-dependent computations that 
 also depend on articulated body inertias (ABIs) are up to date with the most 
 recent changes to the configuration state variables q and velocity state 
@@ -0,0 +1,464 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "simbody/internal/BinaryDataEventReporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace SimTK;
+using std::uint32_t;
+using std::uint64_t;
+
+//==============================================================================
+//                               FILE LAYOUT
+//==============================================================================
+/* A file is a FileHeader, then the chunks, then the chunk index (one
+ChunkEntry per chunk), then a FileFooter. A chunk of n frames holds n times
+followed by n values of each column in turn, all Reals. */
+namespace {
+const char      HeaderMagic[8]  = {'S','i','m','T','K','T','r','j'};
+const char      FooterMagic[8]  = {'S','i','m','T','K','E','n','d'};
+const uint32_t  FormatVersion   = 1;
+const uint32_t  ByteOrderMarker = 0x01020304;
+
+struct FileHeader {
+    char        magic[8];
+    uint32_t    formatVersion;
+    uint32_t    byteOrder;
+    uint32_t    realSize;
+    uint32_t    numColumns;
+    uint32_t    framesPerChunk;
+    uint32_t    reserved;
+};
+
+struct ChunkEntry {
+    uint64_t    offset;     // from the start of the file
+    uint64_t    numFrames;
+    double      startTime, endTime;
+};
+
+struct FileFooter {
+    uint64_t    numChunks;
+    uint64_t    numFrames;
+    uint64_t    indexOffset;
+    char        magic[8];
+};
+}
+
+
+
+//==============================================================================
+//                      BINARY DATA EVENT REPORTER REP
+//==============================================================================
+/* The simulation thread (in handleEvent()) is the only producer and the
+writer thread is the only consumer of the ring buffer, so the ring needs no
+locks: the producer fills the slot at head and then advances head; the
+consumer empties the slot at tail and then advances tail. The mutex and
+condition variable are only used to let the writer sleep when there is
+nothing to do. */
+class BinaryDataEventReporter::BinaryDataEventReporterRep {
+public:
+    BinaryDataEventReporterRep(const System& system,
+                               UserFunction<Vector>* function,
+                               const String& pathname,
+                               int framesPerChunk, int bufferFrames)
+    :   handle(nullptr), system(system), function(function),
+        pathname(pathname), framesPerChunk(framesPerChunk),
+        capacity(bufferFrames), numColumns(-1), head(0), tail(0), stalls(0),
+        closing(false), failed(false), closed(false), framesInChunk(0) {
+        out.open(pathname.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out.good()) {
+            delete function; // we own it but won't get to the destructor
+            this->function = nullptr;
+        }
+        SimTK_ERRCHK1_ALWAYS(out.good(),
+            "BinaryDataEventReporter::BinaryDataEventReporter()",
+            "Can't open file '%s' for writing.", pathname.c_str());
+        writer = std::thread(&BinaryDataEventReporterRep::writeFrames, this);
+    }
+
+    ~BinaryDataEventReporterRep() {
+        if (!closed) {
+            try {close();} catch (...) {}
+        }
+        delete function;
+    }
+
+    void handleEvent(const State& state) {
+        const char* where = "BinaryDataEventReporter::handleEvent()";
+        SimTK_ERRCHK1_ALWAYS(!closed, where,
+            "The file '%s' has already been closed.", pathname.c_str());
+
+        Vector values;
+        int n;
+        if (function) {
+            values = function->evaluate(system, state);
+            n = values.size();
+        } else
+            n = state.getNQ() + state.getNU();
+
+        if (numColumns < 0) {
+            // The first frame sets the width; the writer won't look at the
+            // ring until head is advanced below.
+            numColumns = n;
+            ring.resize((size_t)capacity*(1+numColumns));
+        }
+        SimTK_ERRCHK3_ALWAYS(n == numColumns, where,
+            "Frame at time %g has %d values but earlier frames had %d.",
+            state.getTime(), n, numColumns);
+
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= (uint64_t)capacity) {
+            ++stalls;
+            do {
+                wake.notify_one();
+                std::this_thread::yield();
+            } while (h - tail.load(std::memory_order_acquire)
+                     >= (uint64_t)capacity);
+        }
+
+        Real* slot = &ring[(size_t)(h % capacity)*(1+numColumns)];
+        slot[0] = state.getTime();
+        if (function)
+            for (int i=0; i < n; ++i) slot[1+i] = values[i];
+        else {
+            const Vector& q = state.getQ();
+            const Vector& u = state.getU();
+            for (int i=0; i < q.size(); ++i) slot[1+i] = q[i];
+            for (int i=0; i < u.size(); ++i) slot[1+q.size()+i] = u[i];
+        }
+        head.store(h+1, std::memory_order_release);
+
+        // Wake the writer once there is a chunk's worth to write.
+        if ((h+1) % std::min(framesPerChunk, (capacity+1)/2) == 0)
+            wake.notify_one();
+    }
+
+    void close() {
+        if (closed) return;
+        closed = true;
+        closing.store(true, std::memory_order_release);
+        wake.notify_one();
+        writer.join();
+        SimTK_ERRCHK1_ALWAYS(!failed, "BinaryDataEventReporter::close()",
+            "Failed writing to file '%s'.", pathname.c_str());
+    }
+
+    BinaryDataEventReporter*    handle;
+    const System&               system;
+    UserFunction<Vector>*       function;
+    const String                pathname;
+    const int                   framesPerChunk;
+    const int                   capacity;
+
+    // Set by the first frame; both threads read it after that.
+    int                         numColumns;
+    std::vector<Real>           ring;
+    std::atomic<uint64_t>       head, tail;
+    std::atomic<int>            stalls;
+    std::atomic<bool>           closing;
+    std::atomic<bool>           failed;
+    bool                        closed;  // used by the simulation thread
+
+    std::thread                 writer;
+    std::mutex                  sleepLock;
+    std::condition_variable     wake;
+
+private:
+    // Everything below is used only by the writer thread.
+    void writeFrames() {
+        while (true) {
+            const uint64_t t = tail.load(std::memory_order_relaxed);
+            const bool done = closing.load(std::memory_order_acquire);
+            if (t == head.load(std::memory_order_acquire)) {
+                if (done) break;
+                std::unique_lock<std::mutex> lock(sleepLock);
+                wake.wait_for(lock, std::chrono::milliseconds(10));
+                continue;
+            }
+            if (chunk.empty()) {
+                chunk.resize((size_t)framesPerChunk*(1+numColumns));
+                writeHeader();
+            }
+            const Real* slot = &ring[(size_t)(t % capacity)*(1+numColumns)];
+            for (int c=0; c <= numColumns; ++c)
+                chunk[(size_t)c*framesPerChunk + framesInChunk] = slot[c];
+            tail.store(t+1, std::memory_order_release);
+            if (++framesInChunk == framesPerChunk)
+                writeChunk();
+        }
+        if (chunk.empty()) {
+            numColumns = std::max(numColumns, 0);
+            writeHeader();
+        }
+        if (framesInChunk)
+            writeChunk();
+        writeIndex();
+        out.close();
+        if (out.fail()) failed = true;
+    }
+
+    void writeHeader() {
+        FileHeader hdr;
+        std::memset(&hdr, 0, sizeof(hdr));
+        std::memcpy(hdr.magic, HeaderMagic, sizeof(HeaderMagic));
+        hdr.formatVersion   = FormatVersion;
+        hdr.byteOrder       = ByteOrderMarker;
+        hdr.realSize        = (uint32_t)sizeof(Real);
+        hdr.numColumns      = (uint32_t)numColumns;
+        hdr.framesPerChunk  = (uint32_t)framesPerChunk;
+        write(&hdr, sizeof(hdr));
+    }
+
+    // Write the filled part of each column of the current chunk.
+    void writeChunk() {
+        ChunkEntry entry;
+        entry.offset    = offset;
+        entry.numFrames = framesInChunk;
+        entry.startTime = chunk[0];
+        entry.endTime   = chunk[framesInChunk-1];
+        index.push_back(entry);
+        for (int c=0; c <= numColumns; ++c)
+            write(&chunk[(size_t)c*framesPerChunk],
+                  framesInChunk*sizeof(Real));
+        framesInChunk = 0;
+    }
+
+    void writeIndex() {
+        FileFooter footer;
+        std::memset(&footer, 0, sizeof(footer));
+        footer.numChunks    = index.size();
+        footer.indexOffset  = offset;
+        for (const ChunkEntry& entry : index)
+            footer.numFrames += entry.numFrames;
+        std::memcpy(footer.magic, FooterMagic, sizeof(FooterMagic));
+        if (!index.empty())
+            write(index.data(), index.size()*sizeof(ChunkEntry));
+        write(&footer, sizeof(footer));
+    }
+
+    void write(const void* data, size_t nBytes) {
+        out.write(static_cast<const char*>(data), nBytes);
+        offset += nBytes;
+        if (!out.good()) failed = true;
+    }
+
+    std::ofstream               out;
+    uint64_t                    offset = 0;
+    std::vector<Real>           chunk;
+    int                         framesInChunk;
+    std::vector<ChunkEntry>     index;
+};
+
+
+
+//==============================================================================
+//                        BINARY DATA EVENT REPORTER
+//==============================================================================
+BinaryDataEventReporter::BinaryDataEventReporter
+   (const System& system, UserFunction<Vector>* function, Real reportInterval,
+    const String& pathname, int framesPerChunk, int bufferFrames)
+:   PeriodicEventReporter(reportInterval), rep(nullptr) {
+    SimTK_APIARGCHECK1_ALWAYS(framesPerChunk >= 1, "BinaryDataEventReporter",
+        "BinaryDataEventReporter", "Illegal number of frames per chunk %d.",
+        framesPerChunk);
+    SimTK_APIARGCHECK1_ALWAYS(bufferFrames >= 1, "BinaryDataEventReporter",
+        "BinaryDataEventReporter", "Illegal buffer size %d.", bufferFrames);
+    rep = new BinaryDataEventReporterRep(system, function, pathname,
+                                         framesPerChunk, bufferFrames);
+    updRep().handle = this;
+}
+
+BinaryDataEventReporter::BinaryDataEventReporter
+   (const System& system, Real reportInterval, const String& pathname,
+    int framesPerChunk, int bufferFrames)
+:   BinaryDataEventReporter(system, nullptr, reportInterval, pathname,
+                            framesPerChunk, bufferFrames) {}
+
+BinaryDataEventReporter::~BinaryDataEventReporter() {
+    if (rep && rep->handle == this)
+        delete rep;
+}
+
+void BinaryDataEventReporter::close() {updRep().close();}
+
+int BinaryDataEventReporter::getNumFrames() const
+{   return (int)getRep().head.load(); }
+
+int BinaryDataEventReporter::getNumStalls() const
+{   return getRep().stalls.load(); }
+
+void BinaryDataEventReporter::handleEvent(const State& state) const {
+    updRep().handleEvent(state);
+}
+
+
+
+//==============================================================================
+//                          BINARY DATA READER REP
+//==============================================================================
+class BinaryDataReader::BinaryDataReaderRep {
+public:
+    explicit BinaryDataReaderRep(const String& pathname)
+    :   pathname(pathname), loadedChunk(-1) {
+        const char* where = "BinaryDataReader::BinaryDataReader()";
+        in.open(pathname.c_str(), std::ios::binary);
+        SimTK_ERRCHK1_ALWAYS(in.good(), where,
+            "Can't open file '%s'.", pathname.c_str());
+
+        in.seekg(0, std::ios::end);
+        const uint64_t fileSize = (uint64_t)in.tellg();
+        FileFooter footer;
+        bool ok = fileSize >= sizeof(FileHeader) + sizeof(FileFooter);
+        if (ok) {
+            in.seekg(0);
+            in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+            in.seekg(fileSize - sizeof(FileFooter));
+            in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+            ok = in.good()
+                && std::memcmp(hdr.magic, HeaderMagic, sizeof(HeaderMagic))==0
+                && std::memcmp(footer.magic,FooterMagic,sizeof(FooterMagic))==0
+                && hdr.formatVersion == FormatVersion
+                && hdr.byteOrder == ByteOrderMarker
+                && hdr.realSize == sizeof(Real)
+                && hdr.framesPerChunk >= 1
+                && footer.indexOffset + footer.numChunks*sizeof(ChunkEntry)
+                   + sizeof(FileFooter) == fileSize;
+        }
+        if (ok) {
+            index.resize((size_t)footer.numChunks);
+            in.seekg(footer.indexOffset);
+            if (!index.empty())
+                in.read(reinterpret_cast<char*>(index.data()),
+                        index.size()*sizeof(ChunkEntry));
+            ok = in.good();
+        }
+        // Check that the chunks are where they belong.
+        uint64_t expectedOffset = sizeof(FileHeader), frames = 0;
+        for (unsigned k=0; ok && k < index.size(); ++k) {
+            ok = index[k].offset == expectedOffset
+                && index[k].numFrames >= 1
+                && index[k].numFrames <= hdr.framesPerChunk;
+            firstFrame.push_back((int)frames);
+            frames += index[k].numFrames;
+            expectedOffset += index[k].numFrames*(1+hdr.numColumns)*sizeof(Real);
+        }
+        ok = ok && frames == footer.numFrames
+                && expectedOffset == footer.indexOffset;
+        SimTK_ERRCHK1_ALWAYS(ok, where, "File '%s' was not written completely "
+            "by a BinaryDataEventReporter on this kind of machine.",
+            pathname.c_str());
+        numFrames = (int)frames;
+    }
+
+    // Return the chunk containing a frame, reading it in if necessary.
+    int loadChunkForFrame(int frame) const {
+        SimTK_INDEXCHECK_ALWAYS(frame, numFrames, "BinaryDataReader");
+        const int k = int(std::upper_bound(firstFrame.begin(),
+                                           firstFrame.end(), frame)
+                          - firstFrame.begin()) - 1;
+        loadChunk(k);
+        return k;
+    }
+
+    void loadChunk(int k) const {
+        if (k == loadedChunk) return;
+        const ChunkEntry& entry = index[k];
+        chunk.resize((size_t)entry.numFrames*(1+hdr.numColumns));
+        in.seekg(entry.offset);
+        in.read(reinterpret_cast<char*>(chunk.data()),
+                chunk.size()*sizeof(Real));
+        SimTK_ERRCHK1_ALWAYS(in.good(), "BinaryDataReader",
+            "Failed reading file '%s'.", pathname.c_str());
+        loadedChunk = k;
+    }
+
+    // Value of column c (0 is the time) of a frame in the loaded chunk.
+    Real getValue(int frame, int c) const {
+        const int n = (int)index[loadedChunk].numFrames;
+        return chunk[(size_t)c*n + (frame - firstFrame[loadedChunk])];
+    }
+
+    const String                pathname;
+    mutable std::ifstream       in;
+    FileHeader                  hdr;
+    std::vector<ChunkEntry>     index;
+    std::vector<int>            firstFrame;
+    int                         numFrames;
+
+    mutable std::vector<Real>   chunk;
+    mutable int                 loadedChunk;
+};
+
+
+
+//==============================================================================
+//                            BINARY DATA READER
+//==============================================================================
+BinaryDataReader::BinaryDataReader(const String& pathname)
+:   rep(new BinaryDataReaderRep(pathname)) {}
+
+BinaryDataReader::~BinaryDataReader() {delete rep;}
+
+int BinaryDataReader::getNumFrames() const {return rep->numFrames;}
+
+int BinaryDataReader::getNumColumns() const
+{   return (int)rep->hdr.numColumns; }
+
+Real BinaryDataReader::getTime(int frame) const {
+    rep->loadChunkForFrame(frame);
+    return rep->getValue(frame, 0);
+}
+
+Real BinaryDataReader::getFrame(int frame, Vector& values) const {
+    rep->loadChunkForFrame(frame);
+    const int n = getNumColumns();
+    values.resize(n);
+    for (int c=0; c < n; ++c)
+        values[c] = rep->getValue(frame, c+1);
+    return rep->getValue(frame, 0);
+}
+
+int BinaryDataReader::findFrame(Real time) const {
+    // Find the last chunk that starts no later than time, then search its
+    // frames.
+    const std::vector<ChunkEntry>& index = rep->index;
+    const auto chunk = std::upper_bound(index.begin(), index.end(), time,
+        [](Real t, const ChunkEntry& e) {return t < e.startTime;});
+    if (chunk == index.begin()) return -1;
+    const int k = int(chunk - index.begin()) - 1;
+    rep->loadChunk(k);
+    const int first = rep->firstFrame[k];
+    const Real* times = rep->chunk.data();
+    const int n = (int)index[k].numFrames;
+    return first + int(std::upper_bound(times, times+n, time) - times) - 1;
+}
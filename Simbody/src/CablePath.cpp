@@ -693,7 +693,6 @@ ensureVelocityKinematicsCalculated(const State& state) const {
     if (ppe.x.size()) {
         findKinematicVelocityErrors(state, instInfo, ppe, pve);
         ppe.JInv.solve(pve.nerrdotK, pve.xdot);
-        cout << "*** xdot=" << pve.xdot << endl;
     }
 
     //TODO: calc length dot
@@ -796,10 +795,25 @@ void CablePath::Impl::
 solveForPathPoints(const State& state, const PathInstanceInfo& instInfo, 
                    PathPosEntry& ppe) const 
 {
+    const Real ftol = Real(1e-12)*1000; // TODO
+    const Real minlam = Real(1e-6);
+
     const PathPosEntry& prevPPE = getPrevPosEntry(state);
-    if (prevPPE.x.size())
+    const PathVelEntry& prevPVE = getPrevVelEntry(state);
+    if (prevPPE.x.size()) {
         ppe.x = prevPPE.x; // start with previous solution if there is one
 
+        // If that was a solution for the same active surfaces, and we know
+        // how fast its contact points were moving, extrapolate to the 
+        // current time. A path that wasn't solved has a meaningless xdot.
+        const Real dt = state.getTime() - prevPPE.time;
+        if (prevPVE.xdot.size() == ppe.x.size() && isFinite(dt)
+            && prevPPE.mapToCoords == ppe.mapToCoords
+            && prevPPE.err.norm() <= 1000*ftol)
+            ppe.x += dt*prevPVE.xdot;
+    }
+    ppe.time = state.getTime();
+
     projectOntoSurface(instInfo,ppe); // clean up first
 
     calcPathError(state,instInfo,ppe);
@@ -807,44 +821,23 @@ solveForPathPoints(const State& state, const PathInstanceInfo& instInfo,
     if (ppe.x.size() == 0)
         return; // only via points; no iteration to do
 
-    const Real ftol = Real(1e-12)*1000; // TODO
-    const Real xtol = Real(1e-12)*1000;
-
-    const Real estimatedPathErrorAccuracy = ftol;
-    PathError pathErrorFnc(ppe.x.size(), *this, state, instInfo, ppe, 
-                           estimatedPathErrorAccuracy);
-    Differentiator diff(pathErrorFnc);
-
     Vector dx, xold, xchg;
 
     Real f = ppe.err.norm();
-    cout << "\n***PATH solveForPathPoints@t=" << state.getTime() 
-         << " err=" << f << "\n"; 
 
     Real fold, lam = 1, nextlam = 1;
     Real dxnormPrev = Infinity;
     int maxIter = 20;
     for (int i = 0; i < maxIter; ++i) {
         // We always need a Jacobian even if the path is already good enough
-        // because we use it to solve for xdot. So we might as well do one
-        // iteration.
-        if (i > 0 && f <= ftol) {
-            std::cout << "\n***PATH converged in " 
-                << i << " iterations err=" << f << "\n\n";
-            break;
-        }
-        //cout << "obstacle err = " << f << ", x = " << ppe.x << endl;
-
-        //diff.calcJacobian(ppe.x, ppe.err, ppe.J, 
-        //                  Differentiator::ForwardDifference);
-       // Matrix Jnum = ppe.J;
+        // because we use it to solve for xdot. Factoring it before checking
+        // for convergence means it is evaluated at the final x, and a good
+        // starting guess costs no further geodesics.
         calcPathErrorJacobian(state, instInfo, ppe);
-
-        //cout << "DIFF J=" << Jnum-ppe.J;
-        //cout << "DIFF NORM=" << (Jnum-ppe.J).norm() << "\n";
-
         ppe.JInv.factor(ppe.J);
-        //ppe.JInv.factor(Jnum);
+
+        if (f <= ftol)
+            break;
 
         fold = f;
         xold = ppe.x;
@@ -852,12 +845,8 @@ solveForPathPoints(const State& state, const PathInstanceInfo& instInfo,
         ppe.JInv.solve(ppe.err, dx);
 
         const Real dxnorm = std::sqrt(dx.normSqr()/ppe.x.size()); // rms
-        cout << "|dx| = " << dxnorm << endl;
-        if (dxnorm > Real(.99)*dxnormPrev) {
-           std::cout << "\nPATH stalled in " 
-                << i << " iterations err=" << f << " |dx|=" << dxnorm << "\n\n";
+        if (dxnorm > Real(.99)*dxnormPrev)
             break;
-        }
 
         // backtracking
         lam = nextlam;
@@ -870,12 +859,19 @@ solveForPathPoints(const State& state, const PathInstanceInfo& instInfo,
             f = ppe.err.norm();
             //cout << "step=" << lam << " obstacle err = " << f 
             //     << ", x = " << ppe.x << endl;
-            if (f <= fold)
+            if (f <= fold || lam < minlam)
                 break;
             lam = lam / 2;
         }
         //cout << "step size=" << lam << endl;
 
+        if (f > fold) {
+            // No descent along dx; go back to the previous point and stop.
+            ppe.x = xold;
+            calcPathError(state,instInfo,ppe);
+            break;
+        }
+
         if (lam == nextlam)
             nextlam = std::min(2*lam, Real(1));
 
@@ -1288,6 +1284,96 @@ calcPathErrorJacobian(const State&            state,
 
 }
 
+//==============================================================================
+//                          PATH JACOBIAN FACTOR
+//==============================================================================
+namespace {
+Mat66 getBlock(const Matrix& J, int row, int col) {
+    Mat66 block;
+    for (int i=0; i < 6; ++i)
+        for (int j=0; j < 6; ++j)
+            block(i,j) = J(row+i, col+j);
+    return block;
+}
+
+// Largest absolute column sum.
+Real norm1(const Mat66& m) {
+    Real biggest = 0;
+    for (int j=0; j < 6; ++j) {
+        Real sum = 0;
+        for (int i=0; i < 6; ++i) sum += std::abs(m(i,j));
+        biggest = std::max(biggest, sum);
+    }
+    return biggest;
+}
+}
+
+// Block forward elimination without pivoting between blocks. With Dk=J(k,k),
+// Lk=J(k,k-1) and Uk=J(k,k+1) the reduced diagonal blocks are
+//      P0 = D0,   Pk = Dk - Lk Pk-1^-1 Uk-1
+// and we keep Pk^-1 and Pk^-1 Uk for the solve. Without pivoting between
+// blocks an ill-conditioned Pk loses accuracy that a pivoting LU of all of J
+// would keep, so we give up on the first Pk that is singular or whose 1-norm
+// condition number exceeds 1/sqrt(eps).
+void PathJacobianFactor::factor(const Matrix& J) {
+    const Real MaxPivotCondition = 1/SqrtEps;
+    const int nx = J.nrow();
+    assert(J.ncol() == nx);
+    isBanded = (nx % 6 == 0);
+    if (isBanded) {
+        const int nb = nx / 6;
+        lower.resize(nb); pivotInverse.resize(nb); upperReduced.resize(nb);
+        try {
+            for (int k=0; k < nb; ++k) {
+                Mat66 pivot = getBlock(J, 6*k, 6*k);
+                if (k > 0) {
+                    lower[k] = getBlock(J, 6*k, 6*(k-1));
+                    pivot -= lower[k]*upperReduced[k-1];
+                }
+                pivotInverse[k] = lapackInverse(pivot); // throws if singular
+                if (!(norm1(pivot)*norm1(pivotInverse[k]) 
+                      <= MaxPivotCondition)) {
+                    isBanded = false;
+                    break;
+                }
+                if (k < nb-1)
+                    upperReduced[k] = 
+                        pivotInverse[k]*getBlock(J, 6*k, 6*(k+1));
+            }
+        } catch (const std::exception&) {
+            isBanded = false;
+        }
+    }
+    if (!isBanded)
+        dense.factor(J);
+}
+
+// Forward substitution gk = Pk^-1 (bk - Lk gk-1), then back substitution
+// xk = gk - Pk^-1 Uk xk+1.
+void PathJacobianFactor::solve(const Vector& b, Vector& x) const {
+    if (!isBanded) {
+        dense.solve(b, x);
+        return;
+    }
+    const int nb = pivotInverse.size();
+    assert(b.size() == 6*nb);
+    Array_<Vec6> g(nb);
+    for (int k=0; k < nb; ++k) {
+        Vec6 bk;
+        for (int i=0; i < 6; ++i) bk[i] = b[6*k+i];
+        if (k > 0) bk -= lower[k]*g[k-1];
+        g[k] = pivotInverse[k]*bk;
+    }
+    for (int k=nb-2; k >= 0; --k)
+        g[k] -= upperReduced[k]*g[k+1];
+
+    x.resize(6*nb);
+    for (int k=0; k < nb; ++k)
+        for (int i=0; i < 6; ++i) x[6*k+i] = g[k][i];
+}
+
+
+
 //==============================================================================
 //                             CABLE OBSTACLE
 //==============================================================================
@@ -1438,16 +1524,6 @@ Vec6 CableObstacle::Surface::Impl::calcSurfacePathError
     // If length is very short, or geodesic is backwards, use path binormals
     // rather than geodesic binormals.
     const Real ShortLength = Real(1e-3);
-    if (length <= ShortLength)
-        cout << "==> Using short formulation for length=" << length << endl;
-    if (signP < 0 || signQ < 0) { 
-        cout << "==> Backwards geodesic with length=" << length 
-             << " eIn*tP=" << ~eIn*tP << " eOut*tQ=" << ~eOut*tQ << endl;
-        if (signP != signQ) {
-            cout <<"    Mismatch eIn="<<eIn << " eOut="<<eOut<<endl;
-            cout <<"             tP=" <<tP << " tQ="<<tQ<<endl;
-        }
-    }
 
     const Vec3 bbarP = length<=ShortLength ? eOut % nP : Vec3(bP);
     const Vec3 bbarQ = length<=ShortLength ? eIn  % nQ : Vec3(bQ);
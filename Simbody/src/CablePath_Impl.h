@@ -86,6 +86,38 @@ public:
 };
 
 
+// This is the factorization of the path error Jacobian J=D patherr/Dx used
+// for the Newton update and for xdot. Each active surface contributes six
+// unknowns (P and Q) and six errors, and its errors depend only on its own
+// unknowns, on Q of the preceding surface, and on P of the following one. So
+// when all the active surfaces are implicit J is block tridiagonal in 6x6
+// blocks and we factor it one block row at a time with no fill-in. That
+// doesn't pivot between blocks, so if a reduced diagonal block turns out to
+// be singular or badly conditioned, or the surfaces don't have 3 coordinates
+// per point, we fall back to a dense LU factorization of J.
+class PathJacobianFactor {
+public:
+    PathJacobianFactor() : isBanded(false) {}
+
+    void factor(const Matrix& J);
+
+    // Solve J x = b using the most recent factorization.
+    void solve(const Vector& b, Vector& x) const;
+
+    // Whether the most recent factorization used block elimination rather
+    // than the dense LU.
+    bool isBlockFactored() const {return isBanded;}
+
+private:
+    bool            isBanded;
+    // One entry per active surface when banded; lower[0] is unused.
+    Array_<Mat66>   lower;          // J(k,k-1)
+    Array_<Mat66>   pivotInverse;   // inverse of reduced J(k,k)
+    Array_<Mat66>   upperReduced;   // pivotInverse[k]*J(k,k+1)
+    FactorLU        dense;          // used only when !isBanded
+};
+
+
 // This is a cache entry for holding a path's calculated position-level 
 // information. At the time it is created we know the total number of
 // obstacles n (including the end points), but not which ones are active. We 
@@ -104,7 +136,7 @@ public:
 // quantities.
 class PathPosEntry {
 public:
-    PathPosEntry() : length(NaN) {}
+    PathPosEntry() : time(NaN), length(NaN) {}
 
     // Set the number of obstacles to n. If there is any information already
     // in this object, it is lost.
@@ -120,6 +152,7 @@ public:
 
     // mapToActive, mapToActiveSurface and mapToCoords are already allocated.
     void initialize(int na, int nas, int nx) {
+        time = NaN;
         length = NaN;
         // Active obstacles
         eIn_G.clear(); eIn_G.resize(na); // all NaN
@@ -150,6 +183,10 @@ public:
         return CableObstacleIndex();
     }
 
+    // The time at which the contact point coordinates x were solved for,
+    // used to extrapolate a starting guess for the next solve.
+    Real time;
+
     // This is the total length of the path corresponding to the current
     // configuration and values for contact point coordinates x stored here.
     Real length;
@@ -209,11 +246,10 @@ public:
     // This is the patherr corresponding to x and is always the same length.
     Vector      err;    // patherr (nx of these)
 
-    // This is J(x) where J=partial(patherr)/partial(x), and its LU 
+    // This is J(x) where J=partial(patherr)/partial(x), and its 
     // factorization for use in solving for length dot at Velocity stage.
-    // TODO: this is banded but we're treating it as full.
-    Matrix      J;      // nx X nx
-    FactorLU    JInv;
+    Matrix              J;      // nx X nx
+    PathJacobianFactor  JInv;
 };
 
 
@@ -69,6 +69,26 @@ CablePathIndex adoptCablePath(CablePath& path) {
     return CablePathIndex(cablePaths.size()-1);
 }
 
+void setNumberOfThreads(int numThreads) 
+{   m_threads.setNumberOfThreads(numThreads, "CableTrackerSubsystem"); }
+int getNumberOfThreads() const {return m_threads.getNumberOfThreads();}
+
+// Call the given realize method of every cable path, concurrently if we
+// have threads to use. The paths don't share any state or geometry so they
+// can be realized concurrently.
+typedef void (CablePath::Impl::*RealizeFunc)(const State&) const;
+void realizeCablePaths(const State& state, RealizeFunc realize) const {
+    ParallelExecutor* executor = m_threads.getExecutor();
+    if (!executor || cablePaths.size() < 2) {
+        for (CablePathIndex ix(0); ix < cablePaths.size(); ++ix)
+            (getCablePath(ix).getImpl().*realize)(state);
+        return;
+    }
+    executor->execute([&](int index) {
+        (getCablePath(CablePathIndex(index)).getImpl().*realize)(state);
+    }, cablePaths.size());
+}
+
 // Return the MultibodySystem which owns this CableTrackerSubsystem.
 const MultibodySystem& getMultibodySystem() const 
 {   return MultibodySystem::downcast(getSystem()); }
@@ -125,18 +145,12 @@ int realizeSubsystemInstanceImpl(const State& state) const override {
 }
 
 int realizeSubsystemPositionImpl(const State& state) const override {
-    for (CablePathIndex ix(0); ix < cablePaths.size(); ++ix) {
-        const CablePath& path = getCablePath(ix);
-        path.getImpl().realizePosition(state);
-    }
+    realizeCablePaths(state, &CablePath::Impl::realizePosition);
     return 0;
 }
 
 int realizeSubsystemVelocityImpl(const State& state) const override {
-    for (CablePathIndex ix(0); ix < cablePaths.size(); ++ix) {
-        const CablePath& path = getCablePath(ix);
-        path.getImpl().realizeVelocity(state);
-    }
+    realizeCablePaths(state, &CablePath::Impl::realizeVelocity);
     return 0;
 }
 
@@ -260,6 +274,8 @@ SimTK_DOWNCAST(Impl, Subsystem::Guts);
 private:
 // TOPOLOGY STATE
 Array_<CablePath, CablePathIndex> cablePaths;
+
+ParallelExecutorOption            m_threads;
 };
 
 } // namespace SimTK
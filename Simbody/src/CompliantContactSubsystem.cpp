@@ -36,6 +36,8 @@ patch analysis methods.
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 #include "simbody/internal/MultibodySystem.h"
 
+#include "ForceStiffness.h"
+
 namespace SimTK {
 
 //==============================================================================
@@ -303,6 +305,9 @@ Real calcPotentialEnergy(const State& state) const override {
     return getPotentialEnergyCache(state);
 }
 
+void addInStiffnessAndDamping(const State& state, 
+                              Matrix& K, Matrix& D) const override;
+
 int realizeSubsystemAccelerationImpl(const State& state) const override {
     if (!m_trackDissipatedEnergy)
         return 0; // nothing to do here in that case
@@ -490,6 +495,95 @@ ensureForceCacheValid(const State& state) const {
 }
 
 
+// A contact generator reports how its force changes with penetration depth if
+// it can; that is applied as a point spring at the contact point, stretched 
+// as surface 2 moves along the normal (reducing the depth). The dependence of
+// the force on the relative velocity of the surfaces, from dissipation and
+// friction, is found by differencing the generator's force with the contact
+// geometry held fixed, which is cheap because nothing has to be realized.
+void CompliantContactSubsystemImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const ContactSnapshot& active = m_tracker.getActiveContacts(state);
+    const int nContacts = active.getNumContacts();
+    for (int i=0; i<nContacts; ++i) {
+        const Contact& contact = active.getContact(i);
+        if (contact.getCondition() == Contact::Broken)
+            continue;
+        const ContactSurfaceIndex surf1(contact.getSurface1());
+        const ContactSurfaceIndex surf2(contact.getSurface2());
+        const MobilizedBody& mobod1 = m_tracker.getMobilizedBody(surf1);
+        const MobilizedBody& mobod2 = m_tracker.getMobilizedBody(surf2);
+        const SimbodyMatterSubsystem& matter = mobod1.getMatterSubsystem();
+        const Transform& X_B2S2 = m_tracker.getContactSurfaceTransform(surf2);
+
+        const Transform X_GS1 = mobod1.findFrameTransformInGround
+            (state, m_tracker.getContactSurfaceTransform(surf1));
+        const Transform X_GS2 = mobod2.findFrameTransformInGround
+            (state, X_B2S2);
+        const SpatialVec V_GS1 = mobod1.findFrameVelocityInGround
+            (state, m_tracker.getContactSurfaceTransform(surf1));
+        const SpatialVec V_GS2 = mobod2.findFrameVelocityInGround
+            (state, X_B2S2);
+        const SpatialVec V_S1S2 =
+            findRelativeVelocity(X_GS1, V_GS1, X_GS2, V_GS2);
+
+        const ContactForceGenerator& generator = 
+            getForceGenerator(contact.getTypeId());
+        ContactForce force_S1;
+        generator.calcContactForce(state, contact, V_S1S2, force_S1);
+        if (!force_S1.isValid())
+            continue;
+
+        const Rotation& R_GS1 = X_GS1.R();
+        const Vec3 contactPt_G = X_GS1*force_S1.getContactPoint();
+        UnitVec3 normal_S1; Vec3 dFdDepth_S1;
+        if (generator.calcForceDepthDerivative(state, contact, force_S1, 
+                                               normal_S1, dFdDepth_S1)) {
+            const Vec3 n_G = R_GS1*normal_S1;
+            const Vec3 dFdDepth_G = R_GS1*dFdDepth_S1;
+            addInPointForceStiffnessAndDamping(matter, state,
+                mobod1.getMobilizedBodyIndex(), 
+                mobod1.findStationAtGroundPoint(state, contactPt_G),
+                mobod2.getMobilizedBodyIndex(),
+                mobod2.findStationAtGroundPoint(state, contactPt_G),
+                -dFdDepth_G*~n_G, Mat33(0), K, D);
+        }
+
+        // The generator's velocity V_S1S2 is that of frame S2 relative to
+        // the coincident frame on S1, so we work with the force shifted to 
+        // S2's origin.
+        const Vec3& p12 = contact.getTransform().p();
+        const auto forceAtO2 = [&p12](const ContactForce& f) {
+            if (!f.isValid()) return SpatialVec(Vec3(0));
+            const SpatialVec& F = f.getForceOnSurface2();
+            return SpatialVec(F[0] + (f.getContactPoint()-p12) % F[1], F[1]);
+        };
+        const SpatialVec F0 = forceAtO2(force_S1);
+        Mat66 dFdv_S1;
+        for (int j=0; j < 6; ++j) {
+            SpatialVec V = V_S1S2;
+            Real& vj = V[j/3][j%3];
+            const Real h = SqrtEps*std::max(Real(1), std::abs(vj));
+            vj += h;
+            ContactForce perturbed;
+            generator.calcContactForce(state, contact, V, perturbed);
+            const SpatialVec dF = (forceAtO2(perturbed) - F0)/h;
+            for (int r=0; r < 3; ++r) {
+                dFdv_S1(r,j)   = dF[0][r];
+                dFdv_S1(3+r,j) = dF[1][r];
+            }
+        }
+        Mat66 R(0);
+        R.updSubMat<3,3>(0,0) = R.updSubMat<3,3>(3,3) = R_GS1.asMat33();
+        addInFrameForceStiffnessAndDamping(matter, state,
+            mobod1.getMobilizedBodyIndex(), 
+            mobod1.findStationAtGroundPoint(state, X_GS2.p()),
+            mobod2.getMobilizedBodyIndex(), X_B2S2.p(),
+            Mat66(0), R*dFdv_S1*~R, K, D);
+    }
+}
+
+
 //==============================================================================
 //                      COMPLIANT CONTACT SUBSYSTEM
 //==============================================================================
@@ -873,6 +967,21 @@ static void calcHertzContactForce
 }
 
 
+// Both Hertz force laws produce a normal force fH*(1+1.5c*xdot) with fH
+// proportional to depth^(3/2), and friction proportional to the normal force,
+// so the whole force F grows with depth as 1.5*F/depth.
+static bool calcHertzForceDepthDerivative
+   (Real depth, const UnitVec3& normal_S1, const ContactForce& contactForce_S1,
+    Vec3& dFdDepth_S1)
+{
+    if (depth <= 0) return false;
+    const Vec3& F = contactForce_S1.getForceOnSurface2()[1];
+    if (dot(F, normal_S1) <= 0) return false;
+    dFdDepth_S1 = (Real(1.5)/depth)*F;
+    return true;
+}
+
+
 //==============================================================================
 //                         HERTZ CIRCULAR GENERATOR
 //==============================================================================
@@ -905,6 +1014,19 @@ void ContactForceGenerator::HertzCircular::calcContactForce
                           V_S1S2, R, 1, contactForce_S1, 0);
 }
 
+bool ContactForceGenerator::HertzCircular::calcForceDepthDerivative
+   (const State&            state,
+    const Contact&          overlap,
+    const ContactForce&     contactForce_S1,
+    UnitVec3&               normal_S1,
+    Vec3&                   dFdDepth_S1) const
+{
+    const CircularPointContact& contact = CircularPointContact::getAs(overlap);
+    normal_S1 = contact.getNormal();
+    return calcHertzForceDepthDerivative(contact.getDepth(), normal_S1,
+                                         contactForce_S1, dFdDepth_S1);
+}
+
 void ContactForceGenerator::HertzCircular::calcContactPatch
    (const State&      state,
     const Contact&    overlap,
@@ -1143,6 +1265,20 @@ void ContactForceGenerator::HertzElliptical::calcContactForce
                           V_S1S2, R, e, contactForce_S1, 0);
 }
 
+bool ContactForceGenerator::HertzElliptical::calcForceDepthDerivative
+   (const State&            state,
+    const Contact&          overlap,
+    const ContactForce&     contactForce_S1,
+    UnitVec3&               normal_S1,
+    Vec3&                   dFdDepth_S1) const
+{
+    const EllipticalPointContact& contact = 
+        EllipticalPointContact::getAs(overlap);
+    normal_S1 = contact.getContactFrame().z();
+    return calcHertzForceDepthDerivative(contact.getDepth(), normal_S1,
+                                         contactForce_S1, dFdDepth_S1);
+}
+
 
 void ContactForceGenerator::HertzElliptical::calcContactPatch
    (const State&      state,
@@ -0,0 +1,501 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ContactBroadPhase.h"
+
+#include <algorithm>
+#include <iostream>
+
+using std::pair; using std::make_pair;
+
+namespace SimTK {
+
+namespace {
+
+// Don't bother splitting the pair search among threads for fewer surfaces
+// than this per thread.
+const int MinSurfacesPerChunk = 128;
+
+// A leaf's box is fattened by this fraction of its sphere's radius, so that a
+// surface can move about that far before the tree has to be touched.
+const Real FatMarginFraction = Real(0.25);
+
+bool spheresTouch(const Vec3& c1, Real r1, const Vec3& c2, Real r2)
+{   return (c1-c2).normSqr() <= square(r1+r2); }
+
+// The axis along which the sphere centers are most spread out.
+int findAxisOfGreatestSpread(const Array_<Vec3>& centers) {
+    const int n = (int)centers.size();
+    Vec3 average(0);
+    for (int i=0; i < n; ++i) average += centers[i];
+    average /= n;
+    Vec3 var(0);
+    for (int i=0; i < n; ++i)
+        var += abs(centers[i]-average);
+    int axis = (var[0] > var[1] ? 0 : 1);
+    if (var[2] > var[axis])
+        axis = 2;
+    return axis;
+}
+
+// Concatenate the per-chunk pair lists in chunk order.
+void gatherPairs(const Array_<Array_<pair<int,int> > >& perChunk,
+                 Array_<pair<int,int> >& pairs) {
+    pairs.clear();
+    for (const auto& chunkPairs : perChunk)
+        pairs.insert(pairs.end(), chunkPairs.begin(), chunkPairs.end());
+}
+
+int numChunksFor(ParallelExecutor* executor, int n) {
+    if (!executor || executor->getMaxThreads() < 2)
+        return 1;
+    return std::max(1, std::min(4*executor->getMaxThreads(),
+                                n/MinSurfacesPerChunk));
+}
+
+// Call body(chunk) for each chunk in [0,nChunks), on the executor's threads
+// unless there is only one chunk.
+void forEachChunkIndex(ParallelExecutor* executor, int nChunks,
+                       const std::function<void(int)>& body) {
+    if (nChunks == 1) body(0);
+    else executor->execute(body, nChunks);
+}
+
+Vec3 minOf(const Vec3& a, const Vec3& b) {
+    return Vec3(std::min(a[0],b[0]), std::min(a[1],b[1]), std::min(a[2],b[2]));
+}
+Vec3 maxOf(const Vec3& a, const Vec3& b) {
+    return Vec3(std::max(a[0],b[0]), std::max(a[1],b[1]), std::max(a[2],b[2]));
+}
+
+// Half the surface area of a box; enough for comparing costs.
+Real boxArea(const Vec3& lo, const Vec3& hi) {
+    const Vec3 d = hi - lo;
+    return d[0]*d[1] + d[1]*d[2] + d[2]*d[0];
+}
+
+// Twice the midpoint of a box along an axis, used for ordering leaves. An
+// unbounded box (e.g. a half space) has no midpoint; call it the origin so
+// that the comparisons remain a strict weak ordering.
+Real boxMiddleTimes2(const Vec3& lo, const Vec3& hi, int axis) {
+    const Real m = lo[axis] + hi[axis];
+    return isNaN(m) ? Real(0) : m;
+}
+
+bool boxesOverlap(const Vec3& lo1, const Vec3& hi1,
+                  const Vec3& lo2, const Vec3& hi2) {
+    return lo1[0] <= hi2[0] && lo2[0] <= hi1[0]
+        && lo1[1] <= hi2[1] && lo2[1] <= hi1[1]
+        && lo1[2] <= hi2[2] && lo2[2] <= hi1[2];
+}
+
+}
+
+void ContactBroadPhase::
+findOverlappingPairs(const Array_<Vec3>& centers, const Array_<Real>& radii,
+                     ParallelExecutor* executor,
+                     Array_<pair<int,int> >& pairs) {
+    assert(centers.size() == radii.size());
+    pairs.clear();
+    if (centers.size() < 2)
+        return;
+    switch (method) {
+    case SingleAxisSweep:
+        sweepSingleAxis(centers, radii, executor, pairs); break;
+    case MultiAxisSweep:
+        sweepMultiAxis(centers, radii, executor, pairs); break;
+    case DynamicAABBTree:
+        queryTree(centers, radii, executor, pairs); break;
+    }
+}
+
+//------------------------------------------------------------------------------
+//                              SINGLE AXIS SWEEP
+//------------------------------------------------------------------------------
+// This is the original sweep-and-prune from the contact subsystems.
+namespace {
+class Extent {
+public:
+    Extent(Real start, Real end, int index)
+    :   start(start), end(end), index(index) {}
+    Extent() {}
+    bool operator<(const Extent& e) const
+    {   return start < e.start; }
+    Real start, end; // span along chosen sort axis
+    int  index;
+};
+}
+
+void ContactBroadPhase::
+sweepSingleAxis(const Array_<Vec3>& centers, const Array_<Real>& radii,
+                ParallelExecutor* executor,
+                Array_<pair<int,int> >& pairs) const {
+    const int n = (int)centers.size();
+    const int axis = findAxisOfGreatestSpread(centers);
+
+    // Find the extent of each sphere along the axis and sort them by
+    // starting location. Expensive: O(n log n)
+    Array_<Extent> extents(n);
+    for (int i=0; i < n; ++i)
+        extents[i] = Extent(centers[i][axis]-radii[i],
+                            centers[i][axis]+radii[i], i);
+    std::sort(extents.begin(), extents.end());
+
+    // Now sweep along the axis, finding potential contacts.
+    const int nChunks = numChunksFor(executor, n);
+    Array_<Array_<pair<int,int> > > perChunk(nChunks);
+    forEachChunkIndex(executor, nChunks, [&](int chunk) {
+        Array_<pair<int,int> >& found = perChunk[chunk];
+        const int end = (int)((long long)n*(chunk+1)/nChunks);
+        for (int e1 = (int)((long long)n*chunk/nChunks); e1 < end; ++e1) {
+            const Extent& extent1 = extents[e1];
+            const int i = extent1.index;
+            for (int e2 = e1+1;
+                 e2 < n && extents[e2].start <= extent1.end; ++e2) {
+                const int j = extents[e2].index;
+                if (spheresTouch(centers[i],radii[i],centers[j],radii[j]))
+                    found.push_back(make_pair(i,j));
+            }
+        }
+    });
+    gatherPairs(perChunk, pairs);
+}
+
+//------------------------------------------------------------------------------
+//                              MULTI AXIS SWEEP
+//------------------------------------------------------------------------------
+void ContactBroadPhase::
+sweepMultiAxis(const Array_<Vec3>& centers, const Array_<Real>& radii,
+               ParallelExecutor* executor,
+               Array_<pair<int,int> >& pairs) {
+    const int n = (int)centers.size();
+
+    // Sweep along the axis of greatest spread, using the order from the
+    // last call if it was along the same axis. That order is nearly sorted
+    // already, so insertion sort brings it up to date in close to linear
+    // time; otherwise we sort from scratch.
+    const int axis = findAxisOfGreatestSpread(centers);
+    const int other1 = (axis+1)%3, other2 = (axis+2)%3;
+    Array_<int>& ord = order;
+    if ((int)ord.size() != n || orderAxis != axis) {
+        ord.resize(n);
+        for (int i=0; i < n; ++i) ord[i] = i;
+        std::sort(ord.begin(), ord.end(), [&](int a, int b) {
+            return centers[a][axis]-radii[a] < centers[b][axis]-radii[b];
+        });
+        orderAxis = axis;
+    } else {
+        for (int k=1; k < n; ++k) {
+            const int  moving = ord[k];
+            const Real start  = centers[moving][axis] - radii[moving];
+            int m = k;
+            for (; m > 0 && centers[ord[m-1]][axis]-radii[ord[m-1]] > start;
+                 --m)
+                ord[m] = ord[m-1];
+            ord[m] = moving;
+        }
+    }
+
+    const int nChunks = numChunksFor(executor, n);
+    Array_<Array_<pair<int,int> > > perChunk(nChunks);
+    forEachChunkIndex(executor, nChunks, [&](int chunk) {
+        Array_<pair<int,int> >& found = perChunk[chunk];
+        const int end = (int)((long long)n*(chunk+1)/nChunks);
+        for (int k1 = (int)((long long)n*chunk/nChunks); k1 < end; ++k1) {
+            const int   i    = ord[k1];
+            const Vec3& ci   = centers[i];
+            const Real  ri   = radii[i];
+            const Real  endi = ci[axis] + ri;
+            for (int k2 = k1+1; k2 < n; ++k2) {
+                const int   j  = ord[k2];
+                const Vec3& cj = centers[j];
+                const Real  rj = radii[j];
+                if (cj[axis]-rj > endi)
+                    break; // nothing further along can overlap i
+                const Real rsum = ri + rj;
+                if (std::abs(ci[other1]-cj[other1]) > rsum
+                    || std::abs(ci[other2]-cj[other2]) > rsum
+                    || !spheresTouch(ci, ri, cj, rj))
+                    continue;
+                found.push_back(i < j ? make_pair(i,j) : make_pair(j,i));
+            }
+        }
+    });
+    gatherPairs(perChunk, pairs);
+    std::sort(pairs.begin(), pairs.end());
+}
+
+//------------------------------------------------------------------------------
+//                              DYNAMIC AABB TREE
+//------------------------------------------------------------------------------
+int ContactBroadPhase::allocateNode() {
+    if (freeList < 0) {
+        nodes.push_back();
+        return (int)nodes.size() - 1;
+    }
+    const int node = freeList;
+    freeList = nodes[node].parent;
+    return node;
+}
+
+void ContactBroadPhase::freeNode(int node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+void ContactBroadPhase::setFatBox(int leaf, const Vec3& center, Real radius) {
+    const Vec3 half(radius*(1+FatMarginFraction));
+    nodes[leaf].lo = center - half;
+    nodes[leaf].hi = center + half;
+}
+
+// Recompute boxes and heights from `node` up to the root.
+void ContactBroadPhase::refitUpward(int node) {
+    while (node >= 0) {
+        Node& nd = nodes[node];
+        const Node& c1 = nodes[nd.child1];
+        const Node& c2 = nodes[nd.child2];
+        nd.lo = minOf(c1.lo, c2.lo);
+        nd.hi = maxOf(c1.hi, c2.hi);
+        nd.height = 1 + std::max(c1.height, c2.height);
+        node = nd.parent;
+    }
+}
+
+// Insert the leaf next to the sibling that increases the total box area the
+// least (the usual surface area heuristic).
+void ContactBroadPhase::insertLeaf(int leaf) {
+    if (root < 0) {
+        root = leaf;
+        nodes[leaf].parent = -1;
+        return;
+    }
+
+    const Vec3 lo = nodes[leaf].lo, hi = nodes[leaf].hi;
+    int sibling = root;
+    while (!nodes[sibling].isLeaf()) {
+        const Node& nd = nodes[sibling];
+        const Real area = boxArea(nd.lo, nd.hi);
+        const Real combinedArea =
+            boxArea(minOf(nd.lo, lo), maxOf(nd.hi, hi));
+        // Cost of making a new parent for this node and the leaf, and the
+        // minimum extra cost of pushing the leaf further down.
+        const Real cost = 2*combinedArea;
+        const Real inheritanceCost = 2*(combinedArea - area);
+
+        Real childCost[2];
+        const int children[2] = {nd.child1, nd.child2};
+        for (int c=0; c < 2; ++c) {
+            const Node& child = nodes[children[c]];
+            const Real enlarged =
+                boxArea(minOf(child.lo, lo), maxOf(child.hi, hi));
+            childCost[c] = inheritanceCost + (child.isLeaf()
+                ? enlarged : enlarged - boxArea(child.lo, child.hi));
+        }
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        sibling = childCost[0] <= childCost[1] ? children[0] : children[1];
+    }
+
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocateNode(); // may move the nodes array
+    Node& np = nodes[newParent];
+    np.parent = oldParent;
+    np.child1 = sibling;
+    np.child2 = leaf;
+    np.object = -1;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+    if (oldParent < 0)
+        root = newParent;
+    else if (nodes[oldParent].child1 == sibling)
+        nodes[oldParent].child1 = newParent;
+    else
+        nodes[oldParent].child2 = newParent;
+    refitUpward(newParent);
+}
+
+void ContactBroadPhase::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+    const int parent = nodes[leaf].parent;
+    const int grandParent = nodes[parent].parent;
+    const int sibling = nodes[parent].child1 == leaf
+                        ? nodes[parent].child2 : nodes[parent].child1;
+    if (grandParent < 0) {
+        root = sibling;
+        nodes[sibling].parent = -1;
+    } else {
+        if (nodes[grandParent].child1 == parent)
+            nodes[grandParent].child1 = sibling;
+        else
+            nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        refitUpward(grandParent);
+    }
+    freeNode(parent);
+}
+
+// Build a balanced subtree over the given leaves by splitting at the median
+// along the longest axis of their centers' bounding box.
+int ContactBroadPhase::buildSubtree(int* leaves, int count) {
+    if (count == 1)
+        return leaves[0];
+
+    Vec3 lo(Infinity), hi(-Infinity);
+    for (int k=0; k < count; ++k) {
+        const Node& leaf = nodes[leaves[k]];
+        const Vec3 center(boxMiddleTimes2(leaf.lo, leaf.hi, 0),
+                          boxMiddleTimes2(leaf.lo, leaf.hi, 1),
+                          boxMiddleTimes2(leaf.lo, leaf.hi, 2));
+        lo = minOf(lo, center);
+        hi = maxOf(hi, center);
+    }
+    const Vec3 size = hi - lo;
+    int axis = size[0] > size[1] ? 0 : 1;
+    if (size[2] > size[axis]) axis = 2;
+
+    const int half = count/2;
+    std::nth_element(leaves, leaves+half, leaves+count, [&](int a, int b) {
+        return boxMiddleTimes2(nodes[a].lo, nodes[a].hi, axis)
+             < boxMiddleTimes2(nodes[b].lo, nodes[b].hi, axis);
+    });
+    const int child1 = buildSubtree(leaves, half);
+    const int child2 = buildSubtree(leaves+half, count-half);
+    const int node = allocateNode();
+    Node& nd = nodes[node];
+    nd.parent = -1;
+    nd.child1 = child1;
+    nd.child2 = child2;
+    nd.object = -1;
+    nodes[child1].parent = node;
+    nodes[child2].parent = node;
+    nd.lo = minOf(nodes[child1].lo, nodes[child2].lo);
+    nd.hi = maxOf(nodes[child1].hi, nodes[child2].hi);
+    nd.height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+    return node;
+}
+
+void ContactBroadPhase::
+rebuildTree(const Array_<Vec3>& centers, const Array_<Real>& radii) {
+    const int n = (int)centers.size();
+    nodes.clear();
+    freeList = -1;
+    leafOfObject.resize(n);
+    nodes.reserve(2*n);
+    for (int i=0; i < n; ++i) {
+        const int leaf = allocateNode();
+        Node& nd = nodes[leaf];
+        nd.parent = -1;
+        nd.child1 = nd.child2 = -1;
+        nd.height = 0;
+        nd.object = i;
+        setFatBox(leaf, centers[i], radii[i]);
+        leafOfObject[i] = leaf;
+    }
+    Array_<int> leaves(leafOfObject);
+    root = n ? buildSubtree(leaves.begin(), n) : -1;
+}
+
+void ContactBroadPhase::
+updateTree(const Array_<Vec3>& centers, const Array_<Real>& radii) {
+    const int n = (int)centers.size();
+    if ((int)leafOfObject.size() != n) {
+        rebuildTree(centers, radii);
+        return;
+    }
+
+    // Reinsert only the leaves whose sphere has left its fat box.
+    for (int i=0; i < n; ++i) {
+        const int   leaf = leafOfObject[i];
+        const Vec3& c = centers[i];
+        const Real  r = radii[i];
+        const Node& nd = nodes[leaf];
+        bool inside = true;
+        for (int k=0; k < 3 && inside; ++k)
+            inside = nd.lo[k] <= c[k]-r && c[k]+r <= nd.hi[k];
+        if (inside)
+            continue;
+        removeLeaf(leaf);
+        setFatBox(leaf, c, r);
+        insertLeaf(leaf);
+    }
+
+    // Insertion alone doesn't keep the tree balanced; start over if it has
+    // become much deeper than a balanced one would be.
+    int balancedHeight = 0;
+    while ((1 << balancedHeight) < n) ++balancedHeight;
+    if (nodes[root].height > 2*balancedHeight + 4)
+        rebuildTree(centers, radii);
+}
+
+void ContactBroadPhase::
+queryTree(const Array_<Vec3>& centers, const Array_<Real>& radii,
+          ParallelExecutor* executor,
+          Array_<pair<int,int> >& pairs) {
+    updateTree(centers, radii);
+
+    const int n = (int)centers.size();
+    const int nChunks = numChunksFor(executor, n);
+    Array_<Array_<pair<int,int> > > perChunk(nChunks);
+    forEachChunkIndex(executor, nChunks, [&](int chunk) {
+        Array_<pair<int,int> >& found = perChunk[chunk];
+        Array_<int> stack;
+        const int end = (int)((long long)n*(chunk+1)/nChunks);
+        for (int i = (int)((long long)n*chunk/nChunks); i < end; ++i) {
+            const Vec3& ci = centers[i];
+            const Real  ri = radii[i];
+            const Vec3  lo = ci - Vec3(ri), hi = ci + Vec3(ri);
+            const unsigned firstFound = found.size();
+            stack.clear();
+            stack.push_back(root);
+            while (!stack.empty()) {
+                const Node& nd = nodes[stack.back()];
+                stack.pop_back();
+                if (!boxesOverlap(lo, hi, nd.lo, nd.hi))
+                    continue;
+                if (!nd.isLeaf()) {
+                    stack.push_back(nd.child1);
+                    stack.push_back(nd.child2);
+                    continue;
+                }
+                const int j = nd.object;
+                if (j > i && spheresTouch(ci, ri, centers[j], radii[j]))
+                    found.push_back(make_pair(i,j));
+            }
+            std::sort(found.begin()+firstFound, found.end());
+        }
+    });
+    gatherPairs(perChunk, pairs);
+}
+
+std::ostream& operator<<(std::ostream& o, const ContactBroadPhase& bp) {
+    static const char* names[] =
+        {"SingleAxisSweep", "MultiAxisSweep", "DynamicAABBTree"};
+    return o << "ContactBroadPhase(" << names[bp.getMethod()] << ")";
+}
+
+} // namespace SimTK
@@ -0,0 +1,129 @@
+#ifndef SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
+#define SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include <functional>
+#include <iosfwd>
+#include <utility>
+
+namespace SimTK {
+
+/* This is the broad phase shared by ContactTrackerSubsystem and
+GeneralContactSubsystem. Given a bounding sphere for each contact surface,
+all expressed in the same frame, it finds every pair of spheres that touch.
+The subsystems then apply their own exclusion rules and run the narrow phase
+on the surviving pairs.
+
+An object of this class also holds whatever the chosen method keeps from one
+call to the next to exploit temporal coherence (the sort order for the
+multi-axis sweep, the tree for the AABB tree). The subsystems keep one in a
+State cache entry that survives position changes. That extra data is only an
+accelerator: the set of pairs found never depends on it. */
+class ContactBroadPhase {
+public:
+    // These must match the BroadPhase enums in ContactTrackerSubsystem and
+    // GeneralContactSubsystem.
+    enum Method {
+        // Sort bubble extents along the axis of greatest spread, then sweep.
+        // Nothing is kept between calls. Pairs are reported in sweep order,
+        // with the surface whose extent starts first listed first.
+        SingleAxisSweep = 0,
+        // Keep the extents sorted along the axis of greatest spread, repairing
+        // the order with an insertion sort on each call, and reject pairs
+        // whose centers are too far apart on the other two axes before doing
+        // the sphere test.
+        MultiAxisSweep  = 1,
+        // A dynamic bounding volume hierarchy of "fat" boxes that are only
+        // reinserted when the surface moves outside of them.
+        DynamicAABBTree = 2
+    };
+
+    explicit ContactBroadPhase(Method method = SingleAxisSweep)
+    :   method(method), orderAxis(-1), root(-1), freeList(-1) {}
+
+    Method getMethod() const {return method;}
+
+    /* Replace the contents of `pairs` with all (i,j) for which the spheres
+    i and j overlap. For MultiAxisSweep and DynamicAABBTree each pair has
+    i < j and the list is sorted; for SingleAxisSweep see above. If
+    `executor` is given and there are enough surfaces, the pair search is
+    split among its threads; the result is the same either way. */
+    void findOverlappingPairs(const Array_<Vec3>& centers,
+                              const Array_<Real>& radii,
+                              ParallelExecutor*   executor,
+                              Array_<std::pair<int,int> >& pairs);
+
+private:
+    struct Node {
+        Vec3 lo, hi;          // bounding box (fattened for leaves)
+        int  parent;
+        int  child1, child2;  // -1 for a leaf
+        int  height;          // 0 for a leaf
+        int  object;          // leaves only; the surface index
+
+        bool isLeaf() const {return child1 < 0;}
+    };
+
+    void sweepSingleAxis(const Array_<Vec3>& centers, const Array_<Real>& radii,
+                         ParallelExecutor* executor,
+                         Array_<std::pair<int,int> >& pairs) const;
+    void sweepMultiAxis(const Array_<Vec3>& centers, const Array_<Real>& radii,
+                        ParallelExecutor* executor,
+                        Array_<std::pair<int,int> >& pairs);
+    void queryTree(const Array_<Vec3>& centers, const Array_<Real>& radii,
+                   ParallelExecutor* executor,
+                   Array_<std::pair<int,int> >& pairs);
+
+    void updateTree(const Array_<Vec3>& centers, const Array_<Real>& radii);
+    void rebuildTree(const Array_<Vec3>& centers, const Array_<Real>& radii);
+    int  buildSubtree(int* leaves, int count);
+    int  allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    void refitUpward(int node);
+    void setFatBox(int leaf, const Vec3& center, Real radius);
+
+    Method                  method;
+
+    // MultiAxisSweep: the surfaces ordered by the start of their extent along
+    // orderAxis, as of the last call.
+    Array_<int>             order;
+    int                     orderAxis;
+
+    // DynamicAABBTree.
+    Array_<Node>            nodes;
+    Array_<int>             leafOfObject;
+    int                     root;
+    int                     freeList; // chained through Node::parent
+};
+
+std::ostream& operator<<(std::ostream& o, const ContactBroadPhase& bp);
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
@@ -27,6 +27,8 @@
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 #include "simbody/internal/ContactTrackerSubsystem.h"
 
+#include "ContactBroadPhase.h"
+
 #include <utility>
 using std::pair; using std::make_pair;
 #include <iostream>
@@ -67,21 +69,17 @@ static std::ostream& operator<<(std::ostream& o, const Bubble& bb) {
     return o;
 }
 
-// For spatial sorting of bubbles.
-class BubbleExtent {
-public:
-    BubbleExtent(Real start, Real end, BubbleIndex index) 
-    :   start(start), end(end), index(index) {}
-    BubbleExtent() {}
-    bool operator<(const BubbleExtent& e) const 
-    {   return start < e.start; }
-    Real        start, end; // span along chosen sort axis
-    BubbleIndex index;
+// A surface pair that needs to be handed to its ContactTracker, along with
+// what we need to turn the tracker's answer into the next contact status.
+struct PairToTrack {
+    ContactSurfaceIndex index1, index2;         // index1 < index2
+    const Contact*      prev;                   // null if untracked
+    ContactSurfaceIndex trackSurf1, trackSurf2; // in tracker's order
 };
-static std::ostream& operator<<(std::ostream& o, const BubbleExtent& bx) {
-    o << bx.index << ":(" << bx.start << "," << bx.end << ")";
-    return o;
-}
+
+// Don't split the narrow phase among threads for fewer pairs than this per
+// thread.
+const int MinPairsPerChunk = 16;
 
 typedef std::map< pair<ContactGeometryTypeId,ContactGeometryTypeId>,
                   pair<ContactTracker*,bool> > TrackerMap;
@@ -126,7 +124,8 @@ class ContactTrackerSubsystemImpl : public Subsystem::Guts {
 public:
 // Constructor registers a default set of Trackers to use with geometry
 // we know about. These can be overridden later.
-ContactTrackerSubsystemImpl() : m_defaultTracker(0) {
+ContactTrackerSubsystemImpl() 
+:   m_defaultTracker(0), m_broadPhase(ContactBroadPhase::SingleAxisSweep) {
     adoptContactTracker(new ContactTracker::HalfSpaceSphere());
     adoptContactTracker(new ContactTracker::SphereSphere());
     adoptContactTracker(new ContactTracker::HalfSpaceEllipsoid());
@@ -224,6 +223,11 @@ int realizeSubsystemTopologyImpl(State& state) const override {
     wThis->m_predictedContactsIx = allocateAutoUpdateDiscreteVariable
         (state, Stage::Dynamics, new Value<ContactSnapshot>(), 
          Stage::Acceleration);  // update depends on accelerations
+    // The broad phase keeps its coherence data here; it isn't a function of
+    // the current positions so it is never invalidated short of Topology.
+    wThis->m_broadPhaseIx = allocateCacheEntry
+        (state, Stage::Topology, 
+         new Value<ContactBroadPhase>(ContactBroadPhase(m_broadPhase)));
 
     const SimbodyMatterSubsystem& matter = getMatterSubsystem();
 
@@ -270,6 +274,17 @@ int realizeSubsystemPositionImpl(const State& state) const override {
     return 0;
 }
 
+void setBroadPhase(ContactTrackerSubsystem::BroadPhase broadPhase) {
+    invalidateSubsystemTopologyCache();
+    m_broadPhase = ContactBroadPhase::Method(broadPhase);
+}
+ContactTrackerSubsystem::BroadPhase getBroadPhase() const
+{   return ContactTrackerSubsystem::BroadPhase(m_broadPhase); }
+
+void setNumberOfThreads(int numThreads) 
+{   m_threads.setNumberOfThreads(numThreads, "ContactTrackerSubsystem"); }
+int getNumberOfThreads() const {return m_threads.getNumberOfThreads();}
+
 int realizeSubsystemVelocityImpl(const State& state) const override {
     return 0;
 }
@@ -278,81 +293,86 @@ int realizeSubsystemVelocityImpl(const State& state) const override {
 void addInBroadPhasePairs(const State& state, PairMap& pairs) const {
     const int numBubbles = getNumBubbles();
     
-    // Perform a sweep-and-prune on a single axis to identify potential 
-    // contacts. First, find which axis has the most variation in body 
-    // locations. That is the axis we will use.
-    // TODO: this one-axis method is not good enough in general
-    
-    Vector_<Vec3> centers(numBubbles);
+    Array_<Vec3> centers(numBubbles);
+    Array_<Real> radii(numBubbles);
     for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
         const Bubble&  bubb = m_bubbles[bbx];
         const Surface& surf = m_surfaces[bubb.surface];
         centers[bbx] = surf.mobod->getBodyTransform(state) 
                         * bubb.getCenter();
+        radii[bbx] = bubb.getRadius();
     }
-    Vec3 average = mean(centers);
-    Vec3 var(0);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx)
-        var += abs(centers[bbx]-average);
-    int axis = (var[0] > var[1] ? 0 : 1);
-    if (var[2] > var[axis])
-        axis = 2;
-    
-    // Find the extent of each bubble along the axis and sort them by 
-    // starting location.
-    Array_<BubbleExtent,int> extents(numBubbles);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
-        const Real radius = m_bubbles[bbx].getRadius();
-        const Real center = centers[bbx][axis];
-        extents[bbx] = BubbleExtent(center-radius, center+radius, bbx);
+
+    ContactBroadPhase& broadPhase = Value<ContactBroadPhase>::updDowncast
+        (updCacheEntry(state, m_broadPhaseIx)).upd();
+    Array_<pair<int,int> > touching;
+    broadPhase.findOverlappingPairs(centers, radii, m_threads.getExecutor(), 
+                                    touching);
+
+    for (const auto& touch : touching) {
+        const Bubble& bubb1 = m_bubbles[BubbleIndex(touch.first)];
+        const Bubble& bubb2 = m_bubbles[BubbleIndex(touch.second)];
+
+        // The bubbles are touching. We'll add the corresponding surfaces
+        // to the narrow-phase list unless there are relevant exclusions.
+        const Surface& surf1 = m_surfaces[bubb1.surface];
+        const Surface& surf2 = m_surfaces[bubb2.surface];
+        // Ignore if on the same body.
+        if (surf1.mobod == surf2.mobod) continue;
+        assert(bubb1.surface != bubb2.surface); // duh!
+        // Ignore if surfaces are in a common clique.
+        if (surf1.surface->isInSameClique(*surf2.surface)) continue;
+        // We'll need to do a narrow phase investigation of these two
+        // surfaces; use the lower-numbered one as the index to avoid
+        // duplicates.
+        ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
+        if (low > high) std::swap(low,high);
+        ContactSurfaceSet& surfSet = pairs[low];
+        // Insert this pair with null Contact if the pair isn't already
+        // in the PairMap.
+        surfSet.insert(make_pair(high,(Contact*)0));
     }
-    //cout << "Bubble extents:" << extents << "\n";
+}
 
-    // Expensive: O(n log n)
-    std::sort(extents.begin(), extents.end());
-    
-    // Now sweep along the axis, finding potential contacts.
-    
-    for (int ex1=0; ex1 < numBubbles; ++ex1) {
-        const BubbleExtent& extent1 = extents[ex1];
-        const Bubble&       bubb1   = m_bubbles[extent1.index];
-        const Real          radius1 = bubb1.getRadius();
-        const Vec3&         center1 = centers[extent1.index];
-
-        // Loop over just the overlapping bubbles.
-        for (int ex2(ex1+1); ex2 < numBubbles; ++ex2) {
-            const BubbleExtent& extent2 = extents[ex2];
-            if (extent2.start > extent1.end)
-                break;  // no more bubbles can overlap with extent1
-
-            // These bubbles do overlap along this axis. See if they are
-            // actually touching.
-            const Bubble& bubb2   = m_bubbles[extent2.index];
-            const Real    radius2 = bubb2.getRadius();
-            const Vec3&   center2 = centers[extent2.index];
-            if ((center1-center2).normSqr() > square(radius1+radius2))
-                continue; // nope
-
-            // The bubbles are touching. We'll add the corresponding surfaces
-            // to the narrow-phase list unless there are relevant exclusions.
-            const Surface& surf1 = m_surfaces[bubb1.surface];
-            const Surface& surf2 = m_surfaces[bubb2.surface];
-            // Ignore if on the same body.
-            if (surf1.mobod == surf2.mobod) continue;
-            assert(bubb1.surface != bubb2.surface); // duh!
-            // Ignore if surfaces are in a common clique.
-            if (surf1.surface->isInSameClique(*surf2.surface)) continue;
-            // We'll need to do a narrow phase investigation of these two
-            // surfaces; use the lower-numbered one as the index to avoid
-            // duplicates.
-            ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
-            if (low > high) std::swap(low,high);
-            ContactSurfaceSet& surfSet = pairs[low];
-            // Insert this pair with null Contact if the pair isn't already
-            // in the PairMap.
-            surfSet.insert(make_pair(high,(Contact*)0));
-        }
+// Run the appropriate ContactTracker on one surface pair, filling in the
+// tracker's surface order and leaving `next` empty if there is no contact or
+// no tracker for this pair. Only reads shared data, so can be called
+// concurrently for different pairs.
+void trackPair(const State& state, PairToTrack& item, Contact& next) const {
+    const ContactSurfaceIndex index1 = item.index1, index2 = item.index2;
+    const ContactGeometry& geom1 = m_surfaces[index1].surface->getShape();
+    const ContactGeometry& geom2 = m_surfaces[index2].surface->getShape();
+    const ContactGeometryTypeId typeId1 = geom1.getTypeId();
+    const ContactGeometryTypeId typeId2 = geom2.getTypeId();
+    if (!hasContactTracker(typeId1,typeId2))
+        return; // No algorithm available for detecting collisions between these two objects.
+    bool mustReverse;
+    const ContactTracker& tracker = 
+        getContactTracker(typeId1, typeId2, mustReverse);
+
+    const Transform transform1 = 
+        m_surfaces[index1].mobod->getBodyTransform(state)
+            * m_surfaces[index1].X_BS;
+    const Transform transform2 = 
+        m_surfaces[index2].mobod->getBodyTransform(state)
+            * m_surfaces[index2].X_BS;
+
+    // Put the surfaces in the order required by the tracker.
+    item.trackSurf1 = (mustReverse? index2:index1);
+    item.trackSurf2 = (mustReverse? index1:index2);
+
+    UntrackedContact untracked; // empty handle in case we need it
+    const Contact* prev = item.prev;
+    if (!prev) { 
+        untracked = UntrackedContact(item.trackSurf1, item.trackSurf2);
+        prev = &untracked;
     }
+    if (mustReverse)
+        tracker.trackContact
+           (*prev, transform2,geom2, transform1,geom1, 0/*TODO*/, next);
+    else
+        tracker.trackContact
+           (*prev, transform1,geom1, transform2,geom2, 0/*TODO*/, next);
 }
 
 // Call this any time after positions are known, to ensure that the active
@@ -408,69 +428,53 @@ void ensureActiveContactsUpdated(const State& state) const {
     addInBroadPhasePairs(state, interesting);
     //cout << "Interesting pairs:\n" << interesting << "\n";
 
+    Array_<PairToTrack> toTrack;
     PairMap::const_iterator p = interesting.begin();
     for (; p != interesting.end(); ++p) {
-        const ContactSurfaceIndex index1 = p->first;
-        const Transform transform1 = 
-            m_surfaces[index1].mobod->getBodyTransform(state)
-                * m_surfaces[index1].X_BS;
-        const ContactGeometry& geom1 = m_surfaces[index1].surface->getShape();
-        const ContactGeometryTypeId typeId1 = geom1.getTypeId();
-
         const ContactSurfaceSet& others = p->second;
         ContactSurfaceSet::const_iterator q = others.begin();
         for (; q != others.end(); ++q) {
-            const ContactSurfaceIndex index2 = q->first;
-            const Transform transform2 = 
-                m_surfaces[index2].mobod->getBodyTransform(state)
-                    * m_surfaces[index2].X_BS;
-            const ContactGeometry& geom2 = 
-                m_surfaces[index2].surface->getShape();
-            const ContactGeometryTypeId typeId2 = geom2.getTypeId();
-            if (!hasContactTracker(typeId1,typeId2))
-                continue; // No algorithm available for detecting collisions between these two objects.
-            bool mustReverse;
-            const ContactTracker& tracker = 
-                getContactTracker(typeId1, typeId2, mustReverse);
-
-            // Put the surfaces in the order required by the tracker.
-            const ContactSurfaceIndex trackSurf1 = (mustReverse? index2:index1);
-            const ContactSurfaceIndex trackSurf2 = (mustReverse? index1:index2);
-
-            UntrackedContact untracked; // empty handle in case we need it
-            const Contact* prev = q->second;
-            if (prev && prev->getCondition() == Contact::Broken)
-                prev = 0; // that contact expired
-            if (!prev) { 
-                untracked = UntrackedContact(trackSurf1, trackSurf2);
-                prev = &untracked;
-            }
-            Contact next; // empty handle
-            if (mustReverse)
-                tracker.trackContact
-                   (*prev, transform2,geom2, transform1,geom1, 0/*TODO*/, next);
-            else
-                tracker.trackContact
-                   (*prev, transform1,geom1, transform2,geom2, 0/*TODO*/, next);
-
-            if (!next.isEmpty()) {
-                next.setSurfaces(trackSurf1,trackSurf2);
-                next.setContactId(prev->getCondition()==Contact::Untracked
-                                    ? Contact::createNewContactId()
-                                    : prev->getContactId()); // persistent
-                if (   prev->getCondition()==Contact::Untracked
-                    || prev->getCondition()==Contact::Anticipated)
-                    next.setCondition(Contact::NewContact);
-                else { // was NewContact or Ongoing; now Ongoing or Broken
-                    assert(prev->getCondition()==Contact::NewContact
-                           || prev->getCondition()==Contact::Ongoing);
-                    if (next.getTypeId() != BrokenContact::classTypeId())
-                        next.setCondition(Contact::Ongoing);
-                    // Condition will already by Broken for a BrokenContact
-                }
-                nextActive.adoptContact(next);
-            }
+            PairToTrack item;
+            item.index1 = p->first;
+            item.index2 = q->first;
+            item.prev   = q->second;
+            if (item.prev && item.prev->getCondition() == Contact::Broken)
+                item.prev = 0; // that contact expired
+            toTrack.push_back(item);
+        }
+    }
+
+    // The trackers are independent so can run concurrently; the results are
+    // then collected in the same order regardless.
+    const int numPairs = (int)toTrack.size();
+    Array_<Contact> tracked(numPairs);
+    m_threads.forEachChunk(numPairs, MinPairsPerChunk, [&](int begin, int end) {
+        for (int k = begin; k < end; ++k)
+            trackPair(state, toTrack[k], tracked[k]);
+    });
+
+    for (int k = 0; k < numPairs; ++k) {
+        Contact& next = tracked[k];
+        if (next.isEmpty())
+            continue;
+        const PairToTrack& item = toTrack[k];
+        const Contact::Condition prevCondition = 
+            item.prev ? item.prev->getCondition() : Contact::Untracked;
+        next.setSurfaces(item.trackSurf1,item.trackSurf2);
+        next.setContactId(prevCondition==Contact::Untracked
+                            ? Contact::createNewContactId()
+                            : item.prev->getContactId()); // persistent
+        if (   prevCondition==Contact::Untracked
+            || prevCondition==Contact::Anticipated)
+            next.setCondition(Contact::NewContact);
+        else { // was NewContact or Ongoing; now Ongoing or Broken
+            assert(prevCondition==Contact::NewContact
+                   || prevCondition==Contact::Ongoing);
+            if (next.getTypeId() != BrokenContact::classTypeId())
+                next.setCondition(Contact::Ongoing);
+            // Condition will already by Broken for a BrokenContact
         }
+        nextActive.adoptContact(next);
     }
 
     markDiscreteVarUpdateValueRealized(state, m_activeContactsIx);
@@ -581,6 +585,8 @@ friend class ContactTrackerSubsystem;
 // delete it when replacing or destructing.
 TrackerMap          m_contactTrackers;
 ContactTracker*     m_defaultTracker;
+ContactBroadPhase::Method           m_broadPhase;
+ParallelExecutorOption              m_threads;
 
     // TOPOLOGY CACHE
 // The pair is the first assigned index, and the number of contact surfaces
@@ -591,6 +597,7 @@ Array_<Surface,ContactSurfaceIndex>     m_surfaces;
 Array_<Bubble,BubbleIndex>              m_bubbles;
 DiscreteVariableIndex                   m_activeContactsIx;
 DiscreteVariableIndex                   m_predictedContactsIx;
+CacheEntryIndex                         m_broadPhaseIx;
 };
 
 } // namespace SimTK
@@ -669,6 +676,19 @@ getContactTracker(ContactGeometryTypeId surface1,
                   bool& reverseOrder) const
 {   return getImpl().getContactTracker(surface1,surface2,reverseOrder); }
 
+void ContactTrackerSubsystem::setBroadPhase(BroadPhase broadPhase)
+{   updImpl().setBroadPhase(broadPhase); }
+
+ContactTrackerSubsystem::BroadPhase 
+ContactTrackerSubsystem::getBroadPhase() const
+{   return getImpl().getBroadPhase(); }
+
+void ContactTrackerSubsystem::setNumberOfThreads(int numThreads)
+{   updImpl().setNumberOfThreads(numThreads); }
+
+int ContactTrackerSubsystem::getNumberOfThreads() const
+{   return getImpl().getNumberOfThreads(); }
+
 const ContactSnapshot& ContactTrackerSubsystem::
 getPreviousActiveContacts(const State& state) const
 {   return getImpl().getPrevActiveContacts(state); }
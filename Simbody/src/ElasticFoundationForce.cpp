@@ -27,11 +27,15 @@
 #include "simbody/internal/GeneralContactSubsystem.h"
 #include "simbody/internal/MobilizedBody.h"
 #include "ElasticFoundationForceImpl.h"
+#include <functional>
 #include <map>
 #include <set>
 
 namespace SimTK {
 
+// Contacts with fewer springs than this per thread are evaluated serially.
+static const int MinSpringsPerChunk = 256;
+
 SimTK_INSERT_DERIVED_HANDLE_DEFINITIONS(ElasticFoundationForce, ElasticFoundationForceImpl, Force);
 
 ElasticFoundationForce::ElasticFoundationForce(GeneralForceSubsystem& forces, GeneralContactSubsystem& contacts, ContactSetIndex set) :
@@ -53,6 +57,14 @@ void ElasticFoundationForce::setTransitionVelocity(Real v) {
     updImpl().transitionVelocity = v;
 }
 
+void ElasticFoundationForce::setNumberOfThreads(int numThreads) {
+    updImpl().threads.setNumberOfThreads(numThreads, "ElasticFoundationForce");
+}
+
+int ElasticFoundationForce::getNumberOfThreads() const {
+    return getImpl().threads.getNumberOfThreads();
+}
+
 ElasticFoundationForceImpl::ElasticFoundationForceImpl
    (GeneralContactSubsystem& subsystem, ContactSetIndex set) : 
         subsystem(subsystem), set(set), transitionVelocity(Real(0.01)) {
@@ -97,6 +109,8 @@ void ElasticFoundationForceImpl::calcForce
     Real& pe = Value<Real>::updDowncast
                 (subsystem.updCacheEntry(state, energyCacheIndex));
     pe = 0.0;
+    SpringWork& work = Value<SpringWork>::updDowncast
+                (subsystem.updCacheEntry(state, workCacheIndex));
     for (int i = 0; i < (int) contacts.size(); i++) {
         std::map<ContactSurfaceIndex, Parameters>::const_iterator iter1 = 
             parameters.find(contacts[i].getSurface1());
@@ -112,7 +126,7 @@ void ElasticFoundationForceImpl::calcForce
                 static_cast<const TriangleMeshContact&>(contacts[i]);
             processContact(state, contact.getSurface1(), 
                 contact.getSurface2(), iter1->second, 
-                contact.getSurface1Faces(), areaScale, bodyForces, pe);
+                contact.getSurface1Faces(), areaScale, work, bodyForces, pe);
         }
 
         if (iter2 != parameters.end()) {
@@ -120,7 +134,7 @@ void ElasticFoundationForceImpl::calcForce
                 static_cast<const TriangleMeshContact&>(contacts[i]);
             processContact(state, contact.getSurface2(), 
                 contact.getSurface1(), iter2->second, 
-                contact.getSurface2Faces(), areaScale, bodyForces, pe);
+                contact.getSurface2Faces(), areaScale, work, bodyForces, pe);
         }
     }
 }
@@ -129,7 +143,8 @@ void ElasticFoundationForceImpl::processContact
    (const State& state, 
     ContactSurfaceIndex meshIndex, ContactSurfaceIndex otherBodyIndex, 
     const Parameters& param, const std::set<int>& insideFaces,
-    Real areaScale, Vector_<SpatialVec>& bodyForces, Real& pe) const 
+    Real areaScale, SpringWork& work, Vector_<SpatialVec>& bodyForces, 
+    Real& pe) const 
 {
     const ContactGeometry& otherObject = subsystem.getBodyGeometry(set, otherBodyIndex);
     const MobilizedBody& body1 = subsystem.getBody(set, meshIndex);
@@ -138,58 +153,113 @@ void ElasticFoundationForceImpl::processContact
     const Transform t2g = body2.getBodyTransform(state)*subsystem.getBodyTransform(set, otherBodyIndex); // other object to ground
     const Transform t12 = ~t2g*t1g; // mesh to other object
 
-    // Loop over all the springs, and evaluate the force from each one.
+    // If the other object is a mesh too, the faces of it that were nearest
+    // the springs last time are used as starting points for the searches.
 
-    for (std::set<int>::const_iterator iter = insideFaces.begin(); 
-                                       iter != insideFaces.end(); ++iter) {
-        int face = *iter;
-        UnitVec3 normal;
-        bool inside;
-        Vec3 nearestPoint = otherObject.findNearestPoint(t12*param.springPosition[face], inside, normal);
-        if (!inside)
-            continue;
-        
-        // Find how much the spring is displaced.
-        
-        nearestPoint = t2g*nearestPoint;
-        const Vec3 springPosInGround = t1g*param.springPosition[face];
-        const Vec3 displacement = nearestPoint-springPosInGround;
-        const Real distance = displacement.norm();
-        if (distance == 0.0)
-            continue;
-        const Vec3 forceDir = displacement/distance;
-        
-        // Calculate the relative velocity of the two bodies at the contact point.
-        
-        const Vec3 station1 = body1.findStationAtGroundPoint(state, nearestPoint);
-        const Vec3 station2 = body2.findStationAtGroundPoint(state, nearestPoint);
-        const Vec3 v1 = body1.findStationVelocityInGround(state, station1);
-        const Vec3 v2 = body2.findStationVelocityInGround(state, station2);
-        const Vec3 v = v2-v1;
-        const Real vnormal = dot(v, forceDir);
-        const Vec3 vtangent = v-vnormal*forceDir;
-        
-        // Calculate the damping force.
-        
-        const Real area = areaScale * param.springArea[face];
-        const Real f = param.stiffness*area*distance*(1+param.dissipation*vnormal);
-        Vec3 force = (f > 0 ? f*forceDir : Vec3(0));
-        
-        // Calculate the friction force.
-        
-        const Real vslip = vtangent.norm();
-        if (f > 0 && vslip != 0) {
-            const Real vrel = vslip/transitionVelocity;
-            const Real ffriction = 
-                f*(std::min(vrel, Real(1))
-                 *(param.dynamicFriction+2*(param.staticFriction-param.dynamicFriction)
-                 /(1+vrel*vrel))+param.viscousFriction*vslip);
-            force += ffriction*vtangent/vslip;
+    const bool otherIsMesh = 
+        otherObject.getTypeId() == ContactGeometry::TriangleMesh::classTypeId();
+    int* nearestFace = NULL;
+    if (otherIsMesh) {
+        Array_<int>& hints = 
+            work.nearestFace[std::make_pair(meshIndex, otherBodyIndex)];
+        hints.resize(param.springPosition.size(), -1);
+        nearestFace = hints.begin();
+    }
+
+    // Lay out the inside faces in flat arrays to hold the per-spring results.
+
+    const int numSprings = (int) insideFaces.size();
+    work.face.assign(insideFaces.begin(), insideFaces.end());
+    work.active.resize(numSprings);
+    work.station1.resize(numSprings);
+    work.station2.resize(numSprings);
+    work.force.resize(numSprings);
+    work.energy.resize(numSprings);
+
+    // Evaluate the springs, in parallel if there are enough of them. Each
+    // spring only writes its own entries. A SmoothHeightMap remembers the 
+    // patch it last searched, so it can only be used by one thread.
+
+    const bool canUseThreads = otherObject.getTypeId() 
+                            != ContactGeometry::SmoothHeightMap::classTypeId();
+    const std::function<void(int,int)> evaluateSprings = [&](int begin, int end) {
+        const ContactGeometry::TriangleMesh* otherMesh = otherIsMesh
+            ? &ContactGeometry::TriangleMesh::getAs(otherObject) : NULL;
+        for (int k = begin; k < end; k++) {
+            const int face = work.face[k];
+            work.active[k] = false;
+            const Vec3 springPos = t12*param.springPosition[face];
+            UnitVec3 normal;
+            bool inside;
+            Vec3 nearestPoint;
+            if (otherMesh) {
+                // Start from the face this spring found last time, if any.
+                Vec2 uv;
+                nearestPoint = otherMesh->findNearestPoint(springPos, 
+                    nearestFace[face], inside, nearestFace[face], uv);
+            }
+            else nearestPoint = otherObject.findNearestPoint(springPos, inside, normal);
+            if (!inside)
+                continue;
+            
+            // Find how much the spring is displaced.
+            
+            nearestPoint = t2g*nearestPoint;
+            const Vec3 springPosInGround = t1g*param.springPosition[face];
+            const Vec3 displacement = nearestPoint-springPosInGround;
+            const Real distance = displacement.norm();
+            if (distance == 0.0)
+                continue;
+            const Vec3 forceDir = displacement/distance;
+            
+            // Calculate the relative velocity of the two bodies at the contact point.
+            
+            const Vec3 station1 = body1.findStationAtGroundPoint(state, nearestPoint);
+            const Vec3 station2 = body2.findStationAtGroundPoint(state, nearestPoint);
+            const Vec3 v1 = body1.findStationVelocityInGround(state, station1);
+            const Vec3 v2 = body2.findStationVelocityInGround(state, station2);
+            const Vec3 v = v2-v1;
+            const Real vnormal = dot(v, forceDir);
+            const Vec3 vtangent = v-vnormal*forceDir;
+            
+            // Calculate the damping force.
+            
+            const Real area = areaScale * param.springArea[face];
+            const Real f = param.stiffness*area*distance*(1+param.dissipation*vnormal);
+            Vec3 force = (f > 0 ? f*forceDir : Vec3(0));
+            
+            // Calculate the friction force.
+            
+            const Real vslip = vtangent.norm();
+            if (f > 0 && vslip != 0) {
+                const Real vrel = vslip/transitionVelocity;
+                const Real ffriction = 
+                    f*(std::min(vrel, Real(1))
+                     *(param.dynamicFriction+2*(param.staticFriction-param.dynamicFriction)
+                     /(1+vrel*vrel))+param.viscousFriction*vslip);
+                force += ffriction*vtangent/vslip;
+            }
+
+            work.active[k] = true;
+            work.station1[k] = station1;
+            work.station2[k] = station2;
+            work.force[k] = force;
+            work.energy[k] = param.stiffness*area*displacement.normSqr()/2;
         }
+    };
+    if (canUseThreads)
+        threads.forEachChunk(numSprings, MinSpringsPerChunk, evaluateSprings);
+    else if (numSprings > 0)
+        evaluateSprings(0, numSprings);
+
+    // Apply the forces in face order.
 
-        body1.applyForceToBodyPoint(state, station1, force, bodyForces);
-        body2.applyForceToBodyPoint(state, station2, -force, bodyForces);
-        pe += param.stiffness*area*displacement.normSqr()/2;
+    for (int k = 0; k < numSprings; k++) {
+        if (!work.active[k])
+            continue;
+        body1.applyForceToBodyPoint(state, work.station1[k], work.force[k], bodyForces);
+        body2.applyForceToBodyPoint(state, work.station2[k], -work.force[k], bodyForces);
+        pe += work.energy[k];
     }
 }
 
@@ -201,6 +271,10 @@ Real ElasticFoundationForceImpl::calcPotentialEnergy(const State& state) const {
 void ElasticFoundationForceImpl::realizeTopology(State& state) const {
     energyCacheIndex = subsystem.allocateCacheEntry
                         (state, Stage::Dynamics, new Value<Real>());
+    // This only depends on the topology so that it survives from one step
+    // to the next.
+    workCacheIndex = subsystem.allocateCacheEntry
+                        (state, Stage::Topology, new Value<SpringWork>());
 }
 
 
@@ -29,11 +29,16 @@
 #include "simbody/internal/ElasticFoundationForce.h"
 #include "ForceImpl.h"
 
+#include <map>
+#include <set>
+#include <utility>
+
 namespace SimTK {
 
 class ElasticFoundationForceImpl : public ForceImpl {
 public:
     class Parameters;
+    class SpringWork;
     ElasticFoundationForceImpl(GeneralContactSubsystem& subystem, 
                                ContactSetIndex set);
     ElasticFoundationForceImpl* clone() const override {
@@ -50,7 +55,7 @@ public:
                         ContactSurfaceIndex otherBodyIndex, 
                         const Parameters& param, 
                         const std::set<int>& insideFaces,
-                        Real areaScale,
+                        Real areaScale, SpringWork& work,
                         Vector_<SpatialVec>& bodyForces, Real& pe) const;
 private:
     friend class ElasticFoundationForce;
@@ -58,7 +63,9 @@ private:
     const ContactSetIndex set;
     std::map<ContactSurfaceIndex, Parameters> parameters;
     Real transitionVelocity;
+    ParallelExecutorOption threads;
     mutable CacheEntryIndex energyCacheIndex;
+    mutable CacheEntryIndex workCacheIndex;
 };
 
 class ElasticFoundationForceImpl::Parameters {
@@ -74,6 +81,32 @@ public:
     Array_<Real> springArea;
 };
 
+// The springs of one contact are evaluated into flat per-spring arrays, 
+// possibly in several threads, and then applied to the bodies in face order 
+// so the result does not depend on how the work was divided. This holds 
+// those arrays, which are reused from one evaluation to the next, and for 
+// each (spring mesh, other mesh) pair the face of the other mesh that was 
+// nearest each spring last time. The springs that were inside before are 
+// mostly still inside, and their old nearest faces are used to warm-start 
+// the nearest point searches. It lives in a Topology-stage cache entry; like 
+// the broad phase data in GeneralContactSubsystem it is only an accelerator.
+class ElasticFoundationForceImpl::SpringWork {
+public:
+    Array_<int>  face;       // the inside faces of the current contact
+    Array_<bool> active;     // whether the spring exerts any force
+    Array_<Vec3> station1;   // contact point on the mesh body
+    Array_<Vec3> station2;   // contact point on the other body
+    Array_<Vec3> force;      // force on the mesh body, in Ground
+    Array_<Real> energy;     // potential energy of the spring
+    std::map<std::pair<ContactSurfaceIndex,ContactSurfaceIndex>, Array_<int> >
+                 nearestFace;
+};
+
+inline std::ostream& 
+operator<<(std::ostream& o, const ElasticFoundationForceImpl::SpringWork&) {
+    return o << "ElasticFoundationForceImpl::SpringWork";
+}
+
 } // namespace SimTK
 
 #endif // SimTK_SIMBODY_HUNT_CROSSLEY_FORCE_IMPL_H_
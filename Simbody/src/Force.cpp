@@ -31,6 +31,7 @@
 #include "simbody/internal/Force_BuiltIns.h"
 
 #include "ForceImpl.h"
+#include "ForceStiffness.h"
 
 namespace SimTK {
 
@@ -42,6 +43,10 @@ void Force::setDisabledByDefault(bool shouldBeDisabled)
 {   updImpl().setDisabledByDefault(shouldBeDisabled); }
 bool Force::isDisabledByDefault() const
 {   return getImpl().isDisabledByDefault(); }
+void Force::setSlow(bool isSlow)
+{   updImpl().setSlow(isSlow); }
+bool Force::isSlow() const
+{   return getImpl().isSlow(); }
 
 void Force::disable(State& state) const 
 {   getForceSubsystem().setForceIsDisabled(state, getForceIndex(), true); }
@@ -137,6 +142,26 @@ Real Force::TwoPointLinearSpringImpl::calcPotentialEnergy(const State& state) co
     return k*stretch*stretch/2; // 1/2 k (x-x0)^2
 }
 
+void Force::TwoPointLinearSpringImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const Vec3 p1_G = matter.getMobilizedBody(body1)
+                            .findStationLocationInGround(state, station1);
+    const Vec3 p2_G = matter.getMobilizedBody(body2)
+                            .findStationLocationInGround(state, station2);
+
+    const Vec3 r_G = p2_G - p1_G; // vector from point1 to point2
+    const Real d   = r_G.norm();  // distance between the points
+    if (d == 0) return;           // direction undefined
+
+    // The force on body2 is -k(d-x0)*e. Changing the length changes its
+    // magnitude; rotating the line changes its direction.
+    const Vec3  e   = r_G/d;
+    const Mat33 eet = e*~e;
+    const Mat33 dFdx = -k*eet - (k*(d-x0)/d)*(Mat33(1)-eet);
+    addInPointForceStiffnessAndDamping(matter, state, body1, station1, 
+                                       body2, station2, dFdx, Mat33(0), K, D);
+}
+
 
 void Force::TwoPointLinearSpringImpl::
 calcDecorativeGeometryAndAppend(const State& state, Stage stage, 
@@ -202,6 +227,34 @@ Real Force::TwoPointLinearDamperImpl::calcPotentialEnergy(const State& state) co
     return 0;
 }
 
+void Force::TwoPointLinearDamperImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const Vec3 p1_G = matter.getMobilizedBody(body1)
+                            .findStationLocationInGround(state, station1);
+    const Vec3 p2_G = matter.getMobilizedBody(body2)
+                            .findStationLocationInGround(state, station2);
+    const Vec3 r_G = p2_G - p1_G; // vector from point1 to point2
+    const Real d   = r_G.norm();  // distance between the points
+    if (d == 0) return;           // direction undefined
+
+    const Vec3 v1_G = matter.getMobilizedBody(body1)
+                            .findStationVelocityInGround(state, station1);
+    const Vec3 v2_G = matter.getMobilizedBody(body2)
+                            .findStationVelocityInGround(state, station2);
+    const Vec3 vRel = v2_G - v1_G;
+
+    // The force on body2 is -c*(v.e)*e. Rotating the line changes both the
+    // velocity component along it and the direction of the force.
+    const Vec3  e     = r_G/d;
+    const Mat33 eet   = e*~e;
+    const Real  ve    = dot(vRel, e);
+    const Vec3  vPerp = vRel - ve*e;
+    const Mat33 dFdx = -(damping/d)*(e*~vPerp + ve*(Mat33(1)-eet));
+    const Mat33 dFdv = -damping*eet;
+    addInPointForceStiffnessAndDamping(matter, state, body1, station1, 
+                                       body2, station2, dFdx, dFdv, K, D);
+}
+
 
 //-------------------------- TwoPointConstantForce -----------------------------
 //------------------------------------------------------------------------------
@@ -360,6 +413,15 @@ calcPotentialEnergy(const State& state) const {
     return k*square(q-q0)/2;
 }
 
+void Force::MobilityLinearSpringImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    const Real k = getParams(state).first;
+    // Same qdot=u assumption as calcForce().
+    const int ux = mb.getFirstUIndex(state) + (int)m_whichQ;
+    K(ux,ux) += k;
+}
+
 
 
 //--------------------------- MobilityLinearDamper -----------------------------
@@ -442,6 +504,13 @@ calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
     mb.applyOneMobilityForce(state, m_whichU, frc, mobilityForces);
 }
 
+void Force::MobilityLinearDamperImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    const int ux = mb.getFirstUIndex(state) + (int)m_whichU;
+    D(ux,ux) += getDamping(state);
+}
+
 Real Force::MobilityLinearDamperImpl::
 calcPotentialEnergy(const State& state) const {
     return 0;
@@ -678,6 +747,32 @@ calcPotentialEnergy(const State& state) const {
     return param.k*x*x/2;  // 1/2 k x^2
 }
 
+void Force::MobilityLinearStopImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const Parameters& param = getParameters(state);
+    if (param.k == 0) return;
+
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    const Real q = mb.getOneQ(state, m_whichQ);
+    const Real qdot = param.d != 0 ? mb.getOneQDot(state, m_whichQ) 
+                                   : Real(0);
+    // Differentiate the force law in calcForce(), with the same qdot=u
+    // assumption. When the stop is pulling (the clamped case) there is no 
+    // force, and no contribution.
+    const int ux = mb.getFirstUIndex(state) + (int)m_whichQ;
+    if (q > param.qHigh) {
+        const Real x = q-param.qHigh;
+        if (1+param.d*qdot <= 0) return;
+        K(ux,ux) += param.k*(1+param.d*qdot);
+        D(ux,ux) += param.k*x*param.d;
+    } else if (q < param.qLow) {
+        const Real x = q-param.qLow;
+        if (1-param.d*qdot <= 0) return;
+        K(ux,ux) += param.k*(1-param.d*qdot);
+        D(ux,ux) -= param.k*x*param.d;
+    }
+}
+
 //-------------------------- MobilityDiscreteForce -----------------------------
 //------------------------------------------------------------------------------
 
@@ -1001,6 +1096,10 @@ Real Force::GlobalDamperImpl::calcPotentialEnergy(const State& state) const {
     return 0;
 }
 
+void Force::GlobalDamperImpl::addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    D.updDiag() += damping;
+}
+
 
 //------------------------------ UniformGravity --------------------------------
 //------------------------------------------------------------------------------
@@ -34,7 +34,7 @@ namespace SimTK {
 // This is what a Force handle points to.
 class ForceImpl : public PIMPLImplementation<Force, ForceImpl> {
 public:
-    ForceImpl() : forces(0), defaultDisabled(false) {}
+    ForceImpl() : forces(0), defaultDisabled(false), slow(false) {}
     ForceImpl(const ForceImpl& clone) {*this = clone;}
 
     void setDisabledByDefault(bool shouldBeDisabled) 
@@ -44,6 +44,13 @@ public:
     bool isDisabledByDefault() const 
     {   return defaultDisabled; }
 
+    void setSlow(bool isSlow) 
+    {   invalidateTopologyCache();
+        slow = isSlow; }
+
+    bool isSlow() const 
+    {   return slow; }
+
     virtual ~ForceImpl() {}
     virtual ForceImpl* clone() const = 0;
     virtual bool dependsOnlyOnPositions() const {
@@ -71,6 +78,12 @@ public:
                            Vector&              mobilityForces) const = 0;
     virtual Real calcPotentialEnergy(const State& state) const = 0;
 
+    // Force elements whose forces change quickly with q or u should add 
+    // in (+=) their contributions to the mobility-space stiffness and damping
+    // matrices; see ForceStiffness.h. The default treats the force as nonstiff.
+    virtual void addInStiffnessAndDamping(const State& state, 
+                                          Matrix& K, Matrix& D) const {}
+
     virtual void realizeTopology    (State& state) const {}
     virtual void realizeModel       (State& state) const {}
     virtual void realizeInstance    (const State& state) const {}
@@ -98,6 +111,10 @@ private:
     // by default.
     bool                   defaultDisabled;
 
+    // This says whether a multirate integrator may hold this force element's
+    // forces fixed while it takes substeps; see System::holdSlowForces().
+    bool                   slow;
+
         // TOPOLOGY "CACHE"
     // Nothing in the base Impl class.
 };
@@ -124,6 +141,8 @@ public:
                    Vector_<Vec3>&       particleForces, 
                    Vector&              mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInStiffnessAndDamping(const State& state, 
+                                  Matrix& K, Matrix& D) const override;
 
     void calcDecorativeGeometryAndAppend(const State& s, Stage stage, 
                                          Array_<DecorativeGeometry>& geom) 
@@ -149,6 +168,7 @@ public:
     }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const override;
 private:
     const SimbodyMatterSubsystem& matter;
     const MobilizedBodyIndex body1, body2;
@@ -208,6 +228,8 @@ friend class MobilityLinearSpring;
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
                    override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInStiffnessAndDamping(const State& state, 
+                                  Matrix& K, Matrix& D) const override;
 
     // Allocate the discrete state variable for the parameters. 
     void realizeTopology(State& s) const override {
@@ -258,6 +280,8 @@ friend class MobilityLinearDamper;
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
                    override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInStiffnessAndDamping(const State& state, 
+                                  Matrix& K, Matrix& D) const override;
 
     // Allocate the discrete state variable for the parameters. 
     void realizeTopology(State& s) const override {
@@ -374,6 +398,10 @@ friend class MobilityLinearStop;
     // We're not bothering to cache P.E. -- just recalculate it when asked.
     Real calcPotentialEnergy(const State& state) const override; 
 
+    // Only an engaged stop contributes.
+    void addInStiffnessAndDamping(const State& state, 
+                                  Matrix& K, Matrix& D) const override;
+
     // Allocate the state variables and cache entry. 
     void realizeTopology(State& s) const override {
         // Allocate the discrete variable for dynamics parameters.
@@ -561,6 +589,7 @@ public:
     }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const override;
 private:
     const SimbodyMatterSubsystem& matter;
     Real damping;
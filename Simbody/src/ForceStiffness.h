@@ -0,0 +1,90 @@
+#ifndef SimTK_SIMBODY_FORCE_STIFFNESS_H_
+#define SimTK_SIMBODY_FORCE_STIFFNESS_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Helpers used by force elements to add their contributions to the
+mobility-space stiffness and damping matrices K=-d f/d theta and D=-d f/d u,
+where f are the generalized forces they produce and theta is a displacement in
+u-space (that is, dq=N*dtheta). These are used to form the state derivative
+Jacobian for implicit integrators; see
+MultibodySystem::calcStateDerivativeJacobian().
+
+Most force elements act between a pair of points or frames on two bodies.
+Given the derivatives of the force F_G applied to body 2 (with -F_G applied to
+body 1) with respect to the relative position and velocity of the two points,
+these map them to mobility space using the points' Jacobians J, as
+K -= ~J*dF/dx*J and D -= ~J*dF/dv*J. */
+
+#include "SimTKcommon.h"
+#include "simbody/internal/common.h"
+#include "simbody/internal/SimbodyMatterSubsystem.h"
+
+namespace SimTK {
+
+// A point force F_G acts at station2 on body2, and -F_G at station1 on
+// body1. dFdx and dFdv are its derivatives with respect to the Ground-frame
+// position and velocity of point 2 relative to point 1.
+inline void addInPointForceStiffnessAndDamping
+   (const SimbodyMatterSubsystem& matter, const State& state,
+    MobilizedBodyIndex body1, const Vec3& station1,
+    MobilizedBodyIndex body2, const Vec3& station2,
+    const Mat33& dFdx, const Mat33& dFdv, Matrix& K, Matrix& D)
+{
+    const Array_<MobilizedBodyIndex> onBody = {body1, body2};
+    const Array_<Vec3> stations = {station1, station2};
+    Matrix JS; // 6 x nu
+    matter.calcStationJacobian(state, onBody, stations, JS);
+    const int nu = JS.ncol();
+    const Matrix J = JS(3,0,3,nu) - JS(0,0,3,nu); // relative velocity
+    const Matrix Jt = ~J;
+    if (dFdx != Mat33(0)) K -= Jt * (Matrix(dFdx) * J);
+    if (dFdv != Mat33(0)) D -= Jt * (Matrix(dFdv) * J);
+}
+
+// A spatial force F_G = [moment, force] acts on body2 at its station2, and
+// -F_G on body1 at its station1; the two stations should be coincident or
+// nearly so. dFdx and dFdv are its derivatives with respect to the
+// Ground-frame spatial displacement [angle, position] and spatial velocity
+// [omega, v] of the frame at point 2 relative to the one at point 1.
+inline void addInFrameForceStiffnessAndDamping
+   (const SimbodyMatterSubsystem& matter, const State& state,
+    MobilizedBodyIndex body1, const Vec3& station1,
+    MobilizedBodyIndex body2, const Vec3& station2,
+    const Mat66& dFdx, const Mat66& dFdv, Matrix& K, Matrix& D)
+{
+    const Array_<MobilizedBodyIndex> onBody = {body1, body2};
+    const Array_<Vec3> origins = {station1, station2};
+    Matrix JF; // 12 x nu
+    matter.calcFrameJacobian(state, onBody, origins, JF);
+    const int nu = JF.ncol();
+    const Matrix J = JF(6,0,6,nu) - JF(0,0,6,nu); // relative velocity
+    const Matrix Jt = ~J;
+    if (dFdx != Mat66(0)) K -= Jt * (Matrix(dFdx) * J);
+    if (dFdv != Mat66(0)) D -= Jt * (Matrix(dFdv) * J);
+}
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_FORCE_STIFFNESS_H_
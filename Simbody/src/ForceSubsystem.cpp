@@ -68,5 +68,8 @@ ForceSubsystem::updRep() {
     return SimTK_DYNAMIC_CAST_DEBUG<ForceSubsystemRep&>(updSubsystemGuts());
 }
 
+void ForceSubsystem::setSlow(bool isSlow) {updRep().setSlow(isSlow);}
+bool ForceSubsystem::isSlow() const {return getRep().isSlow();}
+
 } // namespace SimTK
 
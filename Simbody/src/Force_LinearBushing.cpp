@@ -29,6 +29,7 @@
 #include "simbody/internal/Force_LinearBushing.h"
 
 #include "ForceImpl.h"
+#include "ForceStiffness.h"
 
 namespace SimTK {
 
@@ -71,6 +72,8 @@ public:
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInStiffnessAndDamping(const State& state, 
+                                  Matrix& K, Matrix& D) const override;
 
     // Allocate the position and velocity cache entries. These are all
     // lazy-evaluation entries - be sure to check whether they have already
@@ -612,6 +615,32 @@ calcPotentialEnergy(const State& state) const {
     return getPotentialEnergyCache(state);
 }
 
+// This is exact only for small rotations of M in F, where the rotational
+// coordinates are the rotation angles about F's axes and their rates are
+// the components of w_FM, and it ignores the moment of the force about the
+// shift from OF to OM. That is the usual operating range of a bushing and
+// good enough for an iteration matrix.
+void Force::LinearBushingImpl::
+addInStiffnessAndDamping(const State& state, Matrix& K, Matrix& D) const {
+    const InstanceVars& iv = getInstanceVars(state);
+    ensurePositionCacheValid(state);
+    const PositionCache& pc = getPositionCache(state);
+    const Mat33& R_GF = pc.X_GF.R().asMat33();
+
+    // Stiffness and damping along F's axes, re-expressed in Ground.
+    Mat66 dFdx(0), dFdv(0);
+    for (int i=0; i<3; ++i) {
+        const Vec3& e = R_GF(i);
+        const Mat33 eet = e*~e;
+        dFdx.updSubMat<3,3>(0,0) -= iv.k[i]*eet;
+        dFdx.updSubMat<3,3>(3,3) -= iv.k[3+i]*eet;
+        dFdv.updSubMat<3,3>(0,0) -= iv.c[i]*eet;
+        dFdv.updSubMat<3,3>(3,3) -= iv.c[3+i]*eet;
+    }
+    addInFrameForceStiffnessAndDamping(matter, state, 
+        body1x, iv.X_B1F.p(), body2x, iv.X_B2M.p(), dFdx, dFdv, K, D);
+}
+
 
 } // namespace SimTK
 
@@ -28,7 +28,10 @@
 #include "simbody/internal/MultibodySystem.h"
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 
+#include "ContactBroadPhase.h"
+
 #include <algorithm>
+#include <utility>
 
 namespace SimTK {
 
@@ -47,16 +50,9 @@ public:
     mutable Array_<Real,ContactSurfaceIndex>    sphereRadii;
 };
 
-class ContactBodyExtent {
-public:
-    ContactBodyExtent(Real start, Real end, ContactSurfaceIndex index) 
-    :   start(start), end(end), index(index) {}
-    ContactBodyExtent() {}
-    bool operator<(const ContactBodyExtent& e) const 
-    {   return start < e.start; }
-    Real start, end;
-    ContactSurfaceIndex index;
-};
+// Don't split the collision detection among threads for fewer pairs than this
+// per thread.
+static const int MinPairsPerChunk = 16;
 
 
 //==============================================================================
@@ -64,7 +60,8 @@ public:
 //==============================================================================
 class GeneralContactSubsystemImpl : public Subsystem::Guts {
 public:
-    GeneralContactSubsystemImpl() {}
+    GeneralContactSubsystemImpl() 
+    :   broadPhase(ContactBroadPhase::SingleAxisSweep) {}
 
     GeneralContactSubsystemImpl* cloneImpl() const override {
         return new GeneralContactSubsystemImpl(*this);
@@ -133,9 +130,30 @@ public:
         return contacts[set];
     }
     
+    void setBroadPhase(GeneralContactSubsystem::BroadPhase method) {
+        invalidateSubsystemTopologyCache();
+        broadPhase = ContactBroadPhase::Method(method);
+    }
+
+    GeneralContactSubsystem::BroadPhase getBroadPhase() const {
+        return GeneralContactSubsystem::BroadPhase(broadPhase);
+    }
+
+    void setNumberOfThreads(int n) {
+        threads.setNumberOfThreads(n, "GeneralContactSubsystem");
+    }
+
+    int getNumberOfThreads() const {
+        return threads.getNumberOfThreads();
+    }
+
     int realizeSubsystemTopologyImpl(State& state) const override {
         contactsCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Dynamics, new Value<Array_<Array_<Contact> > >());
         contactsValidCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Position, new Value<bool>());
+        // One broad phase per contact set, holding whatever it remembers from one evaluation to the
+        // next; that doesn't depend on the current positions so it is only invalidated by Topology.
+        broadPhasesCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Topology, 
+            new Value<Array_<ContactBroadPhase> >(Array_<ContactBroadPhase>(sets.size(), ContactBroadPhase(broadPhase))));
         for (int i = 0; i < (int) sets.size(); ++i) {
             const ContactSet& set = sets[i];
             int numBodies = set.bodies.size();
@@ -162,6 +180,8 @@ public:
         int numSets = getNumContactSets();
         contacts.resize(numSets);
         
+        Array_<ContactBroadPhase>& broadPhases = Value<Array_<ContactBroadPhase> >::updDowncast(updCacheEntry(state, broadPhasesCacheIndex)).upd();
+        
         // Loop over all contact sets.
         
         for (int setIndex = 0; setIndex < numSets; setIndex++) {
@@ -169,44 +189,34 @@ public:
             const ContactSet& set = sets[setIndex];
             int numBodies = set.bodies.size();
             
-            // Perform a sweep-and-prune on a single axis to identify potential contacts.  First, find which
-            // axis has the most variation in body locations.  That is the axis we will use.
+            // Find the pairs of bodies whose bounding spheres overlap.
             
-            Vector_<Vec3> centers(numBodies);
-            for (ContactSurfaceIndex i(0); i < numBodies; i++)
+            Array_<Vec3> centers(numBodies);
+            Array_<Real> radii(numBodies);
+            for (ContactSurfaceIndex i(0); i < numBodies; i++) {
                 centers[i] = set.bodies[i].getBodyTransform(state)*set.sphereCenters[i];
-            Vec3 average = mean(centers);
-            Vec3 var(0);
-            for (int i = 0; i < numBodies; i++)
-                var += abs(centers[i]-average);
-            int axis = (var[0] > var[1] ? 0 : 1);
-            if (var[2] > var[axis])
-                axis = 2;
-            
-            // Find the extent of each body along the axis and sort them by starting location.
-            
-            Array_<ContactBodyExtent> extents(numBodies);
-            for (ContactSurfaceIndex i(0); i < numBodies; i++)
-                extents[i] = ContactBodyExtent(centers[i][axis]-set.sphereRadii[i], centers[i][axis]+set.sphereRadii[i], i);
-            std::sort(extents.begin(), extents.end());
+                radii[i] = set.sphereRadii[i];
+            }
+            Array_<std::pair<int,int> > pairs;
+            broadPhases[setIndex].findOverlappingPairs(centers, radii, threads.getExecutor(), pairs);
             
-            // Now sweep along the axis, finding potential contacts.
+            // Do a full collision detection on each of them. The pairs are divided among threads
+            // in consecutive chunks, so concatenating the chunks' contacts gives the same order as
+            // processing the pairs serially.
             
-            for (int i = 0; i < numBodies; i++) {
-                const ContactSurfaceIndex index1 = extents[i].index;
-                const Transform transform1 = set.bodies[index1].getBodyTransform(state)*set.transforms[index1];
-                const ContactGeometry& geom1 = set.geometry[index1];
-                const ContactGeometryTypeId typeId1 = geom1.getTypeId();
-                for (int j = i+1; j < numBodies && extents[j].start <= extents[i].end; j++) {
-                    // They overlap along this axis.  See if the bounding spheres overlap.
-                    
-                    const ContactSurfaceIndex index2 = extents[j].index;
-                    const Real sumRadius = set.sphereRadii[index1]+set.sphereRadii[index2];
-                    if ((centers[index1]-centers[index2]).normSqr() <= sumRadius*sumRadius) {
-                        // Do a full collision detection.
-
+            const int numPairs = pairs.size();
+            const int numChunks = threads.getExecutor() ? std::max(1, std::min(threads.getNumberOfThreads(), numPairs/MinPairsPerChunk)) : 1;
+            Array_<Array_<Contact> > chunkContacts(numChunks);
+            threads.forEachChunk(numChunks, 1, [&](int firstChunk, int endChunk) {
+                for (int chunk = firstChunk; chunk < endChunk; chunk++) {
+                    const int end = (int) ((long long) numPairs*(chunk+1)/numChunks);
+                    for (int k = (int) ((long long) numPairs*chunk/numChunks); k < end; k++) {
+                        const ContactSurfaceIndex index1(pairs[k].first), index2(pairs[k].second);
+                        const Transform transform1 = set.bodies[index1].getBodyTransform(state)*set.transforms[index1];
                         const Transform transform2 = set.bodies[index2].getBodyTransform(state)*set.transforms[index2];
+                        const ContactGeometry& geom1 = set.geometry[index1];
                         const ContactGeometry& geom2 = set.geometry[index2];
+                        const ContactGeometryTypeId typeId1 = geom1.getTypeId();
                         const ContactGeometryTypeId typeId2 = geom2.getTypeId();
                         CollisionDetectionAlgorithm* algorithm = 
                             CollisionDetectionAlgorithm::getAlgorithm
@@ -218,16 +228,18 @@ public:
                                 continue; // No algorithm available for detecting collisions between these two objects.
                             algorithm->processObjects(index2, geom2, transform2,
                                                       index1, geom1, transform1,
-                                                      contacts[setIndex]);
+                                                      chunkContacts[chunk]);
                         }
                         else {
                             algorithm->processObjects(index1, geom1, transform1,
                                                       index2, geom2, transform2,
-                                                      contacts[setIndex]);
+                                                      chunkContacts[chunk]);
                         }
                     }
                 }
-            }
+            });
+            for (const Array_<Contact>& found : chunkContacts)
+                contacts[setIndex].insert(contacts[setIndex].end(), found.begin(), found.end());
         }
         contactsValid = true;
         return 0;
@@ -240,6 +252,9 @@ private:
 
     mutable CacheEntryIndex contactsCacheIndex;
     mutable CacheEntryIndex contactsValidCacheIndex;
+    mutable CacheEntryIndex broadPhasesCacheIndex;
+    ContactBroadPhase::Method broadPhase;
+    ParallelExecutorOption threads;
 };
 
 
@@ -287,6 +302,22 @@ const Array_<Contact>& GeneralContactSubsystem::getContacts(const State& state,
     return getImpl().getContacts(state, set);
 }
 
+void GeneralContactSubsystem::setBroadPhase(BroadPhase broadPhase) {
+    updImpl().setBroadPhase(broadPhase);
+}
+
+GeneralContactSubsystem::BroadPhase GeneralContactSubsystem::getBroadPhase() const {
+    return getImpl().getBroadPhase();
+}
+
+void GeneralContactSubsystem::setNumberOfThreads(int numThreads) {
+    updImpl().setNumberOfThreads(numThreads);
+}
+
+int GeneralContactSubsystem::getNumberOfThreads() const {
+    return getImpl().getNumberOfThreads();
+}
+
 bool GeneralContactSubsystem::isInstanceOf(const Subsystem& s) {
     return GeneralContactSubsystemImpl::isA(s.getSubsystemGuts());
 }
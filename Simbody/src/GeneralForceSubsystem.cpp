@@ -38,6 +38,7 @@
 #include <exception>
 
 #include "ForceImpl.h"
+#include "MultibodySystemRep.h"
 
 #include <memory>
 
@@ -609,6 +610,7 @@ public:
         forceEnabledIndex.invalidate();
         enabledParallelForcesIndex.invalidate();
         enabledNonParallelForcesIndex.invalidate();
+        enabledSlowForcesIndex.invalidate();
         cachedForcesAreValidCacheIndex.invalidate();
         rigidBodyForceCacheIndex.invalidate();
         mobilityForceCacheIndex.invalidate();
@@ -631,8 +633,10 @@ public:
         
         
         // Track the enabled forces and whether they should be parallelized.
+        // Slow forces are calculated separately so that they can be held.
         Array_<ForceIndex> enabledNonParallelForces;
         Array_<ForceIndex> enabledParallelForces;
+        Array_<ForceIndex> enabledSlowForces;
 
         // Avoid repeatedly allocating memory.
         enabledNonParallelForces.reserve(forces.size());
@@ -641,7 +645,9 @@ public:
         for (int i = 0; i < (int) forces.size(); ++i) {
             if (forceEnabled[i])
             {
-                if (forces[i]->getImpl().shouldBeParallelIfPossible())
+                if (forces[i]->isSlow())
+                    enabledSlowForces.push_back(ForceIndex(i));
+                else if (forces[i]->getImpl().shouldBeParallelIfPossible())
                     enabledParallelForces.push_back(ForceIndex(i));
                 else
                     enabledNonParallelForces.push_back(ForceIndex(i));
@@ -652,6 +658,8 @@ public:
                 new Value<Array_<ForceIndex> >(enabledNonParallelForces));
         enabledParallelForcesIndex = allocateCacheEntry(s, Stage::Instance,
                 new Value<Array_<ForceIndex> >(enabledParallelForces));
+        enabledSlowForcesIndex = allocateCacheEntry(s, Stage::Instance,
+                new Value<Array_<ForceIndex> >(enabledSlowForces));
 
         //Determine whether the subsystem has parallel forces - if so, use the
         //parallel implementation of CalcForcesTask (even if those parallel
@@ -728,10 +736,14 @@ public:
         Array_<ForceIndex>& enabledParallelForces =
                 Value< Array_<ForceIndex> >::
                     updDowncast(updCacheEntry(s,enabledParallelForcesIndex));
+        Array_<ForceIndex>& enabledSlowForces =
+                Value< Array_<ForceIndex> >::
+                    updDowncast(updCacheEntry(s,enabledSlowForcesIndex));
 
         // Avoid repeatedly allocating memory.
         enabledParallelForces.resize(0);
         enabledNonParallelForces.resize(0);
+        enabledSlowForces.resize(0);
         
         enabledNonParallelForces.reserve(forces.size());
         enabledParallelForces.reserve(forces.size());
@@ -739,7 +751,9 @@ public:
         for (int i = 0; i < (int) forces.size(); ++i) {
             if (forceEnabled[i])
             {
-                if (forces[i]->getImpl().shouldBeParallelIfPossible())
+                if (forces[i]->isSlow())
+                    enabledSlowForces.push_back(ForceIndex(i));
+                else if (forces[i]->getImpl().shouldBeParallelIfPossible())
                     enabledParallelForces.push_back(ForceIndex(i));
                 else
                     enabledNonParallelForces.push_back(ForceIndex(i));
@@ -801,6 +815,18 @@ public:
         Vector&                mobilityForces  =
                                     mbs.updMobilityForces (s, Stage::Dynamics);
 
+        // Slow forces go to the System's slow forces, unless those are being
+        // held in which case they aren't calculated at all.
+        const Array_<ForceIndex>& enabledSlowForces =
+                Value<Array_<ForceIndex>>::
+                             downcast(getCacheEntry(s, enabledSlowForcesIndex));
+        if (!enabledSlowForces.empty() && !mbs.getRep().areSlowForcesHeld(s)) {
+            ForceCacheEntry& slowForces = mbs.getRep().updSlowForces(s);
+            for (ForceIndex fx : enabledSlowForces)
+                forces[fx]->getImpl().calcForce(s, slowForces.rigidBodyForces,
+                    slowForces.particleForces, slowForces.mobilityForces);
+        }
+
         // Short circuit if we're not doing any caching here. Note that we're
         // checking whether the *index* is valid (i.e. does the cache entry
         // exist?), not the contents.
@@ -878,6 +904,13 @@ public:
         return 0;
     }
 
+    bool hasSlowForces() const override {
+        if (isSlow()) return true;
+        for (int i = 0; i < (int) forces.size(); ++i)
+            if (forces[i]->isSlow()) return true;
+        return false;
+    }
+
     Real calcPotentialEnergy(const State& state) const override {
         const Array_<bool>& forceEnabled = Value<Array_<bool> >::downcast
            (getDiscreteVariable(state, forceEnabledIndex)).get();
@@ -891,6 +924,15 @@ public:
         return energy;
     }
 
+    void addInStiffnessAndDamping(const State& state, 
+                                  Matrix& K, Matrix& D) const override {
+        const Array_<bool>& enabled = Value<Array_<bool> >::downcast
+            (getDiscreteVariable(state, forceEnabledIndex));
+        for (int i = 0; i < (int) forces.size(); ++i)
+            if (enabled[i]) 
+                forces[i]->getImpl().addInStiffnessAndDamping(state, K, D);
+    }
+
     int realizeSubsystemAccelerationImpl(const State& s) const override {
         const Array_<bool>& enabled = Value<Array_<bool> >::downcast
             (getDiscreteVariable(s, forceEnabledIndex));
@@ -937,6 +979,9 @@ private:
     //parallel and non-parallel forces
     mutable CacheEntryIndex   enabledParallelForcesIndex;
     mutable CacheEntryIndex   enabledNonParallelForcesIndex;
+    // Enabled forces that have been marked slow; these aren't in either of
+    // the above lists.
+    mutable CacheEntryIndex   enabledSlowForcesIndex;
 
     // This set of cache entries is allocated only if some force element
     // overrode dependsOnlyOnPositions().
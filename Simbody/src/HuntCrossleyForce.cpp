@@ -28,6 +28,7 @@
 #include "simbody/internal/MobilizedBody.h"
 
 #include "HuntCrossleyForceImpl.h"
+#include "ForceStiffness.h"
 
 namespace SimTK {
 
@@ -168,6 +169,79 @@ void HuntCrossleyForceImpl::calcForce(const State& state, Vector_<SpatialVec>& b
     }
 }
 
+// Differentiate the force law in calcForce() for each contact. The normal
+// force f=fH*(1+1.5c*vnormal) with fH proportional to depth^(3/2), and the
+// friction force is proportional to f, so the whole force F changes with 
+// depth as 1.5F/depth and with vnormal as 1.5c*fH*F/f. Otherwise friction is
+// treated as a viscous force in the tangent plane giving the same force at
+// the current slip velocity, since the slope of the Stribeck curve can be 
+// negative.
+void HuntCrossleyForceImpl::addInStiffnessAndDamping
+   (const State& state, Matrix& K, Matrix& D) const {
+    const Array_<Contact>& contacts = subsystem.getContacts(state, set);
+    for (int i = 0; i < (int) contacts.size(); i++) {
+        if (!PointContact::isInstance(contacts[i]))
+            continue;
+        const PointContact& contact = static_cast<const PointContact&>(contacts[i]);
+        const Parameters& param1 = getParameters(contact.getSurface1());
+        const Parameters& param2 = getParameters(contact.getSurface2());
+        
+        const Real s1 = param2.stiffness/(param1.stiffness+param2.stiffness);
+        const Real s2 = 1-s1;
+        const Real depth = contact.getDepth();
+        if (depth <= 0)
+            continue;
+        const Vec3& normal = contact.getNormal();
+        const Vec3 location = contact.getLocation()+(depth*(Real(0.5)-s1))*normal;
+        
+        const Real k = param1.stiffness*s1;
+        const Real c = param1.dissipation*s1 + param2.dissipation*s2;
+        const Real radius = contact.getEffectiveRadiusOfCurvature();
+        const Real fH = Real(4./3.)*k*depth*std::sqrt(radius*k*depth);
+        
+        const MobilizedBody& body1 = subsystem.getBody(set, contact.getSurface1());
+        const MobilizedBody& body2 = subsystem.getBody(set, contact.getSurface2());
+        const Vec3 station1 = body1.findStationAtGroundPoint(state, location);
+        const Vec3 station2 = body2.findStationAtGroundPoint(state, location);
+        const Vec3 v1 = body1.findStationVelocityInGround(state, station1);
+        const Vec3 v2 = body2.findStationVelocityInGround(state, station2);
+        const Vec3 v = v1-v2;
+        const Real vnormal = dot(v, normal);
+        const Vec3 vtangent = v-vnormal*normal;
+        
+        const Real f = fH*(1+Real(1.5)*c*vnormal);
+        if (f <= 0) 
+            continue;
+
+        const bool hasStatic = (param1.staticFriction != 0 || param2.staticFriction != 0);
+        const bool hasDynamic= (param1.dynamicFriction != 0 || param2.dynamicFriction != 0);
+        const bool hasViscous = (param1.viscousFriction != 0 || param2.viscousFriction != 0);
+        const Real us = hasStatic ? 2*param1.staticFriction*param2.staticFriction/(param1.staticFriction+param2.staticFriction) : 0;
+        const Real ud = hasDynamic ? 2*param1.dynamicFriction*param2.dynamicFriction/(param1.dynamicFriction+param2.dynamicFriction) : 0;
+        const Real uv = hasViscous ? 2*param1.viscousFriction*param2.viscousFriction/(param1.viscousFriction+param2.viscousFriction) : 0;
+        const Real vslip = vtangent.norm();
+        const Real vt = getTransitionVelocity();
+        const Real vrel = vslip/vt;
+        // ffriction/vslip, or its limit as vslip goes to zero.
+        const Real cfriction = vslip != 0
+            ? f*(std::min(vrel, Real(1))*(ud+2*(us-ud)/(1+vrel*vrel))+uv*vslip)/vslip
+            : f*((ud+2*(us-ud))/vt+uv);
+        const Vec3 force = f*normal + cfriction*vtangent;
+
+        // Derivatives of the force on body 2 with respect to the motion of
+        // body 2 relative to body 1, which is -v. Moving body 2 along the
+        // normal reduces the depth.
+        const Mat33 nnt = Mat33(normal*~normal);
+        const Mat33 dFdx = -(Real(1.5)/depth)*(force*~normal);
+        const Mat33 dFdv = -(Real(1.5)*c*fH/f)*(force*~normal)
+                           - cfriction*(Mat33(1)-nnt);
+
+        addInPointForceStiffnessAndDamping(body1.getMatterSubsystem(), state,
+            body1.getMobilizedBodyIndex(), station1, 
+            body2.getMobilizedBodyIndex(), station2, dFdx, dFdv, K, D);
+    }
+}
+
 Real HuntCrossleyForceImpl::calcPotentialEnergy(const State& state) const {
     return Value<Real>::downcast(state.getCacheEntry(subsystem.getMySubsystemIndex(), energyCacheIndex)).get();
 }
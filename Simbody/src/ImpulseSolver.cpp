@@ -23,6 +23,11 @@
 
 #include "simbody/internal/common.h"
 #include "simbody/internal/ImpulseSolver.h"
+#include "simbody/internal/SimbodyMatterSubsystem.h"
+#include "simbody/internal/MobilizedBody.h"
+#include "simbody/internal/Constraint.h"
+
+#include <algorithm>
 
 namespace SimTK {
 
@@ -76,4 +81,278 @@ dumpUniContacts(const String& msg,
     printf("------------------------------\n\n");
 }
 
+// The default matrix-free methods just form the dense matrix.
+bool ImpulseSolver::
+solve(int                                 phase,
+      const Array_<MultiplierIndex>&      participating,
+      const SparseCompliance&             A,
+      const Vector&                       D,
+      const Array_<MultiplierIndex>&      expanding,
+      Vector&                             piExpand,
+      Vector&                             verrStart,
+      Vector&                             verrApplied,
+      Vector&                             pi,
+      Array_<UncondRT>&                   unconditional,
+      Array_<UniContactRT>&               uniContact,
+      Array_<UniSpeedRT>&                 uniSpeed,
+      Array_<BoundedRT>&                  bounded,
+      Array_<ConstraintLtdFrictionRT>&    consLtdFriction,
+      Array_<StateLtdFrictionRT>&         stateLtdFriction) const
+{
+    Matrix denseA;
+    A.calcMatrix(denseA);
+    return solve(phase, participating, denseA, D, expanding, piExpand,
+                 verrStart, verrApplied, pi, unconditional, uniContact,
+                 uniSpeed, bounded, consLtdFriction, stateLtdFriction);
+}
+
+bool ImpulseSolver::
+solveBilateral(const Array_<MultiplierIndex>&  participating,
+               const SparseCompliance&         A,
+               const Vector&                   D,
+               const Vector&                   rhs,
+               Vector&                         pi) const
+{
+    Matrix denseA;
+    A.calcMatrix(denseA);
+    return solveBilateral(participating, denseA, D, rhs, pi);
+}
+
+
+
+//==============================================================================
+//                           SPARSE COMPLIANCE
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//                                  CALC
+//------------------------------------------------------------------------------
+// Each enabled Constraint contributes a block of equations acting on a set of
+// branches. We greedily color the blocks so that blocks of the same color 
+// share no branch, then probe with one equation from every block of a color at
+// once: lambda = sum of unit vectors, f = ~G lambda, w = M\ f. Since neither
+// ~G nor M\ mixes branches, the entries of f and w on a block's branches 
+// belong to that block's equation alone.
+void ImpulseSolver::SparseCompliance::
+calc(const SimbodyMatterSubsystem& matter, const State& s) {
+    const int m  = s.getNMultipliers();
+    const int nu = s.getNU();
+    const int nb = matter.getNumBodies();
+    m_nu = nu;
+    m_numProbes = 0;
+
+    // Mobilities of each branch, indexed by the branch's base body.
+    Array_<Array_<int>, MobilizedBodyIndex> branchU(nb);
+    for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        Array_<int>& us = 
+            branchU[mobod.getBaseMobilizedBody().getMobilizedBodyIndex()];
+        const int u0 = mobod.getFirstUIndex(s);
+        for (int i=0; i < mobod.getNumU(s); ++i)
+            us.push_back(u0+i);
+    }
+
+    Array_<Array_<int> > equations, branches; // one entry per block
+    Array_<Array_<int> > colors;              // blocks of each color
+    Array_<Array_<int>, MobilizedBodyIndex> branchColors(nb);
+    Array_<int> used;
+    for (ConstraintIndex cx(0); cx < matter.getNumConstraints(); ++cx) {
+        const Constraint& constraint = matter.getConstraint(cx);
+        int mp, mv, ma;
+        constraint.getNumConstraintEquationsInUse(s, mp, mv, ma);
+        if (mp+mv+ma == 0)
+            continue;
+        MultiplierIndex px0, vx0, ax0;
+        constraint.getIndexOfMultipliersInUse(s, px0, vx0, ax0);
+        const int b = (int)equations.size();
+        equations.push_back(Array_<int>());
+        for (int i=0; i < mp; ++i) equations.back().push_back(px0+i);
+        for (int i=0; i < mv; ++i) equations.back().push_back(vx0+i);
+        for (int i=0; i < ma; ++i) equations.back().push_back(ax0+i);
+
+        // Ground has no mobilities, so it doesn't couple anything.
+        branches.push_back(Array_<int>());
+        Array_<int>& brs = branches.back();
+        Array_<MobilizedBodyIndex> bodies;
+        for (ConstrainedBodyIndex cb(0); 
+             cb < constraint.getNumConstrainedBodies(); ++cb)
+            bodies.push_back(constraint.getMobilizedBodyFromConstrainedBody(cb)
+                             .getMobilizedBodyIndex());
+        for (ConstrainedMobilizerIndex cm(0); 
+             cm < constraint.getNumConstrainedMobilizers(); ++cm)
+            bodies.push_back(constraint.getMobilizedBodyFromConstrainedMobilizer
+                                (cm).getMobilizedBodyIndex());
+        for (MobilizedBodyIndex mbx : bodies)
+            if (mbx != GroundIndex)
+                brs.push_back(matter.getMobilizedBody(mbx)
+                    .getBaseMobilizedBody().getMobilizedBodyIndex());
+        std::sort(brs.begin(), brs.end());
+        brs.erase(std::unique(brs.begin(), brs.end()), brs.end());
+
+        // Choose the lowest color not already used on any of these branches.
+        used.clear();
+        for (int br : brs)
+            used.insert(used.end(), branchColors[MobilizedBodyIndex(br)].begin(),
+                                    branchColors[MobilizedBodyIndex(br)].end());
+        std::sort(used.begin(), used.end());
+        int color = 0;
+        for (int c : used) {
+            if (c > color) break;
+            if (c == color) ++color;
+        }
+        if (color == (int)colors.size())
+            colors.push_back(Array_<int>());
+        colors[color].push_back(b);
+        for (int br : brs)
+            branchColors[MobilizedBodyIndex(br)].push_back(color);
+    }
+
+    // Lay out the rows; every equation of a block has entries for all the 
+    // mobilities of the block's branches.
+    m_start.assign(m+1, 0);
+    for (unsigned b=0; b < equations.size(); ++b) {
+        int len = 0;
+        for (int br : branches[b])
+            len += (int)branchU[MobilizedBodyIndex(br)].size();
+        for (int j : equations[b])
+            m_start[j+1] = len;
+    }
+    for (int j=0; j < m; ++j)
+        m_start[j+1] += m_start[j];
+    const int nnz = m_start[m];
+    m_uIndex.resize(nnz); m_G.resize(nnz); m_W.resize(nnz);
+    for (unsigned b=0; b < equations.size(); ++b)
+        for (int j : equations[b]) {
+            int e = m_start[j];
+            for (int br : branches[b])
+                for (int u : branchU[MobilizedBodyIndex(br)])
+                    m_uIndex[e++] = u;
+        }
+
+    // Probe one equation from each block of a color at a time.
+    m_diag.resize(m);
+    m_diag.setToZero();
+    Vector lambda(m, Real(0)), f(nu), w(nu);
+    for (const Array_<int>& blocks : colors) {
+        unsigned maxEqs = 0;
+        for (int b : blocks)
+            maxEqs = std::max(maxEqs, equations[b].size());
+        for (unsigned k=0; k < maxEqs; ++k) {
+            for (int b : blocks)
+                if (k < equations[b].size())
+                    lambda[equations[b][k]] = 1;
+            matter.multiplyByGTranspose(s, lambda, f);
+            matter.multiplyByMInv(s, f, w);
+            ++m_numProbes;
+            for (int b : blocks) {
+                if (k >= equations[b].size())
+                    continue;
+                const int j = equations[b][k];
+                lambda[j] = 0;
+                Real Ajj = 0;
+                for (int e=m_start[j]; e < m_start[j+1]; ++e) {
+                    const int u = m_uIndex[e];
+                    m_G[e] = f[u]; m_W[e] = w[u];
+                    Ajj += f[u]*w[u];
+                }
+                m_diag[j] = Ajj;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//                          MULTIPLY ROW BY VELOCITY
+//------------------------------------------------------------------------------
+Real ImpulseSolver::SparseCompliance::
+multiplyRowByVelocity(MultiplierIndex j, const Vector& du) const {
+    assert(du.size() == m_nu && du.hasContiguousData());
+    const Real* dup = &du[0];
+    Real sum = 0;
+    for (int e=m_start[j]; e < m_start[j+1]; ++e)
+        sum += m_G[e]*dup[m_uIndex[e]];
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+//                          ADD COLUMN TO VELOCITY
+//------------------------------------------------------------------------------
+void ImpulseSolver::SparseCompliance::
+addColumnToVelocity(MultiplierIndex j, Real s, Vector& du) const {
+    assert(du.size() == m_nu && du.hasContiguousData());
+    Real* dup = &du[0];
+    for (int e=m_start[j]; e < m_start[j+1]; ++e)
+        dup[m_uIndex[e]] += s*m_W[e];
+}
+
+//------------------------------------------------------------------------------
+//                                MULTIPLY
+//------------------------------------------------------------------------------
+void ImpulseSolver::SparseCompliance::
+multiply(const Vector& pi, Vector& Api) const {
+    const int m = size();
+    assert(pi.size() == m);
+    Vector du(m_nu, Real(0));
+    for (MultiplierIndex j(0); j < m; ++j)
+        if (pi[j] != 0)
+            addColumnToVelocity(j, pi[j], du);
+    Api.resize(m);
+    for (MultiplierIndex i(0); i < m; ++i)
+        Api[i] = multiplyRowByVelocity(i, du);
+}
+
+//------------------------------------------------------------------------------
+//                               CALC MATRIX
+//------------------------------------------------------------------------------
+void ImpulseSolver::SparseCompliance::
+calcMatrix(Matrix& A) const {
+    const int m = size();
+    A.resize(m, m);
+    Vector du(m_nu, Real(0));
+    for (MultiplierIndex j(0); j < m; ++j) {
+        addColumnToVelocity(j, 1, du);
+        for (MultiplierIndex i(0); i < m; ++i)
+            A(i,j) = multiplyRowByVelocity(i, du);
+        addColumnToVelocity(j, -1, du);
+    }
+}
+
+//------------------------------------------------------------------------------
+//                               CALC SUBSET
+//------------------------------------------------------------------------------
+void ImpulseSolver::SparseCompliance::
+calcSubset(const Array_<MultiplierIndex>& rows, SparseCompliance& sub) const {
+    const int ms = (int)rows.size();
+    // The mobilities involved, in increasing order; their positions are the
+    // new mobility numbers.
+    Array_<int> us;
+    for (MultiplierIndex j : rows)
+        us.insert(us.end(), m_uIndex.begin()+m_start[j], 
+                            m_uIndex.begin()+m_start[j+1]);
+    std::sort(us.begin(), us.end());
+    us.erase(std::unique(us.begin(), us.end()), us.end());
+
+    sub.m_nu = (int)us.size();
+    sub.m_numProbes = 0;
+    sub.m_start.resize(ms+1);
+    sub.m_start[0] = 0;
+    for (int i=0; i < ms; ++i)
+        sub.m_start[i+1] = sub.m_start[i] 
+                           + m_start[rows[i]+1] - m_start[rows[i]];
+    const int nnz = sub.m_start[ms];
+    sub.m_uIndex.resize(nnz); sub.m_G.resize(nnz); sub.m_W.resize(nnz);
+    sub.m_diag.resize(ms);
+    for (int i=0; i < ms; ++i) {
+        const MultiplierIndex j = rows[i];
+        int es = sub.m_start[i];
+        for (int e=m_start[j]; e < m_start[j+1]; ++e, ++es) {
+            sub.m_uIndex[es] = (int)(std::lower_bound(us.begin(), us.end(),
+                                     m_uIndex[e]) - us.begin());
+            sub.m_G[es] = m_G[e];
+            sub.m_W[es] = m_W[e];
+        }
+        sub.m_diag[i] = m_diag[j];
+    }
+}
+
 } // namespace SimTK
\ No newline at end of file
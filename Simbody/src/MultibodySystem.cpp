@@ -179,16 +179,46 @@ int MultibodySystemRep::realizeTopologyImpl(State& s) const {
     assert(globalSub.isValid());
     assert(matterSub.isValid());
 
+    // Subsystems whose topology hasn't changed may still be realized in the
+    // State, and must be left alone. But everything else depends on the 
+    // Matter subsystem, so if that one has to be realized they all do.
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    if (matter.getStage(s) < Stage::Topology) {
+        for (SubsystemIndex i(0); i < getNumSubsystems(); ++i)
+            if (getSubsystem(i).getStage(s) >= Stage::Topology)
+                s.invalidateSubsystemTopology(i);
+    }
+
     // We do Matter subsystem first here in case any of the GlobalSubsystem
     // topology depends on Matter topology. That's unlikely though since
     // we don't know sizes until Model stage.
-    getMatterSubsystem().getRep().realizeSubsystemTopology(s);
-    getGlobalSubsystem().getRep().realizeSubsystemTopology(s);
-    for (int i=0; i < (int)forceSubs.size(); ++i)
-        getForceSubsystem(forceSubs[i]).getRep().realizeSubsystemTopology(s);
-
-    if (hasDecorationSubsystem())
-        getDecorationSubsystem().getGuts().realizeSubsystemTopology(s);
+    if (matter.getStage(s) < Stage::Topology)
+        matter.getRep().realizeSubsystemTopology(s);
+
+    // The GlobalSubsystem needs to know whether to make room for slow forces.
+    bool haveSlowForces = false;
+    for (int i=0; i < (int)forceSubs.size() && !haveSlowForces; ++i)
+        haveSlowForces = getForceSubsystem(forceSubs[i]).getRep().hasSlowForces();
+    const MultibodySystemGlobalSubsystemRep& global = 
+        getGlobalSubsystem().getRep();
+    if (haveSlowForces != global.getHaveSlowForces()
+        && global.getStage(s) >= Stage::Topology)
+        s.invalidateSubsystemTopology(globalSub);
+    global.setHaveSlowForces(haveSlowForces);
+
+    if (global.getStage(s) < Stage::Topology)
+        global.realizeSubsystemTopology(s);
+    for (int i=0; i < (int)forceSubs.size(); ++i) {
+        const ForceSubsystem& forces = getForceSubsystem(forceSubs[i]);
+        if (forces.getStage(s) < Stage::Topology)
+            forces.getRep().realizeSubsystemTopology(s);
+    }
+
+    if (hasDecorationSubsystem()) {
+        const DecorationSubsystem& decorations = getDecorationSubsystem();
+        if (decorations.getStage(s) < Stage::Topology)
+            decorations.getGuts().realizeSubsystemTopology(s);
+    }
 
     return 0;
 }
@@ -260,8 +290,55 @@ int MultibodySystemRep::realizeDynamicsImpl(const State& s) const {
     getMatterSubsystem().getRep().realizeSubsystemDynamics(s);
 
     // Now do forces in case any of them need dynamics-stage operators.
-    for (int i=0; i < (int)forceSubs.size(); ++i)
-        getForceSubsystem(forceSubs[i]).getRep().realizeSubsystemDynamics(s);
+    const MultibodySystemGlobalSubsystemRep& global = 
+        getGlobalSubsystem().getRep();
+    if (!global.getHaveSlowForces()) {
+        for (int i=0; i < (int)forceSubs.size(); ++i)
+            getForceSubsystem(forceSubs[i]).getRep().realizeSubsystemDynamics(s);
+    } else {
+        // Slow forces must be kept separate so that they can be held. While
+        // they are held, their values were applied by the GlobalSubsystem so
+        // slow force subsystems are skipped altogether. Otherwise the 
+        // GlobalSubsystem left the force entry zero so that it holds only the
+        // forces of the slow subsystems once those have been realized. Those
+        // are moved to the slow forces, and the slow forces are added in once
+        // all the other forces have been calculated.
+        const bool slowForcesHeld = global.areSlowForcesHeld(s);
+        ForceCacheEntry& forces = global.updForceCacheEntry(s,Stage::Dynamics);
+        for (int i=0; i < (int)forceSubs.size(); ++i) {
+            const ForceSubsystem::Guts& forceSub = 
+                getForceSubsystem(forceSubs[i]).getRep();
+            if (!forceSub.isSlow())
+                continue;
+            if (slowForcesHeld) // mark it realized so System::Guts doesn't
+                s.advanceSubsystemToStage(forceSub.getMySubsystemIndex(),
+                                          Stage::Dynamics);
+            else
+                forceSub.realizeSubsystemDynamics(s);
+        }
+
+        ForceCacheEntry& slowForces = global.updSlowForces(s);
+        if (!slowForcesHeld) {
+            slowForces.rigidBodyForces += forces.rigidBodyForces;
+            slowForces.particleForces  += forces.particleForces;
+            slowForces.mobilityForces  += forces.mobilityForces;
+            forces.initializeFromSimilarForceEntry
+               (global.getForceCacheEntry(s, Stage::Velocity));
+        }
+
+        for (int i=0; i < (int)forceSubs.size(); ++i) {
+            const ForceSubsystem::Guts& forceSub = 
+                getForceSubsystem(forceSubs[i]).getRep();
+            if (!forceSub.isSlow())
+                forceSub.realizeSubsystemDynamics(s);
+        }
+
+        if (!slowForcesHeld) {
+            forces.rigidBodyForces += slowForces.rigidBodyForces;
+            forces.particleForces  += slowForces.particleForces;
+            forces.mobilityForces  += slowForces.mobilityForces;
+        }
+    }
 
     if (hasDecorationSubsystem())
         getDecorationSubsystem().getGuts().realizeSubsystemDynamics(s);
@@ -300,6 +377,67 @@ int MultibodySystemRep::realizeReportImpl(const State& s) const {
     return 0;
 }
 
+// This is a semi-analytic approximation that is good enough for the Newton
+// iterations of an implicit integrator. With the force elements' mobility-
+// space stiffness K and damping D (and qdot=N*u), the nonzero blocks of J are
+//      d qdot/d u = N
+//      d udot/d q = -M^-1 K pinv(N)
+//      d udot/d u = -M^-1 D
+// We neglect d qdot/d q, the inertial (Coriolis and gyroscopic) and 
+// geometric terms, constraints, and forces that don't report their stiffness.
+// Those change slowly compared to the stiff force elements that make an
+// implicit integrator worthwhile. Everything is done with O(n) operators so
+// the cost is O(n^2), rather than the n full realizations needed to form J
+// numerically.
+bool MultibodySystemRep::
+calcStateDerivativeJacobianImpl(const State& s, Matrix& J) const {
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    const SimbodyMatterSubsystemRep& rep = matter.getRep();
+    const int ny = s.getNY(), nqSys = s.getNQ();
+    const int nq = matter.getNQ(s), nu = matter.getNU(s);
+    const int q0 = matter.getQStart(s), u0 = nqSys + matter.getUStart(s);
+
+    J.resize(ny, ny);
+    J = 0;
+
+    Matrix K(nu, nu, Real(0)), D(nu, nu, Real(0));
+    for (int i=0; i < (int)forceSubs.size(); ++i)
+        getForceSubsystem(forceSubs[i]).getRep()
+            .addInStiffnessAndDamping(s, K, D);
+
+    Vector in(nu, Real(0)), out;
+
+    // d qdot/d u = N, one column at a time.
+    for (int j=0; j < nu; ++j) {
+        in[j] = 1;
+        rep.multiplyByN(s, false, in, out);
+        in[j] = 0;
+        J(u0+j)(q0, nq) = out;
+    }
+
+    // d udot/d u = -M^-1 D.
+    for (int j=0; j < nu; ++j) {
+        in = D(j);
+        matter.multiplyByMInv(s, in, out);
+        J(u0+j)(u0, nu) = out *= -1;
+    }
+
+    // d udot/d q = -M^-1 (K pinv(N)). Form the rows of K*pinv(N) using
+    // ~pinv(N) * ~(row of K), then its columns times -M^-1.
+    Matrix KNinv(nu, nq);
+    for (int i=0; i < nu; ++i) {
+        in = ~K[i];
+        rep.multiplyByNInv(s, true, in, out);
+        KNinv[i] = ~out;
+    }
+    for (int j=0; j < nq; ++j) {
+        in = KNinv(j);
+        matter.multiplyByMInv(s, in, out);
+        J(q0+j)(u0, nu) = out *= -1;
+    }
+    return true;
+}
+
 
     ///////////////////////////////////////
     // MULTIBODY SYSTEM GLOBAL SUBSYSTEM //
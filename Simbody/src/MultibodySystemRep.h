@@ -99,17 +99,47 @@ inline std::ostream& operator<<(std::ostream& o, const ForceCacheEntry&)
 
 
 
+//==============================================================================
+//                             HELD SLOW FORCES
+//==============================================================================
+/* This Dynamics-stage discrete variable of the MultibodySystemGlobalSubsystem
+records whether the System's slow forces are currently being held (see
+System::holdSlowForces()) and if so, their values. It exists only if some
+force element or force subsystem has been marked slow. */
+struct HeldSlowForces {
+    HeldSlowForces() : held(false) {}
+    // default copy constructor, copy assignment, destructor
+
+    bool            held;
+    ForceCacheEntry forces;
+};
+
+// Useless, but required by Value<T>.
+inline std::ostream& operator<<(std::ostream& o, const HeldSlowForces&) 
+{assert(false);return o;}
+
+
+
 //==============================================================================
 //                   MULTIBODY SYSTEM GLOBAL SUBSYSTEM REP
 //==============================================================================
 /* This is the subsystem used by a MultibodySystem to manage global state
 calculations like forces and potential energy. */
 class MultibodySystemGlobalSubsystemRep : public Subsystem::Guts {
+    friend class MultibodySystemRep;
+
     // Topological variables
 
     static const int NumForceCacheEntries = (Stage::Dynamics-Stage::Model+1);
     mutable CacheEntryIndex forceCacheIndices[NumForceCacheEntries]; // where in state to find our stuff
 
+    // These are allocated only if there are slow forces. The cache entry 
+    // collects the slow forces calculated at Dynamics stage when they aren't
+    // being held, so that they can be.
+    mutable bool                  haveSlowForces;
+    mutable DiscreteVariableIndex heldSlowForcesIndex;
+    mutable CacheEntryIndex       slowForceCacheIndex;
+
     const ForceCacheEntry& getForceCacheEntry(const State& s, Stage g) const {
         assert(subsystemTopologyHasBeenRealized());
         SimTK_STAGECHECK_RANGE(Stage::Model, g, Stage::Dynamics,
@@ -128,7 +158,8 @@ class MultibodySystemGlobalSubsystemRep : public Subsystem::Guts {
     }
 public:
     MultibodySystemGlobalSubsystemRep()
-      : Subsystem::Guts("MultibodySystemGlobalSubsystem", "0.0.2")
+      : Subsystem::Guts("MultibodySystemGlobalSubsystem", "0.0.2"),
+        haveSlowForces(false)
     {
         invalidateSubsystemTopologyCache();
     }
@@ -157,6 +188,49 @@ public:
         return updForceCacheEntry(s,g).mobilityForces;
     }
 
+    // The MultibodySystem tells us before realizing our Topology stage 
+    // whether any of its forces are slow.
+    void setHaveSlowForces(bool haveSlow) const {haveSlowForces = haveSlow;}
+    bool getHaveSlowForces() const {return haveSlowForces;}
+
+    bool areSlowForcesHeld(const State& s) const {
+        return heldSlowForcesIndex.isValid()
+            && Value<HeldSlowForces>::downcast
+                   (getDiscreteVariable(s, heldSlowForcesIndex)).get().held;
+    }
+
+    // Slow forces calculated at Dynamics stage are added here rather than to
+    // the Dynamics-stage ForceCacheEntry; the MultibodySystem adds them in 
+    // when all the force subsystems are done. Only valid if there are slow
+    // forces.
+    ForceCacheEntry& updSlowForces(const State& s) const {
+        return Value<ForceCacheEntry>::updDowncast
+           (updCacheEntry(s, slowForceCacheIndex));
+    }
+
+    bool holdSlowForces(State& s) const {
+        if (!heldSlowForcesIndex.isValid())
+            return false;
+        if (areSlowForcesHeld(s))
+            return true;
+        // Copy the slow forces before updating the discrete variable, which
+        // invalidates the Dynamics stage cache.
+        const ForceCacheEntry slowForces = Value<ForceCacheEntry>::downcast
+           (getCacheEntry(s, slowForceCacheIndex));
+        HeldSlowForces& heldSlow = Value<HeldSlowForces>::updDowncast
+           (updDiscreteVariable(s, heldSlowForcesIndex));
+        heldSlow.forces = slowForces;
+        heldSlow.held = true;
+        return true;
+    }
+
+    void releaseSlowForces(State& s) const {
+        if (!areSlowForcesHeld(s))
+            return;
+        Value<HeldSlowForces>::updDowncast
+           (updDiscreteVariable(s, heldSlowForcesIndex)).upd().held = false;
+    }
+
     // These override virtual methods from Subsystem::Guts.
 
     // Use default copy constructor, but then clear out the cache indices
@@ -166,6 +240,8 @@ public:
             new MultibodySystemGlobalSubsystemRep(*this);
         for (int i=0; i<NumForceCacheEntries; ++i)
             p->forceCacheIndices[i].invalidate();
+        p->heldSlowForcesIndex.invalidate();
+        p->slowForceCacheIndex.invalidate();
         p->invalidateSubsystemTopologyCache();
         return p;
     }
@@ -180,6 +256,15 @@ public:
             forceCacheIndices[g-Stage::Model] = 
                 allocateCacheEntry(s, g, new Value<ForceCacheEntry>());
 
+        heldSlowForcesIndex.invalidate();
+        slowForceCacheIndex.invalidate();
+        if (haveSlowForces) {
+            heldSlowForcesIndex = allocateDiscreteVariable(s, Stage::Dynamics,
+                new Value<HeldSlowForces>());
+            slowForceCacheIndex = allocateCacheEntry(s, Stage::Dynamics,
+                new Value<ForceCacheEntry>());
+        }
+
         return 0;
     }
 
@@ -265,7 +350,33 @@ public:
         dynamicsForces.ensureAllocatedTo(matter.getNumBodies(),
                                          matter.getNumParticles(),
                                          matter.getNumMobilities());
-        dynamicsForces.initializeFromSimilarForceEntry(velocityForces);
+
+        // Held slow forces are applied from the start. Otherwise the slow
+        // forces will be collected as they are calculated, and the entry
+        // starts out zero so that the slow force subsystems can be realized
+        // into it first; the MultibodySystem then moves their forces to the
+        // slow forces and initializes the entry from the lower stages.
+        if (!haveSlowForces || areSlowForcesHeld(s))
+            dynamicsForces.initializeFromSimilarForceEntry(velocityForces);
+        else
+            dynamicsForces.setAllForcesToZero();
+
+        if (haveSlowForces) {
+            ForceCacheEntry& slowForces = updSlowForces(s);
+            slowForces.ensureAllocatedTo(matter.getNumBodies(),
+                                         matter.getNumParticles(),
+                                         matter.getNumMobilities());
+            slowForces.setAllForcesToZero();
+
+            const HeldSlowForces& heldSlow = Value<HeldSlowForces>::downcast
+               (getDiscreteVariable(s, heldSlowForcesIndex));
+            if (heldSlow.held) {
+                dynamicsForces.rigidBodyForces += 
+                    heldSlow.forces.rigidBodyForces;
+                dynamicsForces.particleForces += heldSlow.forces.particleForces;
+                dynamicsForces.mobilityForces += heldSlow.forces.mobilityForces;
+            }
+        }
 
         return 0;
     }
@@ -407,6 +518,14 @@ public:
         return getGlobalSubsystem().getRep().updMobilityForces(s,g);
     }
 
+    // Slow forces; see MultibodySystemGlobalSubsystemRep.
+    bool areSlowForcesHeld(const State& s) const {
+        return getGlobalSubsystem().getRep().areSlowForcesHeld(s);
+    }
+    ForceCacheEntry& updSlowForces(const State& s) const {
+        return getGlobalSubsystem().getRep().updSlowForces(s);
+    }
+
     // pure virtual
     MultibodySystemRep* cloneImpl() const override
     {   return new MultibodySystemRep(*this); }
@@ -444,6 +563,39 @@ public:
         mech.getRep().multiplyByNInv(s,true,fu,fq);
     }  
 
+    // G here is just the velocity constraint Jacobian [P;V], one row per 
+    // uerr, excluding acceleration-only constraints.
+    bool hasMassMatrixOperatorsImpl() const override {return true;}
+    void multiplyByMInvImpl(const State& s, const Vector& f, 
+                            Vector& MInvf) const override {
+        getMatterSubsystem().multiplyByMInv(s,f,MInvf);
+    }
+    void multiplyByGImpl(const State& s, const Vector& u, 
+                         Vector& Gu) const override {
+        const SimbodyMatterSubsystemRep& mech = getMatterSubsystem().getRep();
+        Vector bias;
+        mech.calcBiasForMultiplyByPVA(s,true,true,false,bias);
+        mech.multiplyByPVA(s,true,true,false,bias,u,Gu);
+    }
+    void multiplyByGTransposeImpl(const State& s, const Vector& lambda, 
+                                  Vector& f) const override {
+        const SimbodyMatterSubsystemRep& mech = getMatterSubsystem().getRep();
+        mech.multiplyByPVATranspose(s,true,true,false,lambda,f);
+    }
+
+    // The state derivative Jacobian is built from the stiffness and damping
+    // reported by the force subsystems; see MultibodySystem.cpp.
+    bool hasStateDerivativeJacobianImpl() const override {return true;}
+    bool calcStateDerivativeJacobianImpl(const State& s, 
+                                         Matrix& J) const override;
+
+    bool holdSlowForcesImpl(State& s) const override {
+        return getGlobalSubsystem().getRep().holdSlowForces(s);
+    }
+    void releaseSlowForcesImpl(State& s) const override {
+        getGlobalSubsystem().getRep().releaseSlowForces(s);
+    }
+
     // Currently prescribe() and project() affect only the Matter subsystem.
     bool prescribeQImpl(State& state) const override {
         const SimbodyMatterSubsystem& mech = getMatterSubsystem();
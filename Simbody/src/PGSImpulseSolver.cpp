@@ -104,15 +104,16 @@ void doRowSums(const Array_<int>& columns, // these are MultiplierIndex ints
 // Given a rowSum, update one element of pi and return the squared error.
 // If the corresponding diagonal of A is nonpositive, we will quietly skip
 // the update.
+template <class Ops>
 inline Real doUpdate(const MultiplierIndex& row,
-                     const Matrix&          A,
+                     const Ops&             A,
                      const Vector&          D,
                      const Vector&          rhs,
                      const Real&            SOR, // successive over relaxation
                      const Real&            rowSum,
                      Vector&                pi)
 {
-    Real Arr = A(row,row);
+    Real Arr = A.diag(row);
     if (D.size()) Arr += D[row];
     const Real er = rhs[row]-rowSum;
     if (Arr > Real(0))
@@ -122,8 +123,9 @@ inline Real doUpdate(const MultiplierIndex& row,
 
 // Same but now we're doing multiple row updates and return the sum of the
 // squared errors for those rows.
+template <class Ops>
 Real doUpdates(const Array_<int>& rows, // These are MultiplierIndex ints
-               const Matrix&                  A,
+               const Ops&                     A,
                const Vector&                  D,
                const Vector&                  rhs,
                const Real&                    SOR,
@@ -134,7 +136,7 @@ Real doUpdates(const Array_<int>& rows, // These are MultiplierIndex ints
     Real er2 = 0;
     for (unsigned i=0; i<rows.size(); ++i) {
         const MultiplierIndex row(rows[i]);
-        Real Arr = A(row,row);
+        Real Arr = A.diag(row);
         if (hasDiag) Arr += D[row];
         const Real er = rhs[row]-rowSums[i];
         if (Arr > Real(0))
@@ -212,6 +214,95 @@ boundFriction(Real mu,
     for (unsigned i=0; i<IF.size(); ++i) pi[IF[i]] *= scale;
     return ImpulseSolver::Sliding;
 }
+
+// Access to a dense A: packed and in column order, as required by doRowSum()
+// and doRowSums().
+class DenseOps {
+public:
+    explicit DenseOps(const Matrix& A) : m_A(A) {}
+    int size() const {return m_A.nrow();}
+    Real diag(MultiplierIndex row) const {return m_A(row,row);}
+
+    // Nothing to do; row sums look at pi directly.
+    void start(const Array_<MultiplierIndex>&, const Vector&) {}
+    void commit(MultiplierIndex, const Vector&) {}
+    template <class Rows> void commit(const Rows&, const Vector&) {}
+
+    Real rowSum(const Array_<MultiplierIndex>& columns, MultiplierIndex row,
+                const Vector& D, const Vector& pi) const
+    {   return doRowSum(columns, row, m_A, D, pi); }
+    void rowSums(const Array_<int>& columns, const Array_<int>& rows,
+                 const Vector& D, const Vector& pi, Array_<Real>& sums) const
+    {   doRowSums(columns, rows, m_A, D, pi, sums); }
+
+    // Api = A*piExpand where piExpand is nonzero only for the expanding rows.
+    void multiplyExpansion(const Array_<MultiplierIndex>& expanding,
+                           const Vector& piExpand, Vector& Api) const {
+        Api.resize(size());
+        for (MultiplierIndex mx(0); mx < size(); ++mx)
+            Api[mx] = multRowTimesSparseCol(m_A, mx, expanding, piExpand);
+    }
+    void multiply(const Vector& pi, Vector& Api) const {Api = m_A*pi;}
+private:
+    const Matrix& m_A;
+};
+
+// Access to a matrix-free A=G*W. We keep du=W*pi for the entries of pi that
+// have been committed, so the row sum A[row]*pi is just G[row]*du. Each group
+// of rows is committed after it has been updated and bounded, so the row sums
+// see the same pi as the dense ones do.
+class SparseOps {
+public:
+    explicit SparseOps(const ImpulseSolver::SparseCompliance& A) : m_A(A) {}
+    int size() const {return m_A.size();}
+    Real diag(MultiplierIndex row) const {return m_A.getDiag(row);}
+
+    // pi may be nonzero only for the participating rows.
+    void start(const Array_<MultiplierIndex>& participating, const Vector& pi) 
+    {   m_du.resize(m_A.getNumMobilities()); m_du.setToZero();
+        m_piInDu.resize(size()); m_piInDu.setToZero();
+        commit(participating, pi); }
+    void commit(MultiplierIndex row, const Vector& pi) {
+        const Real change = pi[row] - m_piInDu[row];
+        if (change != 0) {
+            m_A.addColumnToVelocity(row, change, m_du);
+            m_piInDu[row] = pi[row];
+        }
+    }
+    template <class Rows> void commit(const Rows& rows, const Vector& pi) {
+        for (unsigned i=0; i < rows.size(); ++i)
+            commit(MultiplierIndex(rows[i]), pi);
+    }
+
+    // The columns are implicit: only participating entries are in du.
+    Real rowSum(const Array_<MultiplierIndex>&, MultiplierIndex row,
+                const Vector& D, const Vector& pi) const 
+    {   return calcRowSum(row, D, pi); }
+    void rowSums(const Array_<int>&, const Array_<int>& rows,
+                 const Vector& D, const Vector& pi, Array_<Real>& sums) const {
+        sums.resize(rows.size());
+        for (unsigned i=0; i<rows.size(); ++i)
+            sums[i] = calcRowSum(MultiplierIndex(rows[i]), D, pi);
+    }
+
+    void multiplyExpansion(const Array_<MultiplierIndex>& expanding,
+                           const Vector& piExpand, Vector& Api) const {
+        Vector sparseCol(size(), Real(0));
+        for (unsigned nz(0); nz < expanding.size(); ++nz)
+            sparseCol[expanding[nz]] = piExpand[expanding[nz]];
+        m_A.multiply(sparseCol, Api);
+    }
+    void multiply(const Vector& pi, Vector& Api) const {m_A.multiply(pi, Api);}
+private:
+    Real calcRowSum(MultiplierIndex row, const Vector& D, const Vector& pi) const
+    {   Real rowSum = m_A.multiplyRowByVelocity(row, m_du);
+        if (D.size()) rowSum += D[row]*pi[row];
+        return rowSum; }
+
+    const ImpulseSolver::SparseCompliance& m_A;
+    Vector m_du;     // W*m_piInDu
+    Vector m_piInDu; // the values of pi included in m_du
+};
 }
 
 namespace SimTK {
@@ -301,10 +392,6 @@ solve(int                                 phase,
       Array_<StateLtdFrictionRT>&         stateLtdFriction
       ) const 
 {
-    SimTK_DEBUG("\n-----------------\n");
-    SimTK_DEBUG(  "START PGS SOLVER:\n");
-    ++m_nSolves[phase];
-
 #ifndef NDEBUG
    {FactorQTZ fac(A);
     cout << "A=" << A; cout << "D=" << D; 
@@ -319,9 +406,62 @@ solve(int                                 phase,
     cout << "x=" << x << endl;
     cout << "resid=" << A*x-verrDbg << endl;}
 #endif
+    assert(A.ncol()==A.nrow());
+
+    DenseOps ops(A);
+    return solveImpl(phase, participating, ops, D, expanding, piExpand,
+                     verrStart, verrApplied, pi, unconditional, uniContact,
+                     uniSpeed, bounded, consLtdFriction, stateLtdFriction);
+}
 
-    const int m=A.nrow();
-    assert(A.ncol()==m); assert(D.size()==m);
+bool PGSImpulseSolver::
+solve(int                                 phase,
+      const Array_<MultiplierIndex>&      participating, // p<=m of these 
+      const SparseCompliance&             A,     // m X m, matrix-free
+      const Vector&                       D,     // m, diag >= 0 added to A
+      const Array_<MultiplierIndex>&      expanding,
+      Vector&                             piExpand,   // m
+      Vector&                             verrStart, // m, in/out
+      Vector&                             verrApplied, // m
+      Vector&                             pi,         // m, piUnknown
+      Array_<UncondRT>&                   unconditional,
+      Array_<UniContactRT>&               uniContact, // with friction
+      Array_<UniSpeedRT>&                 uniSpeed,
+      Array_<BoundedRT>&                  bounded,
+      Array_<ConstraintLtdFrictionRT>&    consLtdFriction,
+      Array_<StateLtdFrictionRT>&         stateLtdFriction
+      ) const 
+{
+    SparseOps ops(A);
+    return solveImpl(phase, participating, ops, D, expanding, piExpand,
+                     verrStart, verrApplied, pi, unconditional, uniContact,
+                     uniSpeed, bounded, consLtdFriction, stateLtdFriction);
+}
+
+template <class Ops>
+bool PGSImpulseSolver::
+solveImpl(int                                 phase,
+          const Array_<MultiplierIndex>&      participating,
+          Ops&                                A,
+          const Vector&                       D,
+          const Array_<MultiplierIndex>&      expanding,
+          Vector&                             piExpand,
+          Vector&                             verrStart,
+          Vector&                             verrApplied,
+          Vector&                             pi,
+          Array_<UncondRT>&                   unconditional,
+          Array_<UniContactRT>&               uniContact,
+          Array_<UniSpeedRT>&                 uniSpeed,
+          Array_<BoundedRT>&                  bounded,
+          Array_<ConstraintLtdFrictionRT>&    consLtdFriction,
+          Array_<StateLtdFrictionRT>&         stateLtdFriction) const
+{
+    SimTK_DEBUG("\n-----------------\n");
+    SimTK_DEBUG(  "START PGS SOLVER:\n");
+    ++m_nSolves[phase];
+
+    const int m=A.size();
+    assert(D.size()==m);
     assert(verrStart.size()==m); 
     assert(verrApplied.size()==0 || verrApplied.size()==m);
     assert(piExpand.size()==m); 
@@ -333,17 +473,27 @@ solve(int                                 phase,
     pi.resize(m);
     pi.setToZero(); // Use this for piUnknown
 
+    // Start from the initial guess if there is one.
+    if (m_piGuess.size() == m)
+        for (int k=0; k < p; ++k) {
+            const MultiplierIndex mx = participating[k];
+            if (!isNaN(m_piGuess[mx]))
+                pi[mx] = m_piGuess[mx];
+        }
+    A.start(participating, pi);
+
     // If there are applied forces, add them to the rhs.
     if (verrApplied.size()) 
         verrStart += verrApplied;
 
     // Move expansion impulse to RHS. We will always apply the full expansion
     // impulse in one interval in this solver.
-    if (nx) 
-        for (MultiplierIndex mx(0); mx < m; ++mx) {
-            verrStart[mx] -= multRowTimesSparseCol(A,mx,expanding,piExpand)
-                             + D[mx]*piExpand[mx];
-        }
+    if (nx) {
+        Vector Aexp;
+        A.multiplyExpansion(expanding, piExpand, Aexp);
+        for (MultiplierIndex mx(0); mx < m; ++mx)
+            verrStart[mx] -= Aexp[mx] + D[mx]*piExpand[mx];
+    }
 
     // Now rhs = verrStart + verrApplied - [A+D]*piExpand.
     #ifndef NDEBUG
@@ -403,8 +553,9 @@ solve(int                                 phase,
         // UNCONDITIONAL: these are always on.
         for (int k=0; k < mUncond; ++k) {
             const UncondRT& rt = unconditional[k];
-            doRowSums(participating,rt.m_mults,A,D,pi,rowSums);
+            A.rowSums(participating,rt.m_mults,D,pi,rowSums);
             const Real er2=doUpdates(rt.m_mults,A,D,verrStart,sor,rowSums,pi);
+            A.commit(rt.m_mults, pi);
             sum2all += er2; sum2enf += er2;
         }
 
@@ -414,10 +565,11 @@ solve(int                                 phase,
             if (rt.m_type != Participating)
                 continue;
             const MultiplierIndex Nk = rt.m_Nk;
-            const Real rowSum=doRowSum(participating,Nk,A,D,pi);
+            const Real rowSum=A.rowSum(participating,Nk,D,pi);
             const Real er2=doUpdate(Nk,A,D,verrStart,sor,rowSum,pi);
             sum2all += er2;
             rt.m_contactCond = boundUnilateral(rt.m_sign, pi[Nk]);
+            A.commit(Nk, pi);
             if (rt.m_contactCond == UniActive)
                 sum2enf += er2;
         }
@@ -430,11 +582,12 @@ solve(int                                 phase,
                 continue;
             const MultiplierIndex Nk = rt.m_Nk;
             const Array_<MultiplierIndex>& Fk = rt.m_Fk;
-            doRowSums(participating,Fk,A,D,pi,rowSums);
+            A.rowSums(participating,Fk,D,pi,rowSums);
             const Real er2=doUpdates(Fk,A,D,verrStart,sor,rowSums,pi);
             sum2all += er2;
             Real N = std::abs(pi[Nk] + piExpand[Nk]);
             rt.m_frictionCond=boundVector(rt.m_effMu*N, Fk, pi);
+            A.commit(Fk, pi);
             if (rt.m_frictionCond==Rolling)
                 sum2enf += er2;
         }
@@ -444,10 +597,11 @@ solve(int                                 phase,
         for (int k=0; k < mBounded; ++k) {
             BoundedRT& rt = bounded[k];
             const MultiplierIndex rx = rt.m_ix;
-            const Real rowSum=doRowSum(participating,rx,A,D,pi);
+            const Real rowSum=A.rowSum(participating,rx,D,pi);
             const Real er2=doUpdate(rx,A,D,verrStart,sor,rowSum,pi);
             sum2all += er2;
             rt.m_boundedCond=boundScalar(rt.m_lb, pi[rx], rt.m_ub);
+            A.commit(rx, pi);
             if (rt.m_boundedCond == Engaged)
                 sum2enf += er2;
         }
@@ -457,10 +611,11 @@ solve(int                                 phase,
         for (int k=0; k < mStateLtd; ++k) {
             StateLtdFrictionRT& rt = stateLtdFriction[k];
             const Array_<MultiplierIndex>& Fk = rt.m_Fk;
-            doRowSums(participating,Fk,A,D,pi,rowSums);
+            A.rowSums(participating,Fk,D,pi,rowSums);
             const Real localEr2=doUpdates(Fk,A,D,verrStart,sor,rowSums,pi);
             sum2all += localEr2;
             rt.m_frictionCond=boundVector(rt.m_effMu*rt.m_knownN, Fk, pi);
+            A.commit(Fk, pi);
             if (rt.m_frictionCond==Rolling)
                 sum2enf += localEr2;
         }
@@ -472,10 +627,11 @@ solve(int                                 phase,
             ConstraintLtdFrictionRT& rt = consLtdFriction[k];
             const Array_<int>& Fk = rt.m_Fk; // friction components
             const Array_<int>& Nk = rt.m_Nk; // normal components
-            doRowSums(participating,Fk,A,D,pi,rowSums);
+            A.rowSums(participating,Fk,D,pi,rowSums);
             const Real localEr2=doUpdates(Fk,A,D,verrStart,sor,rowSums,pi);
             sum2all += localEr2;
             rt.m_frictionCond=boundFriction(rt.m_effMu,Nk,Fk,pi);
+            A.commit(Fk, pi);
             if (rt.m_frictionCond==Rolling)
                 sum2enf += localEr2;
         }
@@ -519,7 +675,9 @@ solve(int                                 phase,
         ++m_nFail[phase];
     }
 
-    verrStart -= A*pi;
+    Vector Api;
+    A.multiply(pi, Api);
+    verrStart -= Api;
     verrStart -= D.elementwiseMultiply(pi);
     #ifndef NDEBUG
     cout << "FINAL@" << its << " pi=" << pi << " verr=" << verrStart
@@ -540,15 +698,40 @@ solveBilateral
     const Vector&                   rhs,   // m, RHS
     Vector&                         pi     // m, unknown result
     ) const
+{
+    assert(A.ncol()==A.nrow());
+    DenseOps ops(A);
+    return solveBilateralImpl(participating, ops, D, rhs, pi);
+}
+
+bool PGSImpulseSolver::
+solveBilateral
+   (const Array_<MultiplierIndex>&  participating, // p<=m of these 
+    const SparseCompliance&         A,     // m X m, matrix-free
+    const Vector&                   D,     // m, diag>=0 added to A
+    const Vector&                   rhs,   // m, RHS
+    Vector&                         pi     // m, unknown result
+    ) const
+{
+    SparseOps ops(A);
+    return solveBilateralImpl(participating, ops, D, rhs, pi);
+}
+
+template <class Ops>
+bool PGSImpulseSolver::
+solveBilateralImpl(const Array_<MultiplierIndex>&  participating,
+                   Ops&                            A,
+                   const Vector&                   D,
+                   const Vector&                   rhs,
+                   Vector&                         pi) const
 {
     SimTK_DEBUG("--------------------------------\n");
     SimTK_DEBUG(  "PGS BILATERAL SOLVER:\n");
     ++m_nBilateralSolves;
 
-    const int m=A.nrow(); 
+    const int m=A.size(); 
     const int p = (int)participating.size();
 
-    assert(A.ncol()==m); 
     assert(D.size()==0 || D.size()==m);
     assert(rhs.size()==m);
     assert(p<=m);
@@ -556,6 +739,15 @@ solveBilateral
     pi.resize(m);
     pi.setToZero(); // That takes care of all non-participators.
 
+    // Start from the initial guess if there is one.
+    if (m_piGuess.size() == m)
+        for (int k=0; k < p; ++k) {
+            const MultiplierIndex mx = participating[k];
+            if (!isNaN(m_piGuess[mx]))
+                pi[mx] = m_piGuess[mx];
+        }
+    A.start(participating, pi);
+
     if (p == 0) {
         SimTK_DEBUG("  no bilateral participators. Nothing to do.\n");
         SimTK_DEBUG("--------------------------------\n");
@@ -579,8 +771,9 @@ solveBilateral
         Array_<MultiplierIndex> mults(1);
         for (int k=0; k < p; ++k) {
             mults[0] = participating[k];
-            doRowSums(participating,mults,A,D,pi,rowSums);
+            A.rowSums(participating,mults,D,pi,rowSums);
             const Real localEr2=doUpdates(mults,A,D,rhs,sor,rowSums,pi);
+            A.commit(mults[0], pi);
             sum2enf += localEr2;
         }
 
@@ -617,13 +810,14 @@ solveBilateral
     }
 
     #ifndef NDEBUG
-    cout << "A=" << A;
+   {Vector Api;
+    A.multiply(pi, Api);
     cout << "D=" << D << endl;
     cout << "rhs=" << rhs << endl;
     cout << "active=" << participating << endl;
     cout << "-> pi=" << pi << endl;
-    if (D.size()) cout << "resid=" << A*pi+D.elementwiseMultiply(pi)-rhs << endl;
-    else cout << "resid=" << A*pi-rhs << endl;
+    if (D.size()) cout << "resid=" << Api+D.elementwiseMultiply(pi)-rhs << endl;
+    else cout << "resid=" << Api-rhs << endl;}
     #endif
     SimTK_DEBUG("--------------------------------\n");
     return converged;
@@ -28,6 +28,7 @@
 
 #include "SimbodyMatterSubsystemRep.h"
 
+#include <algorithm>
 #include <iostream>
 using std::cout; using std::endl;
 
@@ -48,6 +49,9 @@ namespace {
         DefImpulseSolverType   = SemiExplicitEulerTimeStepper::PLUS;
     const SemiExplicitEulerTimeStepper::PositionProjectionMethod 
         DefPosProjMethod = SemiExplicitEulerTimeStepper::Bilateral;
+    const bool  DefUseMatrixFree       = false;
+    const bool  DefWarmStart           = true;
+    const bool  DefUseIslands          = false;
 }
 
 namespace SimTK {
@@ -64,13 +68,24 @@ SemiExplicitEulerTimeStepper(const MultibodySystem& mbs)
     m_maxInducedImpactsPerStep(DefMaxInducedImpactsPerStep),
     m_projectionMethod(DefPosProjMethod),
     m_solverType(DefImpulseSolverType), 
+    m_useMatrixFree(DefUseMatrixFree),
+    m_warmStart(DefWarmStart),
+    m_useIslands(DefUseIslands),
     m_defaultCaptureVelocity(0),    // means: use 2 x constraintTol
     m_defaultMinCORVelocity(0),     // means: use capture velocity
     m_defaultTransitionVelocity(0), // means: use 2 x constraintTol
     m_minSignificantForce(DefMinSignificantForce),
-    m_solver(0)
+    m_solver(0),
+    m_numIslands(0)
 {}
 
+//------------------------------------------------------------------------------
+//                          SET NUMBER OF THREADS
+//------------------------------------------------------------------------------
+void SemiExplicitEulerTimeStepper::setNumberOfThreads(int numThreads) {
+    m_threads.setNumberOfThreads(numThreads, "SemiExplicitEulerTimeStepper");
+}
+
 
 //------------------------------------------------------------------------------
 //                                 STEP TO
@@ -104,18 +119,34 @@ stepTo(Real time) {
     const int m = verr0.size();
 
     if (m==0) {
+        m_prevUniContactForce.clear(); // no contacts to warm start
+        m_numIslands = 0;
         takeUnconstrainedStep(s, h);
         return Integrator::ReachedScheduledEvent;
     }
 
+    // Find the groups of bodies that the constraints in use don't connect.
+    if (m_useIslands)
+        findIslands(s);
+    else
+        m_numIslands = 1;
+
     // Friction coefficient is fixed by initial slip velocity and doesn't change
     // during impact processing even though the slip velocity will change.
     // The logic is that it takes time for surface asperities to engage or
     // separate and no time is going by during an impact.
     calcCoefficientsOfFriction(s, verr0);
 
-    // Calculate the constraint compliance matrix A=GM\~G.
-    matter.calcProjectedMInv(s, m_GMInvGt); // m X m
+    // Calculate the constraint compliance matrix A=GM\~G, or its matrix-free
+    // equivalent. If the problem splits into islands, each island's dense
+    // block is formed from only its own rows of the matrix-free form, so the
+    // full A is formed only if a solve later turns out not to split; it is
+    // left empty until then.
+    if (m_useMatrixFree || m_numIslands > 1) {
+        m_compliance.calc(matter, s);
+        m_GMInvGt.clear();
+    } else
+        matter.calcProjectedMInv(s, m_GMInvGt); // m X m
 
     // TODO: this is for soft constraints. D >= 0.
     m_D.resize(m); m_D.setToZero();
@@ -314,7 +345,10 @@ stepTo(Real time) {
     // that velocity is what's in verr0.
     Vector verrStart = verr0;
     // Use lambda as a temp here; we are really calculating lambda*h.
+    if (m_warmStart)
+        setWarmStartGuess(h);
     doCompressionPhase(s, verrStart, m_verr, lambda);
+    m_solver->clearInitialGuess();
     #ifndef NDEBUG
     cout << "   dynamics impulse=" << lambda << endl;
     cout << "   updated verrStart=" << verrStart << endl;
@@ -324,6 +358,8 @@ stepTo(Real time) {
     // Convert multipliers from impulses to forces. These are the multipliers
     // reported at end of step.
     lambda /= h;
+    if (m_warmStart)
+        saveWarmStartForces(lambda);
 
     // Calculate constraint forces ~G*lambda (body frcs Fc, mobility frcs fc).
     Vector_<SpatialVec> Fc; Vector fc; 
@@ -719,6 +755,7 @@ classifyUnilateralContactsForSimultaneousImpact
 void SemiExplicitEulerTimeStepper::initialize(const State& initState) {
     m_state = initState;
     m_mbs.realize(m_state, Stage::Acceleration);
+    m_prevUniContactForce.clear();
 
     if (!m_solver) {
         const Real transVel = getDefaultFrictionTransitionVelocityInUse();
@@ -734,6 +771,10 @@ void SemiExplicitEulerTimeStepper::initialize(const State& initState) {
     // Make sure the impulse solve knows our tolerance for slip velocity
     // during rolling.
     m_solver->setMaxRollingSpeed(getDefaultFrictionTransitionVelocityInUse());
+    m_solver->clearInitialGuess();
+
+    // Island solvers are cloned from the solver as needed.
+    m_islandSolvers.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -1145,8 +1186,8 @@ calcExpansionImpulseIfAny(const State& s, const Array_<int>& impacters,
 //------------------------------------------------------------------------------
 //                         DO COMPRESSION PHASE
 //------------------------------------------------------------------------------
-// This phase uses all the proximal constraints and should use a starting
-// guess for impulse saved from the last step if possible.
+// This phase uses all the proximal constraints and starts from the guess for
+// impulse saved from the last step, if the solver has been given one.
 bool SemiExplicitEulerTimeStepper::
 doCompressionPhase(const State& s, Vector& verrStart, Vector& verrApplied, 
                    Vector& compImpulse) 
@@ -1156,10 +1197,9 @@ doCompressionPhase(const State& s, Vector& verrStart, Vector& verrApplied,
     cout << "  verrStart=" << verrStart << endl;
     cout << "  verrApplied=" << verrApplied << endl;
 #endif
-    // TODO: improve initial guess
     m_expansionImpulse.setToZero(); //TODO: shouldn't need to zero this
-    bool converged = m_solver->solve(0,
-        m_allParticipating,m_GMInvGt,m_D,
+    bool converged = solveForImpulses(0,
+        m_allParticipating,
         Array_<MultiplierIndex>(), m_expansionImpulse, 
         verrStart, verrApplied, 
         compImpulse,
@@ -1184,8 +1224,8 @@ doExpansionPhase(const State&   state,
                  Vector&        verrStart, 
                  Vector&        reactionImpulse) {
     // TODO: improve initial guess
-    bool converged = m_solver->solve(1,
-        m_participating,m_GMInvGt,m_D,
+    bool converged = solveForImpulses(1,
+        m_participating,
         expanding,expansionImpulse, verrStart,m_emptyVector,
         reactionImpulse,
         m_unconditional,m_uniContact,m_uniSpeed,m_bounded,
@@ -1209,8 +1249,8 @@ doInducedImpactRound(const State& s,
 #ifndef NDEBUG
     printf("IMP t=%.15g verr=", s.getTime()); cout << verrStart << endl;
 #endif
-    bool converged = m_solver->solve(0,
-        m_participating,m_GMInvGt,m_D,
+    bool converged = solveForImpulses(0,
+        m_participating,
         expanding,expansionImpulse, verrStart,m_emptyVector,
         impulse,
         m_unconditional,m_uniContact,m_uniSpeed,m_bounded,
@@ -1233,8 +1273,8 @@ doPositionCorrectionPhase(const State& state, Vector& pverr,
         SimTK_DEBUG1("UNILATERAL POSITION CORRECTION, %d participators\n",
                      (int)m_posParticipating.size());
         m_expansionImpulse.setToZero(); //TODO: shouldn't need to zero this
-        converged = m_solver->solve(2,
-            m_posParticipating,m_GMInvGt,m_D,
+        converged = solveForImpulses(2,
+            m_posParticipating,
             Array_<MultiplierIndex>(), m_expansionImpulse,
             pverr, m_emptyVector,
             positionImpulse,
@@ -1255,8 +1295,8 @@ doPositionCorrectionPhase(const State& state, Vector& pverr,
         }
         SimTK_DEBUG1("BILATERAL POSITION CORRECTION, %d participators\n",
                     (int)m_participating.size());
-        converged = m_solver->solveBilateral(m_participating,m_GMInvGt,m_D,
-                                             pverr, positionImpulse);
+        converged = solveBilateralForImpulses(m_participating,
+                                              pverr, positionImpulse);
     }
     return converged;
 }
@@ -1273,6 +1313,483 @@ anyPositionErrorsViolated(const State&, const Vector& perr) const {
     return anyViolated;
 }
 
+//------------------------------------------------------------------------------
+//                           SOLVE FOR IMPULSES
+//------------------------------------------------------------------------------
+bool SemiExplicitEulerTimeStepper::
+solveForImpulses
+   (int                                             phase,
+    const Array_<MultiplierIndex>&                  participating,
+    const Array_<MultiplierIndex>&                  expanding,
+    Vector&                                         piExpand,
+    Vector&                                         verrStart,
+    Vector&                                         verrApplied,
+    Vector&                                         pi,
+    Array_<ImpulseSolver::UncondRT>&                unconditional,
+    Array_<ImpulseSolver::UniContactRT>&            uniContact,
+    Array_<ImpulseSolver::UniSpeedRT>&              uniSpeed,
+    Array_<ImpulseSolver::BoundedRT>&               bounded,
+    Array_<ImpulseSolver::ConstraintLtdFrictionRT>& consLtdFriction,
+    Array_<ImpulseSolver::StateLtdFrictionRT>&      stateLtdFriction)
+{
+    if (m_numIslands > 1) {
+        bool split;
+        const bool converged = solveByIslands(phase, participating, expanding,
+            piExpand, verrStart, verrApplied, pi, unconditional, uniContact,
+            uniSpeed, bounded, consLtdFriction, stateLtdFriction, &split);
+        if (split)
+            return converged;
+    }
+    if (m_useMatrixFree)
+        return m_solver->solve(phase, participating, m_compliance, m_D,
+            expanding, piExpand, verrStart, verrApplied, pi, unconditional,
+            uniContact, uniSpeed, bounded, consLtdFriction, stateLtdFriction);
+    if (m_GMInvGt.nrow() != verrStart.size())
+        m_compliance.calcMatrix(m_GMInvGt); // deferred for islands
+    return m_solver->solve(phase, participating, m_GMInvGt, m_D,
+        expanding, piExpand, verrStart, verrApplied, pi, unconditional,
+        uniContact, uniSpeed, bounded, consLtdFriction, stateLtdFriction);
+}
+
+bool SemiExplicitEulerTimeStepper::
+solveBilateralForImpulses(const Array_<MultiplierIndex>& participating,
+                          const Vector& rhs, Vector& pi) {
+    if (m_numIslands > 1) {
+        bool split;
+        const bool converged = 
+            solveBilateralByIslands(participating, rhs, pi, &split);
+        if (split)
+            return converged;
+    }
+    if (m_useMatrixFree)
+        return m_solver->solveBilateral(participating, m_compliance, m_D,
+                                        rhs, pi);
+    if (m_GMInvGt.nrow() != rhs.size())
+        m_compliance.calcMatrix(m_GMInvGt); // deferred for islands
+    return m_solver->solveBilateral(participating, m_GMInvGt, m_D, rhs, pi);
+}
+
+//==============================================================================
+//                                 ISLANDS
+//==============================================================================
+namespace {
+
+// One island's part of an impulse problem, with its multipliers renumbered
+// 0..mults.size()-1 in increasing order of their global numbers.
+struct IslandProblem {
+    Array_<MultiplierIndex>     mults; // global number of each multiplier
+    Array_<MultiplierIndex>     participating, expanding; // local numbers
+    Matrix                      A;          // if dense
+    ImpulseSolver::SparseCompliance compliance; // the island's rows
+    Vector                      D, piExpand, verrStart, verrApplied, pi, guess;
+    bool                        converged;
+
+    // Local copies of the runtimes with local multiplier numbers, and where
+    // each came from.
+    Array_<ImpulseSolver::UncondRT>                 unconditional;
+    Array_<ImpulseSolver::UniContactRT>             uniContact;
+    Array_<ImpulseSolver::UniSpeedRT>               uniSpeed;
+    Array_<ImpulseSolver::BoundedRT>                bounded;
+    Array_<ImpulseSolver::ConstraintLtdFrictionRT>  consLtdFriction;
+    Array_<ImpulseSolver::StateLtdFrictionRT>       stateLtdFriction;
+    Array_<int> uncondIx, uniContactIx, uniSpeedIx, boundedIx, consLtdIx, 
+                stateLtdIx;
+};
+
+// Apply f to each multiplier number in a runtime.
+template <class F> void forEachMult(ImpulseSolver::UncondRT& rt, F f)
+{   for (MultiplierIndex& mx : rt.m_mults) f(mx); }
+template <class F> void forEachMult(ImpulseSolver::UniContactRT& rt, F f)
+{   f(rt.m_Nk); for (MultiplierIndex& mx : rt.m_Fk) f(mx); }
+template <class F> void forEachMult(ImpulseSolver::UniSpeedRT& rt, F f)
+{   f(rt.m_ix); }
+template <class F> void forEachMult(ImpulseSolver::BoundedRT& rt, F f)
+{   f(rt.m_ix); }
+template <class F> 
+void forEachMult(ImpulseSolver::ConstraintLtdFrictionRT& rt, F f)
+{   for (MultiplierIndex& mx : rt.m_Fk) f(mx); 
+    for (MultiplierIndex& mx : rt.m_Nk) f(mx); }
+template <class F> void forEachMult(ImpulseSolver::StateLtdFrictionRT& rt, F f)
+{   for (MultiplierIndex& mx : rt.m_Fk) f(mx); }
+
+// Copy each runtime into the island its multipliers belong to, renumbering
+// them. Returns false if a runtime spans islands.
+template <class RT>
+bool distribute(Array_<RT>& rts, const Array_<int>& multIsland,
+                const Array_<int>& localIndex, 
+                std::vector<IslandProblem>& islands,
+                Array_<RT> IslandProblem::*      local,
+                Array_<int> IslandProblem::*     fromIx) 
+{
+    for (unsigned k=0; k < rts.size(); ++k) {
+        int island = -1; bool spans = false;
+        forEachMult(rts[k], [&](MultiplierIndex& mx) {
+            if (island < 0) island = multIsland[mx];
+            else if (multIsland[mx] != island) spans = true;
+        });
+        if (spans)
+            return false;
+        IslandProblem& isl = islands[std::max(island, 0)];
+        (isl.*local).push_back(rts[k]);
+        forEachMult((isl.*local).back(), [&](MultiplierIndex& mx) 
+        {   mx = MultiplierIndex(localIndex[mx]); });
+        (isl.*fromIx).push_back(k);
+    }
+    return true;
+}
+
+// Copy the solved runtimes back, restoring the global multiplier numbers.
+template <class RT>
+void gather(std::vector<IslandProblem>& islands, Array_<RT>& rts, 
+            Array_<RT> IslandProblem::* local, Array_<int> IslandProblem::* fromIx)
+{
+    for (IslandProblem& isl : islands)
+        for (unsigned i=0; i < (isl.*local).size(); ++i) {
+            RT& rt = (isl.*local)[i];
+            forEachMult(rt, [&](MultiplierIndex& mx) {mx = isl.mults[mx];});
+            rts[(isl.*fromIx)[i]] = rt;
+        }
+}
+
+// Copy the island's entries of a global vector, or leave it empty if the 
+// global one is.
+void gatherIn(const Vector& global, const Array_<MultiplierIndex>& mults,
+              Vector& local) {
+    local.resize(global.size() ? (int)mults.size() : 0);
+    for (int i=0; i < local.size(); ++i) local[i] = global[mults[i]];
+}
+void scatterOut(const Vector& local, const Array_<MultiplierIndex>& mults,
+                Vector& global) {
+    for (int i=0; i < local.size(); ++i) global[mults[i]] = local[i];
+}
+
+}
+
+//------------------------------------------------------------------------------
+//                               FIND ISLANDS
+//------------------------------------------------------------------------------
+// A union-find over the tree branches, identified by their base bodies, joins
+// the branches acted on by each Constraint in use. Branches don't interact
+// through M\, so the compliance A=G M\ ~G is block diagonal with one block for
+// each resulting group of branches. A Constraint acting only on Ground is an
+// island by itself.
+void SemiExplicitEulerTimeStepper::findIslands(const State& s) {
+    const SimbodyMatterSubsystem& matter = m_mbs.getMatterSubsystem();
+    const int m  = s.getNMultipliers();
+    const int nb = matter.getNumBodies();
+
+    Array_<int> parent(nb);
+    for (int b=0; b < nb; ++b) parent[b] = b;
+    const auto findRoot = [&parent](int b) {
+        while (parent[b] != b) {
+            parent[b] = parent[parent[b]]; // path halving
+            b = parent[b];
+        }
+        return b;
+    };
+
+    // The equations and first branch (or -1) of each Constraint in use.
+    Array_<Array_<MultiplierIndex> > equations;
+    Array_<int>                      firstBranch;
+    for (ConstraintIndex cx(0); cx < matter.getNumConstraints(); ++cx) {
+        const Constraint& constraint = matter.getConstraint(cx);
+        int mp, mv, ma;
+        constraint.getNumConstraintEquationsInUse(s, mp, mv, ma);
+        if (mp+mv+ma == 0)
+            continue;
+        MultiplierIndex px0, vx0, ax0;
+        constraint.getIndexOfMultipliersInUse(s, px0, vx0, ax0);
+        equations.push_back(Array_<MultiplierIndex>());
+        for (int i=0; i < mp; ++i) equations.back().push_back(MultiplierIndex(px0+i));
+        for (int i=0; i < mv; ++i) equations.back().push_back(MultiplierIndex(vx0+i));
+        for (int i=0; i < ma; ++i) equations.back().push_back(MultiplierIndex(ax0+i));
+
+        Array_<MobilizedBodyIndex> bodies;
+        for (ConstrainedBodyIndex cb(0); 
+             cb < constraint.getNumConstrainedBodies(); ++cb)
+            bodies.push_back(constraint.getMobilizedBodyFromConstrainedBody(cb)
+                             .getMobilizedBodyIndex());
+        for (ConstrainedMobilizerIndex cm(0); 
+             cm < constraint.getNumConstrainedMobilizers(); ++cm)
+            bodies.push_back(constraint.getMobilizedBodyFromConstrainedMobilizer
+                                (cm).getMobilizedBodyIndex());
+        int first = -1;
+        for (MobilizedBodyIndex mbx : bodies) {
+            if (mbx == GroundIndex)
+                continue;
+            const int branch = matter.getMobilizedBody(mbx)
+                .getBaseMobilizedBody().getMobilizedBodyIndex();
+            if (first < 0) first = branch;
+            else parent[findRoot(branch)] = findRoot(first);
+        }
+        firstBranch.push_back(first);
+    }
+
+    // Number the islands in order of their first Constraint.
+    Array_<int> rootIsland(nb, -1);
+    m_multIsland.assign(m, 0);
+    m_numIslands = 0;
+    for (unsigned c=0; c < equations.size(); ++c) {
+        int island;
+        if (firstBranch[c] < 0)
+            island = m_numIslands++;
+        else {
+            int& ri = rootIsland[findRoot(firstBranch[c])];
+            if (ri < 0) ri = m_numIslands++;
+            island = ri;
+        }
+        for (MultiplierIndex mx : equations[c])
+            m_multIsland[mx] = island;
+    }
+}
+
+//------------------------------------------------------------------------------
+//                          PREPARE ISLAND SOLVERS
+//------------------------------------------------------------------------------
+// The clones are made afresh for each split so that they pick up any changes
+// made to the solver's settings since the last one.
+bool SemiExplicitEulerTimeStepper::prepareIslandSolvers(int nSolvers) {
+    m_islandSolvers.clear();
+    while ((int)m_islandSolvers.size() < nSolvers) {
+        ImpulseSolver* copy = m_solver->clone();
+        if (!copy)
+            return false;
+        m_islandSolvers.push_back(std::unique_ptr<ImpulseSolver>(copy));
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//                            FOR EACH ISLAND
+//------------------------------------------------------------------------------
+// Islands are dealt out in contiguous chunks, a few per thread so that a 
+// large island doesn't hold everything up; each chunk has its own solver. 
+void SemiExplicitEulerTimeStepper::
+forEachIsland(int nIslands, 
+              const std::function<void(ImpulseSolver&,int)>& solveIsland) {
+    const int nThreads = m_threads.getNumberOfThreads();
+    const int nChunks  = nThreads > 1 ? std::min(4*nThreads, nIslands) : 1;
+    const std::function<void(int)> body = [&](int chunk) {
+        const int begin = (int)((long long)nIslands*chunk/nChunks);
+        const int end   = (int)((long long)nIslands*(chunk+1)/nChunks);
+        for (int i=begin; i < end; ++i)
+            solveIsland(*m_islandSolvers[chunk], i);
+    };
+    if (nChunks == 1)
+        body(0);
+    else
+        m_threads.getExecutor()->execute(body, nChunks);
+    for (int c=0; c < nChunks; ++c) {
+        m_solver->accumulateStats(*m_islandSolvers[c]);
+        m_islandSolvers[c]->clearStats();
+    }
+}
+
+//------------------------------------------------------------------------------
+//                            SOLVE BY ISLANDS
+//------------------------------------------------------------------------------
+bool SemiExplicitEulerTimeStepper::
+solveByIslands
+   (int                                             phase,
+    const Array_<MultiplierIndex>&                  participating,
+    const Array_<MultiplierIndex>&                  expanding,
+    Vector&                                         piExpand,
+    Vector&                                         verrStart,
+    Vector&                                         verrApplied,
+    Vector&                                         pi,
+    Array_<ImpulseSolver::UncondRT>&                unconditional,
+    Array_<ImpulseSolver::UniContactRT>&            uniContact,
+    Array_<ImpulseSolver::UniSpeedRT>&              uniSpeed,
+    Array_<ImpulseSolver::BoundedRT>&               bounded,
+    Array_<ImpulseSolver::ConstraintLtdFrictionRT>& consLtdFriction,
+    Array_<ImpulseSolver::StateLtdFrictionRT>&      stateLtdFriction,
+    bool*                                           split)
+{
+    *split = false;
+    const int nThreads = m_threads.getNumberOfThreads();
+    if (!prepareIslandSolvers(nThreads > 1 
+                              ? std::min(4*nThreads, m_numIslands) : 1))
+        return false;
+
+    const int m = verrStart.size();
+    std::vector<IslandProblem> islands(m_numIslands);
+    Array_<int> localIndex(m);
+    for (MultiplierIndex mx(0); mx < m; ++mx) {
+        IslandProblem& isl = islands[m_multIsland[mx]];
+        localIndex[mx] = (int)isl.mults.size();
+        isl.mults.push_back(mx);
+    }
+    typedef IslandProblem IP;
+    if (!(   distribute(unconditional, m_multIsland, localIndex, islands,
+                        &IP::unconditional, &IP::uncondIx)
+          && distribute(uniContact, m_multIsland, localIndex, islands,
+                        &IP::uniContact, &IP::uniContactIx)
+          && distribute(uniSpeed, m_multIsland, localIndex, islands,
+                        &IP::uniSpeed, &IP::uniSpeedIx)
+          && distribute(bounded, m_multIsland, localIndex, islands,
+                        &IP::bounded, &IP::boundedIx)
+          && distribute(consLtdFriction, m_multIsland, localIndex, islands,
+                        &IP::consLtdFriction, &IP::consLtdIx)
+          && distribute(stateLtdFriction, m_multIsland, localIndex, islands,
+                        &IP::stateLtdFriction, &IP::stateLtdIx)))
+        return false;
+    *split = true;
+
+    for (MultiplierIndex mx : participating)
+        islands[m_multIsland[mx]].participating
+            .push_back(MultiplierIndex(localIndex[mx]));
+    for (MultiplierIndex mx : expanding)
+        islands[m_multIsland[mx]].expanding
+            .push_back(MultiplierIndex(localIndex[mx]));
+
+    const Vector& guess = m_solver->getInitialGuess();
+    forEachIsland(m_numIslands, [&](ImpulseSolver& solver, int i) {
+        IslandProblem& isl = islands[i];
+        gatherIn(m_D, isl.mults, isl.D);
+        gatherIn(piExpand, isl.mults, isl.piExpand);
+        gatherIn(verrStart, isl.mults, isl.verrStart);
+        gatherIn(verrApplied, isl.mults, isl.verrApplied);
+        if (guess.size() == m) {
+            gatherIn(guess, isl.mults, isl.guess);
+            solver.setInitialGuess(isl.guess);
+        } else
+            solver.clearInitialGuess();
+
+        if (m_useMatrixFree) {
+            m_compliance.calcSubset(isl.mults, isl.compliance);
+            isl.converged = solver.solve(phase, isl.participating,
+                isl.compliance, isl.D, isl.expanding, isl.piExpand, 
+                isl.verrStart, isl.verrApplied, isl.pi, isl.unconditional,
+                isl.uniContact, isl.uniSpeed, isl.bounded,
+                isl.consLtdFriction, isl.stateLtdFriction);
+        } else {
+            m_compliance.calcSubset(isl.mults, isl.compliance);
+            isl.compliance.calcMatrix(isl.A);
+            isl.converged = solver.solve(phase, isl.participating,
+                isl.A, isl.D, isl.expanding, isl.piExpand, 
+                isl.verrStart, isl.verrApplied, isl.pi, isl.unconditional,
+                isl.uniContact, isl.uniSpeed, isl.bounded,
+                isl.consLtdFriction, isl.stateLtdFriction);
+        }
+    });
+
+    pi.resize(m);
+    bool converged = true;
+    for (IslandProblem& isl : islands) {
+        scatterOut(isl.pi, isl.mults, pi);
+        scatterOut(isl.piExpand, isl.mults, piExpand);
+        scatterOut(isl.verrStart, isl.mults, verrStart);
+        scatterOut(isl.verrApplied, isl.mults, verrApplied);
+        converged = converged && isl.converged;
+    }
+    gather(islands, unconditional, &IP::unconditional, &IP::uncondIx);
+    gather(islands, uniContact, &IP::uniContact, &IP::uniContactIx);
+    gather(islands, uniSpeed, &IP::uniSpeed, &IP::uniSpeedIx);
+    gather(islands, bounded, &IP::bounded, &IP::boundedIx);
+    gather(islands, consLtdFriction, &IP::consLtdFriction, &IP::consLtdIx);
+    gather(islands, stateLtdFriction, &IP::stateLtdFriction, &IP::stateLtdIx);
+    return converged;
+}
+
+//------------------------------------------------------------------------------
+//                        SOLVE BILATERAL BY ISLANDS
+//------------------------------------------------------------------------------
+bool SemiExplicitEulerTimeStepper::
+solveBilateralByIslands(const Array_<MultiplierIndex>& participating,
+                        const Vector& rhs, Vector& pi, bool* split) {
+    *split = false;
+    const int nThreads = m_threads.getNumberOfThreads();
+    if (!prepareIslandSolvers(nThreads > 1 
+                              ? std::min(4*nThreads, m_numIslands) : 1))
+        return false;
+    *split = true;
+
+    const int m = rhs.size();
+    std::vector<IslandProblem> islands(m_numIslands);
+    Array_<int> localIndex(m);
+    for (MultiplierIndex mx(0); mx < m; ++mx) {
+        IslandProblem& isl = islands[m_multIsland[mx]];
+        localIndex[mx] = (int)isl.mults.size();
+        isl.mults.push_back(mx);
+    }
+    for (MultiplierIndex mx : participating)
+        islands[m_multIsland[mx]].participating
+            .push_back(MultiplierIndex(localIndex[mx]));
+
+    forEachIsland(m_numIslands, [&](ImpulseSolver& solver, int i) {
+        IslandProblem& isl = islands[i];
+        gatherIn(m_D, isl.mults, isl.D);
+        gatherIn(rhs, isl.mults, isl.verrStart);
+        solver.clearInitialGuess();
+        if (m_useMatrixFree) {
+            m_compliance.calcSubset(isl.mults, isl.compliance);
+            isl.converged = solver.solveBilateral(isl.participating,
+                isl.compliance, isl.D, isl.verrStart, isl.pi);
+        } else {
+            m_compliance.calcSubset(isl.mults, isl.compliance);
+            isl.compliance.calcMatrix(isl.A);
+            isl.converged = solver.solveBilateral(isl.participating,
+                isl.A, isl.D, isl.verrStart, isl.pi);
+        }
+    });
+
+    pi.resize(m);
+    bool converged = true;
+    for (IslandProblem& isl : islands) {
+        scatterOut(isl.pi, isl.mults, pi);
+        converged = converged && isl.converged;
+    }
+    return converged;
+}
+
+//------------------------------------------------------------------------------
+//                           SET WARM START GUESS
+//------------------------------------------------------------------------------
+// Contacts are matched by UnilateralContactIndex, which doesn't change when
+// contacts become proximal or distal, although their multipliers do. The
+// guess for the compression impulse is the last step's force times h.
+void SemiExplicitEulerTimeStepper::
+setWarmStartGuess(Real h) {
+    m_impulseGuess.resize(m_state.getNMultipliers());
+    m_impulseGuess.setTo(NaN);
+    bool anyGuess = false;
+    for (unsigned k=0; k < m_uniContact.size(); ++k) {
+        const ImpulseSolver::UniContactRT& rt = m_uniContact[k];
+        if (rt.m_ucx >= (int)m_prevUniContactForce.size())
+            continue;
+        const Vec3& prev = m_prevUniContactForce[rt.m_ucx];
+        if (isNaN(prev[0]))
+            continue;
+        m_impulseGuess[rt.m_Nk] = h*prev[0];
+        if (rt.hasFriction() && !isNaN(prev[1])) {
+            m_impulseGuess[rt.m_Fk[0]] = h*prev[1];
+            m_impulseGuess[rt.m_Fk[1]] = h*prev[2];
+        }
+        anyGuess = true;
+    }
+    if (anyGuess)
+        m_solver->setInitialGuess(m_impulseGuess);
+}
+
+//------------------------------------------------------------------------------
+//                          SAVE WARM START FORCES
+//------------------------------------------------------------------------------
+void SemiExplicitEulerTimeStepper::
+saveWarmStartForces(const Vector& lambda) {
+    const SimbodyMatterSubsystem& matter = m_mbs.getMatterSubsystem();
+    m_prevUniContactForce.resize(matter.getNumUnilateralContacts());
+    m_prevUniContactForce.fill(Vec3(NaN));
+    for (unsigned k=0; k < m_uniContact.size(); ++k) {
+        const ImpulseSolver::UniContactRT& rt = m_uniContact[k];
+        Vec3& force = m_prevUniContactForce[rt.m_ucx];
+        force[0] = lambda[rt.m_Nk];
+        if (rt.hasFriction()) {
+            force[1] = lambda[rt.m_Fk[0]];
+            force[2] = lambda[rt.m_Fk[1]];
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 //                            DEBUGGING METHODS
 //------------------------------------------------------------------------------
@@ -107,6 +107,23 @@ void SimbodyMatterSubsystem::setShowDefaultGeometry(bool show) {
     updRep().setShowDefaultGeometry(show);
 }
 
+void SimbodyMatterSubsystem::setNumberOfThreads(int numThreads) {
+    updRep().setNumberOfThreads(numThreads);
+}
+
+int SimbodyMatterSubsystem::getNumberOfThreads() const {
+    return getRep().getNumberOfThreads();
+}
+
+void SimbodyMatterSubsystem::setConstraintSolver(ConstraintSolver solver) {
+    updRep().setConstraintSolver(solver);
+}
+
+SimbodyMatterSubsystem::ConstraintSolver 
+SimbodyMatterSubsystem::getConstraintSolver() const {
+    return getRep().getConstraintSolver();
+}
+
 
 ConstraintIndex SimbodyMatterSubsystem::
 adoptConstraint(Constraint& child) {return updRep().adoptConstraint(child);}
@@ -225,6 +242,56 @@ void SimbodyMatterSubsystem::calcAccelerationIgnoringConstraints
         A_GB, udot, qdotdot, tau);
 }
 
+void SimbodyMatterSubsystem::calcAccelerationIgnoringConstraints
+   (const Array_<const State*>&         states,
+    const Array_<Vector>&               appliedMobilityForces,
+    const Array_<Vector_<SpatialVec> >& appliedBodyForces,
+    Array_<Vector>&                     udot,
+    Array_<Vector_<SpatialVec> >&       A_GB) const
+{
+    const int nStates = (int)states.size();
+    SimTK_APIARGCHECK3_ALWAYS(
+        (int)appliedMobilityForces.size()==nStates 
+        && (int)appliedBodyForces.size()==nStates,
+        "SimbodyMatterSubsystem", "calcAccelerationIgnoringConstraints",
+        "Got %d States but force arrays of length %d and %d.", nStates,
+        (int)appliedMobilityForces.size(), (int)appliedBodyForces.size());
+
+    // The sweeps need contiguous data; make copies of any that aren't.
+    Array_<Vector>                  contigMobilityForces;
+    Array_<Vector_<SpatialVec> >    contigBodyForces;
+    bool needCopies = false;
+    for (int k=0; k < nStates; ++k) {
+        SimTK_APIARGCHECK3_ALWAYS(
+            appliedMobilityForces[k].size()==getNumMobilities(),
+            "SimbodyMatterSubsystem", "calcAccelerationIgnoringConstraints",
+            "Got %d appliedMobilityForces for State %d but there are %d "
+            "mobilities.", appliedMobilityForces[k].size(), k, 
+            getNumMobilities());
+        SimTK_APIARGCHECK3_ALWAYS(
+            appliedBodyForces[k].size()==getNumBodies(),
+            "SimbodyMatterSubsystem", "calcAccelerationIgnoringConstraints",
+            "Got %d appliedBodyForces for State %d but there are %d bodies "
+            "(including Ground).", appliedBodyForces[k].size(), k, 
+            getNumBodies());
+        needCopies = needCopies 
+                     || !appliedMobilityForces[k].hasContiguousData()
+                     || !appliedBodyForces[k].hasContiguousData();
+    }
+
+    if (needCopies) {
+        contigMobilityForces.assign(appliedMobilityForces.begin(),
+                                    appliedMobilityForces.end());
+        contigBodyForces.assign(appliedBodyForces.begin(),
+                                appliedBodyForces.end());
+    }
+
+    getRep().calcTreeAccelerations(states,
+        needCopies ? contigMobilityForces : appliedMobilityForces,
+        needCopies ? contigBodyForces     : appliedBodyForces,
+        udot, A_GB);
+}
+
 
 
 //==============================================================================
@@ -2061,6 +2128,11 @@ realizeArticulatedBodyInertias(const State& s) const {
     getRep().realizeArticulatedBodyInertias(s);
 }
 
+void SimbodyMatterSubsystem::
+realizeArticulatedBodyInertias(const Array_<const State*>& states) const {
+    getRep().realizeArticulatedBodyInertias(states);
+}
+
 void SimbodyMatterSubsystem::
 realizeArticulatedBodyVelocity(const State& s) const {
     getRep().realizeArticulatedBodyVelocity(s);
@@ -34,9 +34,11 @@
 #include "MultibodySystemRep.h"
 #include "MobilizedBodyImpl.h"
 #include "ConstraintImpl.h"
+#include "SparseConstraintSolver.h"
 
 #include <string>
 #include <iostream>
+#include <vector>
 using std::cout; using std::endl;
 
 SimbodyMatterSubsystemRep::SimbodyMatterSubsystemRep
@@ -102,6 +104,7 @@ void SimbodyMatterSubsystemRep::clearTopologyCache() {
     // be deleted when the MobilizedBodyImpl objects are.
     rbNodeLevels.clear();
     nodeNum2NodeMap.clear();
+    rbLevelCost.clear();
 
     showDefaultGeometry = true;
 }
@@ -264,6 +267,7 @@ void SimbodyMatterSubsystemRep::endConstruction(State& s) {
     // objects rather than on MobilizedBody objects.
     nodeNum2NodeMap.clear();
     rbNodeLevels.clear();
+    rbLevelCost.clear();
     DOFTotal = SqDOFTotal = maxNQTotal = 0;
 
     // state allocation
@@ -288,6 +292,9 @@ void SimbodyMatterSubsystemRep::endConstruction(State& s) {
 
         // Count up multibody tree totals.
         const int ndof = n.getDOF();
+        if ((int)rbLevelCost.size() <= level)
+            rbLevelCost.resize(level+1, 0);
+        rbLevelCost[level] += 1 + ndof; // spatial work + per-mobility work
         DOFTotal += ndof; SqDOFTotal += ndof*ndof;
         maxNQTotal += n.getMaxNQ();
     }
@@ -477,6 +484,14 @@ int SimbodyMatterSubsystemRep::realizeSubsystemTopologyImpl(State& s) const {
         allocateLazyCacheEntry(s, Stage::Dynamics,
                                new Value<SBConstrainedAccelerationCache>());
 
+    // The structure of G M^-1 ~G used by the sparse constraint solver depends
+    // only on which constraint equations are in use, so it is worked out the
+    // first time it is needed after Instance stage. The numerical
+    // factorization is kept here too but is redone for each solve.
+    tc.sparseConstraintSolverCacheIndex =
+        allocateLazyCacheEntry(s, Stage::Instance,
+                               new Value<SparseConstraintSolver>());
+
     tc.valid = true;
 
     // Allocate a cache entry for the topologyCache, and save a copy there.
@@ -1239,12 +1254,88 @@ realizeArticulatedBodyInertias(const State& state) const {
 
     // tip-to-base sweep
     for (int i=rbNodeLevels.size()-1 ; i>=0 ; --i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeArticulatedBodyInertiasInward(ic,tpc,abc);
+        sweepLevel(i, [&](const RigidBodyNode& node) {
+            node.realizeArticulatedBodyInertiasInward(ic,tpc,abc);
+        });
 
     markCacheValueRealized(state, abx);
 }
 
+// Batch version. States whose ABIs are already valid are skipped. For the rest
+// we run a single tip-to-base sweep in which each node is applied to every
+// State in turn, so the node's code and topological data are fetched once for
+// the whole batch rather than once per State.
+void SimbodyMatterSubsystemRep::
+realizeArticulatedBodyInertias(const Array_<const State*>& states) const {
+    checkBatchStates("SimbodyMatterSubsystem::realizeArticulatedBodyInertias()",
+                     states, Stage::Instance);
+    const CacheEntryIndex abx = topologyCache.articulatedBodyInertiaCacheIndex;
+
+    Array_<const State*> todo;
+    for (unsigned k=0; k < states.size(); ++k) {
+        const State& state = *states[k];
+        if (isCacheValueRealized(state, abx))
+            continue;
+        SimTK_ERRCHK1_ALWAYS(isPositionKinematicsRealized(state), 
+        "SimbodyMatterSubsystem::realizeArticulatedBodyInertias()",
+        "Articulated body inertias cannot be realized for State %d of the "
+        "batch unless it has been realized to Stage::Position or "
+        "realizePositionKinematics() has been called explicitly.", (int)k);
+        todo.push_back(&state);
+    }
+
+    forEachBatchChunk((int)todo.size(), [&](int begin, int end) {
+        const int n = end - begin;
+        Array_<const SBInstanceCache*>          ic(n);
+        Array_<const SBTreePositionCache*>      tpc(n);
+        Array_<SBArticulatedBodyInertiaCache*>  abc(n);
+        for (int k=0; k < n; ++k) {
+            const State& state = *todo[begin+k];
+            ic[k]  = &getInstanceCache(state);
+            tpc[k] = &getTreePositionCache(state);
+            abc[k] = &updArticulatedBodyInertiaCache(state);
+        }
+
+        // tip-to-base sweep
+        for (int i=rbNodeLevels.size()-1 ; i>=0 ; --i) 
+            for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j) {
+                const RigidBodyNode& node = *rbNodeLevels[i][j];
+                for (int k=0; k < n; ++k)
+                    node.realizeArticulatedBodyInertiasInward
+                                                (*ic[k],*tpc[k],*abc[k]);
+            }
+
+        for (int k=0; k < n; ++k)
+            markCacheValueRealized(*todo[begin+k], abx);
+    });
+}
+
+void SimbodyMatterSubsystemRep::
+checkBatchStates(const char* methodName, const Array_<const State*>& states,
+                 Stage required) const {
+    const StageVersion topoVersion = getSystem().getSystemTopologyCacheVersion();
+    for (unsigned k=0; k < states.size(); ++k) {
+        SimTK_ERRCHK1_ALWAYS(states[k] != nullptr, methodName,
+            "Entry %d of the batch is a null State pointer.", (int)k);
+        SimTK_ERRCHK1_ALWAYS(
+            states[k]->getSystemTopologyStageVersion() == topoVersion, 
+            methodName, "State %d of the batch does not belong to this "
+            "System's current topology.", (int)k);
+        SimTK_ERRCHK3_ALWAYS(getStage(*states[k]) >= required, methodName,
+            "State %d of the batch must be realized to Stage::%s but was "
+            "only at Stage::%s.", (int)k, required.getName().c_str(),
+            getStage(*states[k]).getName().c_str());
+    }
+
+    // The same State appearing twice would have its cache written by two
+    // threads at once.
+    Array_<const State*> sorted(states);
+    std::sort(sorted.begin(), sorted.end());
+    SimTK_ERRCHK_ALWAYS(
+        std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end(),
+        methodName, "The same State appears more than once in the batch.");
+}
+
 // Articulated body inertias are realized only if
 //  - we're already at Stage::Acceleration
 //          OR
@@ -3570,17 +3661,104 @@ solveForConstraintImpulses(const State&     state,
                            const Vector&    deltaV,
                            Vector&          impulse) const
 {
-    Matrix GMInvGt;
-    calcGMInvGt(state, GMInvGt);
     // MUST DUPLICATE SIMBODY'S METHOD HERE:
-    const Real conditioningTol = GMInvGt.nrow() 
+    const Real conditioningTol = deltaV.size() 
                                     * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
+    if (constraintSolver == SimbodyMatterSubsystem::SparseConstraintSolver
+        && solveWithSparseGMInvGt(state, conditioningTol, deltaV, impulse))
+        return;
+
+    Matrix GMInvGt;
+    calcGMInvGt(state, GMInvGt);
     FactorQTZ qtz(GMInvGt, conditioningTol); 
     qtz.solve(deltaV, impulse);
 }
 
 
 
+// =============================================================================
+//                      SOLVE WITH SPARSE G MInv G^T
+// =============================================================================
+// This is the SparseConstraintSolver alternative to calcGMInvGt() followed by
+// a dense factorization. The nonzero structure depends only on which branches
+// of the tree (subtrees of base bodies) each Constraint acts on, since the
+// mass matrix doesn't couple different branches. The solver forms the 
+// nonzeros of G M^-1 ~G using the same O(n) operator sequence as 
+// calcGMInvGt(), but applied to several columns at once.
+bool SimbodyMatterSubsystemRep::
+solveWithSparseGMInvGt(const State&     s,
+                       Real             pivotTol,
+                       const Vector&    rhs,
+                       Vector&          x) const
+{
+    const CacheEntryIndex scx = topologyCache.sparseConstraintSolverCacheIndex;
+    SparseConstraintSolver& solver = 
+        Value<SparseConstraintSolver>::updDowncast(updCacheEntry(s, scx));
+
+    if (!isCacheValueRealized(s, scx)) {
+        const SBInstanceCache& ic = getInstanceCache(s);
+        const int m = ic.totalNHolonomicConstraintEquationsInUse
+                    + ic.totalNNonholonomicConstraintEquationsInUse
+                    + ic.totalNAccelerationOnlyConstraintEquationsInUse;
+
+        Array_<Array_<int> > equations, branches;
+        for (ConstraintIndex cx(0); cx < getNumConstraints(); ++cx) {
+            const ConstraintImpl& crep = getConstraint(cx).getImpl();
+            int mp, mv, ma;
+            crep.getNumConstraintEquationsInUse(s, mp, mv, ma);
+            if (mp+mv+ma == 0)
+                continue;
+            MultiplierIndex px0, vx0, ax0;
+            crep.getIndexOfMultipliersInUse(s, px0, vx0, ax0);
+            equations.push_back(Array_<int>());
+            for (int i=0; i < mp; ++i) equations.back().push_back(px0+i);
+            for (int i=0; i < mv; ++i) equations.back().push_back(vx0+i);
+            for (int i=0; i < ma; ++i) equations.back().push_back(ax0+i);
+
+            // Ground has no mobilities, so it doesn't couple anything.
+            branches.push_back(Array_<int>());
+            Array_<MobilizedBodyIndex> bodies;
+            for (ConstrainedBodyIndex cb(0); 
+                 cb < crep.getNumConstrainedBodies(); ++cb)
+                bodies.push_back(crep.getMobilizedBodyIndexOfConstrainedBody(cb));
+            for (ConstrainedMobilizerIndex cm(0); 
+                 cm < crep.getNumConstrainedMobilizers(); ++cm)
+                bodies.push_back
+                   (crep.getMobilizedBodyIndexOfConstrainedMobilizer(cm));
+            for (MobilizedBodyIndex mbx : bodies)
+                if (mbx != GroundIndex)
+                    branches.back().push_back(getMobilizedBody(mbx)
+                        .getBaseMobilizedBody().getMobilizedBodyIndex());
+        }
+        solver.analyze(m, equations, branches);
+        markCacheValueRealized(s, scx);
+    }
+
+    if (solver.isNonsymmetric())
+        return false;
+
+    const int m  = solver.getNumEquations();
+    const int nu = getNU(s);
+    assert(rhs.size() == m);
+
+    // Same temporaries and bias as calcGMInvGt().
+    Vector Gtcol(nu), MInvGtcol(nu), bias(m);
+    calcBiasForMultiplyByPVA(s,true,true,true,bias);
+    const bool factored = solver.factor
+       ([&](const Vector& lambda, Vector& GMInvGtLambda) {
+            multiplyByPVATranspose(s, true, true, true, lambda, Gtcol);
+            multiplyByMInv(s, Gtcol, MInvGtcol);
+            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGtLambda);
+        }, pivotTol);
+    if (!factored)
+        return false;
+
+    solver.solve(rhs, x);
+    return true;
+}
+
+
+
 // =============================================================================
 //                     CALC BODY ACCELERATION FROM UDOT
 // =============================================================================
@@ -5122,17 +5300,26 @@ void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
     // The method here calculates the mXm matrix G*M^-1*G^T as fast as 
     // I know how to do, O(m*n) with O(n) temporary memory, using a series
     // of O(n) operators. Then we'll factor it here in O(m^3) time. 
-    Matrix GMInvGt(m,m);
-    calcGMInvGt(s, GMInvGt);
-    
-    // specify 1/cond at which we declare rank deficiency
-    FactorQTZ qtz(GMInvGt, conditioningTol); 
+    // Alternatively, if requested, only the nonzeros of G*M^-1*G^T are 
+    // formed and it is factored with a sparse LDL^T; see 
+    // solveWithSparseGMInvGt().
+    const bool sparseSolved = 
+        constraintSolver == SimbodyMatterSubsystem::SparseConstraintSolver
+        && solveWithSparseGMInvGt(s, conditioningTol, udotErr, multipliers);
+
+    if (!sparseSolved) {
+        Matrix GMInvGt(m,m);
+        calcGMInvGt(s, GMInvGt);
+        
+        // specify 1/cond at which we declare rank deficiency
+        FactorQTZ qtz(GMInvGt, conditioningTol); 
 
-    //printf("fwdDynamics: m=%d condTol=%g rank=%d rcond=%g\n",
-    //    GMInvGt.nrow(), conditioningTol, qtz.getRank(),
-    //    qtz.getRCondEstimate());
+        //printf("fwdDynamics: m=%d condTol=%g rank=%d rcond=%g\n",
+        //    GMInvGt.nrow(), conditioningTol, qtz.getRank(),
+        //    qtz.getRCondEstimate());
 
-    qtz.solve(udotErr, multipliers);
+        qtz.solve(udotErr, multipliers);
+    }
 
     // We have the multipliers, now turn them into forces.
 
@@ -5325,21 +5512,132 @@ void SimbodyMatterSubsystemRep::calcTreeAccelerations(const State& s,
         udotPtr[ic.zeroUDot[i]] = 0;
 
     for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
+        sweepLevel(i, [&](const RigidBodyNode& node) {
             node.calcUDotPass1Inward(ic,tpc,abc,abvc,
                 mobilityForcePtr, bodyForcePtr, udotPtr, zPtr, zPlusPtr,
                 hingeForcePtr);
-        }
+        });
 
     for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
+        sweepLevel(i, [&](const RigidBodyNode& node) {
             node.calcUDotPass2Outward(ic,tpc,abc,tvc,dc, 
                 hingeForcePtr, aPtr, udotPtr, tauPtr);
             node.calcQDotDot(sbs, &udotPtr[node.getUIndex()], 
                              &qdotdotPtr[node.getQIndex()]);
+        });
+}
+
+namespace {
+// Return a pointer to a contiguous Vector's data, or null if it is empty.
+template <class T> T* dataOrNull(Vector_<T>& v) 
+{   return v.size() ? &v[0] : nullptr; }
+template <class T> const T* dataOrNull(const Vector_<T>& v) 
+{   return v.size() ? &v[0] : nullptr; }
+}
+
+// Batch version. Each State gets its own temporaries and uses its own cached
+// prescribed udots; the two sweeps are then run node by node across the 
+// whole batch (or across each thread's share of it).
+void SimbodyMatterSubsystemRep::calcTreeAccelerations
+   (const Array_<const State*>&         states,
+    const Array_<Vector>&               mobilityForces,
+    const Array_<Vector_<SpatialVec> >& bodyForces,
+    Array_<Vector>&                     udot,
+    Array_<Vector_<SpatialVec> >&       A_GB) const
+{
+    const int nStates = (int)states.size();
+    assert(mobilityForces.size() == states.size());
+    assert(bodyForces.size() == states.size());
+    checkBatchStates("SimbodyMatterSubsystem::"
+                     "calcAccelerationIgnoringConstraints()", 
+                     states, Stage::Dynamics);
+
+    // Note that realize(Acceleration) depends on getting here to fulfill the
+    // promise of these cache entries' computed-by stage.
+    realizeArticulatedBodyInertias(states); // might already be done
+
+    udot.resize(nStates); A_GB.resize(nStates);
+
+    // Per-State workspace and pointers into the caches.
+    struct Batch {
+        const SBInstanceCache*                  ic;
+        const SBTreePositionCache*              tpc;
+        const SBTreeVelocityCache*              tvc;
+        const SBDynamicsCache*                  dc;
+        const SBArticulatedBodyInertiaCache*    abc;
+        const SBArticulatedBodyVelocityCache*   abvc;
+        Vector                                  netHingeForces, qdotdot, tau;
+        Array_<SpatialVec,MobilizedBodyIndex>   z, zPlus;
+    };
+
+    forEachBatchChunk(nStates, [&](int begin, int end) {
+        const int n = end - begin;
+        Array_<Batch>           ws(n);
+        std::vector<SBStateDigest> sbs; sbs.reserve(n);
+        for (int k=0; k < n; ++k) {
+            const int      b = begin + k;
+            const State&   s = *states[b];
+            Batch&         w = ws[k];
+            realizeArticulatedBodyVelocity(s);
+            sbs.emplace_back(s, *this, Stage::Acceleration);
+            w.ic   = &sbs[k].getInstanceCache();
+            w.tpc  = &sbs[k].getTreePositionCache();
+            w.tvc  = &sbs[k].getTreeVelocityCache();
+            w.dc   = &sbs[k].getDynamicsCache();
+            w.abc  = &getArticulatedBodyInertiaCache(s);
+            w.abvc = &getArticulatedBodyVelocityCache(s);
+
+            assert(mobilityForces[b].size() == getTotalDOF());
+            assert(bodyForces[b].size() == getNumBodies());
+            assert(mobilityForces[b].hasContiguousData());
+            assert(bodyForces[b].hasContiguousData());
+
+            w.netHingeForces.resize(getTotalDOF());
+            w.z.resize(getNumBodies());
+            w.zPlus.resize(getNumBodies());
+            w.qdotdot.resize(getTotalQAlloc());
+            w.tau.resize(w.ic->getTotalNumPresForces());
+            A_GB[b].resize(getNumBodies());
+            udot[b].resize(getTotalDOF());
+            assert(A_GB[b].hasContiguousData() && udot[b].hasContiguousData());
+
+            // Scatter prescribed udots; set known-zero udots to zero.
+            Real* udotPtr = udot[b].size() ? &udot[b][0] : nullptr;
+            const Array_<Real>& presUDots = w.dc->presUDotPool;
+            for (PresUDotPoolIndex i(0); i < presUDots.size(); ++i)
+                udotPtr[w.ic->presUDot[i]] = presUDots[i];
+            for (int i=0; i < (int)w.ic->zeroUDot.size(); ++i)
+                udotPtr[w.ic->zeroUDot[i]] = 0;
         }
+
+        for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
+            for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+                const RigidBodyNode& node = *rbNodeLevels[i][j];
+                for (int k=0; k < n; ++k) {
+                    const int b = begin + k; Batch& w = ws[k];
+                    node.calcUDotPass1Inward(*w.ic,*w.tpc,*w.abc,*w.abvc,
+                        dataOrNull(mobilityForces[b]), 
+                        dataOrNull(bodyForces[b]), 
+                        dataOrNull(udot[b]), w.z.begin(), w.zPlus.begin(),
+                        dataOrNull(w.netHingeForces));
+                }
+            }
+
+        for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
+            for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+                const RigidBodyNode& node = *rbNodeLevels[i][j];
+                for (int k=0; k < n; ++k) {
+                    const int b = begin + k; Batch& w = ws[k];
+                    Real* udotPtr = dataOrNull(udot[b]);
+                    node.calcUDotPass2Outward(*w.ic,*w.tpc,*w.abc,*w.tvc,*w.dc, 
+                        dataOrNull(w.netHingeForces), 
+                        dataOrNull(A_GB[b]), udotPtr, 
+                        dataOrNull(w.tau));
+                    node.calcQDotDot(sbs[k], &udotPtr[node.getUIndex()], 
+                        dataOrNull(w.qdotdot) + node.getQIndex());
+                }
+            }
+    });
 }
 //......................... CALC TREE ACCELERATIONS ............................
 
@@ -6397,6 +6695,62 @@ void SimbodyMatterSubsystemRep::setShowDefaultGeometry(bool show) {
     showDefaultGeometry = show;
 }
 
+
+
+//==============================================================================
+//                              PARALLEL SWEEPS
+//==============================================================================
+namespace {
+// A level is only split across threads if its estimated cost (see
+// rbLevelCost) is at least this large; waking the worker threads costs about
+// as much as processing a few dozen bodies, so narrow levels stay serial.
+const int MinParallelLevelCost = 64;
+}
+
+void SimbodyMatterSubsystemRep::setNumberOfThreads(int numThreads) {
+    sweepThreads.setNumberOfThreads(numThreads, "SimbodyMatterSubsystem");
+}
+
+int SimbodyMatterSubsystemRep::getNumberOfThreads() const {
+    return sweepThreads.getNumberOfThreads();
+}
+
+void SimbodyMatterSubsystemRep::
+sweepLevel(int level,
+           const std::function<void(const RigidBodyNode&)>& op) const {
+    const RBNodePtrList& nodes = rbNodeLevels[level];
+
+    // If we are already running on a pool thread (e.g. the whole realization
+    // is one task of an ensemble), sweep this level serially rather than
+    // nesting parallel work.
+    ParallelExecutor* executor = sweepThreads.getExecutor();
+    if (!executor || nodes.size() < 2 
+        || rbLevelCost[level] < MinParallelLevelCost
+        || ParallelExecutor::isWorkerThread())
+    {
+        for (int j=0 ; j<(int)nodes.size() ; ++j)
+            op(*nodes[j]);
+        return;
+    }
+
+    executor->execute([&](int j) {op(*nodes[j]);}, (int)nodes.size());
+}
+
+void SimbodyMatterSubsystemRep::
+forEachBatchChunk(int n, const std::function<void(int,int)>& op) const {
+    ParallelExecutor* executor = sweepThreads.getExecutor();
+    const int nChunks = !executor || ParallelExecutor::isWorkerThread() 
+                        ? 1 : std::min(n, sweepThreads.getNumberOfThreads());
+    if (nChunks <= 1) {
+        if (n > 0) op(0, n);
+        return;
+    }
+
+    executor->execute([&](int c) {op((c*n)/nChunks, ((c+1)*n)/nChunks);},
+                      nChunks);
+}
+//.............................. PARALLEL SWEEPS ...............................
+
 std::ostream& operator<<(std::ostream& o, const SimbodyMatterSubsystemRep& tree) {
     o << "SimbodyMatterSubsystemRep has " << tree.getNumBodies() << " bodies (incl. G) in "
       << tree.rbNodeLevels.size() << " levels." << std::endl;
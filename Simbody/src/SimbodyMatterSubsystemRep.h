@@ -48,6 +48,7 @@ using std::pair;
 #include <map>
 #include <set>
 #include <algorithm>
+#include <functional>
 
 class RigidBodyNode;
 class RBDistanceConstraint;
@@ -141,7 +142,8 @@ private:
 class SimbodyMatterSubsystemRep : public SimTK::Subsystem::Guts {
 public:
     SimbodyMatterSubsystemRep() 
-      : Subsystem::Guts("SimbodyMatterSubsystem", "0.7.1")
+      : Subsystem::Guts("SimbodyMatterSubsystem", "0.7.1"),
+        constraintSolver(SimbodyMatterSubsystem::DenseConstraintSolver)
     { 
         clearTopologyCache();
     }
@@ -513,6 +515,12 @@ public:
     // automatically realized at Stage::Acceleration.
     void realizeArticulatedBodyVelocity(const State&) const;
 
+    // Batch version of the above for several States of this System. The
+    // sweeps visit each node once for the whole batch, and the batch is split
+    // among threads if setNumberOfThreads() asked for them.
+    void realizeArticulatedBodyInertias
+       (const Array_<const State*>& states) const;
+
     bool isPositionKinematicsRealized(const State&) const;
     bool isVelocityKinematicsRealized(const State&) const;
     bool isCompositeBodyInertiasRealized(const State&) const;
@@ -583,6 +591,16 @@ public:
         Vector&                    qdotdot,
         Vector&                    tau) const; 
 
+    // Batch version of calcTreeAccelerations() for several States of this
+    // System, using each State's own prescribed udots. Forces must be sized
+    // correctly; outputs are resized as needed. Only udot and A_GB are 
+    // returned.
+    void calcTreeAccelerations(const Array_<const State*>&         states,
+        const Array_<Vector>&                mobilityForces,
+        const Array_<Vector_<SpatialVec> >&  bodyForces,
+        Array_<Vector>&                      udot,
+        Array_<Vector_<SpatialVec> >&        A_GB) const;
+
     // Multiply by the mass matrix in O(n) time.
     void multiplyByM(const State& s,
         const Vector&             a,
@@ -944,6 +962,15 @@ public:
                                     const Vector&    deltaV,
                                     Vector&          impulse) const;
 
+    // Solve (G M^-1 G^T) x = rhs using the SparseConstraintSolver kept in the
+    // State, analyzing the constraint structure first if necessary. Returns
+    // false if the matrix isn't symmetric, in which case the caller should
+    // fall back to the dense method.
+    bool solveWithSparseGMInvGt(const State&     state,
+                                Real             pivotTol,
+                                const Vector&    rhs,
+                                Vector&          x) const;
+
     // Given an array of nu udots, return nb body accelerations in G (including
     // Ground as the 0th body with A_GB[0]=0). The returned accelerations are
     // A = J*udot + Jdot*u, with the Jdot*u (coriolis acceleration) term
@@ -1210,6 +1237,19 @@ public:
     bool getShowDefaultGeometry() const;
     void setShowDefaultGeometry(bool show);
 
+    // Number of threads used to process the nodes of a single tree level
+    // concurrently during the recursive sweeps. 1 means everything is serial.
+    void setNumberOfThreads(int numThreads);
+    int getNumberOfThreads() const;
+
+    // Method used to solve for constraint multipliers and impulses.
+    void setConstraintSolver(SimbodyMatterSubsystem::ConstraintSolver solver) {
+        invalidateSubsystemTopologyCache();
+        constraintSolver = solver;
+    }
+    SimbodyMatterSubsystem::ConstraintSolver getConstraintSolver() const
+    {   return constraintSolver; }
+
     void calcTreeForwardDynamicsOperator(const State&,
         const Vector&                   mobilityForces,
         const Vector_<Vec3>&            particleForces,
@@ -1363,6 +1403,10 @@ private:
     Array_<RBNodePtrList>      rbNodeLevels;
     // Map nodeNum (a.k.a. MobilizedBodyIndex) to (level,offset).
     Array_<RigidBodyNodeIndex,MobilizedBodyIndex> nodeNum2NodeMap;
+    // Rough estimate of the work needed to process each level in a sweep;
+    // used to decide whether a level is wide enough to be worth splitting
+    // across threads. Same length as rbNodeLevels.
+    Array_<int>                rbLevelCost;
 
         // Constraints
 
@@ -1436,6 +1480,30 @@ private:
     
     // Specifies whether default decorative geometry should be shown.
     bool showDefaultGeometry;
+
+        // PARALLEL SWEEPS
+
+    // Apply op to every node in rbNodeLevels[level]. The nodes in a level are
+    // independent of one another during any of the recursive sweeps, so if
+    // threads are enabled and the level is costly enough we'll split it.
+    void sweepLevel(int level,
+                    const std::function<void(const RigidBodyNode&)>& op) const;
+
+    // Divide the index range [0,n) into one contiguous chunk per thread and
+    // call op(begin,end) for each chunk, serially if there is no thread pool.
+    void forEachBatchChunk(int n, 
+                           const std::function<void(int,int)>& op) const;
+
+    // Make sure each State in a batch is distinct, belongs to this System's
+    // current topology, and has been realized to at least the required stage.
+    void checkBatchStates(const char* methodName,
+                          const Array_<const State*>& states,
+                          Stage required) const;
+
+    // Not part of the topology; survives topology invalidation.
+    ParallelExecutorOption              sweepThreads;
+
+    SimbodyMatterSubsystem::ConstraintSolver constraintSolver;
 };
 
 std::ostream& operator<<(std::ostream&, const SimbodyMatterSubsystemRep&);
@@ -156,7 +156,8 @@ public:
                           articulatedBodyVelocityCacheIndex,
                           dynamicsCacheIndex, 
                           treeAccelerationCacheIndex, 
-                          constrainedAccelerationCacheIndex;
+                          constrainedAccelerationCacheIndex,
+                          sparseConstraintSolverCacheIndex;
 
 
     // These are instance variables that exist regardless of modeling
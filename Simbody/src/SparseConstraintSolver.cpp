@@ -0,0 +1,343 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include "SparseConstraintSolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+using std::pair;
+
+namespace SimTK {
+
+//------------------------------------------------------------------------------
+//                                  ANALYZE
+//------------------------------------------------------------------------------
+void SparseConstraintSolver::
+analyze(int numEquations, const Array_<Array_<int> >& blockEqs,
+        const Array_<Array_<int> >& blockBranches) {
+    assert(blockEqs.size() == blockBranches.size());
+    m = numEquations;
+    blockEquations = blockEqs;
+    const int nb = (int)blockEqs.size();
+
+    blockOf.assign(m, -1);
+    for (int b=0; b < nb; ++b)
+        for (int e : blockEqs[b]) {
+            assert(0 <= e && e < m && blockOf[e] == -1);
+            blockOf[e] = b;
+        }
+
+    // Number the branches densely and list the blocks acting on each.
+    std::map<int,int> branchNumber;
+    Array_<Array_<int> > branchesOf(nb);
+    Array_<Array_<int> > branchBlocks;
+    for (int b=0; b < nb; ++b)
+        for (int br : blockBranches[b]) {
+            auto ins = branchNumber.insert(std::make_pair(br,
+                                                (int)branchBlocks.size()));
+            if (ins.second) branchBlocks.push_back(Array_<int>());
+            const int nbr = ins.first->second;
+            if (std::find(branchesOf[b].begin(), branchesOf[b].end(), nbr)
+                == branchesOf[b].end()) {
+                branchesOf[b].push_back(nbr);
+                branchBlocks[nbr].push_back(b);
+            }
+        }
+    const int nbr = (int)branchBlocks.size();
+
+    // Blocks are coupled if they share a branch. Every block is coupled to
+    // itself, and is listed first.
+    Array_<int> mark(nb, -1);
+    coupledBlocks.clear();
+    coupledBlocks.resize(nb);
+    for (int b=0; b < nb; ++b) {
+        mark[b] = b;
+        coupledBlocks[b].push_back(b);
+        for (int br : branchesOf[b])
+            for (int c : branchBlocks[br])
+                if (mark[c] != b) {mark[c] = b; coupledBlocks[b].push_back(c);}
+    }
+
+    // Color the blocks so that no two blocks of the same color are coupled
+    // to a common block; then their columns have no nonzero rows in common.
+    // That is distance-2 coloring of the coupling graph, done greedily. The
+    // neighbors of neighbors are reached through the branches so that a
+    // branch shared by many blocks is only scanned once per block.
+    Array_<int> color(nb, -1), forbidden, branchMark(nbr, -1);
+    int numColors = 0;
+    for (int b=0; b < nb; ++b) {
+        for (int c : coupledBlocks[b])
+            for (int br : branchesOf[c]) {
+                if (branchMark[br] == b) continue;
+                branchMark[br] = b;
+                for (int d : branchBlocks[br])
+                    if (color[d] >= 0) forbidden[color[d]] = b;
+            }
+        int k = 0;
+        while (k < numColors && forbidden[k] == b) ++k;
+        if (k == numColors) {forbidden.push_back(-1); ++numColors;}
+        color[b] = k;
+    }
+
+    // One probe for each color and each equation number within a block.
+    probes.clear();
+    Array_<Array_<int> > colorBlocks(numColors);
+    for (int b=0; b < nb; ++b)
+        colorBlocks[color[b]].push_back(b);
+    for (int k=0; k < numColors; ++k) {
+        int maxEqs = 0;
+        for (int b : colorBlocks[k])
+            maxEqs = std::max(maxEqs, (int)blockEqs[b].size());
+        for (int i=0; i < maxEqs; ++i) {
+            probes.push_back(Array_<int>());
+            for (int b : colorBlocks[k])
+                if (i < (int)blockEqs[b].size())
+                    probes.back().push_back(blockEqs[b][i]);
+        }
+    }
+
+    // Minimum degree ordering of the blocks, treating each block as a
+    // clique of its equations so the degree of a block is the number of
+    // equations it is currently coupled to. When a block is eliminated its
+    // remaining neighbors become coupled to each other; those neighbors are
+    // also the rows of the factor below the block's columns.
+    std::vector<std::vector<int> > adj(nb);
+    for (int b=0; b < nb; ++b) {
+        adj[b].assign(coupledBlocks[b].begin()+1, coupledBlocks[b].end());
+        std::sort(adj[b].begin(), adj[b].end());
+    }
+    Array_<int> degree(nb, 0);
+    std::set<pair<int,int> > queue;
+    for (int b=0; b < nb; ++b) {
+        for (int c : adj[b]) degree[b] += (int)blockEqs[c].size();
+        queue.insert(std::make_pair(degree[b], b));
+    }
+    Array_<int> order; order.reserve(nb);
+    std::vector<std::vector<int> > belowBlocks(nb);
+    std::vector<int> merged;
+    while (!queue.empty()) {
+        const int v = queue.begin()->second;
+        queue.erase(queue.begin());
+        order.push_back(v);
+        const std::vector<int>& nbrs = adj[v];
+        for (int u : nbrs) {
+            queue.erase(std::make_pair(degree[u], u));
+            merged.clear();
+            std::set_union(adj[u].begin(), adj[u].end(),
+                           nbrs.begin(), nbrs.end(),
+                           std::back_inserter(merged));
+            adj[u].clear();
+            degree[u] = 0;
+            for (int w : merged)
+                if (w != u && w != v) {
+                    adj[u].push_back(w);
+                    degree[u] += (int)blockEqs[w].size();
+                }
+            queue.insert(std::make_pair(degree[u], u));
+        }
+        belowBlocks[v].swap(adj[v]);
+    }
+
+    // Number the equations block by block in elimination order.
+    perm.resize(m); invPerm.resize(m);
+    Array_<int> blockStart(nb);
+    int pos = 0;
+    for (int v : order) {
+        blockStart[v] = pos;
+        for (int e : blockEqs[v]) {perm[pos] = e; invPerm[e] = pos++;}
+    }
+    assert(pos == m);
+
+    // The structure of L. Within a block each column has the later
+    // equations of the block below it, followed by all the equations of the
+    // blocks that were neighbors when the block was eliminated.
+    colStart.resize(m+1);
+    colRows.clear();
+    for (int v : order) {
+        std::vector<int>& below = belowBlocks[v];
+        std::sort(below.begin(), below.end(), [&](int a, int b)
+                  {return blockStart[a] < blockStart[b];});
+        const int first = blockStart[v], w = (int)blockEqs[v].size();
+        for (int i=0; i < w; ++i) {
+            colStart[first+i] = (int)colRows.size();
+            for (int r=first+i+1; r < first+w; ++r)
+                colRows.push_back(r);
+            for (int c : below)
+                for (int j=0; j < (int)blockEqs[c].size(); ++j)
+                    colRows.push_back(blockStart[c]+j);
+        }
+    }
+    colStart[m] = (int)colRows.size();
+
+    // And by rows.
+    rowStart.assign(m+1, 0);
+    for (int r : colRows) ++rowStart[r+1];
+    for (int k=0; k < m; ++k) rowStart[k+1] += rowStart[k];
+    rowCols.resize(colRows.size()); rowPos.resize(colRows.size());
+    Array_<int> next(rowStart.begin(), rowStart.begin()+m);
+    for (int k=0; k < m; ++k)
+        for (int p=colStart[k]; p < colStart[k+1]; ++p) {
+            const int r = colRows[p];
+            rowCols[next[r]] = k; rowPos[next[r]] = p; ++next[r];
+        }
+
+    Lx.resize(colRows.size()); Ux.resize(colRows.size());
+    D.resize(m); dropped.resize(m);
+    rank = 0;
+    analyzed = true;
+    nonsymmetric = false;
+}
+
+int SparseConstraintSolver::position(int row, int col) const {
+    const int* begin = &colRows[0] + colStart[col];
+    const int* end   = &colRows[0] + colStart[col+1];
+    const int* p = std::lower_bound(begin, end, row);
+    assert(p != end && *p == row);
+    return (int)(p - &colRows[0]);
+}
+
+//------------------------------------------------------------------------------
+//                                   FACTOR
+//------------------------------------------------------------------------------
+bool SparseConstraintSolver::
+factor(const std::function<void(const Vector&, Vector&)>& multiply,
+       Real pivotTol) {
+    assert(analyzed);
+    rank = 0;
+    if (m == 0) return true;
+
+    // Recover the nonzeros of A a probe at a time. Entries below the
+    // diagonal (in elimination order) go in Lx, the transposed entries above
+    // it in Ux, so we can check symmetry.
+    std::fill(Lx.begin(), Lx.end(), Real(0));
+    std::fill(Ux.begin(), Ux.end(), Real(0));
+    std::fill(D.begin(), D.end(), Real(0));
+    Vector x(m, Real(0)), y(m);
+    for (const Array_<int>& probe : probes) {
+        for (int e : probe) x[e] = 1;
+        multiply(x, y);
+        for (int e : probe) x[e] = 0;
+        for (int e : probe) {
+            const int pj = invPerm[e];
+            for (int c : coupledBlocks[blockOf[e]])
+                for (int i : blockEquations[c]) {
+                    const int pi = invPerm[i];
+                    if (pi == pj)     D[pi] = y[i];
+                    else if (pi > pj) Lx[position(pi,pj)] = y[i];
+                    else              Ux[position(pj,pi)] = y[i];
+                }
+        }
+    }
+
+    Real maxDiag = 0;
+    for (int k=0; k < m; ++k) maxDiag = std::max(maxDiag, std::abs(D[k]));
+    const Real symTol = SqrtEps*maxDiag;
+    for (int p=0; p < (int)Lx.size(); ++p) {
+        if (std::abs(Lx[p]-Ux[p]) > symTol) {
+            nonsymmetric = true;
+            return false;
+        }
+        Lx[p] = (Lx[p]+Ux[p])/2;
+    }
+
+    // Left-looking LDL^T. Column k is accumulated in the dense temporary w,
+    // using the row k entries of the earlier columns of L. The rows of an
+    // earlier column below row k are always among the rows of column k.
+    //
+    // Equation k is redundant if eliminating the earlier equations cancels
+    // its diagonal element akk, so we compare its pivot with akk rather than
+    // with the largest diagonal element; a small pivot that isn't small
+    // relative to akk just means the equation is badly scaled. A pivot that
+    // is negative by more than that means A isn't numerically positive
+    // semidefinite, and we leave it to the dense solver.
+    Array_<Real> w(m, Real(0));
+    for (int k=0; k < m; ++k) {
+        for (int p=colStart[k]; p < colStart[k+1]; ++p)
+            w[colRows[p]] = Lx[p];
+        const Real akk = D[k];
+        Real d = akk;
+        for (int q=rowStart[k]; q < rowStart[k+1]; ++q) {
+            const int j = rowCols[q], pkj = rowPos[q];
+            if (dropped[j]) continue;
+            const Real lkj = Lx[pkj], t = lkj*D[j];
+            d -= t*lkj;
+            for (int p=pkj+1; p < colStart[j+1]; ++p)
+                w[colRows[p]] -= Lx[p]*t;
+        }
+        dropped[k] = !(d > pivotTol*akk);
+        if (dropped[k] && d < -pivotTol*akk)
+            return false;
+        D[k] = dropped[k] ? Real(0) : d;
+        if (!dropped[k]) ++rank;
+        const Real dinv = dropped[k] ? Real(0) : 1/d;
+        for (int p=colStart[k]; p < colStart[k+1]; ++p) {
+            Lx[p] = w[colRows[p]]*dinv;
+            w[colRows[p]] = 0;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//                                   SOLVE
+//------------------------------------------------------------------------------
+void SparseConstraintSolver::solve(const Vector& b, Vector& x) const {
+    assert(b.size() == m);
+    Array_<Real> z(m);
+    for (int k=0; k < m; ++k) z[k] = b[perm[k]];
+
+    // L z = b; dropped equations are ignored.
+    for (int k=0; k < m; ++k) {
+        if (dropped[k]) {z[k] = 0; continue;}
+        for (int p=colStart[k]; p < colStart[k+1]; ++p)
+            z[colRows[p]] -= Lx[p]*z[k];
+    }
+    for (int k=0; k < m; ++k)
+        z[k] = dropped[k] ? Real(0) : z[k]/D[k];
+    // ~L x = z
+    for (int k=m-1; k >= 0; --k) {
+        if (dropped[k]) continue;
+        for (int p=colStart[k]; p < colStart[k+1]; ++p)
+            z[k] -= Lx[p]*z[colRows[p]];
+    }
+
+    x.resize(m);
+    for (int k=0; k < m; ++k) x[perm[k]] = z[k];
+}
+
+std::ostream& operator<<(std::ostream& o, const SparseConstraintSolver& s) {
+    return o << "SparseConstraintSolver(m=" << s.getNumEquations()
+             << ", probes=" << s.getNumProbes()
+             << ", nnz(L)=" << s.getNumFactorNonzeros() << ")";
+}
+
+} // namespace SimTK
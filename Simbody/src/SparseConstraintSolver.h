@@ -0,0 +1,126 @@
+#ifndef SimTK_SIMBODY_SPARSE_CONSTRAINT_SOLVER_H_
+#define SimTK_SIMBODY_SPARSE_CONSTRAINT_SOLVER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include <functional>
+#include <iosfwd>
+
+namespace SimTK {
+
+/* This is the sparse alternative to forming G M^-1 ~G densely and factoring
+it with FactorQTZ. The mass matrix is block diagonal, one block for each
+branch of the multibody tree (the subtree of a base body), so two constraint
+equations can only be coupled in G M^-1 ~G if they act on a common branch.
+With many constraints between separately mobilized bodies (chains or nets
+of free bodies) that matrix is very sparse.
+
+analyze() works out everything that depends only on which equations act on
+which branches: a fill-reducing (minimum degree) elimination order, the
+nonzero structure of the LDL^T factor, and a grouping of the columns into
+"probes" such that no row is nonzero in two columns of the same probe. Then
+factor() recovers all the nonzeros of G M^-1 ~G with one O(n) operator
+multiply per probe, rather than one per column, and factors it in place. The
+number of probes depends on how many constraints touch each branch, not on
+the size of the system.
+
+Redundant constraints show up as pivots that are negligible compared with
+the equation's own diagonal element. Those equations are dropped (their
+multipliers come out zero) which, for consistent equations, still gives a
+solution; unlike the dense solver's it is not the minimum-norm one. Badly
+scaled but independent equations are kept. */
+class SparseConstraintSolver {
+public:
+    SparseConstraintSolver() 
+    :   m(0), rank(0), analyzed(false), nonsymmetric(false) {}
+
+    /* There are m equations, partitioned into blocks (the Constraints).
+    blockEquations[b] lists the equations of block b and blockBranches[b] the
+    branches it acts on (any integer ids). Every equation must be in exactly
+    one block. */
+    void analyze(int m, const Array_<Array_<int> >& blockEquations,
+                 const Array_<Array_<int> >& blockBranches);
+    bool isAnalyzed() const {return analyzed;}
+
+    int getNumEquations() const {return m;}
+    int getNumProbes() const {return (int)probes.size();}
+    int getNumFactorNonzeros() const {return (int)colRows.size();}
+
+    /* Form A = G M^-1 ~G by calling multiply(x,y), which must set y=A*x,
+    once per probe, then factor it. Pivots smaller than pivotTol times the
+    diagonal element of their equation are dropped. If A turns out not to be
+    symmetric (it need not be if some constraints don't transmit forces along
+    ~G), or has a pivot that is significantly negative, this returns false
+    and the caller must use a general method instead. */
+    bool factor(const std::function<void(const Vector&, Vector&)>& multiply,
+                Real pivotTol);
+    int getRank() const {return rank;}
+
+    /* Whether factor() found A to be nonsymmetric since the last analyze().
+    That depends only on the kinds of constraints, so there is no point in
+    trying again until the equations change. */
+    bool isNonsymmetric() const {return nonsymmetric;}
+
+    /* After a successful factor(), solve A x = b. */
+    void solve(const Vector& b, Vector& x) const;
+
+private:
+    int position(int row, int col) const;
+
+    int m, rank;
+    bool analyzed, nonsymmetric;
+
+    // Elimination order: perm[k] is the equation eliminated k'th, and
+    // invPerm is its inverse. The rest is in terms of these positions.
+    Array_<int> perm, invPerm;
+
+    // Strictly lower triangle of L, by columns, rows ascending. Column k is
+    // colRows[colStart[k]] to colRows[colStart[k+1]-1]. Row k's entries
+    // are in columns rowCols[rowStart[k]] to rowCols[rowStart[k+1]-1], in
+    // ascending order, and are stored at the matching rowPos indices of
+    // colRows.
+    Array_<int> colStart, colRows;
+    Array_<int> rowStart, rowCols, rowPos;
+
+    // Each probe is a set of equations whose columns are found together.
+    // The rows that may be nonzero in an equation's column are the 
+    // equations of the blocks coupled to its block (including itself).
+    Array_<Array_<int> > probes;
+    Array_<Array_<int> > blockEquations;
+    Array_<Array_<int> > coupledBlocks;
+    Array_<int>          blockOf;     // equation -> block
+
+    // Numeric factor. Lx has the same layout as colRows; Ux is only used
+    // while assembling, to hold the upper triangle.
+    Array_<Real> Lx, Ux, D;
+    Array_<bool> dropped;
+};
+
+std::ostream& operator<<(std::ostream& o, const SparseConstraintSolver& s);
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_SPARSE_CONSTRAINT_SOLVER_H_
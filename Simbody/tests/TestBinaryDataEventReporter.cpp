@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Record a pendulum simulation with BinaryDataEventReporter and check that
+BinaryDataReader gives back exactly what was reported, frame by frame and by
+time, with buffers small enough that the ring wraps around many times and the
+last chunk is partly filled. */
+
+#include "SimTKsimbody.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+const char* DataFile = "TestBinaryDataEventReporter.dat";
+
+// Reports the pendulum's tip location, and keeps a copy of everything it
+// reported.
+class TipLocation : public BinaryDataEventReporter::UserFunction<Vector> {
+public:
+    TipLocation(const MobilizedBody& tip, Array_<Real>& times,
+                Array_<Vector>& values)
+    :   tip(tip), times(times), values(values) {}
+    Vector evaluate(const System& system, const State& state) override {
+        const Vec3 p = tip.getBodyOriginLocation(state);
+        Vector v(3);
+        for (int i=0; i < 3; ++i) v[i] = p[i];
+        times.push_back(state.getTime());
+        values.push_back(v);
+        return v;
+    }
+private:
+    const MobilizedBody&    tip;
+    Array_<Real>&           times;
+    Array_<Vector>&         values;
+};
+
+struct Pendulum {
+    Pendulum() : matter(system), forces(system) {
+        Force::Gravity(forces, matter, -YAxis, 9.8);
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        MobilizedBody::Pin link1(matter.Ground(), Vec3(0), body, Vec3(0,1,0));
+        MobilizedBody::Ball link2(link1, Vec3(0), body, Vec3(0,1,0));
+        tip = link2;
+    }
+    void simulate(Real finalTime) {
+        State state = system.realizeTopology();
+        tip.getParentMobilizedBody().setOneQ(state, 0, 1);
+        RungeKuttaMersonIntegrator integ(system);
+        TimeStepper ts(system, integ);
+        ts.initialize(state);
+        ts.stepTo(finalTime);
+    }
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    MobilizedBody           tip;
+};
+}
+
+void testRoundTrip() {
+    Pendulum pendulum;
+    Array_<Real> times;
+    Array_<Vector> values;
+    // 7 frames per chunk and a 5-frame ring.
+    BinaryDataEventReporter* reporter = new BinaryDataEventReporter
+       (pendulum.system, new TipLocation(pendulum.tip, times, values),
+        0.01, DataFile, 7, 5);
+    pendulum.system.addEventReporter(reporter);
+    pendulum.simulate(1);
+    reporter->close();
+    SimTK_TEST(reporter->getNumFrames() == 101);
+    reporter->close(); // harmless
+    SimTK_TEST_MUST_THROW(reporter->handleEvent(State()));
+
+    BinaryDataReader reader(DataFile);
+    SimTK_TEST(reader.getNumFrames() == 101);
+    SimTK_TEST(reader.getNumColumns() == 3);
+    SimTK_TEST(times.size() == 101);
+    Vector v;
+    for (int i=0; i < reader.getNumFrames(); ++i) {
+        SimTK_TEST(reader.getFrame(i, v) == times[i]);
+        SimTK_TEST(v.size() == 3);
+        for (int c=0; c < 3; ++c)
+            SimTK_TEST(v[c] == values[i][c]); // exact
+    }
+    // Out of order.
+    SimTK_TEST(reader.getTime(100) == times[100]);
+    SimTK_TEST(reader.getTime(3) == times[3]);
+    SimTK_TEST_MUST_THROW(reader.getTime(101));
+
+    // Random access by time.
+    SimTK_TEST(reader.findFrame(-1) == -1);
+    SimTK_TEST(reader.findFrame(0) == 0);
+    SimTK_TEST(reader.findFrame(0.505) == 50);
+    SimTK_TEST(reader.findFrame(times[69]) == 69);
+    SimTK_TEST(reader.findFrame(times[70]) == 70);
+    SimTK_TEST(reader.findFrame(2) == 100);
+}
+
+void testStateVariables() {
+    // Without a UserFunction the q's and u's are recorded.
+    Pendulum pendulum;
+    BinaryDataEventReporter* reporter =
+        new BinaryDataEventReporter(pendulum.system, 0.1, DataFile);
+    pendulum.system.addEventReporter(reporter);
+
+    State state = pendulum.system.realizeTopology();
+    pendulum.tip.getParentMobilizedBody().setOneQ(state, 0, 1);
+    RungeKuttaMersonIntegrator integ(pendulum.system);
+    TimeStepper ts(pendulum.system, integ);
+    ts.initialize(state);
+    ts.stepTo(0.5);
+    const State& last = ts.getState();
+    reporter->close();
+
+    BinaryDataReader reader(DataFile);
+    SimTK_TEST(reader.getNumFrames() == 6);
+    SimTK_TEST(reader.getNumColumns() == last.getNQ() + last.getNU());
+    Vector v;
+    SimTK_TEST(reader.getFrame(5, v) == last.getTime());
+    for (int i=0; i < last.getNQ(); ++i)
+        SimTK_TEST(v[i] == last.getQ()[i]);
+    for (int i=0; i < last.getNU(); ++i)
+        SimTK_TEST(v[last.getNQ()+i] == last.getU()[i]);
+}
+
+void testBadFiles() {
+    SimTK_TEST_MUST_THROW(BinaryDataReader("no/such/file.dat"));
+    { ofstream out(DataFile, ios::binary); out << "not a data file"; }
+    SimTK_TEST_MUST_THROW(BinaryDataReader reader(DataFile));
+
+    // An empty recording is still a valid file.
+    {
+        MultibodySystem system;
+        BinaryDataEventReporter reporter(system, 0.1, DataFile);
+    }
+    BinaryDataReader reader(DataFile);
+    SimTK_TEST(reader.getNumFrames() == 0);
+    SimTK_TEST(reader.findFrame(1) == -1);
+    std::remove(DataFile);
+}
+
+int main() {
+    SimTK_START_TEST("TestBinaryDataEventReporter");
+        SimTK_SUBTEST(testRoundTrip);
+        SimTK_SUBTEST(testStateVariables);
+        SimTK_SUBTEST(testBadFiles);
+    SimTK_END_TEST();
+}
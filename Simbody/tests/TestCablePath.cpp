@@ -0,0 +1,166 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Solve cable paths that wrap over moving spheres and check that the path
+length stays consistent with its time derivative, that the block elimination
+of the path error Jacobian agrees with a dense LU, and that solving the paths
+on several threads gives exactly the same answers as solving them serially. */
+
+#include "SimTKsimbody.h"
+#include "../src/CablePath_Impl.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+const Real Rad = 0.25;
+
+// Each cable runs between two Ground points and passes under numSpheres
+// spheres, each hanging from its own swinging pendulum.
+struct Cables {
+    Cables(int numCables, int numSpheres)
+    :   matter(system), cables(system), forces(system) {
+        Force::Gravity(forces, matter, -YAxis, 9.8);
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        for (int c=0; c < numCables; ++c) {
+            const Vec3 offset(0, 0, 2*c);
+            const Vec3 halfSpan(0.5*numSpheres + 0.5, 0, 0);
+            CablePath path(cables, matter.Ground(), offset - halfSpan,
+                                   matter.Ground(), offset + halfSpan);
+            for (int s=0; s < numSpheres; ++s) {
+                const Vec3 pivot = offset + Vec3(s-0.5*(numSpheres-1),0.9,0);
+                MobilizedBody::Ball bob(matter.Ground(), Transform(pivot),
+                                        body, Transform(Vec3(0,1,0)));
+                CableObstacle::Surface sphere(path, bob, Transform(),
+                                              ContactGeometry::Sphere(Rad));
+                sphere.setContactPointHints(Rad*UnitVec3(-.5,-1,0),
+                                            Rad*UnitVec3( .5,-1,0));
+            }
+            paths.push_back(path);
+        }
+    }
+
+    // Start the pendulums swinging and integrate to finalTime.
+    const State& simulate(Real finalTime) {
+        state = system.realizeTopology();
+        for (int i=0; i < state.getNU(); i += 3) {
+            state.updU()[i]   = 0.5 + 0.01*i;
+            state.updU()[i+2] = 0.3;
+        }
+        system.realize(state, Stage::Position);
+        for (unsigned c=0; c < paths.size(); ++c)
+            paths[c].setIntegratedCableLengthDot(state, 
+                                        paths[c].getCableLength(state));
+
+        RungeKuttaMersonIntegrator integ(system);
+        integ.setAccuracy(1e-5);
+        TimeStepper ts(system, integ);
+        ts.initialize(state);
+        ts.stepTo(finalTime);
+        // A copied State keeps only its Instance-stage cache.
+        state = ts.getState();
+        system.realize(state, Stage::Velocity);
+        return state;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    CableTrackerSubsystem   cables;
+    GeneralForceSubsystem   forces;
+    Array_<CablePath>       paths;
+    State                   state;
+};
+}
+
+// With two spheres the path error Jacobian has more than one block row.
+void testLengthMatchesRate() {
+    Cables cables(1, 2);
+    const State& state = cables.simulate(0.5);
+    const CablePath& path = cables.paths[0];
+    SimTK_TEST(path.getCableLength(state) > 3); // wraps over the spheres
+    SimTK_TEST_EQ_TOL(path.getCableLength(state),
+                      path.getIntegratedCableLengthDot(state), 1e-4);
+}
+
+// With more than one sphere touching the cable the Jacobian is block
+// tridiagonal, and is solved by block elimination. If a reduced pivot block is badly conditioned the
+// factorization must fall back to the dense LU instead.
+void testBlockFactorMatchesLU() {
+    Cables cables(1, 3);
+    const State& state = cables.simulate(0.2);
+    const Matrix& J = cables.paths[0].getImpl().getPosEntry(state).J;
+    const int nx = J.nrow();
+    SimTK_TEST(nx >= 12 && nx % 6 == 0 && J.ncol() == nx);
+
+    Random::Uniform rand(-1, 1);
+    Vector b(nx);
+    for (int i=0; i < nx; ++i) b[i] = rand.getValue();
+
+    PathJacobianFactor banded;
+    banded.factor(J);
+    SimTK_TEST(banded.isBlockFactored());
+    Vector x, xLU;
+    banded.solve(b, x);
+    FactorLU(J).solve(b, xLU);
+    SimTK_TEST_EQ_TOL(x, xLU, 1e-10*xLU.normInf());
+    SimTK_TEST_EQ_TOL(J*x, b, 1e-10);
+
+    // J = [D0 I; I 2I] with D0 nearly singular is itself well conditioned.
+    Matrix Jbad(12, 12, Real(0));
+    for (int i=0; i < 12; ++i) Jbad(i,i) = i < 6 ? 1 : 2;
+    for (int i=0; i < 6; ++i) Jbad(i,i+6) = Jbad(i+6,i) = 1;
+    Jbad(0,0) = 1e-12;
+    Vector bBad(12);
+    for (int i=0; i < 12; ++i) bBad[i] = rand.getValue();
+    banded.factor(Jbad);
+    SimTK_TEST(!banded.isBlockFactored());
+    banded.solve(bBad, x);
+    FactorLU(Jbad).solve(bBad, xLU);
+    SimTK_TEST_EQ(x, xLU);
+}
+
+void testThreadsGiveSameAnswer() {
+    Cables serial(4, 1), parallel(4, 1);
+    parallel.cables.setNumberOfThreads(3);
+    SimTK_TEST(parallel.cables.getNumberOfThreads() == 3);
+    const State& serialState   = serial.simulate(0.5);
+    const State& parallelState = parallel.simulate(0.5);
+    for (unsigned c=0; c < serial.paths.size(); ++c) {
+        const Real length = serial.paths[c].getCableLength(serialState);
+        SimTK_TEST(length > 2);
+        SimTK_TEST(parallel.paths[c].getCableLength(parallelState) == length);
+        SimTK_TEST(parallel.paths[c].getCableLengthDot(parallelState)
+                   == serial.paths[c].getCableLengthDot(serialState));
+    }
+    SimTK_TEST_MUST_THROW(parallel.cables.setNumberOfThreads(0));
+}
+
+int main() {
+    SimTK_START_TEST("TestCablePath");
+        SimTK_SUBTEST(testLengthMatchesRate);
+        SimTK_SUBTEST(testBlockFactorMatchesLU);
+        SimTK_SUBTEST(testThreadsGiveSameAnswer);
+    SimTK_END_TEST();
+}
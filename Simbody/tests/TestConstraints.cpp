@@ -419,6 +419,63 @@ void testDisablingConstraints() {
     delete &system;
 }
 
+// A gripper that may pick up either of two objects. A Weld for each grasp is
+// created before realizeTopology(), disabled by default, and then enabled and
+// disabled in the State; none of that is a topology change.
+void testGraspingWithPreallocatedConstraints() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::UniformGravity gravity(forces, matter, Vec3(0, -9.8, 0));
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+    MobilizedBody::Free gripper(matter.updGround(), Vec3(0), body, Vec3(0));
+    MobilizedBody::Free object1(matter.updGround(), Vec3(0), body, Vec3(0));
+    MobilizedBody::Free object2(matter.updGround(), Vec3(0), body, Vec3(0));
+    Constraint::Weld grasp1(gripper, object1);
+    Constraint::Weld grasp2(gripper, object2);
+    grasp1.setDisabledByDefault(true);
+    grasp2.setDisabledByDefault(true);
+
+    State state = system.realizeTopology();
+    const StageVersion topologyVersion = system.getSystemTopologyCacheVersion();
+    gripper.setQToFitTranslation(state, Vec3(1, 0, 0));
+    object1.setQToFitTranslation(state, Vec3(1, 0, 0));
+    object2.setQToFitTranslation(state, Vec3(2, 0, 0));
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(state.getNMultipliers() == 0);
+    const Vector q = state.getQ();
+
+    // Pick up the first object.
+    grasp1.enable(state);
+    SimTK_TEST(system.systemTopologyHasBeenRealized());
+    SimTK_TEST(system.getSystemTopologyCacheVersion() == topologyVersion);
+    SimTK_TEST(state.getSystemTopologyStageVersion() == topologyVersion);
+    SimTK_TEST(state.getSystemStage() == Stage::Model);
+    SimTK_TEST((state.getQ() - q).normInf() == 0);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(state.getNMultipliers() == 6);
+    // The gripper now carries the object's weight.
+    SimTK_TEST_EQ(gripper.getBodyOriginAcceleration(state),
+                  object1.getBodyOriginAcceleration(state));
+    SimTK_TEST_EQ(gripper.getBodyOriginAcceleration(state)[1], Real(-9.8));
+
+    // Put it down and pick up the other one.
+    grasp1.disable(state);
+    grasp2.enable(state);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(state.getNMultipliers() == 6);
+    SimTK_TEST(grasp1.isDisabled(state) && !grasp2.isDisabled(state));
+    grasp2.disable(state);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST(state.getNMultipliers() == 0);
+    SimTK_TEST(system.getSystemTopologyCacheVersion() == topologyVersion);
+    SimTK_TEST((state.getQ() - q).normInf() == 0);
+
+    // Adding a Constraint instead is a topology change.
+    Constraint::Weld grasp3(gripper, object2);
+    SimTK_TEST(!system.systemTopologyHasBeenRealized());
+}
+
 void testConstraintForces() {
     // Weld one body to ground, push on it, verify that it reacts to match the load.
     MultibodySystem system;
@@ -739,5 +796,6 @@ int main() {
         SimTK_SUBTEST(testConstraintMatrices);
         SimTK_SUBTEST(testConstraintAccelerationErrors);
         SimTK_SUBTEST(testDisablingConstraints);
+        SimTK_SUBTEST(testGraspingWithPreallocatedConstraints);
     SimTK_END_TEST();
 }
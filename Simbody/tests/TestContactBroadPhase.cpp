@@ -0,0 +1,184 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that all the broad phase algorithms available in the contact
+subsystems, run serially or on several threads, find exactly the same 
+contacts as the original single-axis sweep, including after the bodies move
+(which exercises the incremental updates). */
+
+#include "SimTKsimbody.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+using namespace SimTK;
+using namespace std;
+
+typedef Array_<pair<int,int> > PairList;
+
+// A pile of free spheres of assorted sizes, bunched up along x so that the
+// single-axis sweep sees plenty of overlap, lying on a ground half space.
+class SpherePile {
+public:
+    explicit SpherePile(int nSpheres) 
+    :   matter(system), contacts(system), tracker(system) {
+        Random::Uniform rand(0, 1);
+        rand.setSeed(11);
+        setIndex = contacts.createContactSet();
+        contacts.addBody(setIndex, matter.updGround(), 
+            ContactGeometry::HalfSpace(), 
+            Transform(Rotation(-Pi/2, ZAxis))); // y < 0 
+        const ContactMaterial material(1e6, 0, 0, 0, 0);
+        for (int i=0; i < nSpheres; ++i) {
+            const Real radius = 0.05 + 0.1*rand.getValue();
+            Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+            body.addContactSurface(Transform(), 
+                ContactSurface(ContactGeometry::Sphere(radius), material));
+            MobilizedBody::Free sphere(matter.updGround(), body);
+            contacts.addBody(setIndex, sphere, 
+                             ContactGeometry::Sphere(radius), Transform());
+            spheres.push_back(sphere);
+        }
+    }
+
+    // Put the spheres at random locations in a box.
+    void scatter(State& state, int seed) const {
+        Random::Uniform rand(0, 1);
+        rand.setSeed(seed);
+        for (const MobilizedBody& sphere : spheres)
+            sphere.setQToFitTranslation(state, 
+                Vec3(rand.getValue(), 3*rand.getValue()-0.1, 
+                     2*rand.getValue()));
+    }
+
+    // Move each sphere a little. The current locations must all be read
+    // before any q is changed.
+    void jiggle(State& state, int seed) const {
+        Random::Uniform rand(-0.02, 0.02);
+        rand.setSeed(seed);
+        Array_<Vec3> locations;
+        for (const MobilizedBody& sphere : spheres)
+            locations.push_back(sphere.getBodyOriginLocation(state) 
+                + Vec3(rand.getValue(), rand.getValue(), rand.getValue()));
+        for (int i=0; i < (int)spheres.size(); ++i)
+            spheres[i].setQToFitTranslation(state, locations[i]);
+    }
+
+    PairList getGeneralContactPairs(const State& state) const {
+        PairList pairs;
+        for (const Contact& c : contacts.getContacts(state, setIndex))
+            pairs.push_back(make_pair((int)c.getSurface1(), 
+                                      (int)c.getSurface2()));
+        return pairs;
+    }
+
+    PairList getTrackedPairs(const State& state) const {
+        PairList pairs;
+        const ContactSnapshot& snapshot = tracker.getActiveContacts(state);
+        for (int i=0; i < snapshot.getNumContacts(); ++i) {
+            const Contact& c = snapshot.getContact(i);
+            pairs.push_back(make_pair((int)c.getSurface1(), 
+                                      (int)c.getSurface2()));
+        }
+        return pairs;
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    GeneralContactSubsystem     contacts;
+    ContactTrackerSubsystem     tracker;
+    ContactSetIndex             setIndex;
+    Array_<MobilizedBody>       spheres;
+};
+
+static PairList sorted(PairList pairs) {
+    for (auto& p : pairs)
+        if (p.first > p.second) swap(p.first, p.second);
+    sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+// Compute the contacts at two nearby configurations, reusing one State so
+// that any broad phase coherence data is carried from the first to the second.
+static void findContacts(SpherePile& pile, PairList general[2], 
+                         PairList tracked[2]) {
+    State state = pile.system.realizeTopology();
+    pile.scatter(state, 3);
+    pile.system.realize(state, Stage::Dynamics);
+    general[0] = pile.getGeneralContactPairs(state);
+    tracked[0] = pile.getTrackedPairs(state);
+
+    pile.jiggle(state, 4);
+    pile.system.realize(state, Stage::Dynamics);
+    general[1] = pile.getGeneralContactPairs(state);
+    tracked[1] = pile.getTrackedPairs(state);
+}
+
+void testBroadPhasesAgree() {
+    SpherePile pile(600);
+    SimTK_TEST(pile.contacts.getBroadPhase() 
+               == GeneralContactSubsystem::SingleAxisSweep);
+    SimTK_TEST(pile.tracker.getBroadPhase() 
+               == ContactTrackerSubsystem::SingleAxisSweep);
+
+    PairList generalRef[2], trackedRef[2];
+    findContacts(pile, generalRef, trackedRef);
+    SimTK_TEST(generalRef[0].size() > 100); // make sure this is a real test
+    SimTK_TEST(trackedRef[0].size() > 100);
+
+    for (int method = 0; method < 3; ++method) {
+        for (int nThreads = 1; nThreads <= 4; nThreads += 3) {
+            pile.contacts.setBroadPhase
+                (GeneralContactSubsystem::BroadPhase(method));
+            pile.tracker.setBroadPhase
+                (ContactTrackerSubsystem::BroadPhase(method));
+            pile.contacts.setNumberOfThreads(nThreads);
+            pile.tracker.setNumberOfThreads(nThreads);
+            SimTK_TEST(pile.contacts.getNumberOfThreads() == nThreads);
+            SimTK_TEST(pile.tracker.getNumberOfThreads() == nThreads);
+
+            PairList general[2], tracked[2];
+            findContacts(pile, general, tracked);
+            for (int k=0; k < 2; ++k) {
+                // The single-axis sweep must reproduce the original order
+                // exactly; the others report the same contacts.
+                if (method == GeneralContactSubsystem::SingleAxisSweep) {
+                    SimTK_TEST(general[k] == generalRef[k]);
+                } else {
+                    SimTK_TEST(sorted(general[k]) == sorted(generalRef[k]));
+                }
+                SimTK_TEST(tracked[k] == trackedRef[k]);
+            }
+        }
+    }
+
+    SimTK_TEST_MUST_THROW(pile.contacts.setNumberOfThreads(0));
+    SimTK_TEST_MUST_THROW(pile.tracker.setNumberOfThreads(0));
+}
+
+int main() {
+    SimTK_START_TEST("TestContactBroadPhase");
+        SimTK_SUBTEST(testBroadPhasesAgree);
+    SimTK_END_TEST();
+}
@@ -266,11 +266,62 @@ void testEffSphereOnPlaneNewFormulation(bool verbose = false)
     }
 }
 
+// Two overlapping sphere meshes moving through a series of positions. The 
+// forces evaluated with several threads, warm-started from the previous 
+// position, must match those evaluated serially from scratch.
+void testMeshOnMeshThreads() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralContactSubsystem contacts(system);
+    GeneralForceSubsystem forces(system);
+    const ContactSetIndex setIndex = contacts.createContactSet();
+    const PolygonalMesh sphereMesh(PolygonalMesh::createSphereMesh(1.0, 5));
+    const Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Free ball1(matter.updGround(), Transform(), body, Transform());
+    MobilizedBody::Free ball2(matter.updGround(), Transform(), body, Transform());
+    contacts.addBody(setIndex, ball1, ContactGeometry::TriangleMesh(sphereMesh), Transform());
+    contacts.addBody(setIndex, ball2, ContactGeometry::TriangleMesh(sphereMesh), Transform());
+    ElasticFoundationForce ef(forces, contacts, setIndex);
+    ef.setBodyParameters(ContactSurfaceIndex(0), 1e6, 0.1, 0.2, 0.1, 0.01);
+    ef.setBodyParameters(ContactSurfaceIndex(1), 2e6, 0.1, 0.2, 0.1, 0.01);
+    ASSERT(ef.getNumberOfThreads() == 1);
+    State state = system.realizeTopology();
+    const State fresh = state;
+
+    for (int i = 0; i < 10; i++) {
+        ball1.setQToFitTransform(state, Transform(Rotation(0.05*i, ZAxis), Vec3(0)));
+        ball2.setQToFitTransform(state, Transform(Rotation(-0.03*i, YAxis), Vec3(1.9-0.03*i, 0.05*i, 0)));
+        ball1.setUToFitLinearVelocity(state, Vec3(0.1, 0, 0.2));
+        ball2.setUToFitLinearVelocity(state, Vec3(-0.3, 0.1, 0));
+
+        ef.setNumberOfThreads(1);
+        State serial = fresh;
+        serial.updQ() = state.getQ();
+        serial.updU() = state.getU();
+        system.realize(serial, Stage::Dynamics);
+
+        ef.setNumberOfThreads(4);
+        ASSERT(ef.getNumberOfThreads() == 4);
+        system.realize(state, Stage::Dynamics);
+
+        const Vector_<SpatialVec>& expected = system.getRigidBodyForces(serial, Stage::Dynamics);
+        const Vector_<SpatialVec>& actual = system.getRigidBodyForces(state, Stage::Dynamics);
+        for (MobilizedBodyIndex b(0); b < matter.getNumBodies(); ++b) {
+            assertEqual(actual[b][0], expected[b][0]);
+            assertEqual(actual[b][1], expected[b][1]);
+        }
+        assertEqual(system.calcPotentialEnergy(state), system.calcPotentialEnergy(serial));
+        if (i > 0)
+            ASSERT(expected[ball2.getMobilizedBodyIndex()][1].norm() > 0);
+    }
+}
+
 int main() {
     try {
         testForces();
         testEffSphereOnPlaneOldFormulation();
         testEffSphereOnPlaneNewFormulation();
+        testMeshOnMeshThreads();
     }
     catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
@@ -356,12 +356,97 @@ void testDisabling() {
     ASSERT(!forces.isForceDisabled(state, spring.getForceIndex()));
 }
 
+/**
+ * Test that adding a Force rebuilds only its own force subsystem, and that an
+ * existing State can be brought up to date without losing its contents.
+ */
+
+void testIncrementalTopologyChange() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    GeneralForceSubsystem otherForces(system);
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin body1(matter.updGround(), Vec3(0), 
+                             body, Vec3(BOND_LENGTH, 0, 0));
+    MobilizedBody::Free body2(matter.updGround(), Vec3(0), body, Vec3(0));
+    Force::UniformGravity gravity(forces, matter, Vec3(0, -2.0, 0));
+    MyForceImpl* impl = new MyForceImpl();
+    Force::Custom custom(otherForces, impl);
+    Force::MobilityLinearDamper damper(otherForces, body1, 0, 3.0);
+
+    // By default, any topology change rebuilds everything.
+    ASSERT(!system.getUsePartialTopologyRealization());
+    system.realizeTopology();
+    Force::MobilityLinearDamper extraDamper(otherForces, body1, 0, 1.0);
+    ASSERT(!matter.subsystemTopologyHasBeenRealized());
+    ASSERT(!forces.subsystemTopologyHasBeenRealized());
+    system.setUsePartialTopologyRealization(true);
+
+    State state = system.realizeTopology();
+    state.setTime(1.5);
+    body1.setOneQ(state, 0, 0.25);
+    body1.setOneU(state, 0, -0.5);
+    body2.setQToFitTranslation(state, Vec3(1, 2, 3));
+    otherForces.setForceIsDisabled(state, damper.getForceIndex(), true);
+    const Vector y = state.getY();
+
+    // Adding a Force invalidates topology, but only the force subsystem it
+    // was added to gets rebuilt.
+    impl->hasRealized[Stage::Topology] = false;
+    const int nMatterBodies = matter.getNumBodies();
+    Force::TwoPointLinearSpring spring(forces, body1, Vec3(0), body2, Vec3(0),
+                                       2.0, 0.5);
+    ASSERT(!system.systemTopologyHasBeenRealized());
+    ASSERT(matter.subsystemTopologyHasBeenRealized());
+    ASSERT(otherForces.subsystemTopologyHasBeenRealized());
+    ASSERT(!forces.subsystemTopologyHasBeenRealized());
+    system.realizeTopology();
+    ASSERT(!impl->hasRealized[Stage::Topology]);
+    ASSERT(matter.getNumBodies() == nMatterBodies);
+    ASSERT(forces.getNumForces() == 2);
+
+    // The old State no longer matches the System but can be updated.
+    ASSERT(state.getSystemTopologyStageVersion() 
+           != system.getSystemTopologyCacheVersion());
+    system.updateStateToCurrentTopology(state);
+    ASSERT(state.getSystemTopologyStageVersion() 
+           == system.getSystemTopologyCacheVersion());
+    ASSERT(state.getTime() == 1.5);
+    ASSERT((state.getY() - y).norm() == 0);
+    ASSERT(otherForces.isForceDisabled(state, damper.getForceIndex()));
+    ASSERT(!forces.isForceDisabled(state, spring.getForceIndex()));
+
+    // The State computes the same forces as one made from scratch.
+    State fresh = system.getDefaultState();
+    fresh.setTime(1.5);
+    fresh.updY() = y;
+    otherForces.setForceIsDisabled(fresh, damper.getForceIndex(), true);
+    system.realize(state, Stage::Dynamics);
+    system.realize(fresh, Stage::Dynamics);
+    ASSERT_EQUAL(system.calcEnergy(fresh), system.calcEnergy(state));
+    for (MobilizedBodyIndex b(0); b < matter.getNumBodies(); ++b)
+        ASSERT((system.getRigidBodyForces(state, Stage::Dynamics)[b]
+                - system.getRigidBodyForces(fresh, Stage::Dynamics)[b])
+               .norm() < 1e-10);
+
+    // A matter topology change still forces everything to be rebuilt.
+    MobilizedBody::Pin body3(body1, Vec3(0), body, Vec3(BOND_LENGTH, 0, 0));
+    system.realizeTopology();
+    ASSERT(impl->hasRealized[Stage::Topology]);
+    system.updateStateToCurrentTopology(state);
+    ASSERT(state.getNQ() == fresh.getNQ() + 1);
+    ASSERT(body1.getOneQ(state, 0) == 0); // default
+    ASSERT(!otherForces.isForceDisabled(state, damper.getForceIndex()));
+}
+
 int main() {
     try {
         testStandardForces();
         testEnergyConservation();
         testCustomRealization();
         testDisabling();
+        testIncrementalTopologyChange();
     }
     catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
@@ -0,0 +1,341 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that the matrix-free compliance used by the impulse solvers
+reproduces the dense G M\ ~G, that the PGS solver gives the same impulses
+with either form, and that SemiExplicitEulerTimeStepper gives the same
+motion with either form while warm starting saves PGS iterations. Also check
+that solving the independent islands separately, serially or in parallel,
+gives the same motion as one monolithic solve. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Gives access to the iteration counts.
+class CountingPGSImpulseSolver : public PGSImpulseSolver {
+public:
+    explicit CountingPGSImpulseSolver(Real roll2slipTransitionSpeed)
+    :   PGSImpulseSolver(roll2slipTransitionSpeed) {}
+    long long getNumIterations(int phase) const {return m_nIters[phase];}
+};
+
+// A chain of free bodies tied to Ground at one end, with a two-body pendulum
+// branch tied to one of them by a Rod, so there are Constraints that share
+// branches and Constraints that don't.
+struct Chain {
+    explicit Chain(int n) : matter(system), forces(system) {
+        Force::Gravity(forces, matter, -YAxis, 9.8);
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(0.1)));
+        const Vec3 half(0.5, 0, 0);
+        Array_<MobilizedBody> nodes;
+        for (int i=0; i < n; ++i)
+            nodes.push_back(MobilizedBody::Free(matter.Ground(), Vec3(i,0,0),
+                                                body, Vec3(0)));
+        balls.push_back(Constraint::Ball(matter.updGround(), -half,
+                                         nodes[0], -half));
+        for (int i=0; i+1 < n; ++i)
+            balls.push_back(Constraint::Ball(nodes[i], half,
+                                             nodes[i+1], -half));
+        MobilizedBody::Pin top(matter.Ground(), Vec3(1,1,1), body, Vec3(0));
+        MobilizedBody::Pin bottom(top, Vec3(0,-0.5,0), body, Vec3(0));
+        rod = Constraint::Rod(bottom, nodes[n/2], 1.5);
+    }
+
+    State makeState() {
+        State state = system.realizeTopology();
+        Random::Uniform rand(-0.1, 0.1);
+        rand.setSeed(5);
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] += rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+        system.realize(state, Stage::Velocity);
+        return state;
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    GeneralForceSubsystem       forces;
+    Array_<Constraint::Ball>    balls;
+    Constraint::Rod             rod;
+};
+
+void testComplianceMatchesDense() {
+    Chain chain(8);
+    const State state = chain.makeState();
+    const int m = state.getNMultipliers();
+
+    Matrix GMInvGt;
+    chain.matter.calcProjectedMInv(state, GMInvGt);
+
+    ImpulseSolver::SparseCompliance compliance;
+    compliance.calc(chain.matter, state);
+    SimTK_TEST(compliance.size() == m);
+    // Each ball shares a body only with its neighbors and the rod, so a few
+    // groups of three equations cover them all.
+    SimTK_TEST(compliance.getNumProbes() < m);
+
+    Matrix A;
+    compliance.calcMatrix(A);
+    SimTK_TEST_EQ_TOL(A, GMInvGt, 1e-12);
+    for (MultiplierIndex j(0); j < m; ++j)
+        SimTK_TEST_EQ_TOL(compliance.getDiag(j), GMInvGt(j,j), 1e-12);
+
+    Random::Gaussian rand;
+    Vector pi(m), Api;
+    for (int i=0; i < m; ++i) pi[i] = rand.getValue();
+    compliance.multiply(pi, Api);
+    SimTK_TEST_EQ_TOL(Api, GMInvGt*pi, 1e-12);
+
+    // A subset of the rows gives that principal submatrix.
+    Array_<MultiplierIndex> rows;
+    for (MultiplierIndex j(1); j < m; j += 3) rows.push_back(j);
+    ImpulseSolver::SparseCompliance sub;
+    compliance.calcSubset(rows, sub);
+    SimTK_TEST(sub.size() == (int)rows.size());
+    SimTK_TEST(sub.getNumMobilities() < compliance.getNumMobilities());
+    Matrix subA;
+    sub.calcMatrix(subA);
+    for (unsigned r=0; r < rows.size(); ++r)
+        for (unsigned c=0; c < rows.size(); ++c)
+            SimTK_TEST_EQ_TOL(subA(r,c), GMInvGt(rows[r],rows[c]), 1e-12);
+}
+
+void testPGSMatchesDense() {
+    Chain chain(6);
+    const State state = chain.makeState();
+    const int m = state.getNMultipliers();
+
+    Matrix GMInvGt;
+    chain.matter.calcProjectedMInv(state, GMInvGt);
+    ImpulseSolver::SparseCompliance compliance;
+    compliance.calc(chain.matter, state);
+
+    Random::Gaussian rand;
+    rand.setSeed(11);
+    Vector D(m, Real(0)), rhs(m);
+    for (int i=0; i < m; ++i) rhs[i] = rand.getValue();
+
+    Array_<MultiplierIndex> all;
+    for (MultiplierIndex j(0); j < m; ++j) all.push_back(j);
+
+    PGSImpulseSolver pgs(0.01);
+    pgs.setConvergenceTol(1e-10);
+    pgs.setMaxIterations(10000);
+
+    // Bilateral.
+    Vector piDense, piSparse;
+    SimTK_TEST(pgs.solveBilateral(all, GMInvGt, D, rhs, piDense));
+    SimTK_TEST(pgs.solveBilateral(all, compliance, D, rhs, piSparse));
+    SimTK_TEST_EQ_TOL(piSparse, piDense, 1e-8);
+
+    // Treat each ball as a frictional unilateral contact and the rod as
+    // unconditional.
+    Array_<ImpulseSolver::UncondRT> uncond(1);
+    Array_<ImpulseSolver::UniContactRT> uni;
+    Array_<ImpulseSolver::UniSpeedRT> noSpeed;
+    Array_<ImpulseSolver::BoundedRT> noBounded;
+    Array_<ImpulseSolver::ConstraintLtdFrictionRT> noConsLtd;
+    Array_<ImpulseSolver::StateLtdFrictionRT> noStateLtd;
+    MultiplierIndex px0, vx0, ax0;
+    chain.rod.getIndexOfMultipliersInUse(state, px0, vx0, ax0);
+    uncond[0].m_mults.push_back(px0);
+    for (unsigned b=0; b < chain.balls.size(); ++b) {
+        chain.balls[b].getIndexOfMultipliersInUse(state, px0, vx0, ax0);
+        uni.push_back(ImpulseSolver::UniContactRT());
+        ImpulseSolver::UniContactRT& rt = uni.back();
+        rt.m_Nk = px0;
+        rt.m_Fk.push_back(MultiplierIndex(px0+1));
+        rt.m_Fk.push_back(MultiplierIndex(px0+2));
+        rt.m_type = ImpulseSolver::Participating;
+        rt.m_effMu = 0.5;
+    }
+
+    Vector piExpand(m, Real(0)), verrDense = rhs, verrSparse = rhs, noVerr;
+    Array_<ImpulseSolver::UniContactRT> uniSparse = uni;
+    pgs.solve(0, all, GMInvGt, D, Array_<MultiplierIndex>(), piExpand,
+              verrDense, noVerr, piDense, uncond, uni, noSpeed, noBounded,
+              noConsLtd, noStateLtd);
+    pgs.solve(0, all, compliance, D, Array_<MultiplierIndex>(), piExpand,
+              verrSparse, noVerr, piSparse, uncond, uniSparse, noSpeed,
+              noBounded, noConsLtd, noStateLtd);
+    SimTK_TEST_EQ_TOL(piSparse, piDense, 1e-8);
+    SimTK_TEST_EQ_TOL(verrSparse, verrDense, 1e-8);
+    for (unsigned k=0; k < uni.size(); ++k) {
+        SimTK_TEST(uniSparse[k].m_contactCond == uni[k].m_contactCond);
+        SimTK_TEST(uniSparse[k].m_frictionCond == uni[k].m_frictionCond);
+    }
+}
+
+// Boxes resting on the ground on their four bottom corners, one of them with
+// a second box sliding across its top.
+struct Boxes {
+    explicit Boxes(int n) : matter(system), forces(system) {
+        Force::Gravity(forces, matter, -ZAxis, 9.8);
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1./6)));
+        for (int i=0; i < n; ++i) {
+            MobilizedBody::Free box(matter.Ground(), Vec3(2*i,0,0.5),
+                                    body, Vec3(0));
+            addCorners(matter.Ground(), 0, box);
+            if (i == 0) {
+                top = MobilizedBody::Free(matter.Ground(), Vec3(0,0,1.5),
+                                          body, Vec3(0));
+                addCorners(box, 0.5, top);
+            }
+        }
+    }
+
+    void addCorners(MobilizedBody& base, Real height, MobilizedBody& box) {
+        for (int i=-1; i<=1; i+=2)
+        for (int j=-1; j<=1; j+=2)
+            matter.adoptUnilateralContact(new PointPlaneContact
+               (base, ZAxis, height, box, Vec3(0.5*i,0.5*j,-0.5),
+                0, 0.5, 0.4, 0));
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    GeneralForceSubsystem       forces;
+    MobilizedBody::Free         top;
+};
+
+// Returns the final State; fills in the number of PGS iterations used.
+State simulate(Boxes& boxes, bool matrixFree, bool warmStart,
+               long long& iterations) {
+    boxes.system.realizeTopology();
+    State state = boxes.system.getDefaultState();
+    boxes.top.setUToFitLinearVelocity(state, Vec3(0.5,0,0));
+
+    SemiExplicitEulerTimeStepper stepper(boxes.system);
+    CountingPGSImpulseSolver* pgs = new CountingPGSImpulseSolver
+        (stepper.getDefaultFrictionTransitionVelocityInUse());
+    stepper.setImpulseSolver(pgs);
+    stepper.setUseMatrixFreeCompliance(matrixFree);
+    stepper.setWarmStartImpulses(warmStart);
+    stepper.initialize(state);
+    for (int step=1; step <= 300; ++step)
+        stepper.stepTo(step*0.001);
+    iterations = pgs->getNumIterations(0);
+    return stepper.getState();
+}
+
+void testStepper() {
+    Boxes boxes(3);
+    long long densePlain, denseWarm, sparseWarm;
+    const State plain  = simulate(boxes, false, false, densePlain);
+    const State dense  = simulate(boxes, false, true,  denseWarm);
+    const State sparse = simulate(boxes, true,  true,  sparseWarm);
+    cout << "PGS iterations: cold " << densePlain << ", warm " << denseWarm
+         << ", warm matrix-free " << sparseWarm << endl;
+
+    // Matrix-free gives the same motion up to roundoff; warm starting changes
+    // it only within the PGS convergence tolerance.
+    SimTK_TEST_EQ_TOL(sparse.getQ(), dense.getQ(), 1e-6);
+    SimTK_TEST_EQ_TOL(sparse.getU(), dense.getU(), 1e-6);
+    SimTK_TEST_EQ_TOL(dense.getQ(), plain.getQ(), 1e-3);
+    SimTK_TEST(denseWarm < densePlain);
+}
+
+State simulateIslands(Boxes& boxes, bool matrixFree, bool useIslands, 
+                      unsigned numThreads, int& numIslands) {
+    boxes.system.realizeTopology();
+    State state = boxes.system.getDefaultState();
+    boxes.top.setUToFitLinearVelocity(state, Vec3(0.5,0,0));
+
+    SemiExplicitEulerTimeStepper stepper(boxes.system);
+    SimTK_TEST(!stepper.getUseIslands()); // off by default
+    stepper.setUseMatrixFreeCompliance(matrixFree);
+    stepper.setUseIslands(useIslands);
+    stepper.setNumberOfThreads(numThreads);
+    SimTK_TEST(stepper.getNumberOfThreads() == numThreads);
+    stepper.initialize(state);
+    for (int step=1; step <= 200; ++step)
+        stepper.stepTo(step*0.001);
+    numIslands = stepper.getNumIslands();
+    return stepper.getState();
+}
+
+void testIslands() {
+    // The first box and the one on top of it make one island; each other box
+    // is an island by itself.
+    Boxes boxes(6);
+    int nWhole, nSerial, nParallel, nSparse;
+    const State whole    = simulateIslands(boxes, false, false, 1, nWhole);
+    const State serial   = simulateIslands(boxes, false, true,  1, nSerial);
+    const State parallel = simulateIslands(boxes, false, true,  4, nParallel);
+    const State sparse   = simulateIslands(boxes, true,  true,  4, nSparse);
+    SimTK_TEST(nWhole == 1);
+    SimTK_TEST(nSerial == 6 && nParallel == 6 && nSparse == 6);
+
+    // Each island is solved by its own solver in the same order regardless
+    // of threading, so the results are identical.
+    SimTK_TEST((parallel.getQ() - serial.getQ()).normInf() == 0);
+    SimTK_TEST((parallel.getU() - serial.getU()).normInf() == 0);
+    SimTK_TEST_EQ_TOL(sparse.getQ(), serial.getQ(), 1e-4);
+    SimTK_TEST_EQ_TOL(serial.getQ(), whole.getQ(), 1e-3);
+    SimTK_TEST_EQ_TOL(serial.getU(), whole.getU(), 1e-2);
+}
+
+// Changing the ImpulseSolver's settings partway through must affect the
+// islands' solves too.
+State simulateIslandsLimitingIterations(Boxes& boxes, int maxIters) {
+    boxes.system.realizeTopology();
+    State state = boxes.system.getDefaultState();
+    boxes.top.setUToFitLinearVelocity(state, Vec3(0.5,0,0));
+
+    SemiExplicitEulerTimeStepper stepper(boxes.system);
+    CountingPGSImpulseSolver* pgs = new CountingPGSImpulseSolver
+        (stepper.getDefaultFrictionTransitionVelocityInUse());
+    stepper.setImpulseSolver(pgs);
+    stepper.setUseIslands(true);
+    stepper.setNumberOfThreads(2);
+    stepper.initialize(state);
+    for (int step=1; step <= 200; ++step) {
+        if (step == 100) pgs->setMaxIterations(maxIters);
+        stepper.stepTo(step*0.001);
+    }
+    SimTK_TEST(stepper.getNumIslands() > 1);
+    return stepper.getState();
+}
+
+void testIslandSolverSettings() {
+    Boxes boxes(4);
+    const int defaultMaxIters = 
+        PGSImpulseSolver(0.01).getMaxIterations();
+    const State unchanged = 
+        simulateIslandsLimitingIterations(boxes, defaultMaxIters);
+    const State limited = simulateIslandsLimitingIterations(boxes, 1);
+    SimTK_TEST((limited.getU() - unchanged.getU()).normInf() > 0);
+}
+
+int main() {
+    SimTK_START_TEST("TestImpulseSolver");
+        SimTK_SUBTEST(testComplianceMatchesDense);
+        SimTK_SUBTEST(testPGSMatchesDense);
+        SimTK_SUBTEST(testStepper);
+        SimTK_SUBTEST(testIslands);
+        SimTK_SUBTEST(testIslandSolverSettings);
+    SimTK_END_TEST();
+}
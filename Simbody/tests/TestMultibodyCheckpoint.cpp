@@ -0,0 +1,122 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check StateCheckpoint with a real MultibodySystem: the matter subsystem's
+own variables can't be written unless they are explicitly skipped, and a
+simulation resumed from a checkpoint in a fresh State proceeds exactly as one
+resumed from a copy of the State that was saved. */
+
+#include "SimTKsimbody.h"
+
+#include <cstdio>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+const char* ChkFile = "TestMultibodyCheckpoint.chk";
+
+struct Pendulum {
+    Pendulum() : matter(system), forces(system),
+        gravity(forces, matter, -YAxis, 9.8) {
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        MobilizedBody::Pin link1(matter.Ground(), Transform(),
+                                 body, Vec3(0,1,0));
+        MobilizedBody::Pin link2(link1, Transform(), body, Vec3(0,1,0));
+        push = Force::MobilityDiscreteForce(forces, link2, MobilizerUIndex(0));
+        damper = Force::MobilityLinearDamper(forces, link1,
+                                             MobilizerUIndex(0), 0.5);
+        links.push_back(link1); links.push_back(link2);
+    }
+
+    // Run from state to time tFinal with a fresh integrator.
+    State run(const State& state, Real tFinal) const {
+        RungeKuttaMersonIntegrator integ(system);
+        integ.setAccuracy(1e-8);
+        TimeStepper ts(system, integ);
+        ts.initialize(state);
+        ts.stepTo(tFinal);
+        return integ.getState();
+    }
+
+    MultibodySystem                 system;
+    SimbodyMatterSubsystem          matter;
+    GeneralForceSubsystem           forces;
+    Force::Gravity                  gravity;
+    Force::MobilityDiscreteForce    push;
+    Force::MobilityLinearDamper     damper;
+    Array_<MobilizedBody>           links;
+};
+
+// Vector has no operator==; this compares every element exactly.
+bool isSame(const Vector& a, const Vector& b) {
+    if (a.size() != b.size()) return false;
+    for (int i=0; i < a.size(); ++i)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+}
+
+void testResumeExactly() {
+    Pendulum pendulum;
+    State state = pendulum.system.realizeTopology();
+    pendulum.links[0].setOneU(state, 0, 1);
+    pendulum.links[1].setOneQ(state, 0, 0.5);
+    // These are Dynamics and Instance stage discrete variables of types a
+    // checkpoint can hold.
+    pendulum.push.setMobilityForce(state, 0.25);
+    pendulum.damper.disable(state);
+
+    const State atOne = pendulum.run(state, 1);
+
+    // The matter subsystem's variables have types of their own.
+    SimTK_TEST_MUST_THROW(StateCheckpoint::write(atOne, ChkFile));
+    SimTK_TEST(StateCheckpoint::write(atOne, ChkFile, true) > 0);
+
+    State restored = pendulum.system.realizeTopology();
+    pendulum.system.realizeModel(restored);
+    {
+    StateCheckpoint chk(ChkFile);
+    SimTK_TEST(chk.isCompatible(restored));
+    chk.restore(restored);
+    }
+    SimTK_TEST(restored.getTime() == atOne.getTime());
+    SimTK_TEST(isSame(restored.getQ(), atOne.getQ())); // exact
+    SimTK_TEST(isSame(restored.getU(), atOne.getU()));
+    SimTK_TEST(pendulum.push.getMobilityForce(restored) == 0.25);
+    SimTK_TEST(pendulum.damper.isDisabled(restored));
+
+    const State fromCopy = pendulum.run(atOne, 2);
+    const State fromCheckpoint = pendulum.run(restored, 2);
+    SimTK_TEST(fromCheckpoint.getTime() == fromCopy.getTime());
+    SimTK_TEST(isSame(fromCheckpoint.getQ(), fromCopy.getQ()));
+    SimTK_TEST(isSame(fromCheckpoint.getU(), fromCopy.getU()));
+
+    std::remove(ChkFile);
+}
+
+int main() {
+    SimTK_START_TEST("TestMultibodyCheckpoint");
+        SimTK_SUBTEST(testResumeExactly);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,187 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that slow forces can be held fixed, and that MultirateIntegrator
+evaluates them once per step while still getting the right answer when they
+change slowly. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+// A weak spring on a slider that counts how often it is calculated.
+class CountingSpring : public Force::Custom::Implementation {
+public:
+    CountingSpring(const MobilizedBody::Slider& slider, Real k)
+    :   slider(slider), k(k), numCalls(0) {}
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                   Vector_<Vec3>& particleForces,
+                   Vector& mobilityForces) const override {
+        ++numCalls;
+        slider.applyOneMobilityForce(state, 0, -k*slider.getOneQ(state, 0),
+                                     mobilityForces);
+    }
+    Real calcPotentialEnergy(const State& state) const override {
+        return k*square(slider.getOneQ(state, 0))/2;
+    }
+    const MobilizedBody::Slider& slider;
+    const Real k;
+    mutable int numCalls;
+};
+
+// A block on a stiff spring with a weak spring as well. The weak spring may
+// be in the same force subsystem as the stiff one or a separate one.
+struct Oscillator {
+    Oscillator(bool separateSubsystem, Real kWeak=10)
+    :   matter(system), forces(system), slowForces(system) {
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        slider = MobilizedBody::Slider(matter.Ground(), Vec3(0), body, Vec3(0));
+        Force::MobilityLinearSpring(forces, slider, MobilizerQIndex(0), 1e4, 0);
+        counter = new CountingSpring(slider, kWeak);
+        weak = Force::Custom(separateSubsystem ? slowForces : forces, counter);
+    }
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    GeneralForceSubsystem   slowForces;
+    MobilizedBody::Slider   slider;
+    Force::Custom           weak;
+    CountingSpring*         counter; // owned by weak
+};
+
+Real simulate(Integrator& integ, const Oscillator& model, Real tFinal) {
+    State state = model.system.getDefaultState();
+    model.slider.setOneQ(state, 0, 0.01);
+    model.slider.setOneU(state, 0, 1);
+    integ.setAccuracy(1e-6);
+    integ.initialize(state);
+    while (integ.getTime() < tFinal)
+        integ.stepTo(tFinal);
+    return model.slider.getOneQ(integ.getState(), 0);
+}
+}
+
+void testHoldSlowForces() {
+    // Without slow forces there is nothing to hold.
+    Oscillator plain(false);
+    State plainState = plain.system.realizeTopology();
+    plain.system.realize(plainState, Stage::Dynamics);
+    SimTK_TEST(!plain.system.holdSlowForces(plainState));
+
+    for (int separate=0; separate < 2; ++separate) {
+        Oscillator model(separate != 0);
+        if (separate) {
+            model.slowForces.setSlow(true);
+            SimTK_TEST(model.slowForces.isSlow());
+        } else {
+            model.weak.setSlow(true);
+            SimTK_TEST(model.weak.isSlow());
+        }
+        State state = model.system.realizeTopology();
+        model.slider.setOneQ(state, 0, 0.1);
+        model.system.realize(state, Stage::Acceleration);
+        const Real udot0 = model.slider.getOneUDot(state, 0);
+        SimTK_TEST_EQ(udot0, -(1e4+10)*0.1);
+
+        SimTK_TEST(model.system.holdSlowForces(state));
+        SimTK_TEST(state.getSystemStage() < Stage::Dynamics);
+        model.counter->numCalls = 0;
+        model.slider.setOneQ(state, 0, 0.2);
+        model.system.realize(state, Stage::Acceleration);
+        SimTK_TEST(model.counter->numCalls == 0);
+        SimTK_TEST_EQ(model.slider.getOneUDot(state, 0), -1e4*0.2 - 10*0.1);
+
+        model.system.releaseSlowForces(state);
+        model.system.realize(state, Stage::Acceleration);
+        SimTK_TEST(model.counter->numCalls == 1);
+        SimTK_TEST_EQ(model.slider.getOneUDot(state, 0), -(1e4+10)*0.2);
+    }
+}
+
+void testMultirateIntegrator() {
+    const Real tFinal = 1;
+    Oscillator reference(false);
+    reference.system.realizeTopology();
+    RungeKuttaMersonIntegrator refInteg(reference.system);
+    const Real qRef = simulate(refInteg, reference, tFinal);
+
+    for (int separate=0; separate < 2; ++separate) {
+        Oscillator model(separate != 0);
+        if (separate) model.slowForces.setSlow(true);
+        else model.weak.setSlow(true);
+        model.system.realizeTopology();
+        MultirateIntegrator integ(model.system);
+        SimTK_TEST(integ.getNumSubsteps() == 10);
+        SimTK_TEST_MUST_THROW(integ.setNumSubsteps(0));
+        integ.setNumSubsteps(8);
+        SimTK_TEST(integ.getNumSubsteps() == 8);
+        model.system.resetAllCountersToZero();
+        model.counter->numCalls = 0;
+        const Real q = simulate(integ, model, tFinal);
+        const int nDynamics =
+            model.system.getNumRealizationsOfThisStage(Stage::Dynamics);
+        cout << "separate=" << separate << " q=" << q << " qRef=" << qRef
+             << " slow calls=" << model.counter->numCalls
+             << " realizations=" << nDynamics << endl;
+        // The weak spring is held across a step so this is only
+        // approximately the reference solution.
+        SimTK_TEST_EQ_TOL(q, qRef, 1e-3);
+        SimTK_TEST(model.counter->numCalls*10 < nDynamics);
+    }
+}
+
+// A "slow" spring that isn't slow at all must not spoil the accuracy, since
+// the error of holding it is part of the error estimate.
+void testHoldErrorIsControlled() {
+    const Real tFinal = 1;
+    Oscillator reference(false, 5e3);
+    reference.system.realizeTopology();
+    RungeKuttaMersonIntegrator refInteg(reference.system);
+    const Real qRef = simulate(refInteg, reference, tFinal);
+
+    Oscillator model(true, 5e3);
+    model.slowForces.setSlow(true);
+    model.system.realizeTopology();
+    MultirateIntegrator integ(model.system);
+    SimTK_TEST(integ.getMethodMinOrder() == 1);
+    SimTK_TEST(integ.getMethodMaxOrder() == 3);
+    const Real q = simulate(integ, model, tFinal);
+    cout << "stiff slow spring: q=" << q << " qRef=" << qRef
+         << " steps=" << integ.getNumStepsTaken() << endl;
+    // Each step is accurate, but with the hold the method is first order and
+    // the phase error builds up over the 20 or so periods. Allow 5% of the
+    // amplitude, which is about 0.008 here.
+    SimTK_TEST_EQ_TOL(q, qRef, 4e-4);
+}
+
+int main() {
+    SimTK_START_TEST("TestMultirateIntegrator");
+        SimTK_SUBTEST(testHoldSlowForces);
+        SimTK_SUBTEST(testMultirateIntegrator);
+        SimTK_SUBTEST(testHoldErrorIsControlled);
+    SimTK_END_TEST();
+}
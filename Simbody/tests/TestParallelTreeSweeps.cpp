@@ -0,0 +1,215 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that running the articulated body sweeps level-by-level on several
+threads, or across a batch of States, gives the same answers as the serial 
+single-State sweeps. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Build a wide tree: many short branches hanging from Ground, alternating
+// ball and pin joints so that both quaternion and angle mobilizers are used.
+static void buildWideTree(SimbodyMatterSubsystem& matter, int nBranches,
+                          int branchLength) {
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(0.1, 0.2, 0.3)));
+    for (int b=0; b < nBranches; ++b) {
+        MobilizedBody parent = matter.Ground();
+        for (int k=0; k < branchLength; ++k) {
+            const Transform X_PF(Rotation(0.1*b, ZAxis),
+                                 k==0 ? Vec3(b, 0, 0) : Vec3(0, -1, 0));
+            if (k % 2)
+                parent = MobilizedBody::Pin(parent, X_PF, body, Vec3(0, .5, 0));
+            else
+                parent = MobilizedBody::Ball(parent, X_PF, body, Vec3(0, .5, 0));
+        }
+    }
+}
+
+static void randomizeState(const MultibodySystem& system, State& state) {
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(42);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+    system.realize(state, Stage::Position); // normalizes quaternions
+}
+
+void testSweepsMatchSerial() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    buildWideTree(matter, 60, 4);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    randomizeState(system, state);
+    system.realize(state, Stage::Acceleration);
+    const Vector udotSerial = state.getUDot();
+    const Vector qdotdotSerial = state.getQDotDot();
+
+    Vector f(state.getNU());
+    for (int i=0; i < f.size(); ++i) f[i] = std::sin(Real(i));
+    Vector MInvfSerial;
+    matter.multiplyByMInv(state, f, MInvfSerial);
+
+    matter.setNumberOfThreads(4);
+    SimTK_TEST(matter.getNumberOfThreads() == 4);
+
+    State state2 = system.getDefaultState();
+    randomizeState(system, state2);
+    system.realize(state2, Stage::Acceleration);
+    SimTK_TEST_EQ(state2.getUDot(), udotSerial);
+    SimTK_TEST_EQ(state2.getQDotDot(), qdotdotSerial);
+
+    Vector MInvf;
+    matter.multiplyByMInv(state2, f, MInvf);
+    SimTK_TEST_EQ(MInvf, MInvfSerial);
+
+    // Going back to serial must still work.
+    matter.setNumberOfThreads(1);
+    State state3 = system.getDefaultState();
+    randomizeState(system, state3);
+    system.realize(state3, Stage::Acceleration);
+    SimTK_TEST_EQ(state3.getUDot(), udotSerial);
+
+    SimTK_TEST_MUST_THROW(matter.setNumberOfThreads(0));
+    SimTK_TEST_MUST_THROW(matter.setNumberOfThreads(-1));
+}
+
+// A narrow tree should never be split, but must still give correct results
+// when threads are enabled.
+void testNarrowTree() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    buildWideTree(matter, 2, 10);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    randomizeState(system, state);
+    system.realize(state, Stage::Acceleration);
+    const Vector udotSerial = state.getUDot();
+
+    matter.setNumberOfThreads(3);
+    State state2 = system.getDefaultState();
+    randomizeState(system, state2);
+    system.realize(state2, Stage::Acceleration);
+    SimTK_TEST_EQ(state2.getUDot(), udotSerial);
+}
+
+// The batched operators must give the same answers as the single-State ones,
+// both serially and with the batch split among threads.
+void testBatchMatchesSingleState() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    buildWideTree(matter, 5, 3);
+    system.realizeTopology();
+
+    const int nStates = 7;
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(7);
+    Array_<State> states(nStates, system.getDefaultState());
+    Array_<const State*> statePtrs;
+    Array_<Vector> mobilityForces(nStates);
+    Array_<Vector_<SpatialVec> > bodyForces(nStates);
+    for (int k=0; k < nStates; ++k) {
+        State& state = states[k];
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i]=rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i]=rand.getValue();
+        system.realize(state, Stage::Dynamics);
+        statePtrs.push_back(&state);
+        mobilityForces[k].resize(state.getNU());
+        for (int i=0; i < state.getNU(); ++i) 
+            mobilityForces[k][i] = rand.getValue();
+        bodyForces[k].resize(matter.getNumBodies());
+        for (int i=0; i < bodyForces[k].size(); ++i)
+            bodyForces[k][i] = SpatialVec(Vec3(rand.getValue()),
+                                          Vec3(0, rand.getValue(), 0));
+    }
+
+    Array_<Vector> udotExpected(nStates);
+    Array_<Vector_<SpatialVec> > A_GBExpected(nStates);
+    for (int k=0; k < nStates; ++k)
+        matter.calcAccelerationIgnoringConstraints(states[k],
+            mobilityForces[k], bodyForces[k], udotExpected[k], 
+            A_GBExpected[k]);
+
+    for (int nThreads = 1; nThreads <= 3; nThreads += 2) {
+        matter.setNumberOfThreads(nThreads);
+        for (int k=0; k < nStates; ++k)
+            matter.invalidateArticulatedBodyInertias(states[k]);
+        matter.realizeArticulatedBodyInertias(statePtrs);
+        for (int k=0; k < nStates; ++k)
+            SimTK_TEST(matter.isArticulatedBodyInertiasRealized(states[k]));
+
+        Array_<Vector> udot;
+        Array_<Vector_<SpatialVec> > A_GB;
+        matter.calcAccelerationIgnoringConstraints(statePtrs,
+            mobilityForces, bodyForces, udot, A_GB);
+        SimTK_TEST(udot.size() == nStates && A_GB.size() == nStates);
+        for (int k=0; k < nStates; ++k) {
+            SimTK_TEST_EQ(udot[k], udotExpected[k]);
+            SimTK_TEST_EQ(A_GB[k], A_GBExpected[k]);
+        }
+    }
+
+    Array_<Vector> udot;
+    Array_<Vector_<SpatialVec> > A_GB;
+
+    // A State listed twice is caught, even in Release.
+    Array_<const State*> duplicated(statePtrs);
+    duplicated.back() = duplicated.front();
+    SimTK_TEST_MUST_THROW_EXC(matter.calcAccelerationIgnoringConstraints(
+        duplicated, mobilityForces, bodyForces, udot, A_GB),
+        Exception::ErrorCheck);
+    SimTK_TEST_MUST_THROW_EXC(matter.realizeArticulatedBodyInertias(duplicated),
+        Exception::ErrorCheck);
+
+    // So is a State that hasn't been realized far enough.
+    states.back().invalidateAllCacheAtOrAbove(Stage::Dynamics);
+    SimTK_TEST_MUST_THROW_EXC(matter.calcAccelerationIgnoringConstraints(
+        statePtrs, mobilityForces, bodyForces, udot, A_GB),
+        Exception::ErrorCheck);
+    system.realize(states.back(), Stage::Dynamics);
+
+    // Wrong-sized batches are caught.
+    mobilityForces.pop_back();
+    SimTK_TEST_MUST_THROW(matter.calcAccelerationIgnoringConstraints(statePtrs,
+        mobilityForces, bodyForces, udot, A_GB));
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelTreeSweeps");
+        SimTK_SUBTEST(testSweepsMatchSerial);
+        SimTK_SUBTEST(testNarrowTree);
+        SimTK_SUBTEST(testBatchMatchesSingleState);
+    SimTK_END_TEST();
+}
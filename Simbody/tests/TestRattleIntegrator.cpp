@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+/* Check that RattleIntegrator keeps the energy of a conservative closed-chain
+mechanism bounded over a long run, using the MultibodySystem's mass matrix and
+velocity constraint Jacobian for its constraint impulses. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+const Real Angles[] = {0.5, -0.3, 0.2};
+
+// Three unit-length pendulum links in a chain, with the tip of the last one
+// held at a fixed distance from a point on Ground. That closes the loop,
+// leaving two degrees of freedom and chaotic motion.
+struct ClosedChain {
+    ClosedChain() : matter(system), forces(system) {
+        Force::UniformGravity(forces, matter, Vec3(0, -9.8, 0));
+        Body::Rigid body(MassProperties(1, Vec3(0, -0.5, 0), 
+                         UnitInertia::cylinderAlongY(0.05, 0.5)
+                            .shiftFromCentroid(Vec3(0, -0.5, 0))));
+        MobilizedBody parent = matter.Ground();
+        Vec3 tip(0);
+        Real angle = 0;
+        for (int i=0; i < 3; ++i) {
+            links[i] = MobilizedBody::Pin(parent, 
+                                          i==0 ? Vec3(0) : Vec3(0, -1, 0), 
+                                          body, Vec3(0));
+            parent = links[i];
+            angle += Angles[i];
+            tip += Vec3(std::sin(angle), -std::cos(angle), 0);
+        }
+        const Vec3 anchor(1, -2, 0);
+        Constraint::Rod(matter.Ground(), anchor, links[2], Vec3(0, -1, 0), 
+                        (tip - anchor).norm());
+        system.realizeTopology();
+    }
+
+    State getInitialState() const {
+        State state = system.getDefaultState();
+        for (int i=0; i < 3; ++i)
+            links[i].setOneQ(state, 0, Angles[i]);
+        system.realize(state, Stage::Velocity);
+        return state;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    MobilizedBody::Pin      links[3];
+};
+}
+
+void testMassMatrixOperators() {
+    ClosedChain chain;
+    SimTK_TEST(chain.system.hasMassMatrixOperators());
+    State state = chain.getInitialState();
+    for (int i=0; i < 3; ++i)
+        chain.links[i].setOneU(state, 0, i+1);
+    chain.system.realize(state, Stage::Velocity);
+
+    // The Rod is scleronomic, so G*u is the velocity constraint error.
+    Vector Gu;
+    chain.system.multiplyByG(state, state.getU(), Gu);
+    SimTK_TEST(Gu.size() == state.getNUErr());
+    SimTK_TEST_EQ(Gu, state.getUErr());
+
+    // M^-1 agrees with the matter subsystem's operator, and ~G with G.
+    Vector f(3), MInvf, MInvfMatter, Gtlambda;
+    f[0] = 1; f[1] = -2; f[2] = 3;
+    chain.system.multiplyByMInv(state, f, MInvf);
+    chain.matter.multiplyByMInv(state, f, MInvfMatter);
+    SimTK_TEST_EQ(MInvf, MInvfMatter);
+    Vector Gf;
+    chain.system.multiplyByG(state, f, Gf);
+    chain.system.multiplyByGTranspose(state, Vector(1, Real(1)), Gtlambda);
+    SimTK_TEST_EQ(~Gtlambda*f, Gf[0]);
+}
+
+// Run for a long time with a step size large enough that an explicit method
+// would drift. The energy error should stay bounded, no larger in the second
+// half of the run than in the first, and the constraints should be satisfied
+// at every step.
+void testEnergyConservation() {
+    ClosedChain chain;
+    RattleIntegrator integ(chain.system, 0.005);
+    integ.setConstraintTolerance(1e-10);
+    integ.setReturnEveryInternalStep(true);
+    integ.initialize(chain.getInitialState());
+    const Real e0 = chain.system.calcEnergy(integ.getState());
+    const Real scale = 3*9.8*3; // energy range of the swing
+
+    const Real tFinal = 100;
+    Real maxErrFirstHalf = 0, maxErrSecondHalf = 0;
+    while (integ.getTime() < tFinal) {
+        integ.stepTo(tFinal);
+        const State& s = integ.getState();
+        const Real err = std::abs(chain.system.calcEnergy(s) - e0);
+        if (s.getTime() <= tFinal/2)
+            maxErrFirstHalf = std::max(maxErrFirstHalf, err);
+        else
+            maxErrSecondHalf = std::max(maxErrSecondHalf, err);
+        SimTK_TEST(s.getQErr().normInf() < 1e-8);
+        SimTK_TEST(s.getUErr().normInf() < 1e-8);
+    }
+    cout << "energy error " << maxErrFirstHalf << " then " << maxErrSecondHalf
+         << " of " << scale << endl;
+    SimTK_TEST(integ.getTime() == tFinal);
+    SimTK_TEST(maxErrFirstHalf < 1e-3*scale);
+    SimTK_TEST(maxErrSecondHalf < 1.5*maxErrFirstHalf + 1e-10*scale);
+}
+
+int main() {
+    SimTK_START_TEST("TestRattleIntegrator");
+        SimTK_SUBTEST(testMassMatrixOperators);
+        SimTK_SUBTEST(testEnergyConservation);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,226 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that the sparse constraint solver gives the same accelerations and
+constraint forces as the dense one, for nets of free bodies held together by
+constraints, with and without redundant constraints. The multipliers 
+themselves needn't agree where the constraints are redundant. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// An nx X ny curtain of free bodies: the top row is joined by Ball 
+// constraints into a rope tied to Ground at one end, and a rope of ny bodies
+// hangs from each of those. (A fully connected flat grid would have
+// redundant constraints.) Each cell of the grid
+// can also have a short pendulum (a two-body branch) in the middle of the
+// cell, connected to its four surrounding bodies, so that some Constraints
+// act on a branch with more than one body.
+struct Net {
+    Net(int nx, int ny, bool withPendulums) : matter(system), forces(system) {
+        Force::Gravity(forces, matter, -YAxis, 9.8);
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(0.1)));
+        Array_<MobilizedBody> nodes;
+        for (int j=0; j < ny; ++j)
+            for (int i=0; i < nx; ++i) {
+                MobilizedBody::Free node(matter.Ground(), Vec3(i,-j,0),
+                                         body, Vec3(0));
+                nodes.push_back(node);
+            }
+        const Vec3 half(0.5, 0, 0), down(0, 0.5, 0);
+        for (int j=0; j < ny; ++j)
+            for (int i=0; i < nx; ++i) {
+                MobilizedBody& b = nodes[j*nx+i];
+                if (j == 0 && i+1 < nx)
+                    Constraint::Ball(b, half, nodes[j*nx+i+1], -half);
+                if (j+1 < ny)
+                    Constraint::Ball(b, -down, nodes[(j+1)*nx+i], down);
+                if (withPendulums && i+1 < nx && j+1 < ny) {
+                    MobilizedBody::Pin top(matter.Ground(),
+                        Vec3(i+0.5, -j-0.25, 1), body, Vec3(0));
+                    MobilizedBody::Pin bottom(top, Vec3(0,-0.5,0),
+                                              body, Vec3(0));
+                    const Real length = std::sqrt(1.3125); // as built
+                    Constraint::Rod(top, b, length);
+                    Constraint::Rod(bottom, nodes[(j+1)*nx+i+1], length);
+                }
+            }
+        Constraint::Ball(matter.updGround(), Vec3(0,0,0), nodes[0], Vec3(0));
+    }
+
+    // Disturb the q's and u's and project them back onto the constraint
+    // manifold.
+    State makeState(Real qNoise) {
+        State state = system.realizeTopology();
+        Random::Uniform rand(-0.1, 0.1);
+        rand.setSeed(7);
+        for (int i=0; i < state.getNQ(); ++i) 
+            state.updQ()[i] += qNoise*rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+        system.realize(state, Stage::Time);
+        system.project(state, 1e-8);
+        return state;
+    }
+
+    void calcAccelerations(State& state,
+                           SimbodyMatterSubsystem::ConstraintSolver solver,
+                           Vector& udot, Vector& multipliers) {
+        // Changing solvers invalidates the topology; the State is rebuilt
+        // from the old one's q's and u's.
+        const Vector q = state.getQ(), u = state.getU();
+        matter.setConstraintSolver(solver);
+        state = system.realizeTopology();
+        state.updQ() = q; state.updU() = u;
+        system.realize(state, Stage::Acceleration);
+        udot = state.getUDot();
+        multipliers = state.getMultipliers();
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    GeneralForceSubsystem       forces;
+};
+
+void testMatchesDense() {
+    Net net(6, 5, true);
+    SimTK_TEST(net.matter.getConstraintSolver()
+               == SimbodyMatterSubsystem::DenseConstraintSolver);
+    State state = net.makeState(0.01);
+
+    Vector udotDense, lambdaDense, udotSparse, lambdaSparse;
+    net.calcAccelerations(state, SimbodyMatterSubsystem::DenseConstraintSolver,
+                          udotDense, lambdaDense);
+    net.calcAccelerations(state, SimbodyMatterSubsystem::SparseConstraintSolver,
+                          udotSparse, lambdaSparse);
+    SimTK_TEST(net.matter.getConstraintSolver()
+               == SimbodyMatterSubsystem::SparseConstraintSolver);
+    SimTK_TEST(lambdaDense.size() > 100);
+
+    const Real tol = 1e-8*(1+max(abs(udotDense)));
+    SimTK_TEST_EQ_TOL(udotSparse, udotDense, tol);
+    Vector forcesDense, forcesSparse;
+    net.matter.multiplyByGTranspose(state, lambdaDense, forcesDense);
+    net.matter.multiplyByGTranspose(state, lambdaSparse, forcesSparse);
+    SimTK_TEST_EQ_TOL(forcesSparse, forcesDense, 
+                      1e-8*(1+max(abs(forcesDense))));
+
+    // The accelerations must satisfy the constraints.
+    Vector pvaerr = state.getUDotErr();
+    SimTK_TEST_EQ_TOL(pvaerr, Vector(pvaerr.size(), Real(0)), tol);
+
+    // Again, reusing the analysis but with a new factorization.
+    state.updU() *= 2;
+    net.system.realize(state, Stage::Acceleration);
+    const Vector udotSparse2 = state.getUDot();
+    net.calcAccelerations(state, SimbodyMatterSubsystem::DenseConstraintSolver,
+                          udotDense, lambdaDense);
+    SimTK_TEST_EQ_TOL(udotSparse2, udotDense, 1e-8*(1+max(abs(udotDense))));
+}
+
+void testRedundantConstraints() {
+    // Tie one body to its neighbor a second time; the two Ball constraints
+    // between them are fully redundant. The multipliers are not unique, but
+    // the accelerations are.
+    Net net(4, 4, false);
+    MobilizedBody& b1 = net.matter.updMobilizedBody(MobilizedBodyIndex(2));
+    MobilizedBody& b2 = net.matter.updMobilizedBody(MobilizedBodyIndex(3));
+    Constraint::Ball(b1, Vec3(0.5,0,0), b2, Vec3(-0.5,0,0));
+    State state = net.makeState(0);
+
+    Vector udotDense, lambdaDense, udotSparse, lambdaSparse;
+    net.calcAccelerations(state, SimbodyMatterSubsystem::DenseConstraintSolver,
+                          udotDense, lambdaDense);
+    net.calcAccelerations(state, SimbodyMatterSubsystem::SparseConstraintSolver,
+                          udotSparse, lambdaSparse);
+    SimTK_TEST_EQ_TOL(udotSparse, udotDense, 1e-6*(1+max(abs(udotDense))));
+
+    // The redundant constraint forces still have to add up the same.
+    Vector forcesDense, forcesSparse;
+    net.matter.multiplyByGTranspose(state, lambdaDense, forcesDense);
+    net.matter.multiplyByGTranspose(state, lambdaSparse, forcesSparse);
+    SimTK_TEST_EQ_TOL(forcesSparse, forcesDense,
+                      1e-6*(1+max(abs(forcesDense))));
+}
+
+void testBadlyScaledConstraints() {
+    // A very heavy pendulum of two free bodies hangs from Ground beside the
+    // net. Its equations have tiny diagonal elements in G M^-1 ~G compared
+    // with the net's, but they are not redundant and must still be enforced.
+    Net net(4, 4, false);
+    Body::Rigid heavy(MassProperties(1e12, Vec3(0), UnitInertia(0.1)));
+    MobilizedBody::Free top(net.matter.Ground(), Vec3(10,0,0),
+                            heavy, Vec3(0));
+    MobilizedBody::Free bottom(net.matter.Ground(), Vec3(10,-1,0),
+                               heavy, Vec3(0));
+    Constraint::Ball(net.matter.Ground(), Vec3(10,0.5,0), top, Vec3(0,0.5,0));
+    Constraint::Ball(top, Vec3(0,-0.5,0), bottom, Vec3(0,0.5,0));
+    State state = net.makeState(0);
+
+    Vector udot, lambda;
+    net.calcAccelerations(state, SimbodyMatterSubsystem::SparseConstraintSolver,
+                          udot, lambda);
+    const Vector pvaerr = state.getUDotErr();
+    SimTK_TEST_EQ_TOL(pvaerr, Vector(pvaerr.size(), Real(0)), 1e-8);
+}
+
+void testSimulation() {
+    // A short simulation with the sparse solver should stay on the
+    // constraint manifold and match the dense solver.
+    Net net(5, 3, true);
+    State state = net.makeState(0.01);
+    Vector udot, lambda;
+    State denseState = state, sparseState = state;
+    net.calcAccelerations(denseState,
+        SimbodyMatterSubsystem::DenseConstraintSolver, udot, lambda);
+    {
+        RungeKuttaMersonIntegrator integ(net.system);
+        integ.setAccuracy(1e-8);
+        integ.initialize(denseState);
+        integ.stepTo(0.5);
+        denseState = integ.getState();
+    }
+    net.calcAccelerations(sparseState,
+        SimbodyMatterSubsystem::SparseConstraintSolver, udot, lambda);
+    {
+        RungeKuttaMersonIntegrator integ(net.system);
+        integ.setAccuracy(1e-8);
+        integ.initialize(sparseState);
+        integ.stepTo(0.5);
+        sparseState = integ.getState();
+    }
+    SimTK_TEST_EQ_TOL(sparseState.getQ(), denseState.getQ(), 1e-5);
+    SimTK_TEST_EQ_TOL(sparseState.getU(), denseState.getU(), 1e-4);
+}
+
+int main() {
+    SimTK_START_TEST("TestSparseConstraintSolver");
+        SimTK_SUBTEST(testMatchesDense);
+        SimTK_SUBTEST(testRedundantConstraints);
+        SimTK_SUBTEST(testBadlyScaledConstraints);
+        SimTK_SUBTEST(testSimulation);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,210 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check MultibodySystem's state derivative Jacobian against one found by
+finite differences. The mass matrices of these systems don't depend on q and
+there are no velocity-dependent inertial forces, so the Jacobian should be
+exact, apart from discretization error in the finite differences. Then check
+that CPodes gets the same answer with the Jacobian as without it, and with
+fewer evaluations of the state derivatives. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+// Central differences of the state derivatives.
+Matrix calcNumericalJacobian(const System& system, State state) {
+    const int ny = state.getNY();
+    const Vector y0 = state.getY();
+    Matrix J(ny, ny);
+    for (int j=0; j < ny; ++j) {
+        const Real h = 1e-7*std::max(Real(1), std::abs(y0[j]));
+        state.updY() = y0; state.updY()[j] += h;
+        system.realize(state, Stage::Acceleration);
+        const Vector ydotPlus = state.getYDot();
+        state.updY() = y0; state.updY()[j] -= h;
+        system.realize(state, Stage::Acceleration);
+        J(j) = (ydotPlus - state.getYDot())/(2*h);
+    }
+    return J;
+}
+
+Real maxAbsDifference(const Matrix& a, const Matrix& b) {
+    Real diff = 0;
+    for (int i=0; i < a.nrow(); ++i)
+        for (int j=0; j < a.ncol(); ++j)
+            diff = std::max(diff, std::abs(a(i,j) - b(i,j)));
+    return diff;
+}
+
+Real maxAbs(const Matrix& a) {
+    return maxAbsDifference(a, Matrix(a.nrow(), a.ncol(), Real(0)));
+}
+
+void checkJacobian(const MultibodySystem& system, State& state) {
+    system.realize(state, Stage::Acceleration);
+    Matrix J;
+    SimTK_TEST(system.calcStateDerivativeJacobian(state, J));
+    SimTK_TEST(J.nrow() == state.getNY() && J.ncol() == state.getNY());
+    const Matrix Jnum = calcNumericalJacobian(system, state);
+    cout << "max |J-Jnum|=" << maxAbsDifference(J, Jnum)
+         << " max |Jnum|=" << maxAbs(Jnum) << endl;
+    SimTK_TEST(maxAbsDifference(J, Jnum) <= 1e-5*maxAbs(Jnum));
+}
+
+// Spheres on a ground half-space (y > 0 is outside), with compliant
+// contact and friction. The spheres are 2m apart along x so they don't touch
+// each other; ball is the first of them.
+struct BallOnGround {
+    explicit BallOnGround(int nBalls = 1) 
+    :   matter(system), forces(system), tracker(system),
+        contact(system, tracker) {
+        Force::Gravity(forces, matter, -YAxis, 9.81);
+        const ContactMaterial material(1e6, 0.5, 0.8, 0.5, 0.1);
+        matter.updGround().updBody().addContactSurface
+           (Rotation(-Pi/2, ZAxis),
+            ContactSurface(ContactGeometry::HalfSpace(), material));
+        Body::Rigid body(MassProperties(2, Vec3(0), UnitInertia(1)));
+        body.addContactSurface(Transform(),
+            ContactSurface(ContactGeometry::Sphere(0.5), material));
+        for (int i=0; i < nBalls; ++i)
+            balls.push_back(MobilizedBody::Translation(matter.Ground(), 
+                                                       Vec3(2*i,0,0),
+                                                       body, Vec3(0)));
+        ball = balls[0];
+    }
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    GeneralForceSubsystem       forces;
+    ContactTrackerSubsystem     tracker;
+    CompliantContactSubsystem   contact;
+    Array_<MobilizedBody>       balls;
+    MobilizedBody               ball;
+};
+}
+
+void testForceElements() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.81);
+
+    // A body that translates, tied to Ground by a spring and a damper, and
+    // another that slides relative to it along a rotated axis, with a
+    // mobility spring and damper and an engaged stop.
+    Body::Rigid body(MassProperties(1.5, Vec3(0), UnitInertia(1)));
+    MobilizedBody::Translation block(matter.Ground(), Vec3(0), body, Vec3(0));
+    MobilizedBody::Slider slider(block, Rotation(0.3, ZAxis),
+                                 body, Vec3(0));
+    Force::TwoPointLinearSpring(forces, matter.Ground(), Vec3(1,2,0),
+                                block, Vec3(0.1,0,0.2), 1000, 0.5);
+    Force::TwoPointLinearDamper(forces, matter.Ground(), Vec3(-1,0,0),
+                                block, Vec3(0), 20);
+    Force::MobilityLinearSpring(forces, slider, MobilizerQIndex(0), 500, 0.2);
+    Force::MobilityLinearDamper(forces, slider, MobilizerUIndex(0), 3);
+    Force::MobilityLinearStop(forces, slider, MobilizerQIndex(0),
+                              1e4, 0.5, -1, 0.1);
+    Force::GlobalDamper(forces, matter, 0.25);
+
+    State state = system.realizeTopology();
+    block.setQToFitTranslation(state, Vec3(0.3, -0.2, 0.4));
+    block.setUToFitLinearVelocity(state, Vec3(0.5, 1, -2));
+    slider.setOneQ(state, 0, 0.15); // past the upper stop
+    slider.setOneU(state, 0, -0.3);
+    checkJacobian(system, state);
+
+    // Disabled forces don't contribute.
+    Force::TwoPointLinearSpring spring(forces, block, Vec3(0),
+                                       slider, Vec3(0,1,0), 1e5, 0);
+    state = system.realizeTopology();
+    block.setQToFitTranslation(state, Vec3(0.3, -0.2, 0.4));
+    spring.disable(state);
+    checkJacobian(system, state);
+}
+
+void testContact() {
+    BallOnGround model;
+    State state = model.system.realizeTopology();
+    // Penetrating by 1mm, moving down and sliding.
+    model.ball.setQToFitTranslation(state, Vec3(0, 0.499, 0));
+    model.ball.setUToFitLinearVelocity(state, Vec3(0.2, -0.1, 0.05));
+    checkJacobian(model.system, state);
+}
+
+// Drop several balls, each a little differently, and integrate until they
+// have settled. Every step must succeed, and using the analytic Jacobian
+// must save the realizations that finite differencing the Jacobian would
+// need (one per state variable each time it is formed). Those are a good
+// part of the total, but the Newton iterations need realizations either way.
+void testCPodes() {
+    const int NBalls = 4;
+    const Real ReportInterval = 0.05;
+    Real finalY[2]; int nRealize[2];
+    for (int useJacobian=0; useJacobian < 2; ++useJacobian) {
+        BallOnGround model(NBalls);
+        State state = model.system.realizeTopology();
+        for (int i=0; i < NBalls; ++i) {
+            model.balls[i].setQToFitTranslation(state, Vec3(0, 0.6+0.1*i, 0));
+            model.balls[i].setUToFitLinearVelocity(state, Vec3(1, 0, 0.2*i));
+        }
+
+        CPodesIntegrator integ(model.system, CPodes::BDF);
+        integ.setAccuracy(1e-5);
+        integ.setUseAnalyticJacobian(useJacobian != 0);
+        SimTK_TEST(integ.getUseAnalyticJacobian() == (useJacobian != 0));
+        integ.initialize(state);
+        SimTK_TEST_MUST_THROW(integ.setUseAnalyticJacobian(false));
+        model.system.resetAllCountersToZero();
+        for (int k=1; k*ReportInterval <= 2 + 1e-12; ++k) {
+            // The first call only reports the start of the interval.
+            Integrator::SuccessfulStepStatus status;
+            do status = integ.stepTo(k*ReportInterval);
+            while (status == Integrator::StartOfContinuousInterval);
+            SimTK_TEST(status == Integrator::ReachedReportTime);
+            SimTK_TEST_EQ(integ.getTime(), k*ReportInterval);
+        }
+        finalY[useJacobian] =
+            model.ball.getBodyOriginLocation(integ.getState())[1];
+        nRealize[useJacobian] = model.system
+            .getNumRealizationsOfThisStage(Stage::Acceleration);
+        cout << "analytic Jacobian=" << useJacobian
+             << " y=" << finalY[useJacobian]
+             << " realizations=" << nRealize[useJacobian] << endl;
+    }
+    // The ball has settled on the ground either way.
+    SimTK_TEST(finalY[0] < 0.5 && finalY[0] > 0.49);
+    SimTK_TEST_EQ_TOL(finalY[0], finalY[1], 1e-4);
+    SimTK_TEST(4*nRealize[1] < 3*nRealize[0]);
+}
+
+int main() {
+    SimTK_START_TEST("TestStateDerivativeJacobian");
+        SimTK_SUBTEST(testForceElements);
+        SimTK_SUBTEST(testContact);
+        SimTK_SUBTEST(testCPodes);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,117 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Record a simulation with a record-only Visualizer, which needs no display
+and no simbody-visualizer, and check that the recording has the expected
+header and that frames after the first cost little more than the transforms
+of their meshes. */
+
+#include "SimTKsimbody.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+namespace {
+const char* RecordingFile = "TestVisualizerRecording.simviz";
+
+struct Chain {
+    explicit Chain(int n) : matter(system), forces(system) {
+        Force::Gravity(forces, matter, -YAxis, 9.8);
+        matter.setShowDefaultGeometry(false); // meshes only
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+        body.addDecoration(Transform(), DecorativeBrick(Vec3(0.1,0.2,0.1)));
+        body.addDecoration(Transform(), DecorativeSphere(0.05).setColor(Red));
+        MobilizedBody parent = matter.Ground();
+        for (int i=0; i < n; ++i)
+            parent = MobilizedBody::Pin(parent, Vec3(0,-0.2,0),
+                                        body, Vec3(0,0.2,0));
+    }
+
+    // Record frames every 0.01 time units up to finalTime. The recording
+    // is complete once the Chain, which owns the Reporter, is destroyed.
+    void record(Real finalTime) {
+        Visualizer::Reporter* reporter =
+            new Visualizer::Reporter(system, RecordingFile, 0.01);
+        Visualizer& viz = const_cast<Visualizer&>(reporter->getVisualizer());
+        viz.setBackgroundType(Visualizer::SolidColor);
+        viz.setCameraTransform(Transform(Vec3(0,0,5)));
+        system.addEventReporter(reporter);
+
+        State state = system.realizeTopology();
+        state.updQ() = 0.5;
+        RungeKuttaMersonIntegrator integ(system);
+        TimeStepper ts(system, integ);
+        ts.initialize(state);
+        ts.stepTo(finalTime);
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+};
+
+long long getFileSize(const char* fileName) {
+    ifstream file(fileName, ios::binary|ios::ate);
+    return file ? (long long)file.tellg() : -1;
+}
+}
+
+void testRecording() {
+    // One frame, then 101 frames.
+    { Chain chain(10); chain.record(0); }
+    const long long oneFrame = getFileSize(RecordingFile);
+    { Chain chain(10); chain.record(1); }
+    const long long manyFrames = getFileSize(RecordingFile);
+    cout << "Recording: first frame " << oneFrame << " bytes, then "
+         << (manyFrames-oneFrame)/100. << " bytes per frame" << endl;
+    SimTK_TEST(oneFrame > 0);
+
+    // Each later frame sends only a transform for each mesh rather than
+    // the whole description of it.
+    SimTK_TEST(manyFrames - oneFrame < 100*(oneFrame/2));
+
+    ifstream file(RecordingFile, ios::binary);
+    char magic[8];
+    file.read(magic, 8);
+    SimTK_TEST(file && string(magic, 8) == "SimTKViz");
+    file.close();
+    std::remove(RecordingFile);
+}
+
+void testBadFile() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    SimTK_TEST_MUST_THROW(
+        Visualizer::createRecordOnly(system, "no/such/dir/recording.simviz"));
+}
+
+int main() {
+    SimTK_START_TEST("TestVisualizerRecording");
+        SimTK_SUBTEST(testRecording);
+        SimTK_SUBTEST(testBadFile);
+    SimTK_END_TEST();
+}
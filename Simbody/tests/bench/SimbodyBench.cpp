@@ -0,0 +1,780 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/*
+simbody-bench: timings of the core dynamics kernels on a set of parameterized
+scenarios, written as JSON and optionally compared against a baseline file
+written by an earlier run.
+
+    simbody-bench [--quick] [--filter text] [--repeats n] [--json out.json]
+                  [--baseline base.json] [--tolerance fraction] [--list]
+
+Each benchmark is named group/variant/n=size/operation, for example
+chain/pin/n=64/realizeAcceleration. An operation is calibrated to run for a
+minimum sample time and then timed for the given number of repeats; the
+median wall clock time per operation is what is compared with the baseline.
+The exit status is 0 if no benchmark got slower than the baseline by more
+than the tolerance (default 0.15, i.e. 15%), 1 if some did, and 2 for a
+usage or file error.
+
+Timings are only comparable between runs on the same machine with the same
+build type, so keep baselines per machine. Pass --quick for a short smoke run
+with small systems; its results use the same names but aren't meant to be
+compared with those of a full run.
+*/
+
+#include "SimTKsimbody.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace SimTK;
+
+namespace {
+
+//==============================================================================
+//                                 OPTIONS
+//==============================================================================
+struct Options {
+    bool        quick       = false;
+    bool        listOnly    = false;
+    int         repeats     = 5;
+    Real        tolerance   = Real(0.15);
+    std::string filter;
+    std::string jsonFile;
+    std::string baselineFile;
+
+    // Minimum time for one timed sample; the number of operations per sample
+    // is chosen to reach this.
+    double minSampleTime() const {return quick ? 0.005 : 0.05;}
+};
+
+//==============================================================================
+//                                 RESULT
+//==============================================================================
+struct Result {
+    std::string name;
+    std::string group;
+    int         size        = 0;
+    int         opsPerSample= 0;
+    int         repeats     = 0;
+    double      minUs       = 0;  // wall clock microseconds per operation
+    double      medianUs    = 0;
+    double      meanUs      = 0;
+    double      cpuMedianUs = 0;  // thread CPU microseconds per operation
+    long long   steps       = -1; // integrator steps per operation, if any
+};
+
+//==============================================================================
+//                                  RUNNER
+//==============================================================================
+// Owns the options and collected results. Scenarios call wants() before
+// building an expensive system, then run() once for each operation.
+class Runner {
+public:
+    explicit Runner(const Options& opts) : opts(opts) {}
+
+    // Return true if any of the named operations of the scenario whose names
+    // start with prefix would be run, so that the scenario's system is
+    // worth building.
+    bool wants(const std::string& prefix,
+               const std::vector<std::string>& opNames) const {
+        if (opts.filter.empty()) return true;
+        for (const std::string& op : opNames)
+            if ((prefix + op).find(opts.filter) != std::string::npos)
+                return true;
+        return false;
+    }
+
+    // Time op(), which performs one operation. If op() returns a step count
+    // that is recorded too. Calls after the first use the calibrated count.
+    void run(const std::string& group, const std::string& variant, int size,
+             const std::string& opName, const std::function<long long()>& op)
+    {
+        std::ostringstream nm;
+        nm << group << "/" << variant << "/n=" << size << "/" << opName;
+        const std::string name = nm.str();
+        if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos)
+            return;
+        if (opts.listOnly) {
+            std::cout << name << "\n";
+            return;
+        }
+
+        Result r;
+        r.name = name; r.group = group; r.size = size;
+        r.repeats = opts.repeats;
+
+        // Warm up, then calibrate the number of operations per sample.
+        r.steps = op();
+        int nOps = 1;
+        for (;;) {
+            const double t0 = realTime();
+            for (int i=0; i < nOps; ++i) op();
+            const double dt = realTime() - t0;
+            if (dt >= opts.minSampleTime() || nOps >= (1<<24)) break;
+            nOps = dt <= 0 ? nOps*16
+                 : std::max(nOps*2,
+                            int(1.2*nOps*opts.minSampleTime()/dt) + 1);
+        }
+        r.opsPerSample = nOps;
+
+        std::vector<double> wall(opts.repeats), cpu(opts.repeats);
+        for (int k=0; k < opts.repeats; ++k) {
+            const double c0 = threadCpuTime(), t0 = realTime();
+            for (int i=0; i < nOps; ++i) op();
+            wall[k] = 1e6*(realTime() - t0)/nOps;
+            cpu[k]  = 1e6*(threadCpuTime() - c0)/nOps;
+        }
+        r.minUs       = *std::min_element(wall.begin(), wall.end());
+        r.medianUs    = median(wall);
+        r.cpuMedianUs = median(cpu);
+        double sum = 0; for (double w : wall) sum += w;
+        r.meanUs = sum/opts.repeats;
+
+        std::printf("%-58s %12.3f us  (min %.3f, %d ops x %d)\n",
+                    name.c_str(), r.medianUs, r.minUs, nOps, opts.repeats);
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    const Options& getOptions() const {return opts;}
+    const std::vector<Result>& getResults() const {return results;}
+
+private:
+    static double median(std::vector<double> v) {
+        std::sort(v.begin(), v.end());
+        const size_t n = v.size();
+        return n%2 ? v[n/2] : (v[n/2-1] + v[n/2])/2;
+    }
+
+    Options             opts;
+    std::vector<Result> results;
+};
+
+//==============================================================================
+//                                JSON OUTPUT
+//==============================================================================
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {out += '\\'; out += c;}
+        else if ((unsigned char)c < 0x20) {
+            char buf[8]; std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else out += c;
+    }
+    return out + "\"";
+}
+
+bool writeJson(const std::string& fileName, const Options& opts,
+               const std::vector<Result>& results)
+{
+    std::ofstream out(fileName.c_str());
+    if (!out) return false;
+
+    int major=0, minor=0, build=0;
+    SimTK_version_simbody(&major, &minor, &build);
+    const std::time_t now = std::time(nullptr);
+    char when[32];
+    std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    char buf[512];
+    out << "{\n";
+    out << "  \"benchmark\": \"simbody-bench\",\n";
+    out << "  \"simbody_version\": \""
+        << major << "." << minor << "." << build << "\",\n";
+    out << "  \"date\": " << jsonString(when) << ",\n";
+    out << "  \"quick\": " << (opts.quick ? "true" : "false") << ",\n";
+    out << "  \"repeats\": " << opts.repeats << ",\n";
+    out << "  \"results\": [";
+    for (size_t i=0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << jsonString(r.name)
+            << ", \"group\": " << jsonString(r.group);
+        std::snprintf(buf, sizeof(buf),
+            ", \"size\": %d, \"ops_per_sample\": %d, \"repeats\": %d"
+            ", \"median_us\": %.6g, \"min_us\": %.6g, \"mean_us\": %.6g"
+            ", \"cpu_median_us\": %.6g",
+            r.size, r.opsPerSample, r.repeats, r.medianUs, r.minUs, r.meanUs,
+            r.cpuMedianUs);
+        out << buf;
+        if (r.steps >= 0) out << ", \"steps\": " << r.steps;
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return bool(out);
+}
+
+//==============================================================================
+//                                JSON INPUT
+//==============================================================================
+// Just enough of a JSON reader to get the benchmark names and median times
+// back out of a baseline file; it accepts any well-formed JSON but keeps only
+// the "name" and "median_us" members of the objects in "results".
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : s(text), p(0) {}
+
+    // Fills in name -> median_us. Returns false with a message if the text
+    // isn't JSON or has no "results" array.
+    bool readBaseline(std::map<std::string,double>& medians, std::string& err)
+    {
+        try {
+            skipWs(); expect('{');
+            bool sawResults = false;
+            if (!tryConsume('}')) do {
+                const std::string key = readString();
+                skipWs(); expect(':');
+                if (key == "results") {readResults(medians); sawResults=true;}
+                else skipValue();
+                skipWs();
+            } while (tryConsume(','));
+            expect('}');
+            if (!sawResults) throw std::string("no \"results\" array");
+        } catch (const std::string& msg) {
+            std::ostringstream o; o << msg << " at offset " << p;
+            err = o.str();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void readResults(std::map<std::string,double>& medians) {
+        skipWs(); expect('[');
+        skipWs();
+        if (tryConsume(']')) return;
+        do {
+            skipWs(); expect('{');
+            std::string name; double med = -1;
+            skipWs();
+            if (!tryConsume('}')) {
+                do {
+                    skipWs();
+                    const std::string key = readString();
+                    skipWs(); expect(':'); skipWs();
+                    if (key == "name") name = readString();
+                    else if (key == "median_us") med = readNumber();
+                    else skipValue();
+                    skipWs();
+                } while (tryConsume(','));
+                expect('}');
+            }
+            if (!name.empty() && med >= 0) medians[name] = med;
+            skipWs();
+        } while (tryConsume(','));
+        expect(']');
+    }
+
+    void skipValue() {
+        skipWs();
+        if (p >= s.size()) throw std::string("unexpected end of file");
+        const char c = s[p];
+        if (c == '"') {readString(); return;}
+        if (c == '{' || c == '[') {
+            const char close = (c == '{' ? '}' : ']');
+            ++p; skipWs();
+            if (tryConsume(close)) return;
+            do {
+                skipWs();
+                if (c == '{') {readString(); skipWs(); expect(':');}
+                skipValue(); skipWs();
+            } while (tryConsume(','));
+            expect(close);
+            return;
+        }
+        if (c == '-' || std::isdigit((unsigned char)c)) {readNumber(); return;}
+        for (const char* word : {"true", "false", "null"})
+            if (s.compare(p, std::strlen(word), word) == 0)
+            {   p += std::strlen(word); return; }
+        throw std::string("unexpected character");
+    }
+
+    std::string readString() {
+        skipWs(); expect('"');
+        std::string out;
+        while (p < s.size() && s[p] != '"') {
+            if (s[p] == '\\' && p+1 < s.size()) {
+                ++p;
+                switch (s[p]) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                    if (p+4 >= s.size()) throw std::string("bad escape");
+                    out += char(std::strtol(s.substr(p+1,4).c_str(),0,16));
+                    p += 4; break;
+                default: out += s[p];
+                }
+                ++p;
+            } else out += s[p++];
+        }
+        expect('"');
+        return out;
+    }
+
+    double readNumber() {
+        const char* begin = s.c_str() + p;
+        char* end = nullptr;
+        const double v = std::strtod(begin, &end);
+        if (end == begin) throw std::string("expected a number");
+        p += end - begin;
+        return v;
+    }
+
+    void skipWs()
+    {   while (p < s.size() && std::isspace((unsigned char)s[p])) ++p; }
+    bool tryConsume(char c)
+    {   skipWs(); if (p < s.size() && s[p]==c) {++p; return true;}
+        return false; }
+    void expect(char c) {
+        if (!tryConsume(c))
+            throw std::string("expected '") + c + "'";
+    }
+
+    const std::string& s;
+    size_t             p;
+};
+
+// Print a comparison with the baseline and return the number of regressions.
+int compareWithBaseline(const std::string& fileName, Real tolerance,
+                        const std::vector<Result>& results, bool& ok)
+{
+    ok = false;
+    std::ifstream in(fileName.c_str());
+    if (!in) {
+        std::cerr << "simbody-bench: can't read baseline file '"
+                  << fileName << "'\n";
+        return 0;
+    }
+    std::stringstream text; text << in.rdbuf();
+    const std::string contents = text.str();
+    std::map<std::string,double> base;
+    std::string err;
+    if (!JsonReader(contents).readBaseline(base, err)) {
+        std::cerr << "simbody-bench: baseline file '" << fileName
+                  << "' is not valid: " << err << "\n";
+        return 0;
+    }
+    ok = true;
+
+    std::printf("\nComparison with baseline %s (tolerance %.0f%%):\n",
+                fileName.c_str(), 100*tolerance);
+    int nRegressed = 0, nImproved = 0, nMissing = 0;
+    for (const Result& r : results) {
+        auto it = base.find(r.name);
+        if (it == base.end()) {++nMissing; continue;}
+        if (it->second <= 0) continue;
+        const double ratio = r.medianUs / it->second;
+        const char* verdict = "";
+        if (ratio > 1 + tolerance)      {verdict = "SLOWER"; ++nRegressed;}
+        else if (ratio < 1 - tolerance) {verdict = "faster"; ++nImproved;}
+        if (*verdict)
+            std::printf("  %-58s %10.3f -> %10.3f us  %+6.1f%%  %s\n",
+                r.name.c_str(), it->second, r.medianUs, 100*(ratio-1),
+                verdict);
+    }
+    std::printf("%d slower, %d faster, %d not in baseline, %d unchanged\n",
+                nRegressed, nImproved, nMissing,
+                int(results.size()) - nRegressed - nImproved - nMissing);
+    return nRegressed;
+}
+
+//==============================================================================
+//                                SCENARIOS
+//==============================================================================
+const std::vector<std::string> KinematicsOps = {"realizePosition",
+    "realizeVelocity", "realizeAcceleration", "multiplyByMInv",
+    "calcCompositeBodyInertias"};
+const std::vector<std::string> ContactOps = {"realizeDynamics",
+    "realizeAcceleration", "simulate"};
+
+// The operations timed on every tree and loop system. Each invalidates just
+// what it has to so that the named computation is redone.
+void timeKinematicsAndDynamics(Runner& runner, const std::string& group,
+    const std::string& variant, int size, const MultibodySystem& system,
+    State& state)
+{
+    const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    system.realize(state, Stage::Acceleration);
+    const int nu = state.getNU();
+    Vector v(nu, 1.0), result;
+
+    runner.run(group, variant, size, "realizePosition", [&]() {
+        state.updQ(); // invalidates the position kinematics too
+        system.realize(state, Stage::Position); return -1LL; });
+    runner.run(group, variant, size, "realizeVelocity", [&]() {
+        state.updU();
+        system.realize(state, Stage::Velocity); return -1LL; });
+    runner.run(group, variant, size, "realizeAcceleration", [&]() {
+        state.updQ();
+        system.realize(state, Stage::Acceleration); return -1LL; });
+    runner.run(group, variant, size, "multiplyByMInv", [&]() {
+        matter.multiplyByMInv(state, v, result); return -1LL; });
+    runner.run(group, variant, size, "calcCompositeBodyInertias", [&]() {
+        Array_<SpatialInertia, MobilizedBodyIndex> r;
+        matter.calcCompositeBodyInertias(state, r); return -1LL; });
+}
+
+const Body::Rigid& unitBody() {
+    static const Body::Rigid body(MassProperties(1, Vec3(0),
+                                                 UnitInertia::sphere(0.1)));
+    return body;
+}
+
+// Chains and binary trees of identical bodies with each mobilizer type.
+void timeTrees(Runner& runner, const std::vector<int>& sizes) {
+    for (const char* group : {"chain", "tree"})
+    for (const char* variant : {"pin", "ball", "free"})
+    for (int n : sizes) {
+        std::ostringstream prefix;
+        prefix << group << "/" << variant << "/n=" << n << "/";
+        if (!runner.wants(prefix.str(), KinematicsOps)) continue;
+
+        MultibodySystem system;
+        SimbodyMatterSubsystem matter(system);
+        GeneralForceSubsystem forces(system);
+        Force::Gravity(forces, matter, -YAxis, 9.81);
+        const bool isChain = std::strcmp(group, "chain") == 0;
+        for (int i=0; i < n; ++i) {
+            MobilizedBody& parent = matter.updMobilizedBody(
+                MobilizedBodyIndex(isChain ? i : i/2));
+            const Vec3 offset(0.1, -1, 0);
+            switch (variant[0]) {
+            case 'p': MobilizedBody::Pin(parent, offset, unitBody(), Vec3(0));
+                      break;
+            case 'b': MobilizedBody::Ball(parent, offset, unitBody(),Vec3(0));
+                      break;
+            default:  MobilizedBody::Free(parent, offset, unitBody(),Vec3(0));
+            }
+        }
+        State state = system.realizeTopology();
+        system.realizeModel(state);
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] += 0.01*(i%7);
+        timeKinematicsAndDynamics(runner, group, variant, n, system, state);
+    }
+}
+
+// Chains of ball-jointed links hanging from Ground, each closing back to
+// Ground with a ball constraint at its end so that it forms a loop. Besides
+// the usual kinematics and dynamics this times projection of a slightly
+// perturbed configuration and assembly from the unassembled default one.
+void timeClosedLoops(Runner& runner, const std::vector<int>& sizes) {
+    const int LinksPerLoop = 8;
+    for (int n : sizes) {
+        std::ostringstream prefix; prefix << "loops/ball/n=" << n << "/";
+        std::vector<std::string> ops = KinematicsOps;
+        ops.push_back("projectQ"); ops.push_back("assemble");
+        if (!runner.wants(prefix.str(), ops)) continue;
+
+        MultibodySystem system;
+        SimbodyMatterSubsystem matter(system);
+        GeneralForceSubsystem forces(system);
+        Force::Gravity(forces, matter, -YAxis, 9.81);
+        const int nLoops = std::max(1, n/LinksPerLoop);
+        for (int k=0; k < nLoops; ++k) {
+            MobilizedBody last = matter.updGround();
+            Vec3 attach(0, 0, 2*k);
+            for (int i=0; i < LinksPerLoop; ++i) {
+                last = MobilizedBody::Ball(last, attach, unitBody(), Vec3(0));
+                attach = Vec3(0, -1, 0);
+            }
+            // The loop closes at a Ground point the chain can reach when it
+            // is folded partway up.
+            Constraint::Ball(matter.updGround(),
+                             Vec3(0.4*LinksPerLoop, -0.4*LinksPerLoop, 2*k),
+                             last, Vec3(0, -1, 0));
+        }
+        const State defaultState = system.realizeTopology();
+        State state = defaultState;
+        system.realizeModel(state);
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] += 0.02*(i%5);
+        Assembler(system).setErrorTolerance(1e-10).assemble(state);
+        const Vector assembledQ = state.getQ();
+        const int nb = nLoops*LinksPerLoop;
+
+        timeKinematicsAndDynamics(runner, "loops", "ball", nb, system, state);
+        runner.run("loops", "ball", nb, "projectQ", [&]() {
+            state.updQ() = assembledQ;
+            for (int i=0; i < state.getNQ(); i += 3) state.updQ()[i] += 1e-4;
+            system.projectQ(state, 1e-8); return -1LL; });
+        runner.run("loops", "ball", nb, "assemble", [&]() {
+            State s = defaultState;
+            system.realizeModel(s);
+            for (int i=0; i < s.getNQ(); ++i) s.updQ()[i] += 0.02*(i%5);
+            Assembler(system).setErrorTolerance(1e-8).assemble(s);
+            return -1LL; });
+    }
+}
+
+// Add compliant contact with a Ground half space whose normal is +y.
+void addGroundContact(SimbodyMatterSubsystem& matter,
+                      const ContactMaterial& material) {
+    matter.updGround().updBody().addContactSurface(
+        Transform(Rotation(-Pi/2, ZAxis), Vec3(0)),
+        ContactSurface(ContactGeometry::HalfSpace(), material));
+}
+
+// Time force evaluation and a short simulation for a system of free bodies in
+// compliant contact, starting from the state given.
+void timeContact(Runner& runner, const std::string& group,
+    const std::string& variant, int n, const MultibodySystem& system,
+    const State& initState, Real simTime)
+{
+    State state = initState;
+    system.realize(state, Stage::Acceleration);
+    runner.run(group, variant, n, "realizeDynamics", [&]() {
+        state.updQ();
+        system.realize(state, Stage::Dynamics); return -1LL; });
+    runner.run(group, variant, n, "realizeAcceleration", [&]() {
+        state.updQ();
+        system.realize(state, Stage::Acceleration); return -1LL; });
+    runner.run(group, variant, n, "simulate", [&]() {
+        RungeKuttaMersonIntegrator integ(system);
+        integ.setAccuracy(1e-3);
+        TimeStepper ts(system, integ);
+        ts.initialize(initState);
+        ts.stepTo(simTime);
+        return (long long)integ.getNumStepsTaken(); });
+}
+
+// Piles of spheres on free bodies in a k x k x k block, slightly interpene-
+// trating each other and resting on the ground, with sphere-sphere contact.
+void timeContactPiles(Runner& runner, const std::vector<int>& sizes,
+                      Real simTime) {
+    for (int n : sizes) {
+        std::ostringstream prefix; prefix << "contact/spheres/n=" << n << "/";
+        if (!runner.wants(prefix.str(), ContactOps)) continue;
+
+        MultibodySystem system;
+        SimbodyMatterSubsystem matter(system);
+        GeneralForceSubsystem forces(system);
+        Force::Gravity(forces, matter, -YAxis, 9.81);
+        ContactTrackerSubsystem tracker(system);
+        CompliantContactSubsystem contact(system, tracker);
+        contact.setTransitionVelocity(1e-3);
+        const ContactMaterial material(1e6, 0.5, 0.8, 0.6);
+        addGroundContact(matter, material);
+
+        const Real r = 0.1;
+        Body::Rigid ball(MassProperties(1, Vec3(0), UnitInertia::sphere(r)));
+        ball.addContactSurface(Transform(),
+            ContactSurface(ContactGeometry::Sphere(r), material));
+        int k = 1; while (k*k*k < n) ++k;
+        std::vector<MobilizedBody::Free> balls;
+        for (int i=0; i < n; ++i)
+            balls.push_back(MobilizedBody::Free(matter.updGround(), Vec3(0),
+                                                ball, Vec3(0)));
+        State state = system.realizeTopology();
+        system.realizeModel(state);
+        for (int i=0; i < n; ++i) {
+            const int ix = i%k, iz = (i/k)%k, iy = i/(k*k);
+            balls[i].setQToFitTranslation(state,
+                Vec3(ix*1.99*r, r*0.999 + iy*1.99*r, iz*1.99*r));
+        }
+        timeContact(runner, "contact", "spheres", n, system, state, simTime);
+    }
+}
+
+// Free bodies carrying tessellated sphere meshes, each resting on the ground
+// and on the neighboring ones, using elastic foundation contact.
+void timeMeshContact(Runner& runner, const std::vector<int>& sizes,
+                     int resolution, Real simTime) {
+    for (int n : sizes) {
+        std::ostringstream prefix; prefix << "contact/mesh/n=" << n << "/";
+        if (!runner.wants(prefix.str(), ContactOps)) continue;
+
+        MultibodySystem system;
+        SimbodyMatterSubsystem matter(system);
+        GeneralForceSubsystem forces(system);
+        Force::Gravity(forces, matter, -YAxis, 9.81);
+        ContactTrackerSubsystem tracker(system);
+        CompliantContactSubsystem contact(system, tracker);
+        contact.setTransitionVelocity(1e-3);
+        const ContactMaterial material(1e6, 0.5, 0.8, 0.6);
+        addGroundContact(matter, material);
+
+        const Real r = 0.1;
+        const ContactGeometry::TriangleMesh mesh
+           (PolygonalMesh::createSphereMesh(r, resolution));
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia::sphere(r)));
+        body.addContactSurface(Transform(),
+            ContactSurface(mesh, material, 0.01));
+        std::vector<MobilizedBody::Free> bodies;
+        for (int i=0; i < n; ++i)
+            bodies.push_back(MobilizedBody::Free(matter.updGround(), Vec3(0),
+                                                 body, Vec3(0)));
+        State state = system.realizeTopology();
+        system.realizeModel(state);
+        for (int i=0; i < n; ++i)
+            bodies[i].setQToFitTranslation(state,
+                Vec3(i*1.99*r, r*0.99, 0));
+        timeContact(runner, "contact", "mesh", n, system, state, simTime);
+    }
+}
+
+// Each integrator simulates a closed loop of ball-jointed links swinging
+// under gravity, so that constraint projection is included. The system is
+// small enough that it isn't worth checking the filter before building it.
+void timeIntegrators(Runner& runner, int nLinks, Real simTime) {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.81);
+    MobilizedBody last = matter.updGround();
+    for (int i=0; i < nLinks; ++i)
+        last = MobilizedBody::Ball(last, Vec3(0, i ? -1 : 0, 0), unitBody(),
+                                   Vec3(0));
+    Constraint::Ball(matter.updGround(), Vec3(0.4*nLinks, -0.4*nLinks, 0),
+                     last, Vec3(0, -1, 0));
+    State init = system.realizeTopology();
+    system.realizeModel(init);
+    for (int i=0; i < init.getNQ(); ++i) init.updQ()[i] += 0.02*(i%5);
+    Assembler(system).setErrorTolerance(1e-10).assemble(init);
+
+    const Real h = 1e-3, accuracy = 1e-4;
+    typedef std::function<Integrator*()> Maker;
+    const std::pair<const char*, Maker> integrators[] = {
+        {"ExplicitEuler",   [&]{return new ExplicitEulerIntegrator(system);}},
+        {"RungeKutta2",     [&]{return new RungeKutta2Integrator(system);}},
+        {"RungeKutta3",     [&]{return new RungeKutta3Integrator(system);}},
+        {"RungeKuttaMerson",[&]{return new RungeKuttaMersonIntegrator(system);}},
+        {"RungeKuttaFeldberg",
+                        [&]{return new RungeKuttaFeldbergIntegrator(system);}},
+        {"Verlet",          [&]{return new VerletIntegrator(system);}},
+        {"SemiExplicitEuler",
+                     [&]{return new SemiExplicitEulerIntegrator(system, h);}},
+        {"SemiExplicitEuler2",
+                        [&]{return new SemiExplicitEuler2Integrator(system);}},
+        {"Multirate",       [&]{return new MultirateIntegrator(system);}},
+        {"Rattle",          [&]{return new RattleIntegrator(system, h);}},
+        {"CPodes",          [&]{return new CPodesIntegrator(system);}},
+    };
+    for (const auto& entry : integrators) {
+        const Maker& make = entry.second;
+        runner.run("integrator", entry.first, nLinks, "simulate", [&]() {
+            std::unique_ptr<Integrator> integ(make());
+            integ->setAccuracy(accuracy);
+            TimeStepper ts(system, *integ);
+            ts.initialize(init);
+            ts.stepTo(simTime);
+            return (long long)integ->getNumStepsTaken(); });
+    }
+}
+
+void printUsage() {
+    std::cout <<
+"Usage: simbody-bench [options]\n"
+"  --quick               small systems and short samples, for a smoke test\n"
+"  --filter TEXT         run only benchmarks whose name contains TEXT\n"
+"  --list                list the benchmark names and exit\n"
+"  --repeats N           number of timed samples per benchmark (default 5)\n"
+"  --json FILE           write the results to FILE as JSON\n"
+"  --baseline FILE       compare with the results in FILE (from --json)\n"
+"  --tolerance FRACTION  slowdown that counts as a regression (default 0.15)\n"
+"Exit status is 1 if any benchmark regressed relative to the baseline.\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& opts) {
+    for (int i=1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i+1 < argc;
+        if (arg == "--quick") opts.quick = true;
+        else if (arg == "--list") opts.listOnly = true;
+        else if (arg == "--filter" && hasValue) opts.filter = argv[++i];
+        else if (arg == "--json" && hasValue) opts.jsonFile = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            opts.baselineFile = argv[++i];
+        else if (arg == "--repeats" && hasValue) {
+            opts.repeats = std::atoi(argv[++i]);
+            if (opts.repeats < 1) return false;
+        } else if (arg == "--tolerance" && hasValue) {
+            opts.tolerance = std::atof(argv[++i]);
+            if (!(opts.tolerance >= 0)) return false;
+        } else return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage();
+        return 2;
+    }
+
+    Runner runner(opts);
+    try {
+        const std::vector<int> treeSizes = opts.quick
+            ? std::vector<int>{8, 32} : std::vector<int>{16, 64, 256};
+        const std::vector<int> loopSizes = opts.quick
+            ? std::vector<int>{8, 16} : std::vector<int>{8, 32, 128};
+        const std::vector<int> pileSizes = opts.quick
+            ? std::vector<int>{8} : std::vector<int>{8, 27, 64};
+        const std::vector<int> meshSizes = opts.quick
+            ? std::vector<int>{2} : std::vector<int>{2, 8};
+
+        timeTrees(runner, treeSizes);
+        timeClosedLoops(runner, loopSizes);
+        timeContactPiles(runner, pileSizes, opts.quick ? 0.002 : 0.02);
+        timeMeshContact(runner, meshSizes, opts.quick ? 1 : 2,
+                        opts.quick ? 0.002 : 0.02);
+        timeIntegrators(runner, 6, opts.quick ? 0.01 : 0.5);
+    } catch (const std::exception& e) {
+        std::cerr << "simbody-bench: " << e.what() << std::endl;
+        return 2;
+    }
+    if (opts.listOnly) return 0;
+
+    if (!opts.jsonFile.empty()
+        && !writeJson(opts.jsonFile, opts, runner.getResults())) {
+        std::cerr << "simbody-bench: can't write '" << opts.jsonFile << "'\n";
+        return 2;
+    }
+
+    if (!opts.baselineFile.empty()) {
+        bool ok;
+        const int nRegressed = compareWithBaseline(opts.baselineFile,
+            opts.tolerance, runner.getResults(), ok);
+        if (!ok) return 2;
+        return nRegressed ? 1 : 0;
+    }
+    return 0;
+}